@@ -55,6 +55,12 @@ class _IOCrypto {
   static Uint8List getRandomBytes(int count) native "Crypto_GetRandomBytes";
 }
 
+@patch
+class _IOBufferPoolInfo {
+  @patch
+  static List<int> _statistics() native "IOBuffer_PoolStatistics";
+}
+
 @pragma("vm:entry-point")
 _setupHooks() {
   VMLibraryHooks.eventHandlerSendData = _EventHandler._sendData;
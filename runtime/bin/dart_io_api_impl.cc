@@ -7,6 +7,7 @@
 #include "bin/crypto.h"
 #include "bin/directory.h"
 #include "bin/eventhandler.h"
+#include "bin/file_io_pool.h"
 #include "bin/io_natives.h"
 #include "bin/platform.h"
 #include "bin/process.h"
@@ -23,6 +24,7 @@ void BootstrapDartIo() {
 }
 
 void CleanupDartIo() {
+  FileIOPool::Shutdown();
   EventHandler::Stop();
 }
 
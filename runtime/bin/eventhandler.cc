@@ -58,6 +58,8 @@ void TimeoutQueue::UpdateTimeout(Dart_Port port, int64_t timeout) {
 static EventHandler* event_handler = NULL;
 static Monitor* shutdown_monitor = NULL;
 
+bool EventHandler::use_io_uring_ = false;
+
 void EventHandler::Start() {
   // Initialize global socket registry.
   ListeningSocketRegistry::Initialize();
@@ -643,10 +643,20 @@ class EventHandler {
 
   static void SendFromNative(intptr_t id, Dart_Port port, int64_t data);
 
+  // Whether the event handler batches its system calls with io_uring. Only
+  // the Linux event handler does, when the kernel supports it. Takes effect
+  // when the event handler is started.
+  static bool use_io_uring() { return use_io_uring_; }
+  static void set_use_io_uring(bool use_io_uring) {
+    use_io_uring_ = use_io_uring;
+  }
+
  private:
   friend class EventHandlerImplementation;
   EventHandlerImplementation delegate_;
 
+  static bool use_io_uring_;
+
   DISALLOW_COPY_AND_ASSIGN(EventHandler);
 };
 
@@ -10,6 +10,7 @@
 
 #include <errno.h>        // NOLINT
 #include <fcntl.h>        // NOLINT
+#include <poll.h>         // NOLINT
 #include <pthread.h>      // NOLINT
 #include <stdio.h>        // NOLINT
 #include <string.h>       // NOLINT
@@ -20,6 +21,7 @@
 
 #include "bin/dartutils.h"
 #include "bin/fdutils.h"
+#include "bin/io_uring_linux.h"
 #include "bin/lockers.h"
 #include "bin/log.h"
 #include "bin/socket.h"
@@ -48,15 +50,24 @@ static void RemoveFromEpollInstance(intptr_t epoll_fd_, DescriptorInfo* di) {
   VOID_NO_RETRY_EXPECTED(epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, di->fd(), NULL));
 }
 
-static void AddToEpollInstance(intptr_t epoll_fd_, DescriptorInfo* di) {
-  struct epoll_event event;
-  event.events = EPOLLRDHUP | di->GetPollEvents();
+// Sets up the event a DescriptorInfo structure is registered with epoll for.
+static void InitEpollEvent(DescriptorInfo* di, struct epoll_event* event) {
+  event->events = EPOLLRDHUP | di->GetPollEvents();
   if (!di->IsListeningSocket()) {
-    event.events |= EPOLLET;
+    event->events |= EPOLLET;
   }
-  event.data.ptr = di;
-  int status =
-      NO_RETRY_EXPECTED(epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, di->fd(), &event));
+  event->data.ptr = di;
+}
+
+// Registers the file descriptor for a DescriptorInfo structure with epoll
+// (op is EPOLL_CTL_ADD), or updates the events it is registered for (op is
+// EPOLL_CTL_MOD).
+static void AddToEpollInstance(intptr_t epoll_fd_,
+                               DescriptorInfo* di,
+                               int op = EPOLL_CTL_ADD) {
+  struct epoll_event event;
+  InitEpollEvent(di, &event);
+  int status = NO_RETRY_EXPECTED(epoll_ctl(epoll_fd_, op, di->fd(), &event));
   if (status == -1) {
     // TODO(dart:io): Verify that the dart end is handling this correctly.
 
@@ -68,6 +79,15 @@ static void AddToEpollInstance(intptr_t epoll_fd_, DescriptorInfo* di) {
   }
 }
 
+// The size of the io_uring submission queue, which holds the changes to the
+// epoll instance made in a round of the poll loop.
+static const intptr_t kIOUringEntries = 256;
+
+// The user data of an io_uring poll of the epoll instance. The user data of
+// an epoll_ctl call is its DescriptorInfo structure tagged with the call's op.
+static const uint64_t kEpollEventsData = 0;
+static const uint64_t kEpollCtlOpMask = 3;
+
 EventHandlerImplementation::EventHandlerImplementation()
     : socket_map_(&SimpleHashMap::SamePointerValue, 16) {
   intptr_t result;
@@ -117,6 +137,13 @@ EventHandlerImplementation::EventHandlerImplementation()
     FATAL2("Failed adding timerfd fd(%i) to epoll instance: %i", timer_fd_,
            errno);
   }
+  // Falls back to making the changes to the epoll instance one system call
+  // at a time if the kernel does not support io_uring.
+  uring_ = EventHandler::use_io_uring() ? IOUring::Create(kIOUringEntries)
+                                        : NULL;
+  pending_epoll_ctls_ = 0;
+  epoll_poll_queued_ = false;
+  epoll_ready_ = false;
 }
 
 static void DeleteDescriptorInfo(void* info) {
@@ -127,6 +154,7 @@ static void DeleteDescriptorInfo(void* info) {
 
 EventHandlerImplementation::~EventHandlerImplementation() {
   socket_map_.Clear(DeleteDescriptorInfo);
+  delete uring_;
   VOID_TEMP_FAILURE_RETRY(close(epoll_fd_));
   VOID_TEMP_FAILURE_RETRY(close(timer_fd_));
   VOID_TEMP_FAILURE_RETRY(close(interrupt_fds_[0]));
@@ -136,14 +164,73 @@ EventHandlerImplementation::~EventHandlerImplementation() {
 void EventHandlerImplementation::UpdateEpollInstance(intptr_t old_mask,
                                                      DescriptorInfo* di) {
   intptr_t new_mask = di->Mask();
+  int op;
   if ((old_mask != 0) && (new_mask == 0)) {
-    RemoveFromEpollInstance(epoll_fd_, di);
+    op = EPOLL_CTL_DEL;
   } else if ((old_mask == 0) && (new_mask != 0)) {
-    AddToEpollInstance(epoll_fd_, di);
+    op = EPOLL_CTL_ADD;
   } else if ((old_mask != 0) && (new_mask != 0) && (old_mask != new_mask)) {
     ASSERT(!di->IsListeningSocket());
+    // Like adding the descriptor again, modifying it reports the events
+    // that are already pending, but takes a single system call.
+    op = EPOLL_CTL_MOD;
+  } else {
+    return;
+  }
+  if (uring_ != NULL) {
+    QueueEpollCtl(op, di);
+  } else if (op == EPOLL_CTL_DEL) {
     RemoveFromEpollInstance(epoll_fd_, di);
-    AddToEpollInstance(epoll_fd_, di);
+  } else {
+    AddToEpollInstance(epoll_fd_, di, op);
+  }
+}
+
+void EventHandlerImplementation::QueueEpollCtl(int op, DescriptorInfo* di) {
+  struct epoll_event event;
+  InitEpollEvent(di, &event);
+  ASSERT((reinterpret_cast<uword>(di) & kEpollCtlOpMask) == 0);
+  const uint64_t user_data = reinterpret_cast<uword>(di) | op;
+  while (!uring_->PrepareEpollCtl(epoll_fd_, op, di->fd(), &event,
+                                  user_data)) {
+    // The submission queue is full.
+    SubmitEpollChanges(false);
+  }
+  pending_epoll_ctls_++;
+}
+
+void EventHandlerImplementation::SubmitEpollChanges(bool wait_for_events) {
+  if (wait_for_events && !epoll_ready_ && !epoll_poll_queued_) {
+    while (!uring_->PreparePoll(epoll_fd_, POLLIN, kEpollEventsData)) {
+      // The submission queue is full.
+      SubmitEpollChanges(false);
+    }
+    epoll_poll_queued_ = true;
+  }
+  while ((pending_epoll_ctls_ > 0) || (wait_for_events && !epoll_ready_)) {
+    const intptr_t wait_count =
+        pending_epoll_ctls_ + ((wait_for_events && !epoll_ready_) ? 1 : 0);
+    if (!uring_->Enter(wait_count)) {
+      FATAL1("Failed submitting to io_uring: %i", errno);
+    }
+    uint64_t user_data;
+    int32_t result;
+    while (uring_->NextCompletion(&user_data, &result)) {
+      if (user_data == kEpollEventsData) {
+        epoll_poll_queued_ = false;
+        epoll_ready_ = true;
+        continue;
+      }
+      pending_epoll_ctls_--;
+      // Like AddToEpollInstance, report the descriptors epoll does not
+      // accept as closed.
+      const int op = user_data & kEpollCtlOpMask;
+      if ((result < 0) && (op != EPOLL_CTL_DEL)) {
+        DescriptorInfo* di =
+            reinterpret_cast<DescriptorInfo*>(user_data & ~kEpollCtlOpMask);
+        di->NotifyAllDartPorts(1 << kCloseEvent);
+      }
+    }
   }
 }
 
@@ -228,6 +315,11 @@ void EventHandlerImplementation::HandleInterruptFd() {
         }
         intptr_t new_mask = di->Mask();
         UpdateEpollInstance(old_mask, di);
+        if (uring_ != NULL) {
+          // The descriptor must be removed from epoll before it is closed,
+          // and its structure must outlive the queued epoll_ctl calls.
+          SubmitEpollChanges(false);
+        }
 
         intptr_t fd = di->fd();
         ASSERT(fd == socket->fd());
@@ -382,17 +474,34 @@ void EventHandlerImplementation::HandleEvents(struct epoll_event* events,
 
 void EventHandlerImplementation::Poll(uword args) {
   ThreadSignalBlocker signal_blocker(SIGPROF);
-  static const intptr_t kMaxEvents = 16;
+  // Busy servers have many ready descriptors at once, so take them in large
+  // batches to save epoll_wait calls.
+  static const intptr_t kMaxEvents = 128;
   struct epoll_event events[kMaxEvents];
   EventHandler* handler = reinterpret_cast<EventHandler*>(args);
   EventHandlerImplementation* handler_impl = &handler->delegate_;
   ASSERT(handler_impl != NULL);
 
   while (!handler_impl->shutdown_) {
-    intptr_t result = TEMP_FAILURE_RETRY_NO_SIGNAL_BLOCKER(
-        epoll_wait(handler_impl->epoll_fd_, events, kMaxEvents, -1));
+    intptr_t result;
+    if (handler_impl->uring_ != NULL) {
+      // A single io_uring_enter call makes the changes to the epoll instance
+      // from the last round and waits for it to have events, which are then
+      // taken without blocking.
+      handler_impl->SubmitEpollChanges(true);
+      handler_impl->epoll_ready_ = false;
+      result = TEMP_FAILURE_RETRY_NO_SIGNAL_BLOCKER(
+          epoll_wait(handler_impl->epoll_fd_, events, kMaxEvents, 0));
+    } else {
+      result = TEMP_FAILURE_RETRY_NO_SIGNAL_BLOCKER(
+          epoll_wait(handler_impl->epoll_fd_, events, kMaxEvents, -1));
+    }
     ASSERT(EAGAIN == EWOULDBLOCK);
-    if (result <= 0) {
+    if (result == 0) {
+      // The events went away before they were taken, e.g. because their
+      // descriptors were removed.
+      continue;
+    } else if (result < 0) {
       if (errno != EWOULDBLOCK) {
         perror("Poll failed");
       }
@@ -20,6 +20,8 @@
 namespace dart {
 namespace bin {
 
+class IOUring;
+
 class DescriptorInfo : public DescriptorInfoBase {
  public:
   explicit DescriptorInfo(intptr_t fd) : DescriptorInfoBase(fd) {}
@@ -74,6 +76,11 @@ class EventHandlerImplementation {
 
  private:
   void HandleEvents(struct epoll_event* events, int size);
+  void QueueEpollCtl(int op, DescriptorInfo* di);
+  // Submits the changes queued for the epoll instance and waits until they
+  // are made. If [wait_for_events], also waits until the epoll instance has
+  // events.
+  void SubmitEpollChanges(bool wait_for_events);
   static void Poll(uword args);
   void WakeupHandler(intptr_t id, Dart_Port dart_port, int64_t data);
   void HandleInterruptFd();
@@ -90,6 +97,15 @@ class EventHandlerImplementation {
   int epoll_fd_;
   int timer_fd_;
 
+  // Batches the changes to the epoll instance if io_uring is used, or NULL.
+  IOUring* uring_;
+  // The number of queued epoll_ctl calls that have not completed.
+  intptr_t pending_epoll_ctls_;
+  // Whether a poll of the epoll instance is queued.
+  bool epoll_poll_queued_;
+  // Whether the poll found events that have not been taken yet.
+  bool epoll_ready_;
+
   DISALLOW_COPY_AND_ASSIGN(EventHandlerImplementation);
 };
 
@@ -8,6 +8,7 @@
 
 #include "bin/builtin.h"
 #include "bin/dartutils.h"
+#include "bin/file_io_pool.h"
 #include "bin/io_buffer.h"
 #include "bin/namespace.h"
 #include "bin/typed_data_utils.h"
@@ -290,6 +291,66 @@ void FUNCTION_NAME(File_WriteFrom)(Dart_NativeArguments args) {
   }
 }
 
+static Dart_Port GetCompletionPort(Dart_NativeArguments args, intptr_t index) {
+  Dart_Port port = ILLEGAL_PORT;
+  ThrowIfError(Dart_SendPortGetId(Dart_GetNativeArgument(args, index), &port));
+  return port;
+}
+
+void FUNCTION_NAME(File_ReadAsync)(Dart_NativeArguments args) {
+  File* file = GetFile(args);
+  ASSERT(file != NULL);
+  const int64_t length = DartUtils::GetNativeIntegerArgument(args, 1);
+  const int64_t id = DartUtils::GetNativeIntegerArgument(args, 2);
+  const Dart_Port port = GetCompletionPort(args, 3);
+  // The reference is released when the request completes.
+  file->Retain();
+  FileIOPool::Read(file, length, id, port);
+}
+
+void FUNCTION_NAME(File_WriteFromAsync)(Dart_NativeArguments args) {
+  File* file = GetFile(args);
+  ASSERT(file != NULL);
+  Dart_Handle buffer_obj = Dart_GetNativeArgument(args, 1);
+  // Offset and length arguments are checked in Dart code to be
+  // integers and have the property that (offset + length) <=
+  // list.length. Therefore, it is safe to extract their value as
+  // intptr_t.
+  intptr_t start = DartUtils::GetNativeIntptrArgument(args, 2);
+  intptr_t end = DartUtils::GetNativeIntptrArgument(args, 3);
+  const int64_t id = DartUtils::GetNativeIntegerArgument(args, 4);
+  const Dart_Port port = GetCompletionPort(args, 5);
+
+  // The bytes are copied out of the buffer object, which the worker thread
+  // cannot access.
+  intptr_t length = end - start;
+  uint8_t* data = IOBuffer::Allocate(length);
+  if (data == NULL) {
+    Dart_ThrowException(DartUtils::NewDartOSError());
+  }
+  Dart_TypedData_Type type;
+  intptr_t buffer_len = 0;
+  void* buffer = NULL;
+  Dart_Handle result =
+      Dart_TypedDataAcquireData(buffer_obj, &type, &buffer, &buffer_len);
+  if (Dart_IsError(result)) {
+    IOBuffer::Free(data);
+    Dart_PropagateError(result);
+  }
+  ASSERT(type == Dart_TypedData_kUint8 || type == Dart_TypedData_kInt8);
+  ASSERT(end <= buffer_len);
+  ASSERT(buffer != NULL);
+  memmove(data, reinterpret_cast<uint8_t*>(buffer) + start, length);
+  result = Dart_TypedDataReleaseData(buffer_obj);
+  if (Dart_IsError(result)) {
+    IOBuffer::Free(data);
+    Dart_PropagateError(result);
+  }
+  // The reference is released when the request completes.
+  file->Retain();
+  FileIOPool::WriteFrom(file, data, length, id, port);
+}
+
 void FUNCTION_NAME(File_Position)(Dart_NativeArguments args) {
   File* file = GetFile(args);
   ASSERT(file != NULL);
@@ -1244,36 +1305,10 @@ CObject* File::ReadRequest(const CObjectArray& request) {
 }
 
 CObject* File::ReadIntoRequest(const CObjectArray& request) {
-  if ((request.Length() < 1) || !request[0]->IsIntptr()) {
-    return CObject::IllegalArgumentError();
-  }
-  File* file = CObjectToFilePointer(request[0]);
-  RefCntReleaseScope<File> rs(file);
-  if ((request.Length() != 2) || !request[1]->IsInt32OrInt64()) {
-    return CObject::IllegalArgumentError();
-  }
-  if (file->IsClosed()) {
-    return CObject::FileClosedError();
-  }
-  const int64_t length = CObjectInt32OrInt64ToInt64(request[1]);
-  Dart_CObject* io_buffer = CObject::NewIOBuffer(length);
-  if (io_buffer == NULL) {
-    return CObject::NewOSError();
-  }
-  uint8_t* data = io_buffer->value.as_external_typed_data.data;
-  const int64_t bytes_read = file->Read(data, length);
-  if (bytes_read < 0) {
-    CObject::FreeIOBufferData(io_buffer);
-    return CObject::NewOSError();
-  }
-  CObjectExternalUint8Array* external_array =
-      new CObjectExternalUint8Array(io_buffer);
-  external_array->SetLength(bytes_read);
-  CObjectArray* result = new CObjectArray(CObject::NewArray(3));
-  result->SetAt(0, new CObjectIntptr(CObject::NewInt32(0)));
-  result->SetAt(1, new CObjectInt64(CObject::NewInt64(bytes_read)));
-  result->SetAt(2, external_array);
-  return result;
+  // The bytes are copied into the caller's buffer on the Dart side, and the
+  // number of bytes read is the length of the returned buffer, so the reply
+  // is the same as for a read.
+  return ReadRequest(request);
 }
 
 static int SizeInBytes(Dart_TypedData_Type type) {
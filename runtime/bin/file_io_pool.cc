@@ -0,0 +1,309 @@
+// Copyright (c) 2019, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "bin/file_io_pool.h"
+
+#include "bin/dartutils.h"
+#include "bin/io_buffer.h"
+#include "bin/lockers.h"
+#include "bin/utils.h"
+#include "platform/utils.h"
+
+namespace dart {
+namespace bin {
+
+// A queued read or write. The request owns the storage of its completion,
+// which is only valid until the request is deleted.
+class FileIOPool::Request {
+ public:
+  Request(Operation operation,
+          File* file,
+          uint8_t* data,
+          int64_t length,
+          int64_t id,
+          Dart_Port port)
+      : operation_(operation),
+        file_(file),
+        data_(data),
+        length_(length),
+        port_(port),
+        response_(NULL),
+        message_(NULL),
+        next_(NULL) {
+    id_.type = Dart_CObject_kInt64;
+    id_.value.as_int64 = id;
+  }
+
+  ~Request() {
+    file_->Release();
+    IOBuffer::Free(data_);
+    free(message_);
+  }
+
+  void Run() {
+    if (file_->IsClosed()) {
+      SetError(CObject::kFileClosedError);
+      return;
+    }
+    switch (operation_) {
+      case kRead:
+        RunRead();
+        break;
+      case kWriteFrom:
+        RunWriteFrom();
+        break;
+      default:
+        UNREACHABLE();
+    }
+  }
+
+  Dart_CObject* id() { return &id_; }
+  Dart_CObject* response() const { return response_; }
+  Dart_Port port() const { return port_; }
+
+  Request* next() const { return next_; }
+  Request** next_address() { return &next_; }
+  void set_next(Request* next) { next_ = next; }
+
+ private:
+  void RunRead() {
+    if ((length_ < 0) || (length_ > kIntptrMax)) {
+      OSError os_error(-1, "Invalid argument", OSError::kUnknown);
+      SetOSError(&os_error);
+      return;
+    }
+    data_ = IOBuffer::Allocate(static_cast<intptr_t>(length_));
+    if (data_ == NULL) {
+      OSError os_error;
+      SetOSError(&os_error);
+      return;
+    }
+    const int64_t bytes_read = file_->Read(data_, length_);
+    if (bytes_read < 0) {
+      OSError os_error;
+      SetOSError(&os_error);
+      return;
+    }
+    values_[0].type = Dart_CObject_kInt32;
+    values_[0].value.as_int32 = CObject::kSuccess;
+    values_[1].type = Dart_CObject_kExternalTypedData;
+    values_[1].value.as_external_typed_data.type = Dart_TypedData_kUint8;
+    values_[1].value.as_external_typed_data.length = bytes_read;
+    values_[1].value.as_external_typed_data.data = data_;
+    values_[1].value.as_external_typed_data.peer = data_;
+    values_[1].value.as_external_typed_data.callback = IOBuffer::Finalizer;
+    // The buffer is freed by the finalizer of the posted message.
+    data_ = NULL;
+    SetArray(2);
+  }
+
+  void RunWriteFrom() {
+    if (!file_->WriteFully(data_, length_)) {
+      OSError os_error;
+      SetOSError(&os_error);
+      return;
+    }
+    values_[0].type = Dart_CObject_kInt64;
+    values_[0].value.as_int64 = length_;
+    response_ = &values_[0];
+  }
+
+  void SetError(int error) {
+    values_[0].type = Dart_CObject_kInt32;
+    values_[0].value.as_int32 = error;
+    SetArray(1);
+  }
+
+  void SetOSError(OSError* os_error) {
+    const char* message = os_error->message();
+    message_ = strdup((message != NULL) ? message : "");
+    values_[0].type = Dart_CObject_kInt32;
+    values_[0].value.as_int32 = CObject::kOSError;
+    values_[1].type = Dart_CObject_kInt32;
+    values_[1].value.as_int32 = os_error->code();
+    values_[2].type = Dart_CObject_kString;
+    values_[2].value.as_string = message_;
+    SetArray(3);
+  }
+
+  void SetArray(intptr_t length) {
+    for (intptr_t i = 0; i < length; i++) {
+      elements_[i] = &values_[i];
+    }
+    array_.type = Dart_CObject_kArray;
+    array_.value.as_array.length = length;
+    array_.value.as_array.values = elements_;
+    response_ = &array_;
+  }
+
+  static const intptr_t kMaxResponseLength = 3;
+
+  const Operation operation_;
+  File* const file_;
+  uint8_t* data_;
+  const int64_t length_;
+  const Dart_Port port_;
+
+  Dart_CObject id_;
+  Dart_CObject* response_;
+  Dart_CObject array_;
+  Dart_CObject* elements_[kMaxResponseLength];
+  Dart_CObject values_[kMaxResponseLength];
+  char* message_;
+
+  Request* next_;
+
+  DISALLOW_COPY_AND_ASSIGN(Request);
+};
+
+Monitor* FileIOPool::monitor_ = new Monitor();
+FileIOPool::Request* FileIOPool::queue_head_ = NULL;
+FileIOPool::Request* FileIOPool::queue_tail_ = NULL;
+intptr_t FileIOPool::queue_length_ = 0;
+intptr_t FileIOPool::workers_ = 0;
+intptr_t FileIOPool::idle_workers_ = 0;
+bool FileIOPool::shutting_down_ = false;
+int64_t FileIOPool::completion_messages_ = 0;
+
+void FileIOPool::Read(File* file, int64_t length, int64_t id, Dart_Port port) {
+  Enqueue(new Request(kRead, file, NULL, length, id, port));
+}
+
+void FileIOPool::WriteFrom(File* file,
+                           uint8_t* data,
+                           intptr_t length,
+                           int64_t id,
+                           Dart_Port port) {
+  Enqueue(new Request(kWriteFrom, file, data, length, id, port));
+}
+
+void FileIOPool::Enqueue(Request* request) {
+  MonitorLocker ml(monitor_);
+  if (queue_tail_ == NULL) {
+    queue_head_ = request;
+  } else {
+    queue_tail_->set_next(request);
+  }
+  queue_tail_ = request;
+  queue_length_++;
+  if ((idle_workers_ > 0) || (workers_ == kMaxWorkers)) {
+    ml.Notify();
+    return;
+  }
+  int result = Thread::Start(WorkerEntry, 0);
+  if (result != 0) {
+    FATAL1("Failed to start file IO pool worker thread %d", result);
+  }
+  workers_++;
+}
+
+FileIOPool::Request* FileIOPool::TakeBatch() {
+  MonitorLocker ml(monitor_);
+  while ((queue_head_ == NULL) && !shutting_down_) {
+    idle_workers_++;
+    ml.Wait();
+    idle_workers_--;
+  }
+  if (queue_head_ == NULL) {
+    return NULL;
+  }
+  // Share the queued requests between the workers, so that batching does
+  // not serialize requests that another worker could run concurrently.
+  const intptr_t batch_size = Utils::Minimum(
+      kMaxBatchSize, Utils::Maximum<intptr_t>(1, queue_length_ / workers_));
+  Request* batch = queue_head_;
+  Request* last = batch;
+  for (intptr_t i = 1; (i < batch_size) && (last->next() != NULL); i++) {
+    last = last->next();
+    queue_length_--;
+  }
+  queue_length_--;
+  queue_head_ = last->next();
+  if (queue_head_ == NULL) {
+    queue_tail_ = NULL;
+  }
+  last->set_next(NULL);
+  return batch;
+}
+
+void FileIOPool::PostCompletions(Request* completed) {
+  while (completed != NULL) {
+    // Move the completions for the port of the first one to the batch,
+    // keeping them in the order the requests were queued in.
+    const Dart_Port port = completed->port();
+    Request* batch = NULL;
+    Request** batch_tail = &batch;
+    intptr_t batch_length = 0;
+    Request** cursor = &completed;
+    while (*cursor != NULL) {
+      Request* request = *cursor;
+      if (request->port() == port) {
+        *cursor = request->next();
+        request->set_next(NULL);
+        *batch_tail = request;
+        batch_tail = request->next_address();
+        batch_length++;
+      } else {
+        cursor = request->next_address();
+      }
+    }
+
+    Dart_CObject** values = new Dart_CObject*[2 * batch_length];
+    intptr_t i = 0;
+    for (Request* request = batch; request != NULL; request = request->next()) {
+      values[i++] = request->id();
+      values[i++] = request->response();
+    }
+    Dart_CObject message;
+    message.type = Dart_CObject_kArray;
+    message.value.as_array.length = 2 * batch_length;
+    message.value.as_array.values = values;
+    // If the port is closed, the message is dropped and the finalizers of
+    // the buffers read run.
+    Dart_PostCObject(port, &message);
+    delete[] values;
+
+    while (batch != NULL) {
+      Request* request = batch;
+      batch = request->next();
+      delete request;
+    }
+    MonitorLocker ml(monitor_);
+    completion_messages_++;
+  }
+}
+
+void FileIOPool::WorkerEntry(uword param) {
+  while (true) {
+    Request* batch = TakeBatch();
+    if (batch == NULL) {
+      break;
+    }
+    for (Request* request = batch; request != NULL; request = request->next()) {
+      request->Run();
+    }
+    PostCompletions(batch);
+  }
+  MonitorLocker ml(monitor_);
+  workers_--;
+  ml.NotifyAll();
+}
+
+void FileIOPool::Shutdown() {
+  MonitorLocker ml(monitor_);
+  shutting_down_ = true;
+  ml.NotifyAll();
+  while (workers_ > 0) {
+    ml.Wait();
+  }
+  shutting_down_ = false;
+}
+
+int64_t FileIOPool::CompletionMessageCount() {
+  MonitorLocker ml(monitor_);
+  return completion_messages_;
+}
+
+}  // namespace bin
+}  // namespace dart
@@ -0,0 +1,78 @@
+// Copyright (c) 2019, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#ifndef RUNTIME_BIN_FILE_IO_POOL_H_
+#define RUNTIME_BIN_FILE_IO_POOL_H_
+
+#include "bin/builtin.h"
+#include "bin/file.h"
+#include "bin/thread.h"
+#include "include/dart_native_api.h"
+#include "platform/globals.h"
+
+namespace dart {
+namespace bin {
+
+// Runs asynchronous File reads and writes on a dedicated pool of threads.
+//
+// Unlike requests to the IO service, requests to the pool are queued
+// directly by a native call instead of being serialized into a message.
+// The completion of a request is its id followed by its response, which
+// has the same shape as the response of the IO service to the same request.
+// A worker runs the queued requests in batches, and posts the completions
+// of a batch for the same port in a single message.
+class FileIOPool {
+ public:
+  enum Operation {
+    kRead = 0,
+    kWriteFrom = 1,
+  };
+
+  // Queues a read of up to [length] bytes from [file]. On success the
+  // response is [0, bytes], with the bytes in an external Uint8List.
+  static void Read(File* file, int64_t length, int64_t id, Dart_Port port);
+
+  // Queues a write of the [length] bytes at [data] to [file]. The pool
+  // frees [data], which must be allocated with IOBuffer::Allocate. On
+  // success the response is the number of bytes written.
+  static void WriteFrom(File* file,
+                        uint8_t* data,
+                        intptr_t length,
+                        int64_t id,
+                        Dart_Port port);
+
+  // Runs the queued requests and stops the worker threads.
+  static void Shutdown();
+
+  // The number of completion messages posted, for testing.
+  static int64_t CompletionMessageCount();
+
+ private:
+  class Request;
+
+  static void Enqueue(Request* request);
+  static void WorkerEntry(uword param);
+  static Request* TakeBatch();
+  static void PostCompletions(Request* completed);
+
+  static const intptr_t kMaxWorkers = 4;
+  static const intptr_t kMaxBatchSize = 64;
+
+  static Monitor* monitor_;
+  static Request* queue_head_;
+  static Request* queue_tail_;
+  static intptr_t queue_length_;
+  static intptr_t workers_;
+  static intptr_t idle_workers_;
+  static bool shutting_down_;
+  static int64_t completion_messages_;
+
+  DISALLOW_ALLOCATION();
+  DISALLOW_IMPLICIT_CONSTRUCTORS(FileIOPool);
+};
+
+}  // namespace bin
+}  // namespace dart
+
+#endif  // RUNTIME_BIN_FILE_IO_POOL_H_
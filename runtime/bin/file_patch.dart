@@ -83,6 +83,84 @@ class _RandomAccessFileOpsImpl extends NativeFieldWrapperClass1
   length() native "File_Length";
   flush() native "File_Flush";
   lock(int lock, int start, int end) native "File_Lock";
+
+  Future readAsync(int bytes) =>
+      _FileIOPool._submit(this, _FileIOPool.read, null, 0, bytes);
+  Future writeFromAsync(List<int> buffer, int start, int end) =>
+      _FileIOPool._submit(this, _FileIOPool.writeFrom, buffer, start, end);
+
+  void _readAsync(int bytes, int id, SendPort completionPort)
+      native "File_ReadAsync";
+  void _writeFromAsync(List<int> buffer, int start, int end, int id,
+      SendPort completionPort) native "File_WriteFromAsync";
+}
+
+// Runs reads and writes on the native file IO pool. Requests are handed to
+// the pool by a native call, and the pool posts the completions of several
+// requests in one message: a list of request ids, each followed by its
+// response.
+class _FileIOPool {
+  // These must be kept in sync with FileIOPool::Operation.
+  static const int read = 0;
+  static const int writeFrom = 1;
+
+  static RawReceivePort _receivePort;
+  static SendPort _completionPort;
+  static HashMap<int, Completer> _completers = new HashMap<int, Completer>();
+  static int _id = 0;
+
+  static Future _submit(_RandomAccessFileOpsImpl file, int operation,
+      List<int> buffer, int start, int end) {
+    _ensureInitialized();
+    int id;
+    do {
+      id = _getNextId();
+    } while (_completers.containsKey(id));
+    final Completer completer = new Completer();
+    _completers[id] = completer;
+    try {
+      if (operation == read) {
+        file._readAsync(end, id, _completionPort);
+      } else {
+        file._writeFromAsync(buffer, start, end, id, _completionPort);
+      }
+    } catch (error, stackTrace) {
+      _completers.remove(id);
+      _maybeFinalize();
+      return new Future.error(error, stackTrace);
+    }
+    return completer.future;
+  }
+
+  static void _ensureInitialized() {
+    if (_receivePort == null) {
+      _receivePort = new RawReceivePort(_handleCompletions);
+      _completionPort = _receivePort.sendPort;
+    }
+  }
+
+  static void _handleCompletions(List completions) {
+    for (int i = 0; i < completions.length; i += 2) {
+      _completers.remove(completions[i]).complete(completions[i + 1]);
+    }
+    _maybeFinalize();
+  }
+
+  // Closes the port when no request is pending, so that it does not keep
+  // the isolate alive.
+  static void _maybeFinalize() {
+    if (_completers.isEmpty) {
+      _id = 0;
+      _receivePort.close();
+      _receivePort = null;
+      _completionPort = null;
+    }
+  }
+
+  static int _getNextId() {
+    if (_id == 0x7FFFFFFF) _id = 0;
+    return _id++;
+  }
 }
 
 class _WatcherPath {
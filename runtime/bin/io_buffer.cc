@@ -4,9 +4,64 @@
 
 #include "bin/io_buffer.h"
 
+#include "bin/builtin.h"
+#include "bin/dartutils.h"
+#include "bin/lockers.h"
+#include "bin/thread.h"
+#include "platform/utils.h"
+
 namespace dart {
 namespace bin {
 
+// The storage of IO buffers of up to 2^kMaxPooledSizeLog2 bytes is rounded
+// up to a power of two and recycled through a free list per size class, so
+// that a steady stream of reads does not call malloc and free for every
+// buffer. Each buffer is preceded by a header recording its size class.
+static const intptr_t kMinPooledSizeLog2 = 8;
+static const intptr_t kMaxPooledSizeLog2 = 16;
+static const intptr_t kNumSizeClasses =
+    kMaxPooledSizeLog2 - kMinPooledSizeLog2 + 1;
+static const intptr_t kUnpooled = -1;
+
+// Bound on the number of bytes kept in the free list of each size class.
+static const intptr_t kMaxPooledBytesPerClass = 512 * KB;
+
+struct BufferHeader {
+  BufferHeader* next;
+  intptr_t size_class;
+};
+
+static Mutex* pool_mutex = new Mutex();
+static BufferHeader* free_lists[kNumSizeClasses] = {NULL};
+static intptr_t free_counts[kNumSizeClasses] = {0};
+static int64_t pool_hits = 0;
+static int64_t pool_misses = 0;
+static intptr_t pool_resident_bytes = 0;
+
+static intptr_t SizeClass(intptr_t size) {
+  if (size > (static_cast<intptr_t>(1) << kMaxPooledSizeLog2)) {
+    return kUnpooled;
+  }
+  if (size <= (static_cast<intptr_t>(1) << kMinPooledSizeLog2)) {
+    return 0;
+  }
+  return Utils::ShiftForPowerOfTwo(Utils::RoundUpToPowerOfTwo(size)) -
+         kMinPooledSizeLog2;
+}
+
+static intptr_t SizeClassBytes(intptr_t size_class) {
+  return static_cast<intptr_t>(1) << (size_class + kMinPooledSizeLog2);
+}
+
+static uint8_t* DataOf(BufferHeader* header) {
+  return reinterpret_cast<uint8_t*>(header) + sizeof(BufferHeader);
+}
+
+static BufferHeader* HeaderOf(void* buffer) {
+  return reinterpret_cast<BufferHeader*>(reinterpret_cast<uint8_t*>(buffer) -
+                                         sizeof(BufferHeader));
+}
+
 Dart_Handle IOBuffer::Allocate(intptr_t size, uint8_t** buffer) {
   uint8_t* data = Allocate(size);
   if (data == NULL) {
@@ -26,7 +81,81 @@ Dart_Handle IOBuffer::Allocate(intptr_t size, uint8_t** buffer) {
 }
 
 uint8_t* IOBuffer::Allocate(intptr_t size) {
-  return reinterpret_cast<uint8_t*>(malloc(size));
+  const intptr_t size_class = SizeClass(size);
+  if (size_class != kUnpooled) {
+    MutexLocker ml(pool_mutex);
+    BufferHeader* header = free_lists[size_class];
+    if (header != NULL) {
+      free_lists[size_class] = header->next;
+      free_counts[size_class]--;
+      pool_resident_bytes -= SizeClassBytes(size_class);
+      pool_hits++;
+      return DataOf(header);
+    }
+    pool_misses++;
+  }
+  const intptr_t allocation_size =
+      (size_class == kUnpooled) ? size : SizeClassBytes(size_class);
+  BufferHeader* header = reinterpret_cast<BufferHeader*>(
+      malloc(sizeof(BufferHeader) + allocation_size));
+  if (header == NULL) {
+    return NULL;
+  }
+  header->next = NULL;
+  header->size_class = size_class;
+  return DataOf(header);
+}
+
+void IOBuffer::Free(void* buffer) {
+  if (buffer == NULL) {
+    return;
+  }
+  BufferHeader* header = HeaderOf(buffer);
+  const intptr_t size_class = header->size_class;
+  if (size_class != kUnpooled) {
+    const intptr_t bytes = SizeClassBytes(size_class);
+    MutexLocker ml(pool_mutex);
+    if ((free_counts[size_class] + 1) * bytes <= kMaxPooledBytesPerClass) {
+      header->next = free_lists[size_class];
+      free_lists[size_class] = header;
+      free_counts[size_class]++;
+      pool_resident_bytes += bytes;
+      return;
+    }
+  }
+  free(header);
+}
+
+int64_t IOBuffer::PoolHits() {
+  MutexLocker ml(pool_mutex);
+  return pool_hits;
+}
+
+int64_t IOBuffer::PoolMisses() {
+  MutexLocker ml(pool_mutex);
+  return pool_misses;
+}
+
+intptr_t IOBuffer::PoolResidentBytes() {
+  MutexLocker ml(pool_mutex);
+  return pool_resident_bytes;
+}
+
+void FUNCTION_NAME(IOBuffer_PoolStatistics)(Dart_NativeArguments args) {
+  int64_t hits;
+  int64_t misses;
+  intptr_t resident_bytes;
+  {
+    MutexLocker ml(pool_mutex);
+    hits = pool_hits;
+    misses = pool_misses;
+    resident_bytes = pool_resident_bytes;
+  }
+  Dart_Handle result = ThrowIfError(Dart_NewList(3));
+  ThrowIfError(Dart_ListSetAt(result, 0, Dart_NewInteger(hits)));
+  ThrowIfError(Dart_ListSetAt(result, 1, Dart_NewInteger(misses)));
+  ThrowIfError(Dart_ListSetAt(result, 2, Dart_NewInteger(resident_bytes)));
+  Dart_SetReturnValue(args, result);
 }
 
 }  // namespace bin
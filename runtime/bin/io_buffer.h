@@ -22,7 +22,7 @@ class IOBuffer {
 
   // Function for disposing of IO buffer storage. All backing storage
   // for IO buffers must be freed using this function.
-  static void Free(void* buffer) { free(buffer); }
+  static void Free(void* buffer);
 
   // Function for finalizing external byte arrays used as IO buffers.
   static void Finalizer(void* isolate_callback_data,
@@ -31,6 +31,13 @@ class IOBuffer {
     Free(buffer);
   }
 
+  // Statistics of the pool recycling the storage of small IO buffers.
+  // Allocations served from the pool are hits, the others misses. The
+  // resident size is the number of bytes held by the pool for reuse.
+  static int64_t PoolHits();
+  static int64_t PoolMisses();
+  static intptr_t PoolResidentBytes();
+
  private:
   DISALLOW_ALLOCATION();
   DISALLOW_IMPLICIT_CONSTRUCTORS(IOBuffer);
@@ -0,0 +1,43 @@
+// Copyright (c) 2019, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "bin/io_buffer.h"
+#include "platform/assert.h"
+#include "vm/unit_test.h"
+
+namespace dart {
+namespace bin {
+
+VM_UNIT_TEST_CASE(IOBufferPoolReuse) {
+  // Buffers of the same size class share their storage.
+  uint8_t* buffer = IOBuffer::Allocate(1000);
+  EXPECT(buffer != NULL);
+  buffer[999] = 42;
+  const int64_t hits = IOBuffer::PoolHits();
+  const intptr_t resident = IOBuffer::PoolResidentBytes();
+  IOBuffer::Free(buffer);
+  EXPECT_EQ(resident + 1024, IOBuffer::PoolResidentBytes());
+  uint8_t* reused = IOBuffer::Allocate(1024);
+  EXPECT(reused == buffer);
+  EXPECT_EQ(hits + 1, IOBuffer::PoolHits());
+  EXPECT_EQ(resident, IOBuffer::PoolResidentBytes());
+  IOBuffer::Free(reused);
+}
+
+VM_UNIT_TEST_CASE(IOBufferPoolLargeBuffers) {
+  // Large buffers are not kept by the pool.
+  const int64_t hits = IOBuffer::PoolHits();
+  const int64_t misses = IOBuffer::PoolMisses();
+  const intptr_t resident = IOBuffer::PoolResidentBytes();
+  uint8_t* buffer = IOBuffer::Allocate(1 * MB);
+  EXPECT(buffer != NULL);
+  buffer[MB - 1] = 42;
+  IOBuffer::Free(buffer);
+  EXPECT_EQ(hits, IOBuffer::PoolHits());
+  EXPECT_EQ(misses, IOBuffer::PoolMisses());
+  EXPECT_EQ(resident, IOBuffer::PoolResidentBytes());
+}
+
+}  // namespace bin
+}  // namespace dart
@@ -56,6 +56,7 @@ namespace bin {
   V(File_OpenStdio, 1)                                                         \
   V(File_Position, 1)                                                          \
   V(File_Read, 2)                                                              \
+  V(File_ReadAsync, 4)                                                         \
   V(File_ReadByte, 1)                                                          \
   V(File_ReadInto, 4)                                                          \
   V(File_Rename, 3)                                                            \
@@ -69,6 +70,7 @@ namespace bin {
   V(File_Truncate, 2)                                                          \
   V(File_WriteByte, 2)                                                         \
   V(File_WriteFrom, 4)                                                         \
+  V(File_WriteFromAsync, 6)                                                    \
   V(FileSystemWatcher_CloseWatcher, 1)                                         \
   V(FileSystemWatcher_GetSocketId, 2)                                          \
   V(FileSystemWatcher_InitWatcher, 0)                                          \
@@ -81,6 +83,7 @@ namespace bin {
   V(Filter_Process, 4)                                                         \
   V(Filter_Processed, 3)                                                       \
   V(InternetAddress_Parse, 1)                                                  \
+  V(IOBuffer_PoolStatistics, 0)                                                \
   V(IOService_NewServicePort, 0)                                               \
   V(Namespace_Create, 2)                                                       \
   V(Namespace_GetDefault, 0)                                                   \
@@ -144,9 +147,13 @@ namespace bin {
   V(Socket_LeaveMulticast, 4)                                                  \
   V(Socket_Read, 2)                                                            \
   V(Socket_RecvFrom, 1)                                                        \
+  V(Socket_RecvFromBatch, 2)                                                   \
+  V(Socket_SendFile, 4)                                                        \
   V(Socket_SendTo, 6)                                                          \
+  V(Socket_SendToBatch, 6)                                                     \
   V(Socket_SetOption, 4)                                                       \
   V(Socket_SetSocketId, 3)                                                     \
+  V(Socket_WriteBuffers, 4)                                                    \
   V(Socket_WriteList, 4)                                                       \
   V(Stdin_ReadByte, 1)                                                         \
   V(Stdin_GetEchoMode, 1)                                                      \
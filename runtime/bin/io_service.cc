@@ -30,7 +30,7 @@ namespace bin {
 
 void IOServiceCallback(Dart_Port dest_port_id, Dart_CObject* message) {
   Dart_Port reply_port_id = ILLEGAL_PORT;
-  CObject* response = CObject::IllegalArgumentError();
+  CObject* response = NULL;
   CObjectArray request(message);
   if ((message->type == Dart_CObject_kArray) && (request.Length() == 4) &&
       request[0]->IsInt32() && request[1]->IsSendPort() &&
@@ -46,6 +46,9 @@ void IOServiceCallback(Dart_Port dest_port_id, Dart_CObject* message) {
         UNREACHABLE();
     }
   }
+  if (response == NULL) {
+    response = CObject::IllegalArgumentError();
+  }
 
   CObjectArray result(CObject::NewArray(2));
   result.SetAt(0, request[0]);
@@ -11,6 +11,8 @@ class _IOServicePorts {
   List<SendPort> _ports = <SendPort>[];
   List<SendPort> _freePorts = <SendPort>[];
   Map<int, SendPort> _usedPorts = new HashMap<int, SendPort>();
+  // The number of pending requests on each port in use.
+  Map<SendPort, int> _portUses = new HashMap<SendPort, int>();
 
   _IOServicePorts();
 
@@ -24,19 +26,27 @@ class _IOServicePorts {
       final SendPort port = _freePorts.removeLast();
       assert(!_usedPorts.containsKey(forRequestId));
       _usedPorts[forRequestId] = port;
+      _portUses[port] = 1;
       return port;
     }
     // We have already allocated the max number of ports. Re-use an
     // existing one.
     final SendPort port = _ports[forRequestId % maxPorts];
     _usedPorts[forRequestId] = port;
+    _portUses[port] = (_portUses[port] ?? 0) + 1;
     return port;
   }
 
   void _returnPort(int forRequestId) {
     final SendPort port = _usedPorts.remove(forRequestId);
-    if (!_usedPorts.values.contains(port)) {
+    // Counting the uses avoids a linear scan of the pending requests each
+    // time one completes.
+    final int uses = _portUses[port] - 1;
+    if (uses == 0) {
+      _portUses.remove(port);
       _freePorts.add(port);
+    } else {
+      _portUses[port] = uses;
     }
   }
 
@@ -0,0 +1,305 @@
+// Copyright (c) 2019, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "platform/globals.h"
+#if defined(HOST_OS_LINUX)
+
+#include "bin/io_uring_linux.h"
+
+#include <errno.h>        // NOLINT
+#include <string.h>       // NOLINT
+#include <sys/mman.h>     // NOLINT
+#include <sys/syscall.h>  // NOLINT
+#include <unistd.h>       // NOLINT
+
+#include "platform/assert.h"
+#include "platform/atomic.h"
+#include "platform/signal_blocker.h"
+#include "platform/utils.h"
+
+namespace dart {
+namespace bin {
+
+// The system call numbers are the same on all architectures the runtime
+// supports.
+static const long kIOUringSetup = 425;     // NOLINT
+static const long kIOUringEnter = 426;     // NOLINT
+static const long kIOUringRegister = 427;  // NOLINT
+
+static const uint32_t kIOUringEnterGetEvents = 1 << 0;
+static const uint32_t kIOUringFeatSingleMmap = 1 << 0;
+static const uint32_t kIOUringRegisterProbe = 8;
+static const uint16_t kIOUringOpSupported = 1 << 0;
+static const off_t kIOUringOffSqRing = 0;
+static const off_t kIOUringOffCqRing = 0x8000000;
+static const off_t kIOUringOffSqes = 0x10000000;
+
+enum IOUringOp {
+  kIOUringOpPollAdd = 6,
+  kIOUringOpEpollCtl = 29,
+};
+
+// struct io_uring_sqe.
+struct IOUringSubmission {
+  uint8_t opcode;
+  uint8_t flags;
+  uint16_t ioprio;
+  int32_t fd;
+  uint64_t off;
+  uint64_t addr;
+  uint32_t len;
+  uint32_t op_flags;
+  uint64_t user_data;
+  uint64_t pad[3];
+};
+COMPILE_ASSERT(sizeof(IOUringSubmission) == 64);
+
+// struct io_uring_cqe.
+struct IOUringCompletion {
+  uint64_t user_data;
+  int32_t res;
+  uint32_t flags;
+};
+COMPILE_ASSERT(sizeof(IOUringCompletion) == 16);
+
+// struct io_sqring_offsets.
+struct IOUringSqRingOffsets {
+  uint32_t head;
+  uint32_t tail;
+  uint32_t ring_mask;
+  uint32_t ring_entries;
+  uint32_t flags;
+  uint32_t dropped;
+  uint32_t array;
+  uint32_t resv1;
+  uint64_t resv2;
+};
+
+// struct io_cqring_offsets.
+struct IOUringCqRingOffsets {
+  uint32_t head;
+  uint32_t tail;
+  uint32_t ring_mask;
+  uint32_t ring_entries;
+  uint32_t overflow;
+  uint32_t cqes;
+  uint32_t flags;
+  uint32_t resv1;
+  uint64_t resv2;
+};
+
+// struct io_uring_params.
+struct IOUringParams {
+  uint32_t sq_entries;
+  uint32_t cq_entries;
+  uint32_t flags;
+  uint32_t sq_thread_cpu;
+  uint32_t sq_thread_idle;
+  uint32_t features;
+  uint32_t wq_fd;
+  uint32_t resv[3];
+  IOUringSqRingOffsets sq_off;
+  IOUringCqRingOffsets cq_off;
+};
+COMPILE_ASSERT(sizeof(IOUringParams) == 120);
+
+// struct io_uring_probe, with room for the operations used here.
+static const intptr_t kIOUringProbeOps = kIOUringOpEpollCtl + 1;
+
+struct IOUringProbe {
+  uint8_t last_op;
+  uint8_t ops_len;
+  uint16_t resv;
+  uint32_t resv2[3];
+  struct {
+    uint8_t op;
+    uint8_t resv;
+    uint16_t flags;
+    uint32_t resv2;
+  } ops[kIOUringProbeOps];
+};
+
+static bool IsSupported(const IOUringProbe& probe, IOUringOp op) {
+  return (op < probe.ops_len) &&
+         ((probe.ops[op].flags & kIOUringOpSupported) != 0);
+}
+
+static uint32_t* RingAt(void* ring, uint32_t offset) {
+  return reinterpret_cast<uint32_t*>(reinterpret_cast<uint8_t*>(ring) +
+                                     offset);
+}
+
+IOUring* IOUring::Create(intptr_t entries) {
+  IOUringParams params;
+  memset(&params, 0, sizeof(params));
+  int fd = NO_RETRY_EXPECTED(syscall(kIOUringSetup, entries, &params));
+  if (fd == -1) {
+    // Older kernels do not have io_uring, or it is disabled.
+    return NULL;
+  }
+  // Probing for the supported operations needs Linux 5.6, which is also the
+  // first version to support epoll_ctl calls.
+  IOUringProbe probe;
+  memset(&probe, 0, sizeof(probe));
+  intptr_t result =
+      NO_RETRY_EXPECTED(syscall(kIOUringRegister, fd, kIOUringRegisterProbe,
+                                &probe, kIOUringProbeOps));
+  if ((result == -1) || !IsSupported(probe, kIOUringOpPollAdd) ||
+      !IsSupported(probe, kIOUringOpEpollCtl)) {
+    VOID_TEMP_FAILURE_RETRY(close(fd));
+    return NULL;
+  }
+
+  IOUring* uring = new IOUring();
+  uring->fd_ = fd;
+  uring->sq_ring_size_ =
+      params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+  uring->cq_ring_size_ =
+      params.cq_off.cqes + params.cq_entries * sizeof(IOUringCompletion);
+  if ((params.features & kIOUringFeatSingleMmap) != 0) {
+    // Both rings are in a single mapping.
+    uring->sq_ring_size_ =
+        Utils::Maximum(uring->sq_ring_size_, uring->cq_ring_size_);
+    uring->cq_ring_size_ = 0;
+  }
+  uring->sqes_size_ = params.sq_entries * sizeof(IOUringSubmission);
+  uring->sq_ring_ = mmap(NULL, uring->sq_ring_size_, PROT_READ | PROT_WRITE,
+                         MAP_SHARED | MAP_POPULATE, fd, kIOUringOffSqRing);
+  uring->cq_ring_ = uring->sq_ring_;
+  if ((uring->sq_ring_ != MAP_FAILED) && (uring->cq_ring_size_ != 0)) {
+    uring->cq_ring_ = mmap(NULL, uring->cq_ring_size_, PROT_READ | PROT_WRITE,
+                           MAP_SHARED | MAP_POPULATE, fd, kIOUringOffCqRing);
+  }
+  uring->sqes_ = reinterpret_cast<IOUringSubmission*>(
+      mmap(NULL, uring->sqes_size_, PROT_READ | PROT_WRITE,
+           MAP_SHARED | MAP_POPULATE, fd, kIOUringOffSqes));
+  uring->epoll_events_ = new struct epoll_event[params.sq_entries];
+  uring->unsubmitted_ = 0;
+  if ((uring->sq_ring_ == MAP_FAILED) || (uring->cq_ring_ == MAP_FAILED) ||
+      (uring->sqes_ == MAP_FAILED)) {
+    delete uring;
+    return NULL;
+  }
+
+  uring->sq_head_ = RingAt(uring->sq_ring_, params.sq_off.head);
+  uring->sq_tail_ = RingAt(uring->sq_ring_, params.sq_off.tail);
+  uring->sq_mask_ = *RingAt(uring->sq_ring_, params.sq_off.ring_mask);
+  uring->sq_entries_ = *RingAt(uring->sq_ring_, params.sq_off.ring_entries);
+  uring->cq_head_ = RingAt(uring->cq_ring_, params.cq_off.head);
+  uring->cq_tail_ = RingAt(uring->cq_ring_, params.cq_off.tail);
+  uring->cq_mask_ = *RingAt(uring->cq_ring_, params.cq_off.ring_mask);
+  uring->cqes_ = reinterpret_cast<IOUringCompletion*>(
+      RingAt(uring->cq_ring_, params.cq_off.cqes));
+  // Each slot of the submission queue always holds the entry of the same
+  // index.
+  uint32_t* sq_array = RingAt(uring->sq_ring_, params.sq_off.array);
+  for (uint32_t i = 0; i < uring->sq_entries_; i++) {
+    sq_array[i] = i;
+  }
+  return uring;
+}
+
+IOUring::~IOUring() {
+  if ((sqes_ != NULL) && (sqes_ != MAP_FAILED)) {
+    munmap(sqes_, sqes_size_);
+  }
+  if ((cq_ring_ != sq_ring_) && (cq_ring_ != MAP_FAILED)) {
+    munmap(cq_ring_, cq_ring_size_);
+  }
+  if (sq_ring_ != MAP_FAILED) {
+    munmap(sq_ring_, sq_ring_size_);
+  }
+  delete[] epoll_events_;
+  VOID_TEMP_FAILURE_RETRY(close(fd_));
+}
+
+IOUringSubmission* IOUring::NextSubmission(struct epoll_event** event) {
+  // Only io_uring_enter moves the head, so it is current here.
+  const uint32_t tail = *sq_tail_;
+  if (tail - AtomicOperations::LoadAcquire(sq_head_) == sq_entries_) {
+    return NULL;
+  }
+  IOUringSubmission* sqe = &sqes_[tail & sq_mask_];
+  memset(sqe, 0, sizeof(*sqe));
+  if (event != NULL) {
+    *event = &epoll_events_[tail & sq_mask_];
+  }
+  return sqe;
+}
+
+bool IOUring::PrepareEpollCtl(intptr_t epoll_fd,
+                              int op,
+                              intptr_t fd,
+                              const struct epoll_event* event,
+                              uint64_t user_data) {
+  struct epoll_event* sqe_event;
+  IOUringSubmission* sqe = NextSubmission(&sqe_event);
+  if (sqe == NULL) {
+    return false;
+  }
+  // The kernel copies the event when it takes the entry, so it lives in a
+  // slot of its own until the entry is submitted.
+  if (event != NULL) {
+    *sqe_event = *event;
+  }
+  sqe->opcode = kIOUringOpEpollCtl;
+  sqe->fd = epoll_fd;
+  sqe->off = fd;
+  sqe->addr = reinterpret_cast<uint64_t>(sqe_event);
+  sqe->len = op;
+  sqe->user_data = user_data;
+  AtomicOperations::StoreRelease(sq_tail_, *sq_tail_ + 1);
+  unsubmitted_++;
+  return true;
+}
+
+bool IOUring::PreparePoll(intptr_t fd, uint32_t events, uint64_t user_data) {
+  IOUringSubmission* sqe = NextSubmission(NULL);
+  if (sqe == NULL) {
+    return false;
+  }
+  sqe->opcode = kIOUringOpPollAdd;
+  sqe->fd = fd;
+  // The poll events are the low half of op_flags on little-endian hosts;
+  // there is no io_uring on big-endian hosts the runtime supports.
+  sqe->op_flags = events;
+  sqe->user_data = user_data;
+  AtomicOperations::StoreRelease(sq_tail_, *sq_tail_ + 1);
+  unsubmitted_++;
+  return true;
+}
+
+bool IOUring::Enter(intptr_t wait_count) {
+  const uint32_t flags = (wait_count > 0) ? kIOUringEnterGetEvents : 0;
+  // The kernel takes no entries when it fails with EINTR.
+  intptr_t result = TEMP_FAILURE_RETRY_NO_SIGNAL_BLOCKER(syscall(
+      kIOUringEnter, fd_, unsubmitted_, wait_count, flags, NULL, 0));
+  if (result == -1) {
+    return false;
+  }
+  // The kernel took [result] entries. If it was interrupted while waiting
+  // after taking some, the caller finds fewer completions than it waited for
+  // and enters again.
+  ASSERT(static_cast<uint32_t>(result) <= unsubmitted_);
+  unsubmitted_ -= result;
+  return true;
+}
+
+bool IOUring::NextCompletion(uint64_t* user_data, int32_t* result) {
+  // Only this thread moves the head.
+  const uint32_t head = *cq_head_;
+  if (head == AtomicOperations::LoadAcquire(cq_tail_)) {
+    return false;
+  }
+  const IOUringCompletion& cqe = cqes_[head & cq_mask_];
+  *user_data = cqe.user_data;
+  *result = cqe.res;
+  AtomicOperations::StoreRelease(cq_head_, head + 1);
+  return true;
+}
+
+}  // namespace bin
+}  // namespace dart
+
+#endif  // defined(HOST_OS_LINUX)
@@ -0,0 +1,88 @@
+// Copyright (c) 2019, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#ifndef RUNTIME_BIN_IO_URING_LINUX_H_
+#define RUNTIME_BIN_IO_URING_LINUX_H_
+
+#include "platform/globals.h"
+#if defined(HOST_OS_LINUX)
+
+#include <sys/epoll.h>  // NOLINT
+
+namespace dart {
+namespace bin {
+
+struct IOUringSubmission;
+struct IOUringCompletion;
+
+// A minimal io_uring instance that submits epoll_ctl calls and polls of
+// file descriptors in batches, one io_uring_enter call per batch.
+//
+// The kernel interface is declared in io_uring_linux.cc, because the sysroots
+// the runtime is built with may not have <linux/io_uring.h>.
+class IOUring {
+ public:
+  // Returns NULL if the kernel does not support io_uring, or does not support
+  // the operations used here (Linux 5.6 and later do).
+  static IOUring* Create(intptr_t entries);
+
+  ~IOUring();
+
+  // Prepares a call of epoll_ctl(epoll_fd, op, fd, event). The event is copied
+  // when the call is submitted. Returns false if the submission queue is full.
+  bool PrepareEpollCtl(intptr_t epoll_fd,
+                       int op,
+                       intptr_t fd,
+                       const struct epoll_event* event,
+                       uint64_t user_data);
+
+  // Prepares a one-shot poll of the file descriptor for the events. Returns
+  // false if the submission queue is full.
+  bool PreparePoll(intptr_t fd, uint32_t events, uint64_t user_data);
+
+  // Submits the prepared operations, and waits until the completion queue
+  // has at least [wait_count] entries. Returns false and sets errno if this
+  // fails.
+  bool Enter(intptr_t wait_count);
+
+  // Takes the next entry of the completion queue. Returns false if it is
+  // empty.
+  bool NextCompletion(uint64_t* user_data, int32_t* result);
+
+ private:
+  IOUring() {}
+
+  IOUringSubmission* NextSubmission(struct epoll_event** event);
+
+  int fd_;
+  void* sq_ring_;
+  intptr_t sq_ring_size_;
+  void* cq_ring_;
+  intptr_t cq_ring_size_;
+  IOUringSubmission* sqes_;
+  intptr_t sqes_size_;
+
+  uint32_t* sq_head_;
+  uint32_t* sq_tail_;
+  uint32_t sq_mask_;
+  uint32_t sq_entries_;
+  uint32_t* cq_head_;
+  uint32_t* cq_tail_;
+  uint32_t cq_mask_;
+  IOUringCompletion* cqes_;
+
+  // The events of the prepared epoll_ctl calls, by submission queue slot.
+  struct epoll_event* epoll_events_;
+  // The number of prepared operations the kernel has not yet taken.
+  uint32_t unsubmitted_;
+
+  DISALLOW_COPY_AND_ASSIGN(IOUring);
+};
+
+}  // namespace bin
+}  // namespace dart
+
+#endif  // defined(HOST_OS_LINUX)
+
+#endif  // RUNTIME_BIN_IO_URING_LINUX_H_
@@ -21,6 +21,7 @@
 #include "bin/eventhandler.h"
 #include "bin/extensions.h"
 #include "bin/file.h"
+#include "bin/file_io_pool.h"
 #include "bin/gzip.h"
 #include "bin/isolate_data.h"
 #include "bin/loader.h"
@@ -870,6 +871,14 @@ bool RunMainIsolate(const char* script_name, CommandLineOptions* dart_options) {
       CHECK_RESULT(result);
     }
 
+    if (Options::load_type_feedback_filename() != NULL) {
+      uint8_t* buffer = NULL;
+      intptr_t size = 0;
+      ReadFile(Options::load_type_feedback_filename(), &buffer, &size);
+      result = Dart_LoadTypeFeedback(buffer, size);
+      CHECK_RESULT(result);
+    }
+
     // Create a closure for the main entry point which is in the exported
     // namespace of the root library or invoke a getter of the same name
     // in the exported namespace and return the resulting closure.
@@ -912,6 +921,14 @@ bool RunMainIsolate(const char* script_name, CommandLineOptions* dart_options) {
       CHECK_RESULT(result);
       WriteFile(Options::save_compilation_trace_filename(), buffer, size);
     }
+
+    if (Options::save_type_feedback_filename() != NULL) {
+      uint8_t* buffer = NULL;
+      intptr_t size = 0;
+      result = Dart_SaveTypeFeedback(&buffer, &size);
+      CHECK_RESULT(result);
+      WriteFile(Options::save_type_feedback_filename(), buffer, size);
+    }
   }
 
   WriteDepsFile(isolate);
@@ -1146,6 +1163,7 @@ void main(int argc, char** argv) {
     free(error);
   }
   Process::ClearAllSignalHandlers();
+  FileIOPool::Shutdown();
   EventHandler::Stop();
 
 #if !defined(DART_LINK_APP_SNAPSHOT)
@@ -6,6 +6,7 @@
 
 #include "bin/dartutils.h"
 #include "bin/eventhandler.h"
+#include "bin/file.h"
 #include "bin/io_buffer.h"
 #include "bin/isolate_data.h"
 #include "bin/lockers.h"
@@ -373,10 +374,26 @@ void FUNCTION_NAME(Socket_Read)(Dart_NativeArguments args) {
   }
 }
 
+// TODO(sgjesse): Use a MTU value here. Only the loopback adapter can
+// handle 64k datagrams.
+static const int kReceiveBufferLen = 65536;
+
+// The maximum number of datagrams received by one Socket_RecvFromBatch.
+static const int kMaxReceiveBatch = 16;
+
+// Returns the port of the address, and clears it in the address.
+static int TakeAddrPort(RawAddr* addr) {
+  int port = SocketAddress::GetAddrPort(*addr);
+  if (addr->addr.sa_family == AF_INET) {
+    addr->in.sin_port = 0;
+  } else {
+    ASSERT(addr->addr.sa_family == AF_INET6);
+    addr->in6.sin6_port = 0;
+  }
+  return port;
+}
+
 void FUNCTION_NAME(Socket_RecvFrom)(Dart_NativeArguments args) {
-  // TODO(sgjesse): Use a MTU value here. Only the loopback adapter can
-  // handle 64k datagrams.
-  const int kReceiveBufferLen = 65536;
   Socket* socket =
       Socket::GetSocketIdNativeField(Dart_GetNativeArgument(args, 0));
 
@@ -385,6 +402,9 @@ void FUNCTION_NAME(Socket_RecvFrom)(Dart_NativeArguments args) {
   uint8_t* recv_buffer = socket->udp_receive_buffer();
   if (recv_buffer == NULL) {
     recv_buffer = reinterpret_cast<uint8_t*>(malloc(kReceiveBufferLen));
+    if (recv_buffer == NULL) {
+      Dart_ThrowException(DartUtils::NewDartOSError());
+    }
     socket->set_udp_receive_buffer(recv_buffer);
   }
 
@@ -417,13 +437,7 @@ void FUNCTION_NAME(Socket_RecvFrom)(Dart_NativeArguments args) {
   memmove(data_buffer, recv_buffer, bytes_read);
 
   // Get the port and clear it in the sockaddr structure.
-  int port = SocketAddress::GetAddrPort(addr);
-  if (addr.addr.sa_family == AF_INET) {
-    addr.in.sin_port = 0;
-  } else {
-    ASSERT(addr.addr.sa_family == AF_INET6);
-    addr.in6.sin6_port = 0;
-  }
+  int port = TakeAddrPort(&addr);
   // Format the address to a string using the numeric format.
   char numeric_address[INET6_ADDRSTRLEN];
   SocketBase::FormatNumericAddress(addr, numeric_address, INET6_ADDRSTRLEN);
@@ -451,6 +465,86 @@ void FUNCTION_NAME(Socket_RecvFrom)(Dart_NativeArguments args) {
   Dart_SetReturnValue(args, result);
 }
 
+void FUNCTION_NAME(Socket_RecvFromBatch)(Dart_NativeArguments args) {
+  Socket* socket =
+      Socket::GetSocketIdNativeField(Dart_GetNativeArgument(args, 0));
+  // Receive at most kMaxReceiveBatch datagrams. The caller learns how many
+  // were received from the length of the result.
+  const intptr_t max_count = Utils::Minimum<int64_t>(
+      DartUtils::GetInt64ValueCheckRange(Dart_GetNativeArgument(args, 1), 1,
+                                         kMaxInt64),
+      kMaxReceiveBatch);
+
+  // Ensure that the batch receive buffer for the UDP socket has a slot for
+  // each datagram. It only grows when a larger batch is asked for.
+  ASSERT(socket != NULL);
+  uint8_t* recv_buffer = socket->udp_receive_batch_buffer();
+  if (socket->udp_receive_batch_slots() < max_count) {
+    recv_buffer = reinterpret_cast<uint8_t*>(
+        realloc(recv_buffer, max_count * kReceiveBufferLen));
+    if (recv_buffer == NULL) {
+      Dart_ThrowException(DartUtils::NewDartOSError());
+    }
+    socket->set_udp_receive_batch_buffer(recv_buffer, max_count);
+  }
+
+  // Read the datagrams into consecutive slots of the buffer.
+  RawAddr addrs[kMaxReceiveBatch];
+  intptr_t lengths[kMaxReceiveBatch];
+  const intptr_t count =
+      SocketBase::RecvFromBatch(socket->fd(), recv_buffer, kReceiveBufferLen,
+                                max_count, lengths, addrs, SocketBase::kAsync);
+  if (count == 0) {
+    Dart_SetReturnValue(args, Dart_Null());
+    return;
+  }
+  if (count < 0) {
+    ASSERT(count == -1);
+    Dart_SetReturnValue(args, DartUtils::NewDartOSError());
+    return;
+  }
+
+  // Pack the datagrams into a buffer of the exact size.
+  intptr_t total_length = 0;
+  for (intptr_t i = 0; i < count; i++) {
+    total_length += lengths[i];
+  }
+  uint8_t* data_buffer = NULL;
+  Dart_Handle data = IOBuffer::Allocate(total_length, &data_buffer);
+  if (Dart_IsNull(data)) {
+    Dart_SetReturnValue(args, DartUtils::NewDartOSError());
+    return;
+  }
+  if (Dart_IsError(data)) {
+    Dart_PropagateError(data);
+  }
+
+  // The result holds the packed data, followed by the end offset, sender
+  // address, raw sender address and sender port of each datagram.
+  const intptr_t kEntrySize = 4;
+  Dart_Handle result = ThrowIfError(Dart_NewList(1 + count * kEntrySize));
+  ThrowIfError(Dart_ListSetAt(result, 0, data));
+  intptr_t offset = 0;
+  for (intptr_t i = 0; i < count; i++) {
+    memmove(data_buffer + offset, recv_buffer + i * kReceiveBufferLen,
+            lengths[i]);
+    offset += lengths[i];
+    int port = TakeAddrPort(&addrs[i]);
+    char numeric_address[INET6_ADDRSTRLEN];
+    SocketBase::FormatNumericAddress(addrs[i], numeric_address,
+                                     INET6_ADDRSTRLEN);
+    const intptr_t entry = 1 + i * kEntrySize;
+    ThrowIfError(Dart_ListSetAt(result, entry, Dart_NewInteger(offset)));
+    ThrowIfError(Dart_ListSetAt(
+        result, entry + 1,
+        ThrowIfError(Dart_NewStringFromCString(numeric_address))));
+    ThrowIfError(Dart_ListSetAt(result, entry + 2,
+                                SocketAddress::ToTypedData(addrs[i])));
+    ThrowIfError(Dart_ListSetAt(result, entry + 3, Dart_NewInteger(port)));
+  }
+  Dart_SetReturnValue(args, result);
+}
+
 void FUNCTION_NAME(Socket_WriteList)(Dart_NativeArguments args) {
   Socket* socket =
       Socket::GetSocketIdNativeField(Dart_GetNativeArgument(args, 0));
@@ -494,6 +588,117 @@ void FUNCTION_NAME(Socket_WriteList)(Dart_NativeArguments args) {
   }
 }
 
+// The typed data buffers of a list passed to a native, along with lists of
+// the offset and length of the bytes to use in each of them. The buffers
+// are acquired together, so no other Dart API call may be made between
+// Acquire and Release.
+class TypedDataBufferList {
+ public:
+  TypedDataBufferList(Dart_Handle buffers_obj,
+                      Dart_Handle offsets_obj,
+                      Dart_Handle lengths_obj) {
+    ThrowIfError(Dart_ListLength(buffers_obj, &count_));
+    buffer_objs_ = reinterpret_cast<Dart_Handle*>(
+        Dart_ScopeAllocate(count_ * sizeof(Dart_Handle)));
+    buffers_ = reinterpret_cast<const void**>(
+        Dart_ScopeAllocate(count_ * sizeof(const void*)));
+    offsets_ = reinterpret_cast<intptr_t*>(
+        Dart_ScopeAllocate(count_ * sizeof(intptr_t)));
+    lengths_ = reinterpret_cast<intptr_t*>(
+        Dart_ScopeAllocate(count_ * sizeof(intptr_t)));
+    ThrowIfError(Dart_ListGetRange(buffers_obj, 0, count_, buffer_objs_));
+    for (intptr_t i = 0; i < count_; i++) {
+      offsets_[i] = DartUtils::GetIntptrValue(Dart_ListGetAt(offsets_obj, i));
+      lengths_[i] = DartUtils::GetIntptrValue(Dart_ListGetAt(lengths_obj, i));
+    }
+  }
+
+  void Acquire() {
+    for (intptr_t i = 0; i < count_; i++) {
+      Dart_TypedData_Type type;
+      uint8_t* buffer = NULL;
+      intptr_t len;
+      Dart_Handle result = Dart_TypedDataAcquireData(
+          buffer_objs_[i], &type, reinterpret_cast<void**>(&buffer), &len);
+      if (Dart_IsError(result)) {
+        for (intptr_t j = 0; j < i; j++) {
+          Dart_TypedDataReleaseData(buffer_objs_[j]);
+        }
+        Dart_PropagateError(result);
+      }
+      ASSERT((offsets_[i] + lengths_[i]) <= len);
+      buffers_[i] = buffer + offsets_[i];
+    }
+  }
+
+  void Release() {
+    for (intptr_t i = 0; i < count_; i++) {
+      Dart_TypedDataReleaseData(buffer_objs_[i]);
+    }
+  }
+
+  intptr_t count() const { return count_; }
+  const void* const* buffers() const { return buffers_; }
+  const intptr_t* lengths() const { return lengths_; }
+
+ private:
+  intptr_t count_;
+  Dart_Handle* buffer_objs_;
+  const void** buffers_;
+  intptr_t* offsets_;
+  intptr_t* lengths_;
+
+  DISALLOW_COPY_AND_ASSIGN(TypedDataBufferList);
+};
+
+void FUNCTION_NAME(Socket_WriteBuffers)(Dart_NativeArguments args) {
+  Socket* socket =
+      Socket::GetSocketIdNativeField(Dart_GetNativeArgument(args, 0));
+  TypedDataBufferList buffers(Dart_GetNativeArgument(args, 1),
+                              Dart_GetNativeArgument(args, 2),
+                              Dart_GetNativeArgument(args, 3));
+  buffers.Acquire();
+  intptr_t bytes_written = SocketBase::WriteBuffers(
+      socket->fd(), buffers.buffers(), buffers.lengths(), buffers.count(),
+      SocketBase::kAsync);
+  if (bytes_written >= 0) {
+    buffers.Release();
+    Dart_SetReturnValue(args, Dart_NewInteger(bytes_written));
+  } else {
+    // Extract OSError before we release data, as it may override the error.
+    OSError os_error;
+    buffers.Release();
+    Dart_SetReturnValue(args, DartUtils::NewDartOSError(&os_error));
+  }
+}
+
+void FUNCTION_NAME(Socket_SendFile)(Dart_NativeArguments args) {
+  Socket* socket =
+      Socket::GetSocketIdNativeField(Dart_GetNativeArgument(args, 0));
+  int64_t offset = DartUtils::GetInt64ValueCheckRange(
+      Dart_GetNativeArgument(args, 2), 0, kMaxInt64);
+  intptr_t length = DartUtils::GetIntptrValue(Dart_GetNativeArgument(args, 3));
+  // The file pointer was retained for this call by File_GetPointer.
+  File* file = reinterpret_cast<File*>(
+      DartUtils::GetIntptrValue(Dart_GetNativeArgument(args, 1)));
+  if (file == NULL) {
+    Dart_SetReturnValue(args, DartUtils::NewDartArgumentError("File closed"));
+    return;
+  }
+  RefCntReleaseScope<File> rs(file);
+  if (file->IsClosed()) {
+    Dart_SetReturnValue(args, DartUtils::NewDartArgumentError("File closed"));
+    return;
+  }
+  intptr_t bytes_sent = SocketBase::SendFile(socket->fd(), file, offset,
+                                             length, SocketBase::kAsync);
+  if (bytes_sent >= 0) {
+    Dart_SetReturnValue(args, Dart_NewInteger(bytes_sent));
+  } else {
+    Dart_SetReturnValue(args, DartUtils::NewDartOSError());
+  }
+}
+
 void FUNCTION_NAME(Socket_SendTo)(Dart_NativeArguments args) {
   Socket* socket =
       Socket::GetSocketIdNativeField(Dart_GetNativeArgument(args, 0));
@@ -530,6 +735,34 @@ void FUNCTION_NAME(Socket_SendTo)(Dart_NativeArguments args) {
   }
 }
 
+void FUNCTION_NAME(Socket_SendToBatch)(Dart_NativeArguments args) {
+  Socket* socket =
+      Socket::GetSocketIdNativeField(Dart_GetNativeArgument(args, 0));
+  TypedDataBufferList buffers(Dart_GetNativeArgument(args, 1),
+                              Dart_GetNativeArgument(args, 2),
+                              Dart_GetNativeArgument(args, 3));
+  Dart_Handle address_obj = Dart_GetNativeArgument(args, 4);
+  ASSERT(Dart_IsList(address_obj));
+  RawAddr addr;
+  SocketAddress::GetSockAddr(address_obj, &addr);
+  int64_t port = DartUtils::GetInt64ValueCheckRange(
+      Dart_GetNativeArgument(args, 5), 0, 65535);
+  SocketAddress::SetAddrPort(&addr, port);
+  buffers.Acquire();
+  intptr_t datagrams_sent = SocketBase::SendToBatch(
+      socket->fd(), buffers.buffers(), buffers.lengths(), buffers.count(),
+      addr, SocketBase::kAsync);
+  if (datagrams_sent >= 0) {
+    buffers.Release();
+    Dart_SetReturnValue(args, Dart_NewInteger(datagrams_sent));
+  } else {
+    // Extract OSError before we release data, as it may override the error.
+    OSError os_error;
+    buffers.Release();
+    Dart_SetReturnValue(args, DartUtils::NewDartOSError(&os_error));
+  }
+}
+
 void FUNCTION_NAME(Socket_GetPort)(Dart_NativeArguments args) {
   Socket* socket =
       Socket::GetSocketIdNativeField(Dart_GetNativeArgument(args, 0));
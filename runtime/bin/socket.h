@@ -58,6 +58,18 @@ class Socket : public ReferenceCounted<Socket> {
 
   uint8_t* udp_receive_buffer() const { return udp_receive_buffer_; }
   void set_udp_receive_buffer(uint8_t* buffer) { udp_receive_buffer_ = buffer; }
+  // The batch receive buffer holds a slot for each datagram of the largest
+  // batch received so far.
+  uint8_t* udp_receive_batch_buffer() const {
+    return udp_receive_batch_buffer_;
+  }
+  intptr_t udp_receive_batch_slots() const {
+    return udp_receive_batch_slots_;
+  }
+  void set_udp_receive_batch_buffer(uint8_t* buffer, intptr_t slots) {
+    udp_receive_batch_buffer_ = buffer;
+    udp_receive_batch_slots_ = slots;
+  }
 
   static bool Initialize();
 
@@ -107,6 +119,8 @@ class Socket : public ReferenceCounted<Socket> {
     ASSERT(fd_ == kClosedFd);
     free(udp_receive_buffer_);
     udp_receive_buffer_ = NULL;
+    free(udp_receive_batch_buffer_);
+    udp_receive_batch_buffer_ = NULL;
   }
 
   static const int kClosedFd = -1;
@@ -118,6 +132,8 @@ class Socket : public ReferenceCounted<Socket> {
   Dart_Port isolate_port_;
   Dart_Port port_;
   uint8_t* udp_receive_buffer_;
+  uint8_t* udp_receive_batch_buffer_;
+  intptr_t udp_receive_batch_slots_;
 
   friend class ReferenceCounted<Socket>;
   DISALLOW_COPY_AND_ASSIGN(Socket);
@@ -163,6 +163,90 @@ void FUNCTION_NAME(InternetAddress_Parse)(Dart_NativeArguments args) {
   }
 }
 
+intptr_t SocketBase::WriteBuffersOneByOne(intptr_t fd,
+                                          const void* const* buffers,
+                                          const intptr_t* lengths,
+                                          intptr_t count,
+                                          SocketOpKind sync) {
+  intptr_t total_written = 0;
+  for (intptr_t i = 0; i < count; i++) {
+    intptr_t written_bytes = Write(fd, buffers[i], lengths[i], sync);
+    if (written_bytes < 0) {
+      // Report the bytes written so far. A persistent error is reported by
+      // the next write.
+      return (total_written > 0) ? total_written : written_bytes;
+    }
+    total_written += written_bytes;
+    if (written_bytes < lengths[i]) {
+      break;
+    }
+  }
+  return total_written;
+}
+
+intptr_t SocketBase::SendFileThroughBuffer(intptr_t fd,
+                                           File* file,
+                                           int64_t offset,
+                                           intptr_t num_bytes,
+                                           SocketOpKind sync) {
+  const intptr_t kBufferSize = 64 * KB;
+  if (!file->SetPosition(offset)) {
+    return -1;
+  }
+  uint8_t* buffer = IOBuffer::Allocate(kBufferSize);
+  if (buffer == NULL) {
+    return -1;
+  }
+  const int64_t bytes_read =
+      file->Read(buffer, Utils::Minimum(num_bytes, kBufferSize));
+  // The bytes read but not written are read again by the next call, which
+  // starts at the offset following the last byte written.
+  const intptr_t written_bytes =
+      (bytes_read > 0) ? Write(fd, buffer, bytes_read, sync) : bytes_read;
+  IOBuffer::Free(buffer);
+  return written_bytes;
+}
+
+intptr_t SocketBase::SendToOneByOne(intptr_t fd,
+                                    const void* const* buffers,
+                                    const intptr_t* lengths,
+                                    intptr_t count,
+                                    const RawAddr& addr,
+                                    SocketOpKind sync) {
+  for (intptr_t i = 0; i < count; i++) {
+    intptr_t sent_bytes = SendTo(fd, buffers[i], lengths[i], addr, sync);
+    if (sent_bytes < 0) {
+      // Report the datagrams sent so far. A persistent error is reported by
+      // the next send.
+      return (i > 0) ? i : sent_bytes;
+    }
+    if (sent_bytes < lengths[i]) {
+      return i;
+    }
+  }
+  return count;
+}
+
+intptr_t SocketBase::RecvFromOneByOne(intptr_t fd,
+                                      uint8_t* buffer,
+                                      intptr_t slot_size,
+                                      intptr_t count,
+                                      intptr_t* lengths,
+                                      RawAddr* addrs,
+                                      SocketOpKind sync) {
+  for (intptr_t i = 0; i < count; i++) {
+    intptr_t read_bytes =
+        RecvFrom(fd, buffer + i * slot_size, slot_size, &addrs[i], sync);
+    // RecvFrom does not tell an empty datagram from no datagram, so stop
+    // at either.
+    if (read_bytes <= 0) {
+      return (i > 0) ? i : read_bytes;
+    }
+    lengths[i] = read_bytes;
+  }
+  return count;
+}
+
 void FUNCTION_NAME(NetworkInterface_ListSupported)(Dart_NativeArguments args) {
   Dart_SetReturnValue(args,
                       Dart_NewBoolean(SocketBase::ListInterfacesSupported()));
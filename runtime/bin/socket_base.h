@@ -23,6 +23,7 @@
 
 #include "bin/builtin.h"
 #include "bin/dartutils.h"
+#include "bin/file.h"
 #include "bin/thread.h"
 #include "bin/utils.h"
 #include "platform/allocation.h"
@@ -152,6 +153,22 @@ class SocketBase : public AllStatic {
                         const void* buffer,
                         intptr_t num_bytes,
                         SocketOpKind sync);
+  // Writes the buffers in order with as few system calls as the platform
+  // allows. Returns the total number of bytes written, which stops short at
+  // the first buffer that could not be written completely.
+  static intptr_t WriteBuffers(intptr_t fd,
+                               const void* const* buffers,
+                               const intptr_t* lengths,
+                               intptr_t count,
+                               SocketOpKind sync);
+  // Sends up to num_bytes of the file starting at the given offset, without
+  // going through a user space buffer where the platform allows it. The
+  // position of the file is unspecified afterwards.
+  static intptr_t SendFile(intptr_t fd,
+                           File* file,
+                           int64_t offset,
+                           intptr_t num_bytes,
+                           SocketOpKind sync);
   // Send data on a socket. The port to send to is specified in the port
   // component of the passed RawAddr structure. The RawAddr structure is only
   // used for datagram sockets.
@@ -165,6 +182,26 @@ class SocketBase : public AllStatic {
                            intptr_t num_bytes,
                            RawAddr* addr,
                            SocketOpKind sync);
+  // Sends each buffer as a datagram to the given address, with as few
+  // system calls as the platform allows. Returns the number of datagrams
+  // sent.
+  static intptr_t SendToBatch(intptr_t fd,
+                              const void* const* buffers,
+                              const intptr_t* lengths,
+                              intptr_t count,
+                              const RawAddr& addr,
+                              SocketOpKind sync);
+  // Receives up to count datagrams, the i-th into the slot of slot_size
+  // bytes at buffer + i * slot_size, with as few system calls as the
+  // platform allows. Stores the length and source address of each datagram
+  // in lengths and addrs, and returns the number of datagrams received.
+  static intptr_t RecvFromBatch(intptr_t fd,
+                                uint8_t* buffer,
+                                intptr_t slot_size,
+                                intptr_t count,
+                                intptr_t* lengths,
+                                RawAddr* addrs,
+                                SocketOpKind sync);
   // Returns true if the given error-number is because the system was not able
   // to bind the socket to a specific IP.
   static bool IsBindError(intptr_t error_number);
@@ -212,6 +249,33 @@ class SocketBase : public AllStatic {
       int type,
       OSError** os_error);
 
+  // Implementations of WriteBuffers, SendFile, SendToBatch and
+  // RecvFromBatch for platforms without writev, sendfile, sendmmsg and
+  // recvmmsg.
+  static intptr_t WriteBuffersOneByOne(intptr_t fd,
+                                       const void* const* buffers,
+                                       const intptr_t* lengths,
+                                       intptr_t count,
+                                       SocketOpKind sync);
+  static intptr_t SendFileThroughBuffer(intptr_t fd,
+                                        File* file,
+                                        int64_t offset,
+                                        intptr_t num_bytes,
+                                        SocketOpKind sync);
+  static intptr_t SendToOneByOne(intptr_t fd,
+                                 const void* const* buffers,
+                                 const intptr_t* lengths,
+                                 intptr_t count,
+                                 const RawAddr& addr,
+                                 SocketOpKind sync);
+  static intptr_t RecvFromOneByOne(intptr_t fd,
+                                   uint8_t* buffer,
+                                   intptr_t slot_size,
+                                   intptr_t count,
+                                   intptr_t* lengths,
+                                   RawAddr* addrs,
+                                   SocketOpKind sync);
+
  private:
   DISALLOW_ALLOCATION();
   DISALLOW_IMPLICIT_CONSTRUCTORS(SocketBase);
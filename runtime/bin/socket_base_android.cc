@@ -7,18 +7,21 @@
 
 #include "bin/socket_base.h"
 
-#include <errno.h>        // NOLINT
-#include <netinet/tcp.h>  // NOLINT
-#include <stdio.h>        // NOLINT
-#include <stdlib.h>       // NOLINT
-#include <string.h>       // NOLINT
-#include <sys/stat.h>     // NOLINT
-#include <unistd.h>       // NOLINT
+#include <errno.h>         // NOLINT
+#include <netinet/tcp.h>   // NOLINT
+#include <stdio.h>         // NOLINT
+#include <stdlib.h>        // NOLINT
+#include <string.h>        // NOLINT
+#include <sys/sendfile.h>  // NOLINT
+#include <sys/stat.h>      // NOLINT
+#include <sys/uio.h>       // NOLINT
+#include <unistd.h>        // NOLINT
 
 #include "bin/fdutils.h"
 #include "bin/file.h"
 #include "bin/socket_base_android.h"
 #include "platform/signal_blocker.h"
+#include "platform/utils.h"
 
 namespace dart {
 namespace bin {
@@ -102,6 +105,60 @@ intptr_t SocketBase::Write(intptr_t fd,
   return written_bytes;
 }
 
+intptr_t SocketBase::WriteBuffers(intptr_t fd,
+                                  const void* const* buffers,
+                                  const intptr_t* lengths,
+                                  intptr_t count,
+                                  SocketOpKind sync) {
+  ASSERT(fd >= 0);
+  const intptr_t kMaxBuffersPerCall = 64;
+  struct iovec iov[kMaxBuffersPerCall];
+  intptr_t total_written = 0;
+  for (intptr_t i = 0; i < count; i += kMaxBuffersPerCall) {
+    const intptr_t n = Utils::Minimum(count - i, kMaxBuffersPerCall);
+    intptr_t num_bytes = 0;
+    for (intptr_t j = 0; j < n; j++) {
+      iov[j].iov_base = const_cast<void*>(buffers[i + j]);
+      iov[j].iov_len = lengths[i + j];
+      num_bytes += lengths[i + j];
+    }
+    ssize_t written_bytes = TEMP_FAILURE_RETRY(writev(fd, iov, n));
+    if (written_bytes == -1) {
+      ASSERT(EAGAIN == EWOULDBLOCK);
+      if (((sync == kAsync) && (errno == EWOULDBLOCK)) ||
+          (total_written > 0)) {
+        // Report the bytes written so far. A persistent error is reported
+        // by the next write.
+        return total_written;
+      }
+      return -1;
+    }
+    total_written += written_bytes;
+    if (written_bytes < num_bytes) {
+      break;
+    }
+  }
+  return total_written;
+}
+
+intptr_t SocketBase::SendFile(intptr_t fd,
+                              File* file,
+                              int64_t offset,
+                              intptr_t num_bytes,
+                              SocketOpKind sync) {
+  ASSERT(fd >= 0);
+  off_t file_offset = offset;
+  ssize_t sent_bytes = TEMP_FAILURE_RETRY(
+      sendfile(fd, file->GetFD(), &file_offset, num_bytes));
+  ASSERT(EAGAIN == EWOULDBLOCK);
+  if ((sync == kAsync) && (sent_bytes == -1) && (errno == EWOULDBLOCK)) {
+    // If the would block we need to retry and therefore return 0 as
+    // the number of bytes sent.
+    sent_bytes = 0;
+  }
+  return sent_bytes;
+}
+
 intptr_t SocketBase::SendTo(intptr_t fd,
                             const void* buffer,
                             intptr_t num_bytes,
@@ -120,6 +177,25 @@ intptr_t SocketBase::SendTo(intptr_t fd,
   return written_bytes;
 }
 
+intptr_t SocketBase::SendToBatch(intptr_t fd,
+                                 const void* const* buffers,
+                                 const intptr_t* lengths,
+                                 intptr_t count,
+                                 const RawAddr& addr,
+                                 SocketOpKind sync) {
+  return SendToOneByOne(fd, buffers, lengths, count, addr, sync);
+}
+
+intptr_t SocketBase::RecvFromBatch(intptr_t fd,
+                                   uint8_t* buffer,
+                                   intptr_t slot_size,
+                                   intptr_t count,
+                                   intptr_t* lengths,
+                                   RawAddr* addrs,
+                                   SocketOpKind sync) {
+  return RecvFromOneByOne(fd, buffer, slot_size, count, lengths, addrs, sync);
+}
+
 intptr_t SocketBase::GetPort(intptr_t fd) {
   ASSERT(fd >= 0);
   RawAddr raw;
@@ -147,6 +147,22 @@ intptr_t SocketBase::Write(intptr_t fd,
   return written_bytes;
 }
 
+intptr_t SocketBase::WriteBuffers(intptr_t fd,
+                                  const void* const* buffers,
+                                  const intptr_t* lengths,
+                                  intptr_t count,
+                                  SocketOpKind sync) {
+  return WriteBuffersOneByOne(fd, buffers, lengths, count, sync);
+}
+
+intptr_t SocketBase::SendFile(intptr_t fd,
+                              File* file,
+                              int64_t offset,
+                              intptr_t num_bytes,
+                              SocketOpKind sync) {
+  return SendFileThroughBuffer(fd, file, offset, num_bytes, sync);
+}
+
 intptr_t SocketBase::SendTo(intptr_t fd,
                             const void* buffer,
                             intptr_t num_bytes,
@@ -157,6 +173,25 @@ intptr_t SocketBase::SendTo(intptr_t fd,
   return -1;
 }
 
+intptr_t SocketBase::SendToBatch(intptr_t fd,
+                                 const void* const* buffers,
+                                 const intptr_t* lengths,
+                                 intptr_t count,
+                                 const RawAddr& addr,
+                                 SocketOpKind sync) {
+  return SendToOneByOne(fd, buffers, lengths, count, addr, sync);
+}
+
+intptr_t SocketBase::RecvFromBatch(intptr_t fd,
+                                   uint8_t* buffer,
+                                   intptr_t slot_size,
+                                   intptr_t count,
+                                   intptr_t* lengths,
+                                   RawAddr* addrs,
+                                   SocketOpKind sync) {
+  return RecvFromOneByOne(fd, buffer, slot_size, count, lengths, addrs, sync);
+}
+
 intptr_t SocketBase::GetPort(intptr_t fd) {
   IOHandle* handle = reinterpret_cast<IOHandle*>(fd);
   ASSERT(handle->fd() >= 0);
@@ -7,21 +7,24 @@
 
 #include "bin/socket_base.h"
 
-#include <errno.h>        // NOLINT
-#include <ifaddrs.h>      // NOLINT
-#include <net/if.h>       // NOLINT
-#include <netinet/tcp.h>  // NOLINT
-#include <stdio.h>        // NOLINT
-#include <stdlib.h>       // NOLINT
-#include <string.h>       // NOLINT
-#include <sys/stat.h>     // NOLINT
-#include <unistd.h>       // NOLINT
+#include <errno.h>         // NOLINT
+#include <ifaddrs.h>       // NOLINT
+#include <net/if.h>        // NOLINT
+#include <netinet/tcp.h>   // NOLINT
+#include <stdio.h>         // NOLINT
+#include <stdlib.h>        // NOLINT
+#include <string.h>        // NOLINT
+#include <sys/sendfile.h>  // NOLINT
+#include <sys/stat.h>      // NOLINT
+#include <sys/uio.h>       // NOLINT
+#include <unistd.h>        // NOLINT
 
 #include "bin/fdutils.h"
 #include "bin/file.h"
 #include "bin/socket_base_linux.h"
 #include "bin/thread.h"
 #include "platform/signal_blocker.h"
+#include "platform/utils.h"
 
 namespace dart {
 namespace bin {
@@ -105,6 +108,60 @@ intptr_t SocketBase::Write(intptr_t fd,
   return written_bytes;
 }
 
+intptr_t SocketBase::WriteBuffers(intptr_t fd,
+                                  const void* const* buffers,
+                                  const intptr_t* lengths,
+                                  intptr_t count,
+                                  SocketOpKind sync) {
+  ASSERT(fd >= 0);
+  const intptr_t kMaxBuffersPerCall = 64;
+  struct iovec iov[kMaxBuffersPerCall];
+  intptr_t total_written = 0;
+  for (intptr_t i = 0; i < count; i += kMaxBuffersPerCall) {
+    const intptr_t n = Utils::Minimum(count - i, kMaxBuffersPerCall);
+    intptr_t num_bytes = 0;
+    for (intptr_t j = 0; j < n; j++) {
+      iov[j].iov_base = const_cast<void*>(buffers[i + j]);
+      iov[j].iov_len = lengths[i + j];
+      num_bytes += lengths[i + j];
+    }
+    ssize_t written_bytes = TEMP_FAILURE_RETRY(writev(fd, iov, n));
+    if (written_bytes == -1) {
+      ASSERT(EAGAIN == EWOULDBLOCK);
+      if (((sync == kAsync) && (errno == EWOULDBLOCK)) ||
+          (total_written > 0)) {
+        // Report the bytes written so far. A persistent error is reported
+        // by the next write.
+        return total_written;
+      }
+      return -1;
+    }
+    total_written += written_bytes;
+    if (written_bytes < num_bytes) {
+      break;
+    }
+  }
+  return total_written;
+}
+
+intptr_t SocketBase::SendFile(intptr_t fd,
+                              File* file,
+                              int64_t offset,
+                              intptr_t num_bytes,
+                              SocketOpKind sync) {
+  ASSERT(fd >= 0);
+  off64_t file_offset = offset;
+  ssize_t sent_bytes = TEMP_FAILURE_RETRY(
+      sendfile64(fd, file->GetFD(), &file_offset, num_bytes));
+  ASSERT(EAGAIN == EWOULDBLOCK);
+  if ((sync == kAsync) && (sent_bytes == -1) && (errno == EWOULDBLOCK)) {
+    // If the would block we need to retry and therefore return 0 as
+    // the number of bytes sent.
+    sent_bytes = 0;
+  }
+  return sent_bytes;
+}
+
 intptr_t SocketBase::SendTo(intptr_t fd,
                             const void* buffer,
                             intptr_t num_bytes,
@@ -123,6 +180,84 @@ intptr_t SocketBase::SendTo(intptr_t fd,
   return written_bytes;
 }
 
+intptr_t SocketBase::SendToBatch(intptr_t fd,
+                                 const void* const* buffers,
+                                 const intptr_t* lengths,
+                                 intptr_t count,
+                                 const RawAddr& addr,
+                                 SocketOpKind sync) {
+  ASSERT(fd >= 0);
+  const intptr_t kMaxDatagramsPerCall = 64;
+  struct mmsghdr msgs[kMaxDatagramsPerCall];
+  struct iovec iov[kMaxDatagramsPerCall];
+  RawAddr& raw = const_cast<RawAddr&>(addr);
+  intptr_t total_sent = 0;
+  while (total_sent < count) {
+    const intptr_t n = Utils::Minimum(count - total_sent, kMaxDatagramsPerCall);
+    memset(msgs, 0, n * sizeof(struct mmsghdr));
+    for (intptr_t i = 0; i < n; i++) {
+      iov[i].iov_base = const_cast<void*>(buffers[total_sent + i]);
+      iov[i].iov_len = lengths[total_sent + i];
+      msgs[i].msg_hdr.msg_name = &raw.addr;
+      msgs[i].msg_hdr.msg_namelen = SocketAddress::GetAddrLength(addr);
+      msgs[i].msg_hdr.msg_iov = &iov[i];
+      msgs[i].msg_hdr.msg_iovlen = 1;
+    }
+    int sent = TEMP_FAILURE_RETRY(sendmmsg(fd, msgs, n, 0));
+    if (sent == -1) {
+      ASSERT(EAGAIN == EWOULDBLOCK);
+      if (((sync == kAsync) && (errno == EWOULDBLOCK)) || (total_sent > 0)) {
+        // Report the datagrams sent so far. A persistent error is reported
+        // by the next send.
+        return total_sent;
+      }
+      return -1;
+    }
+    total_sent += sent;
+    if (sent < n) {
+      break;
+    }
+  }
+  return total_sent;
+}
+
+intptr_t SocketBase::RecvFromBatch(intptr_t fd,
+                                   uint8_t* buffer,
+                                   intptr_t slot_size,
+                                   intptr_t count,
+                                   intptr_t* lengths,
+                                   RawAddr* addrs,
+                                   SocketOpKind sync) {
+  ASSERT(fd >= 0);
+  const intptr_t kMaxDatagramsPerCall = 64;
+  struct mmsghdr msgs[kMaxDatagramsPerCall];
+  struct iovec iov[kMaxDatagramsPerCall];
+  const intptr_t n = Utils::Minimum(count, kMaxDatagramsPerCall);
+  memset(msgs, 0, n * sizeof(struct mmsghdr));
+  for (intptr_t i = 0; i < n; i++) {
+    iov[i].iov_base = buffer + i * slot_size;
+    iov[i].iov_len = slot_size;
+    msgs[i].msg_hdr.msg_name = &addrs[i].addr;
+    msgs[i].msg_hdr.msg_namelen = sizeof(addrs[i].ss);
+    msgs[i].msg_hdr.msg_iov = &iov[i];
+    msgs[i].msg_hdr.msg_iovlen = 1;
+  }
+  int received = TEMP_FAILURE_RETRY(recvmmsg(fd, msgs, n, 0, NULL));
+  if (received == -1) {
+    ASSERT(EAGAIN == EWOULDBLOCK);
+    if ((sync == kAsync) && (errno == EWOULDBLOCK)) {
+      // If the read would block we need to retry and therefore return 0
+      // as the number of datagrams received.
+      return 0;
+    }
+    return -1;
+  }
+  for (intptr_t i = 0; i < received; i++) {
+    lengths[i] = msgs[i].msg_len;
+  }
+  return received;
+}
+
 intptr_t SocketBase::GetPort(intptr_t fd) {
   ASSERT(fd >= 0);
   RawAddr raw;
@@ -22,7 +22,9 @@ Socket::Socket(intptr_t fd)
       fd_(fd),
       isolate_port_(Dart_GetMainPortId()),
       port_(ILLEGAL_PORT),
-      udp_receive_buffer_(NULL) {}
+      udp_receive_buffer_(NULL),
+      udp_receive_batch_buffer_(NULL),
+      udp_receive_batch_slots_(0) {}
 
 void Socket::SetClosedFd() {
   fd_ = kClosedFd;
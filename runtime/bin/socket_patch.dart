@@ -690,6 +690,52 @@ class _NativeSocket extends _NativeSocketNativeWrapper with _ServiceObject {
     return result;
   }
 
+  List<Datagram> receiveBatch(int maxCount) {
+    if (maxCount is! int || maxCount < 1) {
+      throw new ArgumentError("Invalid maxCount to receiveBatch on Socket");
+    }
+    var datagrams = <Datagram>[];
+    if (isClosing || isClosed) return datagrams;
+    while (datagrams.length < maxCount) {
+      // The native call receives as many of the requested datagrams as it
+      // can at once, and fewer when no more are available.
+      int requested = maxCount - datagrams.length;
+      var result = nativeRecvFromBatch(requested);
+      if (result is OSError) {
+        reportError(result, "Receive failed");
+        break;
+      }
+      if (result == null) break;
+      // The datagrams are views on a single buffer. The result holds the
+      // buffer, followed by the end offset, sender address, raw sender
+      // address and sender port of each datagram.
+      Uint8List data = result[0];
+      int start = 0;
+      for (int i = 1; i < result.length; i += 4) {
+        int end = result[i];
+        datagrams.add(new Datagram(
+            new Uint8List.view(data.buffer, start, end - start),
+            new _InternetAddress(result[i + 1], null, result[i + 2]),
+            result[i + 3]));
+        start = end;
+      }
+      available = nativeAvailable();
+      // TODO(ricow): Remove when we track internal and pipe uses.
+      assert(resourceInfo != null || isPipe || isInternal || isInternalSignal);
+      if (resourceInfo != null) {
+        resourceInfo.totalRead += data.length;
+      }
+      int received = (result.length - 1) ~/ 4;
+      if (received < requested && available == 0) break;
+    }
+    // TODO(ricow): Remove when we track internal and pipe uses.
+    assert(resourceInfo != null || isPipe || isInternal || isInternalSignal);
+    if (resourceInfo != null) {
+      resourceInfo.didRead();
+    }
+    return datagrams;
+  }
+
   int write(List<int> buffer, int offset, int bytes) {
     if (buffer is! List) throw new ArgumentError();
     if (offset == null) offset = 0;
@@ -734,6 +780,75 @@ class _NativeSocket extends _NativeSocketNativeWrapper with _ServiceObject {
     return result;
   }
 
+  // Fills in the typed data, start offset and length of each buffer for
+  // the natives taking a list of buffers. Returns the total length.
+  static int _prepareBuffers(List<List<int>> buffers, List nativeBuffers,
+      List<int> offsets, List<int> lengths) {
+    if (buffers is! List) throw new ArgumentError();
+    int bytes = 0;
+    for (int i = 0; i < buffers.length; i++) {
+      List<int> buffer = buffers[i];
+      if (buffer is! List) throw new ArgumentError();
+      _BufferAndStart bufferAndStart =
+          _ensureFastAndSerializableByteData(buffer, 0, buffer.length);
+      nativeBuffers[i] = bufferAndStart.buffer;
+      offsets[i] = bufferAndStart.start;
+      lengths[i] = buffer.length;
+      bytes += buffer.length;
+    }
+    return bytes;
+  }
+
+  int writeBuffers(List<List<int>> buffers) {
+    if (buffers is! List) throw new ArgumentError();
+    if (isClosing || isClosed) return 0;
+    int count = buffers.length;
+    List nativeBuffers = new List(count);
+    List<int> offsets = new List<int>(count);
+    List<int> lengths = new List<int>(count);
+    int bytes = _prepareBuffers(buffers, nativeBuffers, offsets, lengths);
+    if (bytes == 0) return 0;
+    var result = nativeWriteBuffers(nativeBuffers, offsets, lengths);
+    return _completeWrite(result, bytes);
+  }
+
+  int sendFile(RandomAccessFile file, int position, int count) {
+    if (file is! _RandomAccessFile) throw new ArgumentError(file);
+    if (position is! int || count is! int) {
+      throw new ArgumentError("Invalid arguments to sendFile on Socket");
+    }
+    if (position < 0) throw new RangeError.value(position);
+    if (count < 0) throw new RangeError.value(count);
+    _RandomAccessFile randomAccessFile = file;
+    if ((position + count) > randomAccessFile.lengthSync()) {
+      throw new RangeError.value(position + count);
+    }
+    if (isClosing || isClosed) return 0;
+    if (count == 0) return 0;
+    var result = nativeSendFile(randomAccessFile._pointer(), position, count);
+    if (result is ArgumentError) throw result;
+    return _completeWrite(result, count);
+  }
+
+  // Reports an error or updates the write state after writing at most
+  // [bytes] bytes, and returns the number of bytes written.
+  int _completeWrite(result, int bytes) {
+    if (result is OSError) {
+      OSError osError = result;
+      scheduleMicrotask(() => reportError(osError, "Write failed"));
+      result = 0;
+    }
+    if (result < bytes) {
+      writeAvailable = false;
+    }
+    // TODO(ricow): Remove when we track internal and pipe uses.
+    assert(resourceInfo != null || isPipe || isInternal || isInternalSignal);
+    if (resourceInfo != null) {
+      resourceInfo.addWrite(result);
+    }
+    return result;
+  }
+
   int send(List<int> buffer, int offset, int bytes, InternetAddress address,
       int port) {
     _throwOnBadPort(port);
@@ -755,6 +870,35 @@ class _NativeSocket extends _NativeSocketNativeWrapper with _ServiceObject {
     return result;
   }
 
+  int sendBatch(List<List<int>> buffers, InternetAddress address, int port) {
+    _throwOnBadPort(port);
+    if (buffers is! List) throw new ArgumentError();
+    if (isClosing || isClosed) return 0;
+    int count = buffers.length;
+    if (count == 0) return 0;
+    List nativeBuffers = new List(count);
+    List<int> offsets = new List<int>(count);
+    List<int> lengths = new List<int>(count);
+    _prepareBuffers(buffers, nativeBuffers, offsets, lengths);
+    var result = nativeSendToBatch(nativeBuffers, offsets, lengths,
+        (address as _InternetAddress)._in_addr, port);
+    if (result is OSError) {
+      OSError osError = result;
+      scheduleMicrotask(() => reportError(osError, "Send failed"));
+      result = 0;
+    }
+    // TODO(ricow): Remove when we track internal and pipe uses.
+    assert(resourceInfo != null || isPipe || isInternal || isInternalSignal);
+    if (resourceInfo != null) {
+      int bytes = 0;
+      for (int i = 0; i < result; i++) {
+        bytes += lengths[i];
+      }
+      resourceInfo.addWrite(bytes);
+    }
+    return result;
+  }
+
   _NativeSocket accept() {
     // Don't issue accept if we're closing.
     if (isClosing || isClosed) return null;
@@ -1016,6 +1160,7 @@ class _NativeSocket extends _NativeSocketNativeWrapper with _ServiceObject {
           'ext.dart.io.getOpenSockets', _SocketResourceInfo.getOpenSockets);
       registerExtension('ext.dart.io.getSocketByID',
           _SocketResourceInfo.getSocketInfoMapByID);
+      _IOBufferPoolInfo.connect();
 
       connectedResourceHandler = true;
     }
@@ -1127,10 +1272,17 @@ class _NativeSocket extends _NativeSocketNativeWrapper with _ServiceObject {
   nativeAvailable() native "Socket_Available";
   nativeRead(int len) native "Socket_Read";
   nativeRecvFrom() native "Socket_RecvFrom";
+  nativeRecvFromBatch(int maxCount) native "Socket_RecvFromBatch";
   nativeWrite(List<int> buffer, int offset, int bytes)
       native "Socket_WriteList";
+  nativeWriteBuffers(List buffers, List<int> offsets, List<int> lengths)
+      native "Socket_WriteBuffers";
+  nativeSendFile(int filePointer, int position, int count)
+      native "Socket_SendFile";
   nativeSendTo(List<int> buffer, int offset, int bytes, List<int> address,
       int port) native "Socket_SendTo";
+  nativeSendToBatch(List buffers, List<int> offsets, List<int> lengths,
+      List<int> address, int port) native "Socket_SendToBatch";
   nativeCreateConnect(List<int> addr, int port) native "Socket_CreateConnect";
   nativeCreateBindConnect(List<int> addr, int port, List<int> sourceAddr)
       native "Socket_CreateBindConnect";
@@ -1345,6 +1497,11 @@ class _RawSocket extends Stream<RawSocketEvent> implements RawSocket {
   int write(List<int> buffer, [int offset, int count]) =>
       _socket.write(buffer, offset, count);
 
+  int writeBuffers(List<List<int>> buffers) => _socket.writeBuffers(buffers);
+
+  int sendFile(RandomAccessFile file, int position, int count) =>
+      _socket.sendFile(file, position, count);
+
   Future<RawSocket> close() => _socket.close().then<RawSocket>((_) => this);
 
   void shutdown(SocketDirection direction) => _socket.shutdown(direction);
@@ -1840,10 +1997,16 @@ class _RawDatagramSocket extends Stream<RawSocketEvent>
   int send(List<int> buffer, InternetAddress address, int port) =>
       _socket.send(buffer, 0, buffer.length, address, port);
 
+  int sendBatch(List<List<int>> buffers, InternetAddress address, int port) =>
+      _socket.sendBatch(buffers, address, port);
+
   Datagram receive() {
     return _socket.receive();
   }
 
+  List<Datagram> receiveBatch([int maxCount = 16]) =>
+      _socket.receiveBatch(maxCount);
+
   void joinMulticast(InternetAddress group, [NetworkInterface interface]) {
     _socket.joinMulticast(group, interface);
   }
@@ -967,6 +967,25 @@ DART_EXPORT void Dart_NotifyIdle(int64_t deadline);
  */
 DART_EXPORT void Dart_NotifyLowMemory();
 
+/**
+ * Sets goals for the garbage collector of the current isolate. The sizes of
+ * the new and old generations are then chosen to meet the goals rather than
+ * by the default growth heuristics. The goals are best effort: when both
+ * cannot be met, the pause goal limits growth more than the time goal
+ * demands.
+ *
+ * Overrides the --gc_time_goal and --gc_pause_goal flags for this isolate.
+ *
+ * \param gc_time_percent The desired maximum percentage of time spent in
+ *   garbage collection pauses. Zero means no goal.
+ * \param pause_millis The desired maximum length of a garbage collection
+ *   pause in milliseconds. Zero means no goal.
+ *
+ * Requires there to be a current isolate.
+ */
+DART_EXPORT void Dart_SetGarbageCollectionGoals(intptr_t gc_time_percent,
+                                                intptr_t pause_millis);
+
 /**
  * Notifies the VM that the current thread should not be profiled until a
  * matching call to Dart_ThreadEnableProfiling is made.
@@ -3178,6 +3197,30 @@ Dart_SaveCompilationTrace(uint8_t** buffer, intptr_t* buffer_length);
 DART_EXPORT DART_WARN_UNUSED_RESULT Dart_Handle
 Dart_LoadCompilationTrace(uint8_t* buffer, intptr_t buffer_length);
 
+/**
+ * Record the type feedback collected by unoptimized code in the current
+ * isolate: receiver classes at call sites, field guards and usage counters.
+ *
+ * \param buffer Returns a pointer to a buffer containing the feedback.
+ *   This buffer is scope allocated and is only valid  until the next call to
+ *   Dart_ExitScope.
+ * \param size Returns the size of the buffer.
+ * \return Returns an valid handle upon success.
+ */
+DART_EXPORT DART_WARN_UNUSED_RESULT Dart_Handle
+Dart_SaveTypeFeedback(uint8_t** buffer, intptr_t* buffer_length);
+
+/**
+ * Compile the functions recorded by Dart_SaveTypeFeedback and restore their
+ * type feedback, so that functions that were hot can be optimized right away.
+ * Feedback for functions whose source has changed is dropped.
+ *
+ * \return Returns an error handle if a compilation error was encountered or
+ *   the buffer does not contain type feedback.
+ */
+DART_EXPORT DART_WARN_UNUSED_RESULT Dart_Handle
+Dart_LoadTypeFeedback(uint8_t* buffer, intptr_t buffer_length);
+
 /*
  * ==============
  * Precompilation
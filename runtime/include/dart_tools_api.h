@@ -485,5 +485,14 @@ DART_EXPORT int64_t
 Dart_IsolateRunnableLatencyMetric(Dart_Isolate isolate);  // Microsecond
 DART_EXPORT int64_t
 Dart_IsolateRunnableHeapSizeMetric(Dart_Isolate isolate);  // Byte
+DART_EXPORT int64_t
+Dart_IsolateBackgroundCompilationQueueLengthMetric(
+    Dart_Isolate isolate);  // Counter
+DART_EXPORT int64_t
+Dart_IsolateBackgroundCompilationLatencyMetric(
+    Dart_Isolate isolate);  // Microsecond
+DART_EXPORT int64_t
+Dart_IsolateBackgroundCompilationLatencyMaxMetric(
+    Dart_Isolate isolate);  // Microsecond
 
 #endif  // RUNTIME_INCLUDE_DART_TOOLS_API_H_
@@ -0,0 +1,28 @@
+// Copyright (c) 2019, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+import 'package:observatory/service_io.dart';
+import 'package:unittest/unittest.dart';
+
+import 'test_helper.dart';
+
+var tests = <VMTest>[
+  (VM vm) async {
+    var result = await vm.invokeRpcNoUpgrade('_getCompilerPassTimes', {});
+    expect(result['type'], equals('CompilerPassTimes'));
+    List limits = result['bucketLimitsMicros'];
+    expect(limits.first, equals(2));
+    List passes = result['passes'];
+    expect(passes, isNotEmpty);
+    for (Map pass in passes) {
+      expect(pass['name'], isNotNull);
+      List histogram = pass['histogram'];
+      expect(histogram.length, equals(limits.length + 1));
+      expect(histogram.fold(0, (a, b) => a + b), equals(pass['runs']));
+      expect(pass['totalMicros'], greaterThanOrEqualTo(0));
+    }
+  },
+];
+
+main(args) async => runVMTests(args, tests);
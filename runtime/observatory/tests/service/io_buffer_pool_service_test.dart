@@ -0,0 +1,57 @@
+// Copyright (c) 2019, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+import 'dart:async';
+import 'dart:convert';
+import 'dart:developer';
+import 'dart:io' as io;
+import 'package:observatory/service_io.dart';
+import 'package:unittest/unittest.dart';
+import 'test_helper.dart';
+
+Future setupFiles() async {
+  var readingFile;
+
+  Future<ServiceExtensionResponse> cleanup(ignored_a, ignored_b) {
+    readingFile.closeSync();
+    var result = jsonEncode({'type': 'foobar'});
+    return new Future.value(new ServiceExtensionResponse.result(result));
+  }
+
+  Future<ServiceExtensionResponse> setup(ignored_a, ignored_b) async {
+    // Small reads allocate their buffers from the pool, and return them to
+    // it when the buffers are collected.
+    var file = new io.File.fromUri(io.Platform.script);
+    readingFile = await file.open();
+    for (int i = 0; i < 10; i++) {
+      await readingFile.setPosition(0);
+      expect((await readingFile.read(100)).length, equals(100));
+    }
+    var result = jsonEncode({'type': 'foobar'});
+    return new Future.value(new ServiceExtensionResponse.result(result));
+  }
+
+  registerExtension('ext.dart.io.cleanup', cleanup);
+  registerExtension('ext.dart.io.setup', setup);
+}
+
+var ioBufferPoolTests = <IsolateTest>[
+  (Isolate isolate) async {
+    await isolate.invokeRpcNoUpgrade('ext.dart.io.setup', {});
+    try {
+      var result = await isolate.invokeRpcNoUpgrade(
+          'ext.dart.io.getIOBufferPoolStatistics', {});
+      expect(result['type'], equals('_iobufferpool'));
+      expect(result['hits'], greaterThanOrEqualTo(0));
+      expect(result['misses'], greaterThanOrEqualTo(0));
+      expect(result['hits'] + result['misses'], greaterThanOrEqualTo(10));
+      expect(result['residentBytes'], greaterThanOrEqualTo(0));
+    } finally {
+      await isolate.invokeRpcNoUpgrade('ext.dart.io.cleanup', {});
+    }
+  },
+];
+
+main(args) async =>
+    runIsolateTests(args, ioBufferPoolTests, testeeBefore: setupFiles);
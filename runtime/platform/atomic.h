@@ -48,6 +48,17 @@ class AtomicOperations : public AllStatic {
     return *static_cast<volatile T*>(ptr);
   }
 
+  // Performs a store of a word to 'ptr', but without any guarantees about
+  // memory order (i.e., no store barriers/fences).
+  template <typename T>
+  static void StoreRelaxed(T* ptr, T value) {
+    *static_cast<volatile T*>(ptr) = value;
+  }
+
+  // Orders all loads and stores before the barrier before all loads and
+  // stores after it, including a store before a later load.
+  static void FullMemoryBarrier();
+
   template <typename T>
   static T LoadAcquire(T* ptr);
 
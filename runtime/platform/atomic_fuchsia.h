@@ -65,6 +65,10 @@ inline uint32_t AtomicOperations::CompareAndSwapUint32(uint32_t* ptr,
   return __sync_val_compare_and_swap(ptr, old_value, new_value);
 }
 
+inline void AtomicOperations::FullMemoryBarrier() {
+  __atomic_thread_fence(__ATOMIC_SEQ_CST);
+}
+
 template <typename T>
 inline T AtomicOperations::LoadAcquire(T* ptr) {
   return __atomic_load_n(ptr, __ATOMIC_ACQUIRE);
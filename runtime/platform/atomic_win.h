@@ -141,6 +141,14 @@ inline uint32_t AtomicOperations::CompareAndSwapUint32(uint32_t* ptr,
 #endif
 }
 
+inline void AtomicOperations::FullMemoryBarrier() {
+#if (defined(HOST_ARCH_X64) || defined(HOST_ARCH_IA32))
+  MemoryBarrier();
+#else
+#error Unsupported host architecture.
+#endif
+}
+
 template <typename T>
 inline T AtomicOperations::LoadAcquire(T* ptr) {
 #if (defined(HOST_ARCH_X64) || defined(HOST_ARCH_IA32))
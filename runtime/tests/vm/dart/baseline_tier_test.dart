@@ -0,0 +1,54 @@
+// Copyright (c) 2019, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// VMOptions=--baseline_tier --baseline_optimization_counter_threshold=10 --optimization_counter_threshold=100 --no-use-osr --no-background-compilation
+
+// Test that functions compute the same results in unoptimized code, in
+// baseline code, after deoptimizing out of baseline code and in fully
+// optimized code.
+
+import "package:expect/expect.dart";
+
+class Point {
+  final x, y;
+  Point(this.x, this.y);
+  get sum => x + y;
+}
+
+add(a, b) => a + b;
+
+sumPoints(List<Point> points) {
+  var result = 0;
+  for (var p in points) {
+    result = add(result, p.sum);
+  }
+  return result;
+}
+
+main() {
+  // Cross both thresholds with Smi arguments.
+  for (int i = 0; i < 300; i++) {
+    Expect.equals(2 * i + 1, add(i, i + 1));
+    if (i == 20) {
+      // Baseline code specialized for Smis deoptimizes on doubles and
+      // strings, and is compiled again afterwards.
+      Expect.equals(3.5, add(1.5, 2));
+      Expect.equals("ab", add("a", "b"));
+    }
+  }
+  // Fully optimized code keeps working for all argument types.
+  Expect.equals(3.5, add(1.5, 2));
+  Expect.equals("ab", add("a", "b"));
+  Expect.equals(0x4000000000000000, add(0x3fffffffffffffff, 1));
+
+  final points = new List<Point>.generate(10, (i) => new Point(i, 2 * i));
+  for (int i = 0; i < 300; i++) {
+    Expect.equals(135, sumPoints(points));
+    if (i == 20) {
+      Expect.equals(4.5, sumPoints([new Point(1.5, 3)]));
+    }
+  }
+  Expect.equals(4.5, sumPoints([new Point(1.5, 3)]));
+  Expect.equals(135, sumPoints(points));
+}
@@ -0,0 +1,106 @@
+// Copyright (c) 2019, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// VMOptions=--optimization_counter_threshold=10 --no-use-osr --no-background-compilation
+
+// Test that int fields keep their values when they are stored unboxed, both
+// inside and outside of the smi range, and that loaded values are not
+// changed by later stores.
+
+import "package:expect/expect.dart";
+
+const int kBig = 0x4000000000000000;
+
+class Counter {
+  int value;
+  Counter(this.value);
+}
+
+class Holder {
+  var value;
+  Holder(this.value);
+}
+
+class Wide {
+  int value;
+  Wide(this.value);
+}
+
+void setWide(Wide w, int value) {
+  w.value = value;
+}
+
+int getWide(Wide w) => w.value;
+
+void incrementWide(Wide w) {
+  w.value = w.value + 1;
+}
+
+int bump(Counter c) {
+  final int before = c.value;
+  c.value = c.value + 1;
+  return before;
+}
+
+main() {
+  final c = new Counter(kBig);
+  final loaded = <int>[];
+  for (int i = 0; i < 1000; i++) {
+    loaded.add(bump(c));
+  }
+  Expect.equals(kBig + 1000, c.value);
+  for (int i = 0; i < loaded.length; i++) {
+    Expect.equals(kBig + i, loaded[i]);
+  }
+
+  // Smi values share the field with Mint values, and stay Smis.
+  final small = new Counter(1);
+  Expect.equals(1, bump(small));
+  Expect.equals(2, small.value);
+  Expect.isTrue(identical(2, small.value));
+  Expect.equals(kBig + 1000, bump(c));
+  Expect.equals(kBig + 1001, c.value);
+
+  // Cross the smi range boundary in both directions.
+  final edge = new Counter(0x3ffffffffffffff0);
+  for (int i = 0; i < 100; i++) {
+    final int before = edge.value;
+    if (i.isEven) {
+      Expect.equals(before, bump(edge));
+      Expect.equals(before + 1, edge.value);
+    } else {
+      edge.value = i;
+      Expect.isTrue(identical(i, edge.value));
+      edge.value = before + 1;
+    }
+  }
+  Expect.equals(0x3ffffffffffffff0 + 100, edge.value);
+
+  // Storing a value that is not an int makes the field boxed again.
+  final holder = new Holder(kBig);
+  for (int i = 0; i < 100; i++) {
+    holder.value = holder.value + 1;
+  }
+  Expect.equals(kBig + 100, holder.value);
+  holder.value = "string";
+  Expect.equals("string", holder.value);
+  holder.value = 3;
+  Expect.equals(3, holder.value);
+
+  // Widen a field guarded as Smi with a shared Mint constant, from code
+  // compiled while the guard was still Smi. Neither the constant nor values
+  // loaded by that code may change when optimized code updates the field.
+  final wide = new Wide(0);
+  setWide(wide, 1);
+  Expect.equals(1, getWide(wide));
+  setWide(wide, kBig);
+  final int before = getWide(wide);
+  for (int i = 0; i < 100; i++) {
+    incrementWide(wide);
+  }
+  Expect.equals("4611686018427387904", kBig.toString());
+  Expect.equals("4611686018427387904", before.toString());
+  Expect.equals(kBig + 100, wide.value);
+  Expect.equals(kBig + 100, getWide(wide));
+}
@@ -6,7 +6,9 @@
 
 #include "bin/builtin.h"
 #include "bin/file.h"
+#include "bin/file_io_pool.h"
 #include "bin/isolate_data.h"
+#include "bin/lockers.h"
 #include "bin/process.h"
 #include "bin/reference_counting.h"
 
@@ -15,13 +17,34 @@
 
 #include "vm/clustered_snapshot.h"
 #include "vm/dart_api_impl.h"
+#include "vm/heap/freelist.h"
+#include "vm/random.h"
 #include "vm/stack_frame.h"
 #include "vm/timer.h"
 
+#if !defined(DART_IO_SECURE_SOCKET_DISABLED)
+#include "bin/io_service.h"
+#endif
+
+#if defined(HOST_OS_LINUX)
+#include <netinet/in.h>   // NOLINT
+#include <netinet/tcp.h>  // NOLINT
+#include <sys/socket.h>   // NOLINT
+
+#include "bin/eventhandler.h"
+#include "bin/fdutils.h"
+#include "bin/socket.h"
+#endif
+
 using dart::bin::File;
 
 namespace dart {
 
+DECLARE_FLAG(bool, baseline_tier);
+DECLARE_FLAG(bool, loop_vectorization);
+DECLARE_FLAG(bool, loop_versioning);
+DECLARE_FLAG(bool, unbox_int64_fields);
+
 Benchmark* Benchmark::first_ = NULL;
 Benchmark* Benchmark::tail_ = NULL;
 const char* Benchmark::executable_ = NULL;
@@ -757,6 +780,685 @@ BENCHMARK(LargeMap) {
   benchmark->set_score(elapsed_time);
 }
 
+static int CompareInt64(const int64_t* a, const int64_t* b) {
+  return (*a < *b) ? -1 : ((*a > *b) ? 1 : 0);
+}
+
+// Runs a fixed workload that keeps a sliding window of live objects and
+// reports the 99th percentile GC pause in microseconds.
+static void RunGCPauseWorkload(Benchmark* benchmark, Thread* thread) {
+  const char* kScript =
+      "var window = new List(1024);\n"
+      "var next = 0;\n"
+      "step() {\n"
+      "  for (int i = 0; i < 64; i++) {\n"
+      "    window[next] = new List(64);\n"
+      "    next = (next + 1) % window.length;\n"
+      "  }\n"
+      "  var garbage;\n"
+      "  for (int i = 0; i < 1024; i++) {\n"
+      "    garbage = new List(16);\n"
+      "  }\n"
+      "  return garbage.length;\n"
+      "}";
+  Dart_Handle h_lib = TestCase::LoadTestScript(kScript, NULL);
+  EXPECT_VALID(h_lib);
+  Heap* heap = thread->isolate()->heap();
+  const intptr_t kSteps = 20000;
+  MallocGrowableArray<int64_t> pauses;
+  int64_t gc_time = 0;
+  intptr_t collections = 0;
+  for (intptr_t i = 0; i < kSteps; i++) {
+    Dart_Handle h_result = Dart_Invoke(h_lib, NewString("step"), 0, NULL);
+    EXPECT_VALID(h_result);
+    const int64_t new_gc_time = heap->new_space()->gc_time_micros() +
+                                heap->old_space()->gc_time_micros();
+    const intptr_t new_collections = heap->new_space()->collections() +
+                                     heap->old_space()->collections();
+    // Collections in the same step are taken to be equally long.
+    const intptr_t step_collections = new_collections - collections;
+    for (intptr_t j = 0; j < step_collections; j++) {
+      pauses.Add((new_gc_time - gc_time) / step_collections);
+    }
+    gc_time = new_gc_time;
+    collections = new_collections;
+  }
+  pauses.Sort(CompareInt64);
+  const int64_t p99 =
+      pauses.is_empty() ? 0 : pauses[(pauses.length() * 99) / 100];
+  benchmark->set_score(p99);
+}
+
+BENCHMARK(GCPauseDefaultGrowth) {
+  RunGCPauseWorkload(benchmark, thread);
+}
+
+BENCHMARK(GCPauseWithGoals) {
+  Dart_SetGarbageCollectionGoals(5, 2);
+  RunGCPauseWorkload(benchmark, thread);
+}
+
+// Marks a wide tree with the given number of marker tasks. The score is the
+// best time of a full collection in microseconds.
+static void RunMarkerWorkload(Benchmark* benchmark,
+                              Thread* thread,
+                              intptr_t num_tasks) {
+  TransitionNativeToVM transition(thread);
+  StackZone zone(thread);
+  HANDLESCOPE(thread);
+  SetFlagScope<bool> sfs(&FLAG_concurrent_mark, false);
+  SetFlagScope<int> sfs2(&FLAG_marker_tasks, num_tasks);
+  Heap* heap = thread->isolate()->heap();
+
+  // A wide tree, so that every marker can find work.
+  const intptr_t kFanOut = 256;
+  const intptr_t kLeafLength = 16;
+  const Array& root = Array::Handle(Array::New(kFanOut, Heap::kOld));
+  Array& node = Array::Handle();
+  Array& leaf = Array::Handle();
+  for (intptr_t i = 0; i < kFanOut; i++) {
+    node = Array::New(kFanOut, Heap::kOld);
+    for (intptr_t j = 0; j < kFanOut; j++) {
+      leaf = Array::New(kLeafLength, Heap::kOld);
+      node.SetAt(j, leaf);
+    }
+    root.SetAt(i, node);
+  }
+
+  int64_t best = kMaxInt64;
+  for (intptr_t i = 0; i < 5; i++) {
+    heap->WaitForSweeperTasks(thread);
+    const int64_t start = OS::GetCurrentMonotonicMicros();
+    heap->CollectAllGarbage();
+    best = Utils::Minimum(best, OS::GetCurrentMonotonicMicros() - start);
+  }
+  heap->WaitForSweeperTasks(thread);
+  benchmark->set_score(best);
+}
+
+BENCHMARK(MarkerTasks1) {
+  RunMarkerWorkload(benchmark, thread, 1);
+}
+
+BENCHMARK(MarkerTasks2) {
+  RunMarkerWorkload(benchmark, thread, 2);
+}
+
+BENCHMARK(MarkerTasks4) {
+  RunMarkerWorkload(benchmark, thread, 4);
+}
+
+BENCHMARK(MarkerTasks8) {
+  RunMarkerWorkload(benchmark, thread, 8);
+}
+
+// Measures the latency of allocations from a free list fragmented into many
+// large holes of random sizes. The score is the p99 latency in nanoseconds.
+BENCHMARK(FreeListFragmentedLatency) {
+  FreeList* free_list = new FreeList();
+  const intptr_t kBlobSize = 16 * MB;
+  const intptr_t kMinSize = 2 * KB;
+  const intptr_t kMaxSize = 64 * KB;
+  const intptr_t kNumAllocations = 10000;
+  VirtualMemory* region =
+      VirtualMemory::Allocate(kBlobSize, /* is_executable */ false, NULL);
+  Random random(42);
+
+  // Carve the region into blocks of random sizes and free every other one.
+  uword top = region->start();
+  uword end = region->end();
+  bool free = true;
+  while (top < end) {
+    intptr_t size =
+        Utils::RoundUp(kMinSize + (random.NextUInt32() % (kMaxSize - kMinSize)),
+                       kObjectAlignment);
+    size = Utils::Minimum(size, static_cast<intptr_t>(end - top));
+    if (free) {
+      free_list->Free(top, size);
+    }
+    free = !free;
+    top += size;
+  }
+
+  MallocGrowableArray<int64_t> latencies(kNumAllocations);
+  for (intptr_t i = 0; i < kNumAllocations; i++) {
+    intptr_t size = Utils::RoundUp(
+        kObjectAlignment + (random.NextUInt32() % (kMaxSize / 2)),
+        kObjectAlignment);
+    int64_t start = OS::GetCurrentMonotonicTicks();
+    uword addr = free_list->TryAllocate(size, false);
+    latencies.Add(OS::GetCurrentMonotonicTicks() - start);
+    if ((addr != 0) && ((i % 2) == 0)) {
+      // Return half of the allocations to keep the list fragmented.
+      free_list->Free(addr, size);
+    }
+  }
+  latencies.Sort(CompareInt64);
+
+  const double ticks_per_ns = OS::GetCurrentMonotonicFrequency() / 1e9;
+  const int64_t p99 = latencies[(kNumAllocations * 99) / 100] / ticks_per_ns;
+  benchmark->set_score(p99);
+
+  delete region;
+  delete free_list;
+}
+
+// Runs numeric kernels over typed data whose loops are bounds checked on
+// every iteration unless the checks are hoisted out of them.
+static void RunTypedDataLoops(Benchmark* benchmark, Thread* thread) {
+  const char* kScript =
+      "import 'dart:typed_data';\n"
+      "double sum(Float64List list) {\n"
+      "  double result = 0.0;\n"
+      "  for (int i = 0; i < list.length; i++) {\n"
+      "    result += list[i];\n"
+      "  }\n"
+      "  return result;\n"
+      "}\n"
+      "void blur(Uint8List from, Uint8List to) {\n"
+      "  for (int i = 1; i < from.length - 1; i++) {\n"
+      "    to[i] = (from[i - 1] + 2 * from[i] + from[i + 1]) >> 2;\n"
+      "  }\n"
+      "}\n"
+      "var doubles = new Float64List(4096);\n"
+      "var from = new Uint8List(4096);\n"
+      "var to = new Uint8List(4096);\n"
+      "double step() {\n"
+      "  blur(from, to);\n"
+      "  blur(to, from);\n"
+      "  return sum(doubles);\n"
+      "}";
+  Dart_Handle h_lib = TestCase::LoadTestScript(kScript, NULL);
+  EXPECT_VALID(h_lib);
+  // Warmup first to get the kernels optimized.
+  const intptr_t kWarmupSteps = 1000;
+  for (intptr_t i = 0; i < kWarmupSteps; i++) {
+    Dart_Handle h_result = Dart_Invoke(h_lib, NewString("step"), 0, NULL);
+    EXPECT_VALID(h_result);
+  }
+  const intptr_t kSteps = 10000;
+  Timer timer(true, "Typed Data Loops");
+  timer.Start();
+  for (intptr_t i = 0; i < kSteps; i++) {
+    Dart_Handle h_result = Dart_Invoke(h_lib, NewString("step"), 0, NULL);
+    EXPECT_VALID(h_result);
+  }
+  timer.Stop();
+  benchmark->set_score(timer.TotalElapsedTime());
+}
+
+BENCHMARK(TypedDataLoops) {
+  RunTypedDataLoops(benchmark, thread);
+}
+
+BENCHMARK(TypedDataLoopsNoVersioning) {
+  SetFlagScope<bool> sfs(&FLAG_loop_versioning, false);
+  RunTypedDataLoops(benchmark, thread);
+}
+
+// Runs element-wise kernels over typed data that can be done on SIMD
+// vectors instead of single elements.
+static void RunTypedDataMaps(Benchmark* benchmark, Thread* thread) {
+  const char* kScript =
+      "import 'dart:typed_data';\n"
+      "void scale(Float32List to, Float32List from) {\n"
+      "  for (int i = 0; i < to.length; i++) {\n"
+      "    to[i] = from[i] * 0.5;\n"
+      "  }\n"
+      "}\n"
+      "void axpy(double a, Float64List x, Float64List y) {\n"
+      "  for (int i = 0; i < y.length; i++) {\n"
+      "    y[i] = y[i] + a * x[i];\n"
+      "  }\n"
+      "}\n"
+      "void mix(Int32List to, Int32List from) {\n"
+      "  for (int i = 0; i < to.length; i++) {\n"
+      "    to[i] = to[i] ^ from[i];\n"
+      "  }\n"
+      "}\n"
+      "var floats = new Float32List(4099);\n"
+      "var doubles = new Float64List(4099);\n"
+      "var ints = new Int32List(4099);\n"
+      "void step() {\n"
+      "  scale(floats, floats);\n"
+      "  axpy(0.5, doubles, doubles);\n"
+      "  mix(ints, ints);\n"
+      "}";
+  Dart_Handle h_lib = TestCase::LoadTestScript(kScript, NULL);
+  EXPECT_VALID(h_lib);
+  // Warmup first to get the kernels optimized.
+  const intptr_t kWarmupSteps = 1000;
+  for (intptr_t i = 0; i < kWarmupSteps; i++) {
+    Dart_Handle h_result = Dart_Invoke(h_lib, NewString("step"), 0, NULL);
+    EXPECT_VALID(h_result);
+  }
+  const intptr_t kSteps = 10000;
+  Timer timer(true, "Typed Data Maps");
+  timer.Start();
+  for (intptr_t i = 0; i < kSteps; i++) {
+    Dart_Handle h_result = Dart_Invoke(h_lib, NewString("step"), 0, NULL);
+    EXPECT_VALID(h_result);
+  }
+  timer.Stop();
+  benchmark->set_score(timer.TotalElapsedTime());
+}
+
+BENCHMARK(TypedDataMaps) {
+  RunTypedDataMaps(benchmark, thread);
+}
+
+BENCHMARK(TypedDataMapsNoVectorization) {
+  SetFlagScope<bool> sfs(&FLAG_loop_vectorization, false);
+  RunTypedDataMaps(benchmark, thread);
+}
+
+// Runs a startup-like trace from cold: many functions that get warm but
+// rarely hot, so the score is dominated by how soon they run optimized code.
+static void RunTimeToPeak(Benchmark* benchmark, Thread* thread) {
+  const char* kScript =
+      "abstract class Shape { double area(); }\n"
+      "class Rect extends Shape {\n"
+      "  final double w, h;\n"
+      "  Rect(this.w, this.h);\n"
+      "  double area() => w * h;\n"
+      "}\n"
+      "class Circle extends Shape {\n"
+      "  final double r;\n"
+      "  Circle(this.r);\n"
+      "  double area() => 3.14159 * r * r;\n"
+      "}\n"
+      "double totalArea(List<Shape> shapes) {\n"
+      "  double sum = 0.0;\n"
+      "  for (var s in shapes) sum += s.area();\n"
+      "  return sum;\n"
+      "}\n"
+      "int checksum(String s) {\n"
+      "  int h = 0;\n"
+      "  for (int i = 0; i < s.length; i++) {\n"
+      "    h = (h * 31 + s.codeUnitAt(i)) & 0x3fffffff;\n"
+      "  }\n"
+      "  return h;\n"
+      "}\n"
+      "String describe(int i) => 'item ${i % 7}: ${i * 3}';\n"
+      "Map<String, int> index(List<String> keys) {\n"
+      "  var result = <String, int>{};\n"
+      "  for (int i = 0; i < keys.length; i++) result[keys[i]] = i;\n"
+      "  return result;\n"
+      "}\n"
+      "int step(int n) {\n"
+      "  var shapes = <Shape>[];\n"
+      "  for (int i = 0; i < 8; i++) {\n"
+      "    shapes.add(i.isEven ? new Rect(i + 1.0, 2.0)\n"
+      "                        : new Circle(i + 0.5));\n"
+      "  }\n"
+      "  var keys = new List<String>.generate(8, (i) => describe(n + i));\n"
+      "  var h = 0;\n"
+      "  index(keys).forEach((k, v) => h = (h + checksum(k) + v) & 0xffff);\n"
+      "  return h + totalArea(shapes).toInt();\n"
+      "}";
+  Dart_Handle h_lib = TestCase::LoadTestScript(kScript, NULL);
+  EXPECT_VALID(h_lib);
+  const intptr_t kSteps = 5000;
+  Timer timer(true, "Time To Peak");
+  timer.Start();
+  for (intptr_t i = 0; i < kSteps; i++) {
+    Dart_Handle args[1] = {Dart_NewInteger(i)};
+    Dart_Handle h_result = Dart_Invoke(h_lib, NewString("step"), 1, args);
+    EXPECT_VALID(h_result);
+  }
+  timer.Stop();
+  benchmark->set_score(timer.TotalElapsedTime());
+}
+
+BENCHMARK(TimeToPeak) {
+  RunTimeToPeak(benchmark, thread);
+}
+
+BENCHMARK(TimeToPeakBaselineTier) {
+  SetFlagScope<bool> sfs(&FLAG_baseline_tier, true);
+  RunTimeToPeak(benchmark, thread);
+}
+
+// Updates a counter and a 64-bit hash field, which hold both Smi and Mint
+// values, and reports the number of scavenges, which grows with the number
+// of boxes allocated.
+static void RunInt64FieldStores(Benchmark* benchmark, Thread* thread) {
+  const char* kScript =
+      "class Stats {\n"
+      "  int count;\n"
+      "  int hash;\n"
+      "  Stats(this.count, this.hash);\n"
+      "}\n"
+      "final stats = new Stats(0, 0);\n"
+      "step() {\n"
+      "  var s = stats;\n"
+      "  for (int i = 0; i < 1000; i++) {\n"
+      "    s.count = s.count + 1;\n"
+      "    s.hash = ((s.hash ^ i) * 1099511628211) & 0x7fffffffffffffff;\n"
+      "  }\n"
+      "  return s.hash & 0xff;\n"
+      "}";
+  Dart_Handle h_lib = TestCase::LoadTestScript(kScript, NULL);
+  EXPECT_VALID(h_lib);
+  Heap* heap = thread->isolate()->heap();
+  const intptr_t collections = heap->new_space()->collections();
+  const intptr_t kSteps = 20000;
+  for (intptr_t i = 0; i < kSteps; i++) {
+    Dart_Handle h_result = Dart_Invoke(h_lib, NewString("step"), 0, NULL);
+    EXPECT_VALID(h_result);
+  }
+  benchmark->set_score(heap->new_space()->collections() - collections);
+}
+
+BENCHMARK(Int64FieldStores) {
+  RunInt64FieldStores(benchmark, thread);
+}
+
+BENCHMARK(Int64FieldStoresBoxed) {
+  SetFlagScope<bool> sfs(&FLAG_unbox_int64_fields, false);
+  RunInt64FieldStores(benchmark, thread);
+}
+
+#if !defined(DART_IO_SECURE_SOCKET_DISABLED)
+// Counts the completions of asynchronous file reads posted to a native port,
+// either one per message by the IO service or in batches by the file IO pool.
+class FileReadCompletions : public AllStatic {
+ public:
+  static void Expect(intptr_t count) {
+    bin::MonitorLocker ml(monitor_);
+    pending_ = count;
+  }
+
+  static void Wait() {
+    bin::MonitorLocker ml(monitor_);
+    while (pending_ > 0) {
+      ml.Wait();
+    }
+  }
+
+  static void HandleIOServiceReply(Dart_Port dest_port,
+                                   Dart_CObject* message) {
+    Complete(1);
+  }
+
+  static void HandleFileIOPoolCompletions(Dart_Port dest_port,
+                                          Dart_CObject* message) {
+    Complete(message->value.as_array.length / 2);
+  }
+
+ private:
+  static void Complete(intptr_t count) {
+    bin::MonitorLocker ml(monitor_);
+    pending_ -= count;
+    if (pending_ == 0) {
+      ml.Notify();
+    }
+  }
+
+  static bin::Monitor* monitor_;
+  static intptr_t pending_;
+};
+
+bin::Monitor* FileReadCompletions::monitor_ = new bin::Monitor();
+intptr_t FileReadCompletions::pending_ = 0;
+
+static const intptr_t kFileReadRequests = 10000;
+static const intptr_t kFileReadLength = 64;
+
+// Issues many small asynchronous reads of the benchmark executable, and
+// scores the time until they have all completed.
+static void RunFileReads(Benchmark* benchmark, bool use_file_io_pool) {
+  File* file = File::Open(NULL, Benchmark::Executable(), File::kRead);
+  EXPECT(file != NULL);
+  Dart_Port reply_port = Dart_NewNativePort(
+      "FileReads",
+      use_file_io_pool ? FileReadCompletions::HandleFileIOPoolCompletions
+                       : FileReadCompletions::HandleIOServiceReply,
+      false);
+  EXPECT(reply_port != ILLEGAL_PORT);
+  Dart_Port service_port = bin::IOService::GetServicePort();
+  FileReadCompletions::Expect(kFileReadRequests);
+
+  Timer timer(true, "File Reads");
+  timer.Start();
+  for (intptr_t i = 0; i < kFileReadRequests; i++) {
+    // Each request releases a reference to the file when it completes.
+    file->Retain();
+    if (use_file_io_pool) {
+      bin::FileIOPool::Read(file, kFileReadLength, i, reply_port);
+      continue;
+    }
+    Dart_CObject id;
+    id.type = Dart_CObject_kInt32;
+    id.value.as_int32 = i;
+    Dart_CObject reply;
+    reply.type = Dart_CObject_kSendPort;
+    reply.value.as_send_port.id = reply_port;
+    reply.value.as_send_port.origin_id = ILLEGAL_PORT;
+    Dart_CObject request;
+    request.type = Dart_CObject_kInt32;
+    request.value.as_int32 = bin::IOService::kFileReadRequest;
+    Dart_CObject pointer;
+    pointer.type = Dart_CObject_kInt64;
+    pointer.value.as_int64 = reinterpret_cast<intptr_t>(file);
+    Dart_CObject length;
+    length.type = Dart_CObject_kInt64;
+    length.value.as_int64 = kFileReadLength;
+    Dart_CObject* data_values[] = {&pointer, &length};
+    Dart_CObject data;
+    data.type = Dart_CObject_kArray;
+    data.value.as_array.length = ARRAY_SIZE(data_values);
+    data.value.as_array.values = data_values;
+    Dart_CObject* message_values[] = {&id, &reply, &request, &data};
+    Dart_CObject message;
+    message.type = Dart_CObject_kArray;
+    message.value.as_array.length = ARRAY_SIZE(message_values);
+    message.value.as_array.values = message_values;
+    EXPECT(Dart_PostCObject(service_port, &message));
+  }
+  FileReadCompletions::Wait();
+  timer.Stop();
+  benchmark->set_score(timer.TotalElapsedTime());
+
+  Dart_CloseNativePort(service_port);
+  Dart_CloseNativePort(reply_port);
+  file->Release();
+}
+
+BENCHMARK(FileReadsIOService) {
+  RunFileReads(benchmark, false);
+}
+
+BENCHMARK(FileReadsIOPool) {
+  RunFileReads(benchmark, true);
+}
+#endif  // !defined(DART_IO_SECURE_SOCKET_DISABLED)
+
+#if defined(HOST_OS_LINUX)
+// Bounces messages over loopback TCP connections through the event handler,
+// the way a proxy forwards requests and responses: each end stops reading
+// while it forwards a message, and the client ends count round trips.
+class LoopbackPingPong : public AllStatic {
+ public:
+  static const intptr_t kConnections = 16;
+  static const intptr_t kRoundTrips = 1000;
+  static const intptr_t kMessageSize = 512;
+
+  static void Run(Benchmark* benchmark) {
+    intptr_t listen_fd = NO_RETRY_EXPECTED(socket(AF_INET, SOCK_STREAM, 0));
+    EXPECT(listen_fd >= 0);
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t addr_len = sizeof(addr);
+    EXPECT_EQ(0, bind(listen_fd, reinterpret_cast<sockaddr*>(&addr),
+                      addr_len));
+    EXPECT_EQ(0, listen(listen_fd, kConnections));
+    EXPECT_EQ(0, getsockname(listen_fd, reinterpret_cast<sockaddr*>(&addr),
+                             &addr_len));
+    for (intptr_t i = 0; i < kConnections; i++) {
+      intptr_t client_fd =
+          NO_RETRY_EXPECTED(socket(AF_INET, SOCK_STREAM, 0));
+      EXPECT_EQ(0, NO_RETRY_EXPECTED(connect(
+                       client_fd, reinterpret_cast<sockaddr*>(&addr),
+                       addr_len)));
+      intptr_t server_fd =
+          NO_RETRY_EXPECTED(accept(listen_fd, NULL, NULL));
+      EXPECT(server_fd >= 0);
+      InitEnd(&ends_[2 * i], client_fd, true);
+      InitEnd(&ends_[2 * i + 1], server_fd, false);
+    }
+    VOID_TEMP_FAILURE_RETRY(close(listen_fd));
+
+    bin::MonitorLocker ml(monitor_);
+    pending_ = kConnections;
+    Timer timer(true, "Loopback Ping Pong");
+    timer.Start();
+    for (intptr_t i = 0; i < 2 * kConnections; i++) {
+      Send(&ends_[i], 1 << bin::kSetEventMaskCommand | 1 << bin::kInEvent);
+      if (ends_[i].is_client) {
+        Write(&ends_[i]);
+      }
+    }
+    while (pending_ > 0) {
+      ml.Wait();
+    }
+    timer.Stop();
+    benchmark->set_score(timer.TotalElapsedTime());
+
+    pending_ = 2 * kConnections;
+    for (intptr_t i = 0; i < 2 * kConnections; i++) {
+      Send(&ends_[i], 1 << bin::kCloseCommand);
+    }
+    while (pending_ > 0) {
+      ml.Wait();
+    }
+    for (intptr_t i = 0; i < 2 * kConnections; i++) {
+      Dart_CloseNativePort(ends_[i].port);
+      ends_[i].socket->Release();
+    }
+  }
+
+ private:
+  struct End {
+    bin::Socket* socket;
+    Dart_Port port;
+    bool is_client;
+    intptr_t received;
+    intptr_t round_trips;
+  };
+
+  static void InitEnd(End* end, intptr_t fd, bool is_client) {
+    int no_delay = 1;
+    EXPECT_EQ(0, setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &no_delay,
+                            sizeof(no_delay)));
+    EXPECT(bin::FDUtils::SetNonBlocking(fd));
+    end->socket = new bin::Socket(fd);
+    end->port = Dart_NewNativePort("LoopbackPingPong", HandleEvents, false);
+    EXPECT(end->port != ILLEGAL_PORT);
+    end->is_client = is_client;
+    end->received = 0;
+    end->round_trips = 0;
+  }
+
+  // Sends a command for the end to the event handler, which releases a
+  // reference to its socket.
+  static void Send(End* end, int64_t data) {
+    end->socket->Retain();
+    bin::EventHandler::SendFromNative(reinterpret_cast<intptr_t>(end->socket),
+                                      end->port, data);
+  }
+
+  static void Write(End* end) {
+    uint8_t message[kMessageSize];
+    memset(message, 0, sizeof(message));
+    // The socket buffers have room for a whole message.
+    EXPECT_EQ(kMessageSize,
+              NO_RETRY_EXPECTED(write(end->socket->fd(), message,
+                                      kMessageSize)));
+  }
+
+  static void HandleEvents(Dart_Port port, Dart_CObject* message) {
+    End* end = NULL;
+    for (intptr_t i = 0; i < 2 * kConnections; i++) {
+      if (ends_[i].port == port) {
+        end = &ends_[i];
+      }
+    }
+    ASSERT(end != NULL);
+    ASSERT(message->type == Dart_CObject_kInt32);
+    const int32_t events = message->value.as_int32;
+    if ((events & (1 << bin::kDestroyedEvent)) != 0) {
+      Complete();
+      return;
+    }
+    if ((events & (1 << bin::kInEvent)) == 0) {
+      return;
+    }
+    // Take all the data, as the event handler only reports new data.
+    uint8_t buffer[kMessageSize];
+    intptr_t messages = 0;
+    intptr_t bytes;
+    while ((bytes = NO_RETRY_EXPECTED(
+                read(end->socket->fd(), buffer, sizeof(buffer)))) > 0) {
+      end->received += bytes;
+      if (end->received >= kMessageSize) {
+        end->received -= kMessageSize;
+        messages++;
+      }
+    }
+    Send(end, 1 << bin::kReturnTokenCommand | 1);
+    if (messages == 0) {
+      return;
+    }
+    ASSERT(messages == 1);
+    if (end->is_client && (++end->round_trips == kRoundTrips)) {
+      Complete();
+      return;
+    }
+    Send(end, 1 << bin::kSetEventMaskCommand);
+    Write(end);
+    Send(end, 1 << bin::kSetEventMaskCommand | 1 << bin::kInEvent);
+  }
+
+  static void Complete() {
+    bin::MonitorLocker ml(monitor_);
+    pending_--;
+    if (pending_ == 0) {
+      ml.Notify();
+    }
+  }
+
+  static End ends_[2 * kConnections];
+  static bin::Monitor* monitor_;
+  static intptr_t pending_;
+};
+
+LoopbackPingPong::End LoopbackPingPong::ends_[2 * kConnections];
+bin::Monitor* LoopbackPingPong::monitor_ = new bin::Monitor();
+intptr_t LoopbackPingPong::pending_ = 0;
+
+// Restarts the event handler with or without io_uring around the benchmark.
+static void RunLoopbackPingPong(Benchmark* benchmark, bool use_io_uring) {
+  bin::EventHandler::Stop();
+  bin::EventHandler::set_use_io_uring(use_io_uring);
+  bin::EventHandler::Start();
+  LoopbackPingPong::Run(benchmark);
+  bin::EventHandler::Stop();
+  bin::EventHandler::set_use_io_uring(false);
+  bin::EventHandler::Start();
+}
+
+BENCHMARK(LoopbackPingPongEpoll) {
+  RunLoopbackPingPong(benchmark, false);
+}
+
+BENCHMARK(LoopbackPingPongIOUring) {
+  RunLoopbackPingPong(benchmark, true);
+}
+#endif  // defined(HOST_OS_LINUX)
+
 BENCHMARK_MEMORY(InitialRSS) {
   benchmark->set_score(bin::Process::MaxRSS());
 }
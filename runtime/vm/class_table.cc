@@ -430,11 +430,14 @@ void ClassTable::UpdateAllocatedNew(intptr_t cid, intptr_t size) {
   stats->recent.AddNew(size);
 }
 
-void ClassTable::UpdateAllocatedOld(intptr_t cid, intptr_t size) {
+void ClassTable::UpdateAllocatedOld(intptr_t cid,
+                                    intptr_t size,
+                                    intptr_t count) {
   ClassHeapStats* stats = PreliminaryStatsAt(cid);
   ASSERT(stats != NULL);
   ASSERT(size != 0);
-  stats->recent.AddOld(size);
+  ASSERT(count >= 0);
+  stats->recent.AddOld(size, count);
 }
 
 void ClassTable::UpdateAllocatedExternalNew(intptr_t cid, intptr_t size) {
@@ -598,11 +601,12 @@ void ClassTable::UpdateLiveOld(intptr_t cid, intptr_t size, intptr_t count) {
   stats->post_gc.AddOld(size, count);
 }
 
-void ClassTable::UpdateLiveNew(intptr_t cid, intptr_t size) {
+void ClassTable::UpdateLiveNew(intptr_t cid, intptr_t size, intptr_t count) {
   ClassHeapStats* stats = PreliminaryStatsAt(cid);
   ASSERT(stats != NULL);
   ASSERT(size >= 0);
-  stats->post_gc.AddNew(size);
+  ASSERT(count >= 0);
+  stats->post_gc.AddNew(size, count);
 }
 
 void ClassTable::UpdateLiveOldExternal(intptr_t cid, intptr_t size) {
@@ -63,8 +63,8 @@ class AllocStats {
     new_external_size = 0;
   }
 
-  void AddNew(T size) {
-    AtomicOperations::IncrementBy(&new_count, 1);
+  void AddNew(T size, T count = 1) {
+    AtomicOperations::IncrementBy(&new_count, count);
     AtomicOperations::IncrementBy(&new_size, size);
   }
 
@@ -252,7 +252,7 @@ class ClassTable {
 #ifndef PRODUCT
   // Called whenever a class is allocated in the runtime.
   void UpdateAllocatedNew(intptr_t cid, intptr_t size);
-  void UpdateAllocatedOld(intptr_t cid, intptr_t size);
+  void UpdateAllocatedOld(intptr_t cid, intptr_t size, intptr_t count = 1);
 
   void UpdateAllocatedExternalNew(intptr_t cid, intptr_t size);
   void UpdateAllocatedExternalOld(intptr_t cid, intptr_t size);
@@ -295,7 +295,9 @@ class ClassTable {
  private:
   friend class GCMarker;
   friend class MarkingWeakVisitor;
-  friend class ScavengerVisitor;
+  friend class ScavengerClassStats;
+  template <bool>
+  friend class ScavengerVisitorBase;
   friend class ScavengerWeakVisitor;
   friend class ClassHeapStatsTestHelper;
   static const int initial_capacity_ = 512;
@@ -317,7 +319,7 @@ class ClassTable {
   // May not have updated size for variable size classes.
   ClassHeapStats* PreliminaryStatsAt(intptr_t cid);
   void UpdateLiveOld(intptr_t cid, intptr_t size, intptr_t count = 1);
-  void UpdateLiveNew(intptr_t cid, intptr_t size);
+  void UpdateLiveNew(intptr_t cid, intptr_t size, intptr_t count = 1);
   void UpdateLiveOldExternal(intptr_t cid, intptr_t size);
   void UpdateLiveNewExternal(intptr_t cid, intptr_t size);
 #endif  // !PRODUCT
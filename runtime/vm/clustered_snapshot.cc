@@ -602,6 +602,7 @@ class FunctionDeserializationCluster : public DeserializationCluster {
         func->ptr()->usage_counter_ = 0;
         func->ptr()->optimized_instruction_count_ = 0;
         func->ptr()->optimized_call_site_count_ = 0;
+        func->ptr()->non_escaping_parameters_ = 0;
         func->ptr()->deoptimization_counter_ = 0;
         func->ptr()->state_bits_ = 0;
         func->ptr()->inlining_depth_ = 0;
@@ -8,6 +8,7 @@
 #include "vm/log.h"
 #include "vm/longjump.h"
 #include "vm/object_store.h"
+#include "vm/os.h"
 #include "vm/resolver.h"
 #include "vm/symbols.h"
 
@@ -316,6 +317,437 @@ RawObject* CompilationTraceLoader::EvaluateInitializer(const Field& field) {
   return Object::null();
 }
 
+static const char* kTypeFeedbackHeader = "dart-type-feedback-v1";
+
+// The most fields on a line, which is a call site testing two arguments.
+static const intptr_t kMaxTypeFeedbackFields = 9;
+
+// Format, one record per line after the header:
+//   F,<uri>,<class>,<function>,<fingerprint>,<usage>
+//   I,<deopt id>,<target>,<args tested>,<count>,<uri>,<class>[,<uri>,<class>]
+//   G,<uri>,<class>,<field>,<guarded uri>,<guarded class>
+// Call sites belong to the preceding function. A field guarded by dynamic has
+// an empty guarded class.
+TypeFeedbackSaver::TypeFeedbackSaver(Zone* zone)
+    : zone_(zone),
+      buf_(zone, 16 * KB),
+      cls_name_(String::Handle(zone)),
+      lib_(Library::Handle(zone)),
+      uri_(String::Handle(zone)),
+      fields_(Array::Handle(zone)),
+      field_(Field::Handle(zone)),
+      functions_(Array::Handle(zone)),
+      function_(Function::Handle(zone)),
+      name_(String::Handle(zone)),
+      ic_data_array_(Array::Handle(zone)),
+      ic_data_(ICData::Handle(zone)),
+      key_cls_(Class::Handle(zone)),
+      key_lib_(Library::Handle(zone)),
+      key_name_(String::Handle(zone)),
+      key_uri_(String::Handle(zone)) {
+  buf_.Printf("%s\n", kTypeFeedbackHeader);
+}
+
+void TypeFeedbackSaver::Visit(const Class& cls) {
+  if (!cls.is_finalized()) {
+    return;  // Nothing compiled or stored yet.
+  }
+  cls_name_ = cls.Name();
+  cls_name_ = String::RemovePrivateKey(cls_name_);
+  lib_ = cls.library();
+  uri_ = lib_.url();
+
+  fields_ = cls.fields();
+  for (intptr_t i = 0; i < fields_.Length(); i++) {
+    field_ ^= fields_.At(i);
+    VisitField(field_);
+  }
+  functions_ = cls.functions();
+  for (intptr_t i = 0; i < functions_.Length(); i++) {
+    function_ ^= functions_.At(i);
+    VisitFunction(function_);
+  }
+}
+
+void TypeFeedbackSaver::VisitField(const Field& field) {
+  if (field.is_static() || (field.guarded_cid() == kIllegalCid)) {
+    return;
+  }
+  name_ = field.name();
+  name_ = String::RemovePrivateKey(name_);
+  const char* guarded = ",";
+  if (field.guarded_cid() != kDynamicCid) {
+    guarded = ClassKey(field.guarded_cid());
+    if (guarded == NULL) {
+      return;
+    }
+  }
+  buf_.Printf("G,%s,%s,%s,%s\n", uri_.ToCString(), cls_name_.ToCString(),
+              name_.ToCString(), guarded);
+}
+
+void TypeFeedbackSaver::VisitFunction(const Function& function) {
+  if (!function.HasCode()) {
+    return;  // Not compiled.
+  }
+  if (function.parent_function() != Function::null()) {
+    return;  // See CompilationTraceSaver::Visit.
+  }
+
+  // Optimizing resets the usage counter, so optimized functions are recorded
+  // as just hot enough to be optimized again.
+  intptr_t usage = function.HasOptimizedCode()
+                       ? FLAG_optimization_counter_threshold
+                       : Utils::Maximum<intptr_t>(0, function.usage_counter());
+  name_ = function.name();
+  name_ = String::RemovePrivateKey(name_);
+  buf_.Printf("F,%s,%s,%s,%" Pd32 ",%" Pd "\n", uri_.ToCString(),
+              cls_name_.ToCString(), name_.ToCString(),
+              function.SourceFingerprint(), usage);
+
+  ic_data_array_ = function.ic_data_array();
+  if (ic_data_array_.IsNull()) {
+    return;
+  }
+  GrowableArray<intptr_t> class_ids(2);
+  const char* keys[2];
+  // The first element is the edge counters.
+  for (intptr_t i = 1; i < ic_data_array_.Length(); i++) {
+    ic_data_ ^= ic_data_array_.At(i);
+    const intptr_t num_args = ic_data_.NumArgsTested();
+    if ((ic_data_.rebind_rule() != ICData::kInstance) || (num_args < 1) ||
+        (num_args > 2)) {
+      continue;
+    }
+    name_ = ic_data_.target_name();
+    name_ = String::RemovePrivateKey(name_);
+    for (intptr_t j = 0; j < ic_data_.NumberOfChecks(); j++) {
+      const intptr_t count = ic_data_.GetCountAt(j);
+      if (count == 0) {
+        continue;
+      }
+      ic_data_.GetClassIdsAt(j, &class_ids);
+      bool found = true;
+      for (intptr_t k = 0; k < num_args; k++) {
+        keys[k] = ClassKey(class_ids[k]);
+        found = found && (keys[k] != NULL);
+      }
+      if (!found) {
+        continue;
+      }
+      buf_.Printf("I,%" Pd ",%s,%" Pd ",%" Pd ",%s", ic_data_.deopt_id(),
+                  name_.ToCString(), num_args, count, keys[0]);
+      if (num_args == 2) {
+        buf_.Printf(",%s", keys[1]);
+      }
+      buf_.Printf("\n");
+    }
+  }
+}
+
+// Returns "<uri>,<class>" for 'cid' or NULL if it is not a library class.
+const char* TypeFeedbackSaver::ClassKey(intptr_t cid) {
+  ClassTable* class_table = Isolate::Current()->class_table();
+  if (!class_table->HasValidClassAt(cid)) {
+    return NULL;
+  }
+  key_cls_ = class_table->At(cid);
+  key_lib_ = key_cls_.library();
+  if (key_lib_.IsNull()) {
+    return NULL;
+  }
+  key_name_ = key_cls_.Name();
+  key_name_ = String::RemovePrivateKey(key_name_);
+  key_uri_ = key_lib_.url();
+  return OS::SCreate(zone_, "%s,%s", key_uri_.ToCString(),
+                     key_name_.ToCString());
+}
+
+TypeFeedbackLoader::TypeFeedbackLoader(Thread* thread)
+    : thread_(thread),
+      zone_(thread->zone()),
+      uri_(String::Handle(zone_)),
+      class_name_(String::Handle(zone_)),
+      name_(String::Handle(zone_)),
+      lib_(Library::Handle(zone_)),
+      cls_(Class::Handle(zone_)),
+      lookup_cls_(Class::Handle(zone_)),
+      function_(Function::Handle(zone_)),
+      target_(Function::Handle(zone_)),
+      field_(Field::Handle(zone_)),
+      ic_data_array_(Array::Handle(zone_)),
+      ic_data_(ICData::Handle(zone_)),
+      args_desc_array_(Array::Handle(zone_)),
+      error_(Object::Handle(zone_)),
+      hot_functions_() {}
+
+// Splits 'line' at commas in place. Returns the number of fields, or -1 if
+// there are more than 'max_fields'.
+static intptr_t SplitFields(char* line, char** fields, intptr_t max_fields) {
+  intptr_t num_fields = 0;
+  fields[num_fields++] = line;
+  for (char* c = line; *c != '\0'; c++) {
+    if (*c == ',') {
+      if (num_fields == max_fields) {
+        return -1;
+      }
+      *c = '\0';
+      fields[num_fields++] = c + 1;
+    }
+  }
+  return num_fields;
+}
+
+static bool HasCheck(const ICData& ic_data,
+                     const GrowableArray<intptr_t>& class_ids) {
+  GrowableArray<intptr_t> check(2);
+  for (intptr_t i = 0; i < ic_data.NumberOfChecks(); i++) {
+    ic_data.GetClassIdsAt(i, &check);
+    bool matches = true;
+    for (intptr_t k = 0; k < class_ids.length(); k++) {
+      matches = matches && (check[k] == class_ids[k]);
+    }
+    if (matches) {
+      return true;
+    }
+  }
+  return false;
+}
+
+static bool ParseInt(const char* field, int64_t* value) {
+  return (field[0] != '\0') && OS::StringToInt64(field, value);
+}
+
+RawObject* TypeFeedbackLoader::LoadFeedback(uint8_t* buffer, intptr_t size) {
+  char* cursor = reinterpret_cast<char*>(buffer);
+  char* limit = cursor + size;
+  char* newline = FindCharacter(cursor, '\n', limit);
+  const intptr_t header_length = strlen(kTypeFeedbackHeader);
+  if ((newline == NULL) || (newline - cursor != header_length) ||
+      (strncmp(cursor, kTypeFeedbackHeader, header_length) != 0)) {
+    return ApiError::New(
+        String::Handle(zone_, String::New("Invalid type feedback header")));
+  }
+  cursor = newline + 1;
+
+  char* fields[kMaxTypeFeedbackFields];
+  while (cursor < limit) {
+    newline = FindCharacter(cursor, '\n', limit);
+    if (newline == NULL) {
+      break;
+    }
+    *newline = '\0';
+    intptr_t num_fields = SplitFields(cursor, fields, kMaxTypeFeedbackFields);
+    cursor = newline + 1;
+    if (num_fields < 1) {
+      continue;
+    }
+    if (strcmp(fields[0], "F") == 0) {
+      error_ = LoadFunction(fields, num_fields);
+      if (error_.IsError()) {
+        return error_.raw();
+      }
+    } else if (strcmp(fields[0], "I") == 0) {
+      LoadCallSite(fields, num_fields);
+    } else if (strcmp(fields[0], "G") == 0) {
+      LoadField(fields, num_fields);
+    }
+  }
+
+  QueueHotFunctions();
+  return Object::null();
+}
+
+RawClass* TypeFeedbackLoader::LookupClass(const char* uri_cstr,
+                                          const char* cls_cstr) {
+  uri_ = Symbols::New(thread_, uri_cstr);
+  lib_ = Library::LookupLibrary(thread_, uri_);
+  if (lib_.IsNull()) {
+    return Class::null();
+  }
+  class_name_ = Symbols::New(thread_, cls_cstr);
+  if (class_name_.Equals(Symbols::TopLevel())) {
+    return lib_.toplevel_class();
+  }
+  lookup_cls_ = lib_.SlowLookupClassAllowMultiPartPrivate(class_name_);
+  if (lookup_cls_.IsNull()) {
+    return Class::null();
+  }
+  if (lookup_cls_.EnsureIsFinalized(thread_) != Error::null()) {
+    return Class::null();
+  }
+  return lookup_cls_.raw();
+}
+
+RawObject* TypeFeedbackLoader::LoadFunction(char** fields,
+                                            intptr_t num_fields) {
+  // Call sites that follow are ignored unless a function is found.
+  function_ = Function::null();
+  ic_data_array_ = Array::null();
+  int64_t fingerprint = 0;
+  int64_t usage = 0;
+  if ((num_fields != 6) || !ParseInt(fields[4], &fingerprint) ||
+      !ParseInt(fields[5], &usage)) {
+    return Object::null();
+  }
+  cls_ = LookupClass(fields[1], fields[2]);
+  if (cls_.IsNull()) {
+    return Object::null();
+  }
+  name_ = Symbols::New(thread_, fields[3]);
+  function_ = cls_.LookupFunctionAllowPrivate(name_);
+  if (function_.IsNull() || function_.is_abstract()) {
+    if (FLAG_trace_compilation_trace) {
+      THR_Print("Type feedback: missing function %s,%s,%s\n", fields[1],
+                fields[2], fields[3]);
+    }
+    function_ = Function::null();
+    return Object::null();
+  }
+  if (!function_.HasCode()) {
+    error_ = Compiler::CompileFunction(thread_, function_);
+    if (error_.IsError()) {
+      function_ = Function::null();
+      return error_.raw();
+    }
+  }
+  if (fingerprint != function_.SourceFingerprint()) {
+    // Deopt ids no longer match the recorded call sites.
+    if (FLAG_trace_compilation_trace) {
+      THR_Print("Type feedback: changed function %s,%s,%s\n", fields[1],
+                fields[2], fields[3]);
+    }
+    function_ = Function::null();
+    return Object::null();
+  }
+
+  if (usage > function_.usage_counter()) {
+    function_.SetUsageCounter(static_cast<intptr_t>(usage));
+  }
+  if (usage >= FLAG_optimization_counter_threshold) {
+    hot_functions_.Add(&Function::ZoneHandle(zone_, function_.raw()));
+  }
+  ic_data_array_ = function_.ic_data_array();
+  return Object::null();
+}
+
+void TypeFeedbackLoader::LoadCallSite(char** fields, intptr_t num_fields) {
+  int64_t deopt_id = 0;
+  int64_t num_args = 0;
+  int64_t count = 0;
+  if (ic_data_array_.IsNull() || (num_fields < 5) ||
+      !ParseInt(fields[1], &deopt_id) || !ParseInt(fields[3], &num_args) ||
+      !ParseInt(fields[4], &count)) {
+    return;
+  }
+  if ((num_args < 1) || (num_args > 2) || (count <= 0) ||
+      (num_fields != 5 + 2 * num_args)) {
+    return;
+  }
+
+  // The first element is the edge counters.
+  ic_data_ = ICData::null();
+  for (intptr_t i = 1; i < ic_data_array_.Length(); i++) {
+    ic_data_ ^= ic_data_array_.At(i);
+    if (ic_data_.deopt_id() == deopt_id) {
+      break;
+    }
+    ic_data_ = ICData::null();
+  }
+  if (ic_data_.IsNull() || (ic_data_.rebind_rule() != ICData::kInstance) ||
+      (ic_data_.NumArgsTested() != num_args) ||
+      ic_data_.IsTrackingExactness()) {
+    return;
+  }
+  name_ = ic_data_.target_name();
+  name_ = String::RemovePrivateKey(name_);
+  if (!name_.Equals(fields[2])) {
+    return;
+  }
+
+  GrowableArray<intptr_t> class_ids(2);
+  for (intptr_t i = 0; i < num_args; i++) {
+    cls_ = LookupClass(fields[5 + 2 * i], fields[6 + 2 * i]);
+    if (cls_.IsNull()) {
+      return;
+    }
+    class_ids.Add(cls_.id());
+  }
+  if (HasCheck(ic_data_, class_ids)) {
+    return;  // Already seen in this run.
+  }
+
+  // Resolve as the IC miss handler would in this program.
+  cls_ = thread_->isolate()->class_table()->At(class_ids[0]);
+  name_ = ic_data_.target_name();
+  args_desc_array_ = ic_data_.arguments_descriptor();
+  ArgumentsDescriptor args_desc(args_desc_array_);
+  target_ = Resolver::ResolveDynamicForReceiverClass(cls_, name_, args_desc);
+  if (target_.IsNull()) {
+    return;  // noSuchMethod is handled by the miss handler.
+  }
+  if (num_args == 1) {
+    ic_data_.AddReceiverCheck(class_ids[0], target_,
+                              static_cast<intptr_t>(count));
+  } else {
+    ic_data_.AddCheck(class_ids, target_, static_cast<intptr_t>(count));
+  }
+}
+
+void TypeFeedbackLoader::LoadField(char** fields, intptr_t num_fields) {
+  if (!FLAG_use_field_guards || (num_fields != 6)) {
+    return;
+  }
+  cls_ = LookupClass(fields[1], fields[2]);
+  if (cls_.IsNull()) {
+    return;
+  }
+  name_ = Symbols::New(thread_, fields[3]);
+  field_ = cls_.LookupFieldAllowPrivate(name_);
+  if (field_.IsNull() || field_.is_static() ||
+      (field_.guarded_cid() != kIllegalCid)) {
+    return;  // Missing, or already stored to in this run.
+  }
+  intptr_t guarded_cid = kDynamicCid;
+  if (fields[4][0] != '\0') {
+    cls_ = LookupClass(fields[4], fields[5]);
+    if (cls_.IsNull()) {
+      return;
+    }
+    guarded_cid = cls_.id();
+    if ((guarded_cid == kIntegerCid) && !Field::SupportsIntegerGuards()) {
+      guarded_cid = kDynamicCid;
+    }
+  }
+  // Nullability and list lengths are only tracked from the first store, so
+  // be conservative about them. This also keeps the field boxed.
+  field_.set_guarded_cid(guarded_cid);
+  field_.set_is_nullable(true);
+  field_.set_guarded_list_length(Field::kNoFixedLength);
+  field_.InitializeGuardedListLengthInObjectOffset();
+}
+
+void TypeFeedbackLoader::QueueHotFunctions() {
+  Isolate* isolate = thread_->isolate();
+  if (hot_functions_.is_empty() || !FLAG_background_compilation ||
+      BackgroundCompiler::IsDisabled(isolate)) {
+    // The restored usage counters trigger optimization on the next call.
+    return;
+  }
+  BackgroundCompiler::Start(isolate);
+  for (intptr_t i = 0; i < hot_functions_.length(); i++) {
+    const Function& function = *hot_functions_[i];
+    if (!function.HasCode() || function.HasOptimizedCode() ||
+        !function.IsOptimizable() || !function.is_background_optimizable()) {
+      continue;
+    }
+    // As in the runtime's optimization entry, keep the function from
+    // requesting optimization again while it waits in the queue.
+    function.SetUsageCounter(INT_MIN);
+    isolate->background_compiler()->CompileOptimized(function);
+  }
+}
+
 #endif  // !defined(DART_PRECOMPILED_RUNTIME)
 
 }  // namespace dart
@@ -59,6 +59,79 @@ class CompilationTraceLoader : public ValueObject {
   Object& error_;
 };
 
+// Records the type feedback gathered by unoptimized code: the receiver classes
+// seen at instance calls, the guarded classes of instance fields and how hot
+// each function is. Class ids are not stable across runs, so classes are
+// recorded by library URI and name.
+class TypeFeedbackSaver : public ClassVisitor {
+ public:
+  explicit TypeFeedbackSaver(Zone* zone);
+  void Visit(const Class& cls);
+
+  void StealBuffer(uint8_t** buffer, intptr_t* buffer_length) {
+    *buffer = reinterpret_cast<uint8_t*>(buf_.buffer());
+    *buffer_length = buf_.length();
+  }
+
+ private:
+  void VisitField(const Field& field);
+  void VisitFunction(const Function& function);
+  const char* ClassKey(intptr_t cid);
+
+  Zone* zone_;
+  ZoneTextBuffer buf_;
+  String& cls_name_;
+  Library& lib_;
+  String& uri_;
+  Array& fields_;
+  Field& field_;
+  Array& functions_;
+  Function& function_;
+  String& name_;
+  Array& ic_data_array_;
+  ICData& ic_data_;
+  Class& key_cls_;
+  Library& key_lib_;
+  String& key_name_;
+  String& key_uri_;
+};
+
+// Restores the feedback recorded by TypeFeedbackSaver in a program with
+// matching sources. Functions whose source fingerprint changed are compiled
+// but get no feedback. Functions that were hot are queued for optimization in
+// the background, or optimized on their next call if there is no background
+// compiler.
+class TypeFeedbackLoader : public ValueObject {
+ public:
+  explicit TypeFeedbackLoader(Thread* thread);
+
+  RawObject* LoadFeedback(uint8_t* buffer, intptr_t buffer_length);
+
+ private:
+  RawClass* LookupClass(const char* uri_cstr, const char* cls_cstr);
+  RawObject* LoadFunction(char** fields, intptr_t num_fields);
+  void LoadCallSite(char** fields, intptr_t num_fields);
+  void LoadField(char** fields, intptr_t num_fields);
+  void QueueHotFunctions();
+
+  Thread* thread_;
+  Zone* zone_;
+  String& uri_;
+  String& class_name_;
+  String& name_;
+  Library& lib_;
+  Class& cls_;
+  Class& lookup_cls_;
+  Function& function_;
+  Function& target_;
+  Field& field_;
+  Array& ic_data_array_;
+  ICData& ic_data_;
+  Array& args_desc_array_;
+  Object& error_;
+  GrowableArray<const Function*> hot_functions_;
+};
+
 }  // namespace dart
 
 #endif  // RUNTIME_VM_COMPILATION_TRACE_H_
@@ -2352,6 +2352,8 @@ bool PrecompileParsedFunctionHelper::Compile(CompilationPipeline* pipeline) {
         // At the moment we are leaking CodeStatistics objects for
         // simplicity because this is just a development mode flag.
         function_stats = new CodeStatistics(&assembler);
+        function_stats->set_eliminated_bounds_checks(
+            flow_graph->eliminated_bounds_checks());
       }
 
       FlowGraphCompiler graph_compiler(
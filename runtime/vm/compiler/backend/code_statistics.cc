@@ -12,6 +12,7 @@ CombinedCodeStatistics::CombinedCodeStatistics() {
   object_header_bytes_ = 0;
   return_const_count_ = 0;
   return_const_with_load_field_count_ = 0;
+  eliminated_bounds_checks_ = 0;
   intptr_t i = 0;
 
 #define DO(type, attrs)                                                        \
@@ -104,6 +105,8 @@ void CombinedCodeStatistics::DumpStatistics() {
   OS::PrintErr("% 8" Pd " return-constant functions\n", return_const_count_);
   OS::PrintErr("% 8" Pd " return-constant-with-load-field functions\n",
                return_const_with_load_field_count_);
+  OS::PrintErr("% 8" Pd " eliminated bounds checks\n",
+               eliminated_bounds_checks_);
   OS::PrintErr("--------------------\n");
 }
 
@@ -124,6 +127,7 @@ CodeStatistics::CodeStatistics(Assembler* assembler) : assembler_(assembler) {
   instruction_bytes_ = 0;
   unaccounted_bytes_ = 0;
   alignment_bytes_ = 0;
+  eliminated_bounds_checks_ = 0;
 
   stack_index_ = -1;
   for (intptr_t i = 0; i < kStackSize; i++)
@@ -200,6 +204,7 @@ void CodeStatistics::AppendTo(CombinedCodeStatistics* stat) {
   ASSERT(stat->unaccounted_bytes_ >= 0);
   stat->alignment_bytes_ += alignment_bytes_;
   stat->object_header_bytes_ += Instructions::HeaderSize();
+  stat->eliminated_bounds_checks_ += eliminated_bounds_checks_;
 
   if (returns_constant) stat->return_const_count_++;
   if (returns_const_with_load_field_) {
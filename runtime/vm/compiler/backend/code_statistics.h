@@ -63,6 +63,7 @@ class CombinedCodeStatistics {
   intptr_t object_header_bytes_;
   intptr_t return_const_count_;
   intptr_t return_const_with_load_field_count_;
+  intptr_t eliminated_bounds_checks_;
 };
 
 class CodeStatistics {
@@ -79,6 +80,12 @@ class CodeStatistics {
 
   void Finalize();
 
+  // Records the number of bounds checks the optimizer removed from the
+  // function.
+  void set_eliminated_bounds_checks(intptr_t count) {
+    eliminated_bounds_checks_ = count;
+  }
+
  private:
   static const int kStackSize = 8;
 
@@ -93,6 +100,7 @@ class CodeStatistics {
   intptr_t instruction_bytes_;
   intptr_t unaccounted_bytes_;
   intptr_t alignment_bytes_;
+  intptr_t eliminated_bounds_checks_;
 
   intptr_t stack_[kStackSize];
   intptr_t stack_index_;
@@ -57,8 +57,10 @@ FlowGraph::FlowGraph(const ParsedFunction& parsed_function,
       loop_invariant_loads_(nullptr),
       deferred_prefixes_(parsed_function.deferred_prefixes()),
       await_token_positions_(nullptr),
+      reoptimizing_call_sites_(),
       captured_parameters_(new (zone()) BitVector(zone(), variable_count())),
       inlining_id_(-1),
+      eliminated_bounds_checks_(0),
       should_print_(FlowGraphPrinter::ShouldPrint(parsed_function.function())) {
   DiscoverBlocks();
 }
@@ -121,6 +123,15 @@ void FlowGraph::AddToDeferredPrefixes(
   }
 }
 
+void FlowGraph::AddReoptimizingCallSite(const ICData& ic_data) {
+  for (intptr_t i = 0; i < reoptimizing_call_sites_.length(); i++) {
+    if (reoptimizing_call_sites_[i]->raw() == ic_data.raw()) {
+      return;
+    }
+  }
+  reoptimizing_call_sites_.Add(&ICData::ZoneHandle(zone(), ic_data.raw()));
+}
+
 bool FlowGraph::ShouldReorderBlocks(const Function& function,
                                     bool is_optimized) {
   return is_optimized && FLAG_reorder_basic_blocks && !function.is_intrinsic();
@@ -654,22 +665,50 @@ bool LivenessAnalysis::UpdateLiveIn(const BlockEntryInstr& block) {
 
 void LivenessAnalysis::ComputeLiveInAndLiveOutSets() {
   const intptr_t block_count = postorder_.length();
-  bool changed;
-  do {
-    changed = false;
 
-    for (intptr_t i = 0; i < block_count; i++) {
-      const BlockEntryInstr& block = *postorder_[i];
-
-      // Live-in set depends only on kill set which does not
-      // change in this loop and live-out set.  If live-out
-      // set does not change there is no need to recompute
-      // live-in set.
-      if (UpdateLiveOut(block) && UpdateLiveIn(block)) {
-        changed = true;
+  // Collect the predecessors along the edges followed by UpdateLiveOut,
+  // which include the edges from the graph entry to the catch entries.
+  GrowableArray<ZoneGrowableArray<intptr_t>*> predecessors(block_count);
+  for (intptr_t i = 0; i < block_count; i++) {
+    predecessors.Add(new (zone()) ZoneGrowableArray<intptr_t>(zone(), 2));
+  }
+  for (intptr_t i = 0; i < block_count; i++) {
+    Instruction* last = postorder_[i]->last_instruction();
+    for (intptr_t j = 0; j < last->SuccessorCount(); j++) {
+      predecessors[last->SuccessorAt(j)->postorder_number()]->Add(i);
+    }
+  }
+
+  // Sweeping over all blocks until nothing changes revisits every block
+  // of a large graph once per loop nesting level, so use a worklist
+  // instead. Blocks are initially popped in postorder, i.e. mostly after
+  // their successors.
+  GrowableArray<intptr_t> worklist(block_count);
+  BitVector* in_worklist = new (zone()) BitVector(zone(), block_count);
+  for (intptr_t i = block_count - 1; i >= 0; i--) {
+    worklist.Add(i);
+    in_worklist->Add(i);
+  }
+  while (!worklist.is_empty()) {
+    const intptr_t i = worklist.RemoveLast();
+    in_worklist->Remove(i);
+    const BlockEntryInstr& block = *postorder_[i];
+
+    // Live-in set depends only on kill set which does not
+    // change in this loop and live-out set.  If live-out
+    // set does not change there is no need to recompute
+    // live-in set.
+    if (UpdateLiveOut(block) && UpdateLiveIn(block)) {
+      ZoneGrowableArray<intptr_t>* preds = predecessors[i];
+      for (intptr_t j = 0; j < preds->length(); j++) {
+        const intptr_t pred = (*preds)[j];
+        if (!in_worklist->Contains(pred)) {
+          worklist.Add(pred);
+          in_worklist->Add(pred);
+        }
       }
     }
-  } while (changed);
+  }
 }
 
 void LivenessAnalysis::Analyze() {
@@ -326,11 +326,29 @@ class FlowGraph : public ZoneAllocated {
     return deferred_prefixes_;
   }
 
+  // Call sites whose polymorphic fallback counts calls towards reoptimizing
+  // the function. Their reoptimization budget is only charged once the code
+  // is installed, see CompileParsedFunctionHelper::FinalizeCompilation.
+  void AddReoptimizingCallSite(const ICData& ic_data);
+
+  const GrowableArray<const ICData*>& reoptimizing_call_sites() const {
+    return reoptimizing_call_sites_;
+  }
+
   BitVector* captured_parameters() const { return captured_parameters_; }
 
   intptr_t inlining_id() const { return inlining_id_; }
   void set_inlining_id(intptr_t value) { inlining_id_ = value; }
 
+  // Number of array bounds checks removed from the graph because they were
+  // proven redundant or were replaced by a check in a loop pre-header.
+  intptr_t eliminated_bounds_checks() const {
+    return eliminated_bounds_checks_;
+  }
+  void RecordEliminatedBoundsChecks(intptr_t count) {
+    eliminated_bounds_checks_ += count;
+  }
+
   // Returns true if any instructions were canonicalized away.
   bool Canonicalize();
 
@@ -519,10 +537,12 @@ class FlowGraph : public ZoneAllocated {
 
   ZoneGrowableArray<const LibraryPrefix*>* deferred_prefixes_;
   ZoneGrowableArray<TokenPosition>* await_token_positions_;
+  GrowableArray<const ICData*> reoptimizing_call_sites_;
   DirectChainedHashMap<ConstantPoolTrait> constant_instr_pool_;
   BitVector* captured_parameters_;
 
   intptr_t inlining_id_;
+  intptr_t eliminated_bounds_checks_;
   bool should_print_;
 };
 
@@ -574,7 +594,8 @@ class LivenessAnalysis : public ValueObject {
   bool UpdateLiveIn(const BlockEntryInstr& instr);
 
   // Perform fix-point iteration updating live-out and live-in sets
-  // for blocks until they stop changing.
+  // for blocks until they stop changing. Only the predecessors of blocks
+  // whose live-in set changed are revisited.
   void ComputeLiveInAndLiveOutSets();
 
   Zone* zone() const { return zone_; }
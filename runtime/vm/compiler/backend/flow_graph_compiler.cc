@@ -52,12 +52,18 @@ DEFINE_FLAG(int,
             min_optimization_counter_threshold,
             5000,
             "The minimum invocation count for a function.");
+DEFINE_FLAG(int,
+            baseline_optimization_counter_threshold,
+            2000,
+            "The invocation count at which a function is compiled in the "
+            "baseline tier, if enabled.");
 DEFINE_FLAG(int,
             optimization_counter_scale,
             2000,
             "The scale of invocation count, by size of the function.");
 DEFINE_FLAG(bool, source_lines, false, "Emit source line as assembly comment.");
 
+DECLARE_FLAG(bool, baseline_tier);
 DECLARE_FLAG(bool, code_comments);
 DECLARE_FLAG(charp, deoptimize_filter);
 DECLARE_FLAG(bool, intrinsify);
@@ -66,6 +72,7 @@ DECLARE_FLAG(int, reoptimization_counter_threshold);
 DECLARE_FLAG(int, stacktrace_every);
 DECLARE_FLAG(charp, stacktrace_filter);
 DECLARE_FLAG(bool, trace_compiler);
+DECLARE_FLAG(bool, unbox_int64_fields);
 
 // Assign locations to incoming arguments, i.e., values pushed above spill slots
 // with PushArgument.  Recursively allocates from outermost to innermost
@@ -124,6 +131,8 @@ FlowGraphCompiler::FlowGraphCompiler(
       deopt_infos_(),
       static_calls_target_table_(),
       is_optimizing_(is_optimizing),
+      is_baseline_(is_optimizing &&
+                   thread_->compiler_state().is_baseline_tier()),
       speculative_policy_(speculative_policy),
       may_reoptimize_(false),
       intrinsic_mode_(false),
@@ -165,11 +174,21 @@ FlowGraphCompiler::FlowGraphCompiler(
                            inline_id_to_token_pos, inline_id_to_function);
 }
 
+// An unboxed int64 field holds its value as a Smi if it fits, and otherwise
+// in a mutable Mint box private to the instance, which is updated with a
+// single word store.
+bool FlowGraphCompiler::SupportsUnboxedInt64Fields() {
+  return (kBitsPerWord == 64) && FLAG_unbox_int64_fields &&
+         SupportsUnboxedInt64();
+}
+
 bool FlowGraphCompiler::IsUnboxedField(const Field& field) {
   bool valid_class =
       (SupportsUnboxedDoubles() && (field.guarded_cid() == kDoubleCid)) ||
       (SupportsUnboxedSimd128() && (field.guarded_cid() == kFloat32x4Cid)) ||
-      (SupportsUnboxedSimd128() && (field.guarded_cid() == kFloat64x2Cid));
+      (SupportsUnboxedSimd128() && (field.guarded_cid() == kFloat64x2Cid)) ||
+      (SupportsUnboxedInt64Fields() &&
+       IsUnboxedInt64FieldCid(field.guarded_cid()));
   return field.is_unboxing_candidate() && !field.is_final() &&
          !field.is_nullable() && valid_class;
 }
@@ -177,7 +196,19 @@ bool FlowGraphCompiler::IsUnboxedField(const Field& field) {
 bool FlowGraphCompiler::IsPotentialUnboxedField(const Field& field) {
   return field.is_unboxing_candidate() &&
          (FlowGraphCompiler::IsUnboxedField(field) ||
-          (!field.is_final() && (field.guarded_cid() == kIllegalCid)));
+          (!field.is_final() && (field.guarded_cid() == kIllegalCid)) ||
+          IsPotentialUnboxedInt64Field(field));
+}
+
+// A Smi or Mint guard can still widen to kIntegerCid, which unboxes the
+// field. Code compiled before that must check the guard when it runs, so
+// that it neither stores a shared Mint into the field, where it would be
+// updated in place, nor hands out the box of the field.
+bool FlowGraphCompiler::IsPotentialUnboxedInt64Field(const Field& field) {
+  return SupportsUnboxedInt64Fields() && Field::SupportsIntegerGuards() &&
+         !field.is_final() && !field.is_nullable() &&
+         ((field.guarded_cid() == kSmiCid) ||
+          (field.guarded_cid() == kMintCid));
 }
 
 void FlowGraphCompiler::InitCompiler() {
@@ -208,9 +239,16 @@ void FlowGraphCompiler::InitCompiler() {
         if ((ic_data != NULL) && (ic_data->NumberOfUsedChecks() == 0)) {
           may_reoptimize_ = true;
         }
+        if (current->IsPolymorphicInstanceCall() &&
+            current->AsPolymorphicInstanceCall()->counts_calls()) {
+          may_reoptimize_ = true;
+        }
       }
     }
   }
+  if (is_baseline()) {
+    may_reoptimize_ = true;
+  }
 
   if (!is_optimizing()) {
     // Initialize edge counter array.
@@ -1779,7 +1817,9 @@ const ICData* FlowGraphCompiler::GetOrAddStaticCallICData(
 
 intptr_t FlowGraphCompiler::GetOptimizationThreshold() const {
   intptr_t threshold;
-  if (is_optimizing()) {
+  if (is_baseline()) {
+    threshold = FLAG_optimization_counter_threshold;
+  } else if (is_optimizing()) {
     threshold = FLAG_reoptimization_counter_threshold;
   } else if (parsed_function_.function().IsIrregexpFunction()) {
     threshold = FLAG_regexp_optimization_counter_threshold;
@@ -1791,6 +1831,10 @@ intptr_t FlowGraphCompiler::GetOptimizationThreshold() const {
     if (threshold > FLAG_optimization_counter_threshold) {
       threshold = FLAG_optimization_counter_threshold;
     }
+    if (FLAG_baseline_tier &&
+        (threshold > FLAG_baseline_optimization_counter_threshold)) {
+      threshold = FLAG_baseline_optimization_counter_threshold;
+    }
   }
   return threshold;
 }
@@ -1881,7 +1925,19 @@ void FlowGraphCompiler::EmitPolymorphicInstanceCall(
     TokenPosition token_pos,
     LocationSummary* locs,
     bool complete,
-    intptr_t total_ic_calls) {
+    intptr_t total_ic_calls,
+    bool counts_calls) {
+  if (counts_calls) {
+    // Count in the inline cache of the original call like a call without
+    // type feedback does, see GenerateInstanceCall.
+    const ICData& ic_data =
+        ICData::ZoneHandle(zone(), original_call.ic_data()->Original());
+    ASSERT(may_reoptimize() || flow_graph().IsCompiledForOsr());
+    EmitOptimizedInstanceCall(*StubEntryFor(ic_data, /*optimized=*/true),
+                              ic_data, deopt_id, token_pos, locs,
+                              original_call.entry_kind());
+    return;
+  }
   if (FLAG_polymorphic_with_deopt) {
     Label* deopt =
         AddDeoptStub(deopt_id, ICData::kDeoptPolymorphicInstanceCallTestFail);
@@ -2208,7 +2264,7 @@ void FlowGraphCompiler::FrameStateUpdateWith(Instruction* instr) {
 void FlowGraphCompiler::FrameStatePush(Definition* defn) {
   Representation rep = defn->representation();
   if ((rep == kUnboxedDouble) || (rep == kUnboxedFloat64x2) ||
-      (rep == kUnboxedFloat32x4)) {
+      (rep == kUnboxedFloat32x4) || (rep == kUnboxedInt64)) {
     // LoadField instruction lies about its representation in the unoptimized
     // code because Definition::representation() can't depend on the type of
     // compilation but MakeLocationSummary and EmitNativeCode can.
@@ -331,11 +331,17 @@ class FlowGraphCompiler : public ValueObject {
   static bool SupportsUnboxedDoubles();
   static bool SupportsUnboxedInt64();
   static bool SupportsUnboxedSimd128();
+  static bool SupportsUnboxedInt64Fields();
+  // Fields guarded as Mint or as Smi and Mint hold unboxed int64 values.
+  static bool IsUnboxedInt64FieldCid(intptr_t cid) {
+    return (cid == kMintCid) || (cid == kIntegerCid);
+  }
   static bool SupportsHardwareDivision();
   static bool CanConvertInt64ToDouble();
 
   static bool IsUnboxedField(const Field& field);
   static bool IsPotentialUnboxedField(const Field& field);
+  static bool IsPotentialUnboxedInt64Field(const Field& field);
 
   // Accessors.
   Assembler* assembler() const { return assembler_; }
@@ -549,7 +555,8 @@ class FlowGraphCompiler : public ValueObject {
       TokenPosition token_pos,
       LocationSummary* locs,
       bool complete,
-      intptr_t total_call_count);
+      intptr_t total_call_count,
+      bool counts_calls = false);
 
   // Pass a value for try-index where block is not available (e.g. slow path).
   void EmitMegamorphicInstanceCall(const String& function_name,
@@ -694,6 +701,10 @@ class FlowGraphCompiler : public ValueObject {
 
   bool may_reoptimize() const { return may_reoptimize_; }
 
+  // Baseline code is optimized code that counts invocations like
+  // unoptimized code does, to get replaced by fully optimized code.
+  bool is_baseline() const { return is_baseline_; }
+
   // Use in unoptimized compilation to preserve/reuse ICData.
   const ICData* GetOrAddInstanceCallICData(intptr_t deopt_id,
                                            const String& target_name,
@@ -972,6 +983,7 @@ class FlowGraphCompiler : public ValueObject {
   // separate table?
   GrowableArray<StaticCallsStruct*> static_calls_target_table_;
   const bool is_optimizing_;
+  const bool is_baseline_;
   SpeculativeInliningPolicy* speculative_policy_;
   // Set to true if optimized code has IC calls.
   bool may_reoptimize_;
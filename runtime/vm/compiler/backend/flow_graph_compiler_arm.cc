@@ -868,8 +868,9 @@ void FlowGraphCompiler::EmitFrameEntry() {
 
     __ ldr(R3, FieldAddress(function_reg, Function::usage_counter_offset()));
     // Reoptimization of an optimized function is triggered by counting in
-    // IC stubs, but not at the entry of the function.
-    if (!is_optimizing()) {
+    // IC stubs, but not at the entry of the function. Baseline code counts
+    // its invocations like unoptimized code.
+    if (!is_optimizing() || is_baseline()) {
       __ add(R3, R3, Operand(1));
       __ str(R3, FieldAddress(function_reg, Function::usage_counter_offset()));
     }
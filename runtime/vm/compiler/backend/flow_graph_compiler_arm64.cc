@@ -850,8 +850,9 @@ void FlowGraphCompiler::EmitFrameEntry() {
     __ LoadFieldFromOffset(R7, function_reg, Function::usage_counter_offset(),
                            kWord);
     // Reoptimization of an optimized function is triggered by counting in
-    // IC stubs, but not at the entry of the function.
-    if (!is_optimizing()) {
+    // IC stubs, but not at the entry of the function. Baseline code counts
+    // its invocations like unoptimized code.
+    if (!is_optimizing() || is_baseline()) {
       __ add(R7, R7, Operand(1));
       __ StoreFieldToOffset(R7, function_reg, Function::usage_counter_offset(),
                             kWord);
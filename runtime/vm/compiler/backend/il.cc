@@ -46,6 +46,10 @@ DEFINE_FLAG(bool,
             unbox_numeric_fields,
             !USING_DBC,
             "Support unboxed double and float32x4 fields.");
+DEFINE_FLAG(bool,
+            unbox_int64_fields,
+            true,
+            "Support unboxed int64 fields on 64-bit targets.");
 
 class SubclassFinder {
  public:
@@ -755,6 +759,9 @@ Representation LoadFieldInstr::representation() const {
         return kUnboxedFloat32x4;
       case kFloat64x2Cid:
         return kUnboxedFloat64x2;
+      case kMintCid:
+      case kIntegerCid:
+        return kUnboxedInt64;
       default:
         UNREACHABLE();
     }
@@ -784,6 +791,9 @@ Representation StoreInstanceFieldInstr::RequiredInputRepresentation(
         return kUnboxedFloat32x4;
       case kFloat64x2Cid:
         return kUnboxedFloat64x2;
+      case kMintCid:
+      case kIntegerCid:
+        return kUnboxedInt64;
       default:
         UNREACHABLE();
     }
@@ -3327,6 +3337,14 @@ Instruction* GuardFieldClassInstr::Canonicalize(FlowGraph* flow_graph) {
     return NULL;
   }
 
+  if (field().guarded_cid() == kIntegerCid) {
+    // Any int passes an integer guard.
+    return (field().is_nullable() ? value()->Type()->IsNullableInt()
+                                  : value()->Type()->IsInt())
+               ? NULL
+               : this;
+  }
+
   const intptr_t cid = field().is_nullable() ? value()->Type()->ToNullableCid()
                                              : value()->Type()->ToCid();
   if (field().guarded_cid() == cid) {
@@ -4170,7 +4188,8 @@ void PolymorphicInstanceCallInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
                           instance_call()->argument_names());
   compiler->EmitPolymorphicInstanceCall(
       targets_, *instance_call(), args_info, deopt_id(),
-      instance_call()->token_pos(), locs(), complete(), total_call_count());
+      instance_call()->token_pos(), locs(), complete(), total_call_count(),
+      counts_calls());
 }
 #endif
 
@@ -895,6 +895,7 @@ class Instruction : public ZoneAllocated {
   // GetDeoptId and/or CopyDeoptIdFrom.
   friend class CallSiteInliner;
   friend class LICM;
+  friend class LoopOptimizer;
   friend class ComparisonInstr;
   friend class Scheduler;
   friend class BlockEntryInstr;
@@ -3344,7 +3345,8 @@ class PolymorphicInstanceCallInstr : public TemplateDefinition<0, Throws> {
       : TemplateDefinition(instance_call->deopt_id()),
         instance_call_(instance_call),
         targets_(targets),
-        complete_(complete) {
+        complete_(complete),
+        counts_calls_(false) {
     ASSERT(instance_call_ != NULL);
     ASSERT(targets.length() != 0);
     total_call_count_ = CallCount();
@@ -3391,6 +3393,12 @@ class PolymorphicInstanceCallInstr : public TemplateDefinition<0, Throws> {
 
   void set_total_call_count(intptr_t count) { total_call_count_ = count; }
 
+  // If set, the call dispatches through the inline cache of the original
+  // call, counting its receivers there and in the usage counter of the
+  // function, which gets reoptimized once the calls become frequent.
+  bool counts_calls() const { return counts_calls_; }
+  void set_counts_calls(bool value) { counts_calls_ = value; }
+
   DECLARE_INSTRUCTION(PolymorphicInstanceCall)
 
   virtual bool ComputeCanDeoptimize() const { return true; }
@@ -3412,6 +3420,7 @@ class PolymorphicInstanceCallInstr : public TemplateDefinition<0, Throws> {
   InstanceCallInstr* instance_call_;
   const CallTargets& targets_;
   const bool complete_;
+  bool counts_calls_;
   intptr_t total_call_count_;
 
   friend class PolymorphicInliner;
@@ -1703,6 +1703,22 @@ void GuardFieldClassInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
       __ CompareImmediate(TMP, kDynamicCid);
       __ b(&ok, EQ);
 
+      if (Field::SupportsIntegerGuards() &&
+          ((value_cid == kDynamicCid) ||
+           RawObject::IsIntegerClassId(value_cid))) {
+        // Any int passes an integer guard.
+        Label update;
+        __ CompareImmediate(TMP, kIntegerCid);
+        if (value_cid == kDynamicCid) {
+          __ b(&update, NE);
+          __ CompareImmediate(value_cid_reg, kSmiCid);
+          __ b(&ok, EQ);
+          __ CompareImmediate(value_cid_reg, kMintCid);
+        }
+        __ b(&ok, EQ);
+        __ Bind(&update);
+      }
+
       __ Push(field_reg);
       __ Push(value_reg);
       __ CallRuntime(kUpdateFieldCidRuntimeEntry, 2);
@@ -1717,7 +1733,12 @@ void GuardFieldClassInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
       // Value's class id is not known.
       __ tsti(value_reg, Immediate(kSmiTagMask));
 
-      if (field_cid != kSmiCid) {
+      if (field_cid == kIntegerCid) {
+        // Both Smi and Mint values pass an integer guard.
+        __ b(&ok, EQ);
+        __ LoadClassId(value_cid_reg, value_reg);
+        __ CompareImmediate(value_cid_reg, kMintCid);
+      } else if (field_cid != kSmiCid) {
         __ b(fail, EQ);
         __ LoadClassId(value_cid_reg, value_reg);
         __ CompareImmediate(value_cid_reg, field_cid);
@@ -1729,6 +1750,9 @@ void GuardFieldClassInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
       }
 
       __ b(fail, NE);
+    } else if ((field_cid == kIntegerCid) &&
+               RawObject::IsIntegerClassId(value_cid)) {
+      // The value is known to be an int.
     } else {
       // Both value's and field's class id is known.
       ASSERT((value_cid != field_cid) && (value_cid != nullability));
@@ -1901,21 +1925,54 @@ static void EnsureMutableBox(FlowGraphCompiler* compiler,
   __ Bind(&done);
 }
 
+// Unboxed int64 fields hold their value as a Smi if it fits, and otherwise in
+// a Mint box owned by the instance. Loads that box into box_reg, allocating
+// it if the field holds a Smi or null.
+static void EnsureMutableMintBox(FlowGraphCompiler* compiler,
+                                 StoreInstanceFieldInstr* instruction,
+                                 Register box_reg,
+                                 Register instance_reg,
+                                 intptr_t offset,
+                                 Register temp) {
+  Label done, allocate;
+  __ LoadFieldFromOffset(box_reg, instance_reg, offset);
+  __ BranchIfSmi(box_reg, &allocate);
+  __ CompareObject(box_reg, Object::null_object());
+  __ b(&done, NE);
+  __ Bind(&allocate);
+  BoxAllocationSlowPath::Allocate(compiler, instruction,
+                                  compiler->mint_class(), box_reg, temp);
+  __ MoveRegister(temp, box_reg);
+  __ StoreIntoObjectOffset(instance_reg, offset, temp,
+                           Assembler::kValueIsNotSmi,
+                           /*lr_reserved=*/!compiler->intrinsic_mode());
+  __ Bind(&done);
+}
+
 LocationSummary* StoreInstanceFieldInstr::MakeLocationSummary(Zone* zone,
                                                               bool opt) const {
   const intptr_t kNumInputs = 2;
   const intptr_t kNumTemps =
       (IsUnboxedStore() && opt) ? 2 : ((IsPotentialUnboxedStore()) ? 2 : 0);
-  LocationSummary* summary = new (zone)
-      LocationSummary(zone, kNumInputs, kNumTemps,
-                      ((IsUnboxedStore() && opt && is_initialization()) ||
-                       IsPotentialUnboxedStore())
-                          ? LocationSummary::kCallOnSlowPath
-                          : LocationSummary::kNoCall);
+  // Unboxed int64 stores allocate a box when the value leaves the Smi range.
+  const bool is_int64_store =
+      IsUnboxedStore() && opt &&
+      FlowGraphCompiler::IsUnboxedInt64FieldCid(
+          slot().field().UnboxedFieldCid());
+  LocationSummary* summary = new (zone) LocationSummary(
+      zone, kNumInputs, kNumTemps,
+      ((IsUnboxedStore() && opt && (is_initialization() || is_int64_store)) ||
+       IsPotentialUnboxedStore())
+          ? LocationSummary::kCallOnSlowPath
+          : LocationSummary::kNoCall);
 
   summary->set_in(0, Location::RequiresRegister());
   if (IsUnboxedStore() && opt) {
-    summary->set_in(1, Location::RequiresFpuRegister());
+    if (is_int64_store) {
+      summary->set_in(1, Location::RequiresRegister());
+    } else {
+      summary->set_in(1, Location::RequiresFpuRegister());
+    }
     summary->set_temp(0, Location::RequiresRegister());
     summary->set_temp(1, Location::RequiresRegister());
   } else if (IsPotentialUnboxedStore()) {
@@ -1939,11 +1996,28 @@ void StoreInstanceFieldInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
   const intptr_t offset_in_bytes = OffsetInBytes();
 
   if (IsUnboxedStore() && compiler->is_optimizing()) {
-    const VRegister value = locs()->in(1).fpu_reg();
     const Register temp = locs()->temp(0).reg();
     const Register temp2 = locs()->temp(1).reg();
     const intptr_t cid = slot().field().UnboxedFieldCid();
 
+    if (FlowGraphCompiler::IsUnboxedInt64FieldCid(cid)) {
+      __ Comment("UnboxedInt64StoreInstanceFieldInstr");
+      const Register value = locs()->in(1).reg();
+      Label store_mint;
+      ASSERT(kSmiTag == 0);
+      __ LslImmediate(temp2, value, kSmiTagSize);
+      __ cmp(value, Operand(temp2, ASR, kSmiTagSize));
+      __ b(&store_mint, NE);
+      __ StoreIntoObjectOffsetNoBarrier(instance_reg, offset_in_bytes, temp2);
+      __ b(&skip_store);
+      __ Bind(&store_mint);
+      EnsureMutableMintBox(compiler, this, temp, instance_reg, offset_in_bytes,
+                           temp2);
+      __ StoreFieldToOffset(value, temp, Mint::value_offset());
+      __ Bind(&skip_store);
+      return;
+    }
+
     if (is_initialization()) {
       const Class* cls = NULL;
       switch (cid) {
@@ -1968,6 +2042,7 @@ void StoreInstanceFieldInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
     } else {
       __ LoadFieldFromOffset(temp, instance_reg, offset_in_bytes);
     }
+    const VRegister value = locs()->in(1).fpu_reg();
     switch (cid) {
       case kDoubleCid:
         __ Comment("UnboxedDoubleStoreInstanceFieldInstr");
@@ -2003,6 +2078,7 @@ void StoreInstanceFieldInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
     Label store_double;
     Label store_float32x4;
     Label store_float64x2;
+    Label store_mint;
 
     __ LoadObject(temp, Field::ZoneHandle(Z, slot().field().Original()));
 
@@ -2031,6 +2107,16 @@ void StoreInstanceFieldInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
     __ CompareImmediate(temp2, kFloat64x2Cid);
     __ b(&store_float64x2, EQ);
 
+    if (FlowGraphCompiler::SupportsUnboxedInt64Fields()) {
+      __ LoadFieldFromOffset(temp2, temp, Field::guarded_cid_offset(),
+                             kUnsignedHalfword);
+      __ CompareImmediate(temp2, kMintCid);
+      __ b(&store_mint, EQ);
+
+      __ CompareImmediate(temp2, kIntegerCid);
+      __ b(&store_mint, EQ);
+    }
+
     // Fall through.
     __ b(&store_pointer);
 
@@ -2066,6 +2152,17 @@ void StoreInstanceFieldInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
       __ b(&skip_store);
     }
 
+    if (FlowGraphCompiler::SupportsUnboxedInt64Fields()) {
+      __ Bind(&store_mint);
+      // Smis are stored as they are.
+      __ BranchIfSmi(value_reg, &store_pointer);
+      EnsureMutableMintBox(compiler, this, temp, instance_reg, offset_in_bytes,
+                           temp2);
+      __ LoadFieldFromOffset(temp2, value_reg, Mint::value_offset());
+      __ StoreFieldToOffset(temp2, temp, Mint::value_offset());
+      __ b(&skip_store);
+    }
+
     __ Bind(&store_pointer);
   }
 
@@ -2293,10 +2390,22 @@ void LoadFieldInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
   ASSERT(sizeof(classid_t) == kInt16Size);
   const Register instance_reg = locs()->in(0).reg();
   if (IsUnboxedLoad() && compiler->is_optimizing()) {
-    const VRegister result = locs()->out(0).fpu_reg();
     const Register temp = locs()->temp(0).reg();
     __ LoadFieldFromOffset(temp, instance_reg, OffsetInBytes());
     const intptr_t cid = slot().field().UnboxedFieldCid();
+    if (FlowGraphCompiler::IsUnboxedInt64FieldCid(cid)) {
+      __ Comment("UnboxedInt64LoadFieldInstr");
+      const Register result = locs()->out(0).reg();
+      Label done, load_mint;
+      __ BranchIfNotSmi(temp, &load_mint);
+      __ SmiUntag(result, temp);
+      __ b(&done);
+      __ Bind(&load_mint);
+      __ LoadFieldFromOffset(result, temp, Mint::value_offset());
+      __ Bind(&done);
+      return;
+    }
+    const VRegister result = locs()->out(0).fpu_reg();
     switch (cid) {
       case kDoubleCid:
         __ Comment("UnboxedDoubleLoadFieldInstr");
@@ -2323,6 +2432,7 @@ void LoadFieldInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
     Label load_double;
     Label load_float32x4;
     Label load_float64x2;
+    Label load_mint;
 
     __ LoadObject(result_reg, Field::ZoneHandle(slot().field().Original()));
 
@@ -2347,6 +2457,15 @@ void LoadFieldInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
     __ CompareImmediate(temp, kFloat64x2Cid);
     __ b(&load_float64x2, EQ);
 
+    if (FlowGraphCompiler::SupportsUnboxedInt64Fields()) {
+      __ ldr(temp, field_cid_operand, kUnsignedHalfword);
+      __ CompareImmediate(temp, kMintCid);
+      __ b(&load_mint, EQ);
+
+      __ CompareImmediate(temp, kIntegerCid);
+      __ b(&load_mint, EQ);
+    }
+
     // Fall through.
     __ b(&load_pointer);
 
@@ -2384,6 +2503,20 @@ void LoadFieldInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
       __ b(&done);
     }
 
+    if (FlowGraphCompiler::SupportsUnboxedInt64Fields()) {
+      // Smis are loaded as they are. Otherwise the value is outside of the
+      // Smi range and the box is copied, as it is updated in place.
+      __ Bind(&load_mint);
+      __ LoadFieldFromOffset(temp, instance_reg, OffsetInBytes());
+      __ BranchIfSmi(temp, &load_pointer);
+      BoxAllocationSlowPath::Allocate(compiler, this, compiler->mint_class(),
+                                      result_reg, temp);
+      __ LoadFieldFromOffset(temp, instance_reg, OffsetInBytes());
+      __ LoadFieldFromOffset(temp, temp, Mint::value_offset());
+      __ StoreFieldToOffset(temp, result_reg, Mint::value_offset());
+      __ b(&done);
+    }
+
     __ Bind(&load_pointer);
   }
   __ LoadFieldFromOffset(result_reg, instance_reg, OffsetInBytes());
@@ -537,6 +537,9 @@ void PolymorphicInstanceCallInstr::PrintOperandsTo(BufferFormatter* f) const {
   if (complete()) {
     f->Print(" COMPLETE");
   }
+  if (counts_calls()) {
+    f->Print(" COUNTING");
+  }
   if (instance_call()->entry_kind() == Code::EntryKind::kUnchecked) {
     f->Print(" using unchecked entrypoint");
   }
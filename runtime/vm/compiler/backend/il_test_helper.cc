@@ -0,0 +1,119 @@
+// Copyright (c) 2019, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "vm/compiler/backend/il_test_helper.h"
+
+#include "vm/compiler/backend/inliner.h"
+#include "vm/compiler/frontend/kernel_to_il.h"
+#include "vm/compiler/jit/jit_call_specializer.h"
+#include "vm/dart_api_impl.h"
+#include "vm/object.h"
+#include "vm/parser.h"
+#include "vm/symbols.h"
+#include "vm/unit_test.h"
+
+namespace dart {
+
+// The pass state the JIT pipeline sets up for a flow graph.
+class JitPassState : public ValueObject {
+ public:
+  JitPassState(Thread* thread, FlowGraph* flow_graph)
+      : speculative_policy_(/*enable_blacklist*/ false),
+        pass_state_(thread, flow_graph, &speculative_policy_),
+        call_specializer_(flow_graph, &speculative_policy_) {
+    pass_state_.call_specializer = &call_specializer_;
+    pass_state_.inline_id_to_function.Add(&flow_graph->function());
+    pass_state_.caller_inline_id.Add(-1);
+  }
+
+  CompilerPassState* pass_state() { return &pass_state_; }
+
+ private:
+  SpeculativeInliningPolicy speculative_policy_;
+  CompilerPassState pass_state_;
+  JitCallSpecializer call_specializer_;
+
+  DISALLOW_COPY_AND_ASSIGN(JitPassState);
+};
+
+FlowGraph* BuildFlowGraph(Thread* thread,
+                          Dart_Handle script,
+                          const char* name) {
+  Zone* zone = thread->zone();
+  Library& lib =
+      Library::ZoneHandle(Library::RawCast(Api::UnwrapHandle(script)));
+  RawFunction* raw_func =
+      lib.LookupLocalFunction(String::Handle(Symbols::New(thread, name)));
+  EXPECT(raw_func != Function::null());
+  ParsedFunction* parsed_function =
+      new (zone) ParsedFunction(thread, Function::ZoneHandle(zone, raw_func));
+
+  ZoneGrowableArray<const ICData*>* ic_data_array =
+      new (zone) ZoneGrowableArray<const ICData*>();
+  parsed_function->function().RestoreICDataMap(ic_data_array, true);
+  kernel::FlowGraphBuilder builder(parsed_function, ic_data_array, nullptr,
+                                   nullptr, true, DeoptId::kNone);
+  FlowGraph* flow_graph = builder.BuildGraph();
+  EXPECT(flow_graph != nullptr);
+  return flow_graph;
+}
+
+void RunPassesUpTo(Thread* thread,
+                   FlowGraph* flow_graph,
+                   CompilerPass::Id last) {
+  JitPassState state(thread, flow_graph);
+  static const CompilerPass::Id kPasses[] = {
+      CompilerPass::kComputeSSA,
+      CompilerPass::kApplyICData,
+      CompilerPass::kTryOptimizePatterns,
+      CompilerPass::kSetOuterInliningId,
+      CompilerPass::kTypePropagation,
+      CompilerPass::kApplyClassIds,
+      CompilerPass::kInlining,
+      CompilerPass::kTypePropagation,
+      CompilerPass::kApplyClassIds,
+      CompilerPass::kTypePropagation,
+      CompilerPass::kApplyICData,
+      CompilerPass::kCanonicalize,
+      CompilerPass::kBranchSimplify,
+      CompilerPass::kIfConvert,
+      CompilerPass::kCanonicalize,
+      CompilerPass::kConstantPropagation,
+      CompilerPass::kOptimisticallySpecializeSmiPhis,
+      CompilerPass::kTypePropagation,
+      CompilerPass::kWidenSmiToInt32,
+      CompilerPass::kSelectRepresentations,
+      CompilerPass::kCSE,
+      CompilerPass::kLICM,
+      CompilerPass::kTryOptimizePatterns,
+      CompilerPass::kDSE,
+      CompilerPass::kTypePropagation,
+      CompilerPass::kOptimizeLoops,
+      CompilerPass::kRangeAnalysis,
+      CompilerPass::kOptimizeBranches,
+      CompilerPass::kVectorizeLoops,
+  };
+  for (intptr_t i = 0; i < static_cast<intptr_t>(ARRAY_SIZE(kPasses)); i++) {
+    CompilerPass::Get(kPasses[i])->Run(state.pass_state());
+    if (kPasses[i] == last) {
+      return;
+    }
+  }
+  UNREACHABLE();
+}
+
+void RunJitPipeline(Thread* thread, FlowGraph* flow_graph) {
+  JitPassState state(thread, flow_graph);
+  CompilerPass::RunPipeline(CompilerPass::kJIT, state.pass_state());
+}
+
+FlowGraph* CompileOptimized(Thread* thread,
+                            Dart_Handle script,
+                            const char* name) {
+  FlowGraph* flow_graph = BuildFlowGraph(thread, script, name);
+  RunJitPipeline(thread, flow_graph);
+  return flow_graph;
+}
+
+}  // namespace dart
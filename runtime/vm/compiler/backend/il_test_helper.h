@@ -0,0 +1,40 @@
+// Copyright (c) 2019, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+//
+// Helpers shared by the unit tests that compile functions of a test script
+// and inspect the resulting flow graphs.
+
+#ifndef RUNTIME_VM_COMPILER_BACKEND_IL_TEST_HELPER_H_
+#define RUNTIME_VM_COMPILER_BACKEND_IL_TEST_HELPER_H_
+
+#include "include/dart_api.h"
+#include "vm/compiler/backend/flow_graph.h"
+#include "vm/compiler/compiler_pass.h"
+
+namespace dart {
+
+// Builds the CFG of function [name] of the script from the type feedback
+// collected by invoking it.
+FlowGraph* BuildFlowGraph(Thread* thread,
+                          Dart_Handle script,
+                          const char* name);
+
+// Runs the JIT pipeline on a flow graph, up to and including the pass
+// [last]. Passes after the vectorization of loops are not supported.
+void RunPassesUpTo(Thread* thread,
+                   FlowGraph* flow_graph,
+                   CompilerPass::Id last);
+
+// Runs the whole JIT pipeline on a flow graph.
+void RunJitPipeline(Thread* thread, FlowGraph* flow_graph);
+
+// Builds the CFG of function [name] of an invoked script and runs the whole
+// JIT pipeline on it.
+FlowGraph* CompileOptimized(Thread* thread,
+                            Dart_Handle script,
+                            const char* name);
+
+}  // namespace dart
+
+#endif  // RUNTIME_VM_COMPILER_BACKEND_IL_TEST_HELPER_H_
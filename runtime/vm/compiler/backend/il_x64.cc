@@ -1693,6 +1693,23 @@ void GuardFieldClassInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
               Immediate(kDynamicCid));
       __ j(EQUAL, &ok);
 
+      if (Field::SupportsIntegerGuards() &&
+          ((value_cid == kDynamicCid) ||
+           RawObject::IsIntegerClassId(value_cid))) {
+        // Any int passes an integer guard.
+        Label update;
+        __ cmpw(FieldAddress(field_reg, Field::guarded_cid_offset()),
+                Immediate(kIntegerCid));
+        if (value_cid == kDynamicCid) {
+          __ j(NOT_EQUAL, &update);
+          __ cmpq(value_cid_reg, Immediate(kSmiCid));
+          __ j(EQUAL, &ok);
+          __ cmpq(value_cid_reg, Immediate(kMintCid));
+        }
+        __ j(EQUAL, &ok);
+        __ Bind(&update);
+      }
+
       __ pushq(field_reg);
       __ pushq(value_reg);
       __ CallRuntime(kUpdateFieldCidRuntimeEntry, 2);
@@ -1707,7 +1724,12 @@ void GuardFieldClassInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
       // Value's class id is not known.
       __ testq(value_reg, Immediate(kSmiTagMask));
 
-      if (field_cid != kSmiCid) {
+      if (field_cid == kIntegerCid) {
+        // Both Smi and Mint values pass an integer guard.
+        __ j(ZERO, &ok);
+        __ LoadClassId(value_cid_reg, value_reg);
+        __ CompareImmediate(value_cid_reg, Immediate(kMintCid));
+      } else if (field_cid != kSmiCid) {
         __ j(ZERO, fail);
         __ LoadClassId(value_cid_reg, value_reg);
         __ CompareImmediate(value_cid_reg, Immediate(field_cid));
@@ -1719,6 +1741,9 @@ void GuardFieldClassInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
       }
 
       __ j(NOT_EQUAL, fail);
+    } else if ((field_cid == kIntegerCid) &&
+               RawObject::IsIntegerClassId(value_cid)) {
+      // The value is known to be an int.
     } else {
       // Both value's and field's class id is known.
       ASSERT((value_cid != field_cid) && (value_cid != nullability));
@@ -1907,16 +1932,25 @@ LocationSummary* StoreInstanceFieldInstr::MakeLocationSummary(Zone* zone,
   const intptr_t kNumInputs = 2;
   const intptr_t kNumTemps =
       (IsUnboxedStore() && opt) ? 2 : ((IsPotentialUnboxedStore()) ? 3 : 0);
-  LocationSummary* summary = new (zone)
-      LocationSummary(zone, kNumInputs, kNumTemps,
-                      ((IsUnboxedStore() && opt && is_initialization()) ||
-                       IsPotentialUnboxedStore())
-                          ? LocationSummary::kCallOnSlowPath
-                          : LocationSummary::kNoCall);
+  // Unboxed int64 stores allocate a box when the value leaves the Smi range.
+  const bool is_int64_store =
+      IsUnboxedStore() && opt &&
+      FlowGraphCompiler::IsUnboxedInt64FieldCid(
+          slot().field().UnboxedFieldCid());
+  LocationSummary* summary = new (zone) LocationSummary(
+      zone, kNumInputs, kNumTemps,
+      ((IsUnboxedStore() && opt && (is_initialization() || is_int64_store)) ||
+       IsPotentialUnboxedStore())
+          ? LocationSummary::kCallOnSlowPath
+          : LocationSummary::kNoCall);
 
   summary->set_in(0, Location::RequiresRegister());
   if (IsUnboxedStore() && opt) {
-    summary->set_in(1, Location::RequiresFpuRegister());
+    if (is_int64_store) {
+      summary->set_in(1, Location::RequiresRegister());
+    } else {
+      summary->set_in(1, Location::RequiresFpuRegister());
+    }
     summary->set_temp(0, Location::RequiresRegister());
     summary->set_temp(1, Location::RequiresRegister());
   } else if (IsPotentialUnboxedStore()) {
@@ -1953,6 +1987,31 @@ static void EnsureMutableBox(FlowGraphCompiler* compiler,
   __ Bind(&done);
 }
 
+// Unboxed int64 fields hold their value as a Smi if it fits, and otherwise in
+// a Mint box owned by the instance. Loads that box into box_reg, allocating
+// it if the field holds a Smi or null.
+static void EnsureMutableMintBox(FlowGraphCompiler* compiler,
+                                 StoreInstanceFieldInstr* instruction,
+                                 Register box_reg,
+                                 Register instance_reg,
+                                 intptr_t offset,
+                                 Register temp) {
+  Label done, allocate;
+  __ movq(box_reg, FieldAddress(instance_reg, offset));
+  __ testq(box_reg, Immediate(kSmiTagMask));
+  __ j(ZERO, &allocate);
+  __ CompareObject(box_reg, Object::null_object());
+  __ j(NOT_EQUAL, &done);
+  __ Bind(&allocate);
+  BoxAllocationSlowPath::Allocate(compiler, instruction,
+                                  compiler->mint_class(), box_reg, temp);
+  __ movq(temp, box_reg);
+  __ StoreIntoObject(instance_reg, FieldAddress(instance_reg, offset), temp,
+                     Assembler::kValueIsNotSmi);
+
+  __ Bind(&done);
+}
+
 void StoreInstanceFieldInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
   ASSERT(sizeof(classid_t) == kInt16Size);
   Label skip_store;
@@ -1961,11 +2020,28 @@ void StoreInstanceFieldInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
   const intptr_t offset_in_bytes = OffsetInBytes();
 
   if (IsUnboxedStore() && compiler->is_optimizing()) {
-    XmmRegister value = locs()->in(1).fpu_reg();
     Register temp = locs()->temp(0).reg();
     Register temp2 = locs()->temp(1).reg();
     const intptr_t cid = slot().field().UnboxedFieldCid();
 
+    if (FlowGraphCompiler::IsUnboxedInt64FieldCid(cid)) {
+      __ Comment("UnboxedInt64StoreInstanceFieldInstr");
+      const Register value = locs()->in(1).reg();
+      Label store_mint;
+      __ MoveRegister(temp2, value);
+      __ SmiTag(temp2);
+      __ j(OVERFLOW, &store_mint);
+      __ StoreIntoObjectNoBarrier(
+          instance_reg, FieldAddress(instance_reg, offset_in_bytes), temp2);
+      __ jmp(&skip_store);
+      __ Bind(&store_mint);
+      EnsureMutableMintBox(compiler, this, temp, instance_reg, offset_in_bytes,
+                           temp2);
+      __ movq(FieldAddress(temp, Mint::value_offset()), value);
+      __ Bind(&skip_store);
+      return;
+    }
+
     if (is_initialization()) {
       const Class* cls = NULL;
       switch (cid) {
@@ -1990,6 +2066,7 @@ void StoreInstanceFieldInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
     } else {
       __ movq(temp, FieldAddress(instance_reg, offset_in_bytes));
     }
+    XmmRegister value = locs()->in(1).fpu_reg();
     switch (cid) {
       case kDoubleCid:
         __ Comment("UnboxedDoubleStoreInstanceFieldInstr");
@@ -2025,6 +2102,7 @@ void StoreInstanceFieldInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
     Label store_double;
     Label store_float32x4;
     Label store_float64x2;
+    Label store_mint;
 
     __ LoadObject(temp, Field::ZoneHandle(Z, slot().field().Original()));
 
@@ -2048,6 +2126,16 @@ void StoreInstanceFieldInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
             Immediate(kFloat64x2Cid));
     __ j(EQUAL, &store_float64x2);
 
+    if (FlowGraphCompiler::SupportsUnboxedInt64Fields()) {
+      __ cmpw(FieldAddress(temp, Field::guarded_cid_offset()),
+              Immediate(kMintCid));
+      __ j(EQUAL, &store_mint);
+
+      __ cmpw(FieldAddress(temp, Field::guarded_cid_offset()),
+              Immediate(kIntegerCid));
+      __ j(EQUAL, &store_mint);
+    }
+
     // Fall through.
     __ jmp(&store_pointer);
 
@@ -2083,6 +2171,18 @@ void StoreInstanceFieldInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
       __ jmp(&skip_store);
     }
 
+    if (FlowGraphCompiler::SupportsUnboxedInt64Fields()) {
+      __ Bind(&store_mint);
+      // Smis are stored as they are.
+      __ testq(value_reg, Immediate(kSmiTagMask));
+      __ j(ZERO, &store_pointer);
+      EnsureMutableMintBox(compiler, this, temp, instance_reg, offset_in_bytes,
+                           temp2);
+      __ movq(temp2, FieldAddress(value_reg, Mint::value_offset()));
+      __ movq(FieldAddress(temp, Mint::value_offset()), temp2);
+      __ jmp(&skip_store);
+    }
+
     __ Bind(&store_pointer);
   }
 
@@ -2309,10 +2409,21 @@ void LoadFieldInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
   ASSERT(sizeof(classid_t) == kInt16Size);
   Register instance_reg = locs()->in(0).reg();
   if (IsUnboxedLoad() && compiler->is_optimizing()) {
-    XmmRegister result = locs()->out(0).fpu_reg();
     Register temp = locs()->temp(0).reg();
     __ movq(temp, FieldAddress(instance_reg, OffsetInBytes()));
     intptr_t cid = slot().field().UnboxedFieldCid();
+    if (FlowGraphCompiler::IsUnboxedInt64FieldCid(cid)) {
+      __ Comment("UnboxedInt64LoadFieldInstr");
+      const Register result = locs()->out(0).reg();
+      Label done;
+      __ MoveRegister(result, temp);
+      __ SmiUntag(result);
+      __ j(NOT_CARRY, &done, Assembler::kNearJump);
+      __ movq(result, Address(result, TIMES_2, Mint::value_offset()));
+      __ Bind(&done);
+      return;
+    }
+    XmmRegister result = locs()->out(0).fpu_reg();
     switch (cid) {
       case kDoubleCid:
         __ Comment("UnboxedDoubleLoadFieldInstr");
@@ -2342,6 +2453,7 @@ void LoadFieldInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
     Label load_double;
     Label load_float32x4;
     Label load_float64x2;
+    Label load_mint;
 
     __ LoadObject(result, Field::ZoneHandle(slot().field().Original()));
 
@@ -2360,6 +2472,14 @@ void LoadFieldInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
     __ cmpw(field_cid_operand, Immediate(kFloat64x2Cid));
     __ j(EQUAL, &load_float64x2);
 
+    if (FlowGraphCompiler::SupportsUnboxedInt64Fields()) {
+      __ cmpw(field_cid_operand, Immediate(kMintCid));
+      __ j(EQUAL, &load_mint);
+
+      __ cmpw(field_cid_operand, Immediate(kIntegerCid));
+      __ j(EQUAL, &load_mint);
+    }
+
     // Fall through.
     __ jmp(&load_pointer);
 
@@ -2397,6 +2517,21 @@ void LoadFieldInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
       __ jmp(&done);
     }
 
+    if (FlowGraphCompiler::SupportsUnboxedInt64Fields()) {
+      // Smis are loaded as they are. Otherwise the value is outside of the
+      // Smi range and the box is copied, as it is updated in place.
+      __ Bind(&load_mint);
+      __ movq(temp, FieldAddress(instance_reg, OffsetInBytes()));
+      __ testq(temp, Immediate(kSmiTagMask));
+      __ j(ZERO, &load_pointer);
+      BoxAllocationSlowPath::Allocate(compiler, this, compiler->mint_class(),
+                                      result, temp);
+      __ movq(temp, FieldAddress(instance_reg, OffsetInBytes()));
+      __ movq(temp, FieldAddress(temp, Mint::value_offset()));
+      __ movq(FieldAddress(result, Mint::value_offset()), temp);
+      __ jmp(&done);
+    }
+
     __ Bind(&load_pointer);
   }
   __ movq(result, FieldAddress(instance_reg, OffsetInBytes()));
@@ -12,6 +12,7 @@
 #include "vm/compiler/backend/branch_optimizer.h"
 #include "vm/compiler/backend/flow_graph_compiler.h"
 #include "vm/compiler/backend/il_printer.h"
+#include "vm/compiler/backend/redundancy_elimination.h"
 #include "vm/compiler/backend/type_propagator.h"
 #include "vm/compiler/compiler_pass.h"
 #include "vm/compiler/frontend/flow_graph_builder.h"
@@ -87,7 +88,22 @@ DEFINE_FLAG(int,
             max_inlined_per_depth,
             500,
             "Max. number of inlined calls per depth");
+DEFINE_FLAG(int,
+            max_polymorphic_reoptimizations,
+            4,
+            "How many times a polymorphic call site that dropped infrequent "
+            "targets may trigger reoptimization when they become frequent.");
+DEFINE_FLAG(int,
+            polymorphic_inlining_min_share,
+            12,
+            "Inline only targets of polymorphic calls receiving at least "
+            "this share of the calls, in percents (0 .. 100).");
 DEFINE_FLAG(bool, print_inlining_tree, false, "Print inlining tree");
+DEFINE_FLAG(bool,
+            escape_summaries,
+            true,
+            "Treat allocations passed to parameters that do not escape the "
+            "callee like constant arguments when inlining.");
 DEFINE_FLAG(bool,
             enable_inlining_annotations,
             false,
@@ -232,6 +248,156 @@ class GraphInfoCollector : public ValueObject {
   intptr_t instruction_count_;
 };
 
+// Computes the escape summary of a function from a flow graph: a bit mask
+// with bit i set if parameter i is only loaded from, stored into, compared
+// or passed to a callee that does not let it escape either. An allocation
+// passed to such a parameter can be removed by allocation sinking once the
+// function is inlined, which the inliner takes into account.
+class EscapeSummaryCollector : public ValueObject {
+ public:
+  explicit EscapeSummaryCollector(const FlowGraph& graph) : graph_(graph) {}
+
+  // Computes the summary for the given definitions of the parameters, which
+  // may be null or constants for parameters that are not tracked.
+  intptr_t Collect(const GrowableArray<Definition*>& parameters) {
+    intptr_t summary = 0;
+    const intptr_t count = Utils::Minimum(
+        parameters.length(), Function::kMaxEscapeSummaryParameters);
+    for (intptr_t i = 0; i < count; i++) {
+      Definition* param = parameters[i];
+      if (param != NULL && !param->IsConstant() && !Escapes(param)) {
+        summary |= (1 << i);
+      }
+    }
+    return summary;
+  }
+
+  // Computes the summary from the parameters of the graph itself.
+  intptr_t Collect() {
+    intptr_t summary = CollectFrom(graph_.graph_entry()->normal_entry());
+    if (graph_.graph_entry()->unchecked_entry() != NULL) {
+      summary &= CollectFrom(graph_.graph_entry()->unchecked_entry());
+    }
+    return summary;
+  }
+
+ private:
+  intptr_t CollectFrom(FunctionEntryInstr* entry) {
+    if (entry == NULL) {
+      return 0;
+    }
+    GrowableArray<Definition*> parameters(
+        Function::kMaxEscapeSummaryParameters);
+    for (intptr_t i = 0; i < Function::kMaxEscapeSummaryParameters; i++) {
+      parameters.Add(NULL);
+    }
+    for (intptr_t i = 0; i < entry->initial_definitions()->length(); i++) {
+      ParameterInstr* param = (*entry->initial_definitions())[i]->AsParameter();
+      if (param != NULL &&
+          param->index() < Function::kMaxEscapeSummaryParameters) {
+        parameters[param->index()] = param;
+      }
+    }
+    return Collect(parameters);
+  }
+
+  // Returns true if the value of param may escape the graph.
+  bool Escapes(Definition* param) {
+    aliases_.Clear();
+    aliases_.Add(param);
+    for (intptr_t i = 0; i < aliases_.length(); i++) {
+      for (Value* use = aliases_[i]->input_use_list(); use != NULL;
+           use = use->next_use()) {
+        Instruction* instr = use->instruction();
+        if (instr->IsRedefinition() || instr->IsAssertAssignable()) {
+          aliases_.Add(instr->AsDefinition());
+        } else if (!IsSafeUse(use)) {
+          return true;
+        }
+      }
+    }
+    // Arguments are not inputs of calls, check them separately.
+    for (BlockIterator block_it = graph_.reverse_postorder_iterator();
+         !block_it.Done(); block_it.Advance()) {
+      for (ForwardInstructionIterator it(block_it.Current()); !it.Done();
+           it.Advance()) {
+        Instruction* instr = it.Current();
+        for (intptr_t i = 0; i < instr->ArgumentCount(); i++) {
+          Definition* arg = instr->PushArgumentAt(i)->value()->definition();
+          if (IsAlias(arg) && !IsNonEscapingArgument(instr, i)) {
+            return true;
+          }
+        }
+      }
+    }
+    return false;
+  }
+
+  bool IsAlias(Definition* defn) const {
+    for (intptr_t i = 0; i < aliases_.length(); i++) {
+      if (aliases_[i] == defn) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  static bool IsSafeUse(Value* use) {
+    Instruction* instr = use->instruction();
+    if (instr->IsPushArgument() || instr->IsLoadField() ||
+        instr->IsStrictCompare() || instr->IsLoadClassId() ||
+        instr->IsCheckNull() || instr->IsCheckClass() ||
+        instr->IsCheckClassId()) {
+      return true;
+    }
+    if (StoreInstanceFieldInstr* store = instr->AsStoreInstanceField()) {
+      return use == store->instance();
+    }
+    if (LoadIndexedInstr* load = instr->AsLoadIndexed()) {
+      return use == load->array();
+    }
+    if (StoreIndexedInstr* store = instr->AsStoreIndexed()) {
+      return use == store->array();
+    }
+    return false;
+  }
+
+  static bool IsNonEscapingArgument(Instruction* call, intptr_t index) {
+    if (ClosureCallInstr* closure_call = call->AsClosureCall()) {
+      // The closure itself is passed as the receiver of its function, which
+      // can only load the context and type arguments from it.
+      return index == closure_call->FirstArgIndex();
+    }
+    if (StaticCallInstr* static_call = call->AsStaticCall()) {
+      return IsNonEscapingParameter(static_call->function(),
+                                    index - static_call->FirstArgIndex());
+    }
+    if (PolymorphicInstanceCallInstr* poly_call =
+            call->AsPolymorphicInstanceCall()) {
+      const intptr_t param_index =
+          index - poly_call->instance_call()->FirstArgIndex();
+      const CallTargets& targets = poly_call->targets();
+      for (intptr_t i = 0; i < targets.length(); i++) {
+        if (!IsNonEscapingParameter(*targets.TargetAt(i)->target,
+                                    param_index)) {
+          return false;
+        }
+      }
+      return true;
+    }
+    return false;
+  }
+
+  static bool IsNonEscapingParameter(const Function& function,
+                                     intptr_t index) {
+    return (index >= 0) && (index < Function::kMaxEscapeSummaryParameters) &&
+           ((function.non_escaping_parameters() & (1 << index)) != 0);
+  }
+
+  const FlowGraph& graph_;
+  GrowableArray<Definition*> aliases_;
+};
+
 // Structure for collecting inline data needed to print inlining tree.
 struct InlinedInfo {
   const Function* caller;
@@ -579,6 +745,9 @@ class PolymorphicInliner : public ValueObject {
 
   const Function& caller_function_;
   const intptr_t caller_inlining_id_;
+
+  // Whether some variant was left out for receiving too few of the calls.
+  bool has_infrequent_variants_;
 };
 
 static bool HasAnnotation(const Function& function, const char* annotation) {
@@ -924,7 +1093,10 @@ class CallSiteInliner : public ValueObject {
     }
 
     GrowableArray<Value*>* arguments = call_data->arguments;
-    const intptr_t constant_arguments = CountConstants(*arguments);
+    const intptr_t constant_arguments =
+        CountConstants(*arguments) +
+        CountSinkableArguments(*arguments, call_data->first_arg_index,
+                               function.non_escaping_parameters());
     InliningDecision decision = ShouldWeInline(
         function, function.optimized_instruction_count(),
         function.optimized_call_site_count(), constant_arguments);
@@ -1187,6 +1359,22 @@ class CallSiteInliner : public ValueObject {
         for (intptr_t i = 0; i < param_stubs->length(); ++i) {
           if ((*param_stubs)[i]->IsConstant()) ++constants_count;
         }
+        if (FLAG_escape_summaries) {
+          // The callee graph may prove more parameters not to escape than
+          // the summary recorded when the callee was last optimized.
+          GrowableArray<Definition*> params(function.NumParameters());
+          for (intptr_t i = inlined_type_args_param;
+               i < param_stubs->length(); ++i) {
+            params.Add((*param_stubs)[i]);
+          }
+          EscapeSummaryCollector escapes(*callee_graph);
+          const intptr_t sinkable_count = CountSinkableArguments(
+              *arguments, first_actual_param_index,
+              function.non_escaping_parameters() | escapes.Collect(params));
+          TRACE_INLINING(THR_Print("     sinkable args: %" Pd "\n",
+                                   sinkable_count));
+          constants_count += sinkable_count;
+        }
 
         FlowGraphInliner::CollectGraphInfo(callee_graph);
         const intptr_t size = function.optimized_instruction_count();
@@ -1514,6 +1702,16 @@ class CallSiteInliner : public ValueObject {
                       call->instance_call()->function_name().ToCString()));
         continue;
       }
+      if ((call_info[call_idx].ratio * 100) < FLAG_inlining_hotness &&
+          !HasOnlyAlwaysInlinedTargets(call->targets())) {
+        TRACE_INLINING(
+            THR_Print("  => %s\n     Bailout: cold %f\n",
+                      call->instance_call()->function_name().ToCString(),
+                      call_info[call_idx].ratio));
+        PRINT_INLINING_TREE("Too cold", &call_info[call_idx].caller(),
+                            &call->targets().FirstTarget(), call);
+        continue;
+      }
       const Function& cl = call_info[call_idx].caller();
       intptr_t caller_inlining_id =
           call_info[call_idx].caller_graph->inlining_id();
@@ -1523,6 +1721,39 @@ class CallSiteInliner : public ValueObject {
     return inlined;
   }
 
+  bool HasOnlyAlwaysInlinedTargets(const CallTargets& targets) {
+    for (intptr_t i = 0; i < targets.length(); ++i) {
+      if (!inliner_->AlwaysInline(*targets.TargetAt(i)->target)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // Counts the arguments that allocation sinking could remove if the callee
+  // was inlined, i.e. allocations passed to parameters that do not escape
+  // according to the given summary. These are weighed like constants.
+  static intptr_t CountSinkableArguments(const GrowableArray<Value*>& arguments,
+                                         intptr_t first_arg_index,
+                                         intptr_t non_escaping_parameters) {
+    if (!FLAG_escape_summaries) {
+      return 0;
+    }
+    const intptr_t count =
+        Utils::Minimum(arguments.length() - first_arg_index,
+                       Function::kMaxEscapeSummaryParameters);
+    intptr_t sinkable_count = 0;
+    for (intptr_t i = 0; i < count; ++i) {
+      Definition* arg =
+          arguments[first_arg_index + i]->definition()->OriginalDefinition();
+      if (((non_escaping_parameters & (1 << i)) != 0) &&
+          AllocationSinking::IsSupportedAllocation(arg)) {
+        ++sinkable_count;
+      }
+    }
+    return sinkable_count;
+  }
+
   bool AdjustForOptionalParameters(const ParsedFunction& parsed_function,
                                    intptr_t first_arg_index,
                                    const Array& argument_names,
@@ -1648,7 +1879,8 @@ PolymorphicInliner::PolymorphicInliner(CallSiteInliner* owner,
       inlined_entries_(num_variants_),
       exit_collector_(new (Z) InlineExitCollector(owner->caller_graph(), call)),
       caller_function_(caller_function),
-      caller_inlining_id_(caller_inlining_id) {}
+      caller_inlining_id_(caller_inlining_id),
+      has_infrequent_variants_(false) {}
 
 Isolate* PolymorphicInliner::isolate() const {
   return owner_->caller_graph()->isolate();
@@ -2060,6 +2292,23 @@ TargetEntryInstr* PolymorphicInliner::BuildDecisionGraph() {
         owner_->caller_graph()->alloc_ssa_temp_index());
     fallback_call->InheritDeoptTarget(zone(), call_);
     fallback_call->set_total_call_count(call_->CallCount());
+    if (has_infrequent_variants_ && !FLAG_precompiled_mode &&
+        call_->instance_call()->HasICData()) {
+      // Count the calls reaching the fallback, so that the caller gets
+      // reoptimized if the targets left out turn out to be frequent after
+      // all, e.g. after a phase change of the program. Every call site may
+      // trigger this a limited number of times. The budget is charged when
+      // the code is installed, as the compilation may still be aborted.
+      const ICData& ic_data = ICData::Handle(
+          zone(), call_->instance_call()->ic_data()->Original());
+      const intptr_t limit =
+          Utils::Minimum<intptr_t>(FLAG_max_polymorphic_reoptimizations,
+                                   ICData::kMaxReoptimizations);
+      if (ic_data.reoptimizations() < limit) {
+        owner_->caller_graph()->AddReoptimizingCallSite(ic_data);
+        fallback_call->set_counts_calls(true);
+      }
+    }
     ReturnInstr* fallback_return =
         new ReturnInstr(call_->instance_call()->token_pos(),
                         new Value(fallback_call), DeoptId::kNone);
@@ -2092,6 +2341,13 @@ static void TracePolyInlining(const CallTargets& targets,
             targets.TargetAt(idx)->count, total, percent, message);
 }
 
+// Returns true if count is less than the given percentage of total.
+static bool IsBelowShare(intptr_t count, intptr_t total, intptr_t percent) {
+  // Counts may be large enough for count * 100 to overflow.
+  return static_cast<double>(count) * 100 <
+         static_cast<double>(total) * percent;
+}
+
 bool PolymorphicInliner::trace_inlining() const {
   return owner_->trace_inlining();
 }
@@ -2100,6 +2356,9 @@ bool PolymorphicInliner::Inline() {
   ASSERT(&variants_ == &call_->targets_);
 
   intptr_t total = call_->total_call_count();
+  const intptr_t min_share =
+      Utils::Minimum(Utils::Maximum(FLAG_polymorphic_inlining_min_share, 0),
+                     100);
   for (intptr_t var_idx = 0; var_idx < variants_.length(); ++var_idx) {
     TargetInfo* info = variants_.TargetAt(var_idx);
     if (variants_.length() > FLAG_max_polymorphic_checks) {
@@ -2119,13 +2378,14 @@ bool PolymorphicInliner::Inline() {
     intptr_t size = target.optimized_instruction_count();
     bool small = (size != 0 && size < FLAG_inlining_size_threshold);
 
-    // If it's less than 3% of the dispatches, we won't even consider
-    // checking for the class ID and branching to another already-inlined
-    // version.
-    if (!try_harder && count < (total >> 5)) {
+    // If it's less than a quarter of the minimum share (3% by default) of
+    // the dispatches, we won't even consider checking for the class ID and
+    // branching to another already-inlined version.
+    if (!try_harder && IsBelowShare(count, total, min_share / 4)) {
       TRACE_INLINING(
           TracePolyInlining(variants_, var_idx, total, "way too infrequent"));
       non_inlined_variants_->Add(info);
+      has_infrequent_variants_ = true;
       continue;
     }
 
@@ -2137,13 +2397,16 @@ bool PolymorphicInliner::Inline() {
       continue;
     }
 
-    // If it's less than 12% of the dispatches and it's not already inlined, we
-    // don't consider inlining.  For very small functions we are willing to
-    // consider inlining for 6% of the cases.
-    if (!try_harder && count < (total >> (small ? 4 : 3))) {
+    // If it's less than the minimum share (12% by default) of the
+    // dispatches and it's not already inlined, we don't consider inlining.
+    // For very small functions we are willing to consider inlining for half
+    // of that share.
+    if (!try_harder &&
+        IsBelowShare(count, total, small ? min_share / 2 : min_share)) {
       TRACE_INLINING(
           TracePolyInlining(variants_, var_idx, total, "too infrequent"));
       non_inlined_variants_->Add(&variants_[var_idx]);
+      has_infrequent_variants_ = true;
       continue;
     }
 
@@ -2201,6 +2464,12 @@ void FlowGraphInliner::CollectGraphInfo(FlowGraph* flow_graph, bool force) {
 
     function.SetOptimizedInstructionCountClamped(info.instruction_count());
     function.SetOptimizedCallSiteCountClamped(info.call_site_count());
+    // Callee graphs being inlined use the arguments in place of their
+    // parameters, so only the final graph of the function is summarized.
+    if (force && !flow_graph->IsCompiledForOsr()) {
+      EscapeSummaryCollector escapes(*flow_graph);
+      function.set_non_escaping_parameters(escapes.Collect());
+    }
   }
 }
 
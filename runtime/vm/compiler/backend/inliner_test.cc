@@ -0,0 +1,117 @@
+// Copyright (c) 2019, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "vm/compiler/backend/inliner.h"
+#include "vm/compiler/backend/il.h"
+#include "vm/compiler/backend/il_test_helper.h"
+#include "vm/object.h"
+#include "vm/symbols.h"
+#include "vm/unit_test.h"
+
+namespace dart {
+
+// Helper method to count the instructions of a flow graph for which the
+// predicate holds.
+static intptr_t CountInstructions(FlowGraph* flow_graph,
+                                  bool (*predicate)(Instruction*)) {
+  intptr_t count = 0;
+  for (BlockIterator block_it = flow_graph->reverse_postorder_iterator();
+       !block_it.Done(); block_it.Advance()) {
+    for (ForwardInstructionIterator it(block_it.Current()); !it.Done();
+         it.Advance()) {
+      if (predicate(it.Current())) {
+        count++;
+      }
+    }
+  }
+  return count;
+}
+
+static bool IsAllocation(Instruction* instr) {
+  return instr->IsAllocateObject() || instr->IsAllocateContext() ||
+         instr->IsAllocateUninitializedContext();
+}
+
+static bool IsCall(Instruction* instr) {
+  return instr->IsStaticCall() || instr->IsClosureCall() ||
+         instr->IsInstanceCall() || instr->IsPolymorphicInstanceCall();
+}
+
+TEST_CASE(EscapeSummaryOfParameters) {
+  const char* script_chars =
+      "class Box {\n"
+      "  var value;\n"
+      "}\n"
+      "load(a, b) => a.value;\n"
+      "storeValue(a, b) {\n"
+      "  b.value = a;\n"
+      "}\n"
+      "select(a, b, bool c) {\n"
+      "  var x = c ? a : b;\n"
+      "  return x.value;\n"
+      "}\n"
+      "identity(a, b) {\n"
+      "  b.value = 0;\n"
+      "  return a;\n"
+      "}\n"
+      "main() {\n"
+      "  var a = new Box();\n"
+      "  var b = new Box();\n"
+      "  for (int i = 0; i < 100; i++) {\n"
+      "    load(a, b);\n"
+      "    storeValue(a, b);\n"
+      "    select(a, b, i.isEven);\n"
+      "    identity(a, b);\n"
+      "  }\n"
+      "}\n";
+  Dart_Handle script = TestCase::LoadTestScript(script_chars, NULL);
+  EXPECT_VALID(Dart_Invoke(script, NewString("main"), 0, NULL));
+
+  TransitionNativeToVM transition(thread);
+  CompilerState state(thread);
+
+  // Loading from or storing into a parameter does not let it escape.
+  FlowGraph* flow_graph = CompileOptimized(thread, script, "load");
+  EXPECT_EQ(0x3, flow_graph->function().non_escaping_parameters());
+
+  // Storing a parameter as the value of a field does.
+  flow_graph = CompileOptimized(thread, script, "storeValue");
+  EXPECT_EQ(0x2, flow_graph->function().non_escaping_parameters());
+
+  // So does merging it with another value in a phi.
+  flow_graph = CompileOptimized(thread, script, "select");
+  EXPECT_EQ(0, flow_graph->function().non_escaping_parameters() & 0x3);
+
+  // And returning it.
+  flow_graph = CompileOptimized(thread, script, "identity");
+  EXPECT_EQ(0x2, flow_graph->function().non_escaping_parameters());
+}
+
+TEST_CASE(InlineNonEscapingClosureArgument) {
+  const char* script_chars =
+      "apply(int f(int y), int x) => f(x);\n"
+      "foo(int n) {\n"
+      "  int s = 0;\n"
+      "  for (int i = 0; i < n; i++) {\n"
+      "    s += apply((y) => y + 1, i);\n"
+      "  }\n"
+      "  return s;\n"
+      "}\n"
+      "main() {\n"
+      "  for (int i = 0; i < 100; i++) foo(10);\n"
+      "}\n";
+  Dart_Handle script = TestCase::LoadTestScript(script_chars, NULL);
+  EXPECT_VALID(Dart_Invoke(script, NewString("main"), 0, NULL));
+
+  TransitionNativeToVM transition(thread);
+  CompilerState state(thread);
+
+  // The closure is only called by apply, so apply and then the closure are
+  // inlined, and the closure is not allocated anymore.
+  FlowGraph* flow_graph = CompileOptimized(thread, script, "foo");
+  EXPECT_EQ(0, CountInstructions(flow_graph, IsCall));
+  EXPECT_EQ(0, CountInstructions(flow_graph, IsAllocation));
+}
+
+}  // namespace dart
@@ -0,0 +1,377 @@
+// Copyright (c) 2019, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#if !defined(DART_PRECOMPILED_RUNTIME)
+
+#include "vm/compiler/backend/loop_optimizer.h"
+
+#include "vm/bit_vector.h"
+#include "vm/flags.h"
+#include "vm/log.h"
+
+namespace dart {
+
+DEFINE_FLAG(bool,
+            loop_versioning,
+            true,
+            "Replace bounds checks in counted loops by a check before the "
+            "loop.");
+DECLARE_FLAG(bool, array_bounds_check_elimination);
+DECLARE_FLAG(bool, trace_optimization);
+
+// Returns true if the induction is an invariant that can be expressed as
+// a bound, i.e. a constant or a constant offset from a definition.
+static bool ToBound(InductionVar* x, Definition** def, int64_t* offset) {
+  if (!InductionVar::IsInvariant(x)) {
+    return false;
+  }
+  if (x->mult() == 0) {
+    *def = nullptr;
+  } else if (x->mult() == 1) {
+    *def = x->def();
+  } else {
+    return false;
+  }
+  *offset = x->offset();
+  return true;
+}
+
+// Returns true if def takes the value of x plus a constant offset in every
+// iteration of the loop, for the basic linear induction x.
+static bool IsOffsetOf(LoopInfo* loop,
+                       Definition* x,
+                       Definition* def,
+                       int64_t* offset) {
+  if (def == x) {
+    *offset = 0;
+    return true;
+  }
+  InductionVar* control = loop->LookupInduction(x);
+  InductionVar* induc = loop->LookupInduction(def);
+  if (!InductionVar::IsLinear(induc) ||
+      !induc->next()->IsEqual(control->next())) {
+    return false;
+  }
+  InductionVar* a = induc->initial();
+  InductionVar* b = control->initial();
+  if (a->mult() != b->mult() || (a->mult() != 0 && a->def() != b->def()) ||
+      Utils::WillSubOverflow(a->offset(), b->offset())) {
+    return false;
+  }
+  *offset = a->offset() - b->offset();
+  return true;
+}
+
+// Returns the integer value def stands for, looking through redefinitions
+// and int64 boxing.
+static Definition* UnwrapInteger(Definition* def) {
+  while (def->IsRedefinition() || def->IsBoxInt64() || def->IsUnboxInt64()) {
+    def = def->InputAt(0)->definition();
+  }
+  return def;
+}
+
+// Returns true if the bound can be used as a smi operand.
+static bool IsTaggedBound(Definition* def) {
+  return def == nullptr || def->representation() == kTagged;
+}
+
+void LoopOptimizer::Optimize() {
+  if (!FLAG_array_bounds_check_elimination) {
+    return;
+  }
+  // Versioning relies on deoptimization, which is not available in AOT
+  // and may have failed before.
+  version_loops_ =
+      FLAG_loop_versioning && !FLAG_precompiled_mode &&
+      !flow_graph_->function().ProhibitsBoundsCheckGeneralization();
+  const LoopHierarchy& hierarchy = flow_graph_->GetLoopHierarchy();
+  if (hierarchy.num_loops() == 0) {
+    return;
+  }
+  hierarchy.ComputeInduction();
+  VisitHierarchy(hierarchy.top());
+}
+
+void LoopOptimizer::VisitHierarchy(LoopInfo* loop) {
+  for (; loop != nullptr; loop = loop->next()) {
+    VisitHierarchy(loop->inner());
+    Bound lower;
+    Bound upper;
+    Definition* x = ComputeControlBounds(loop, &lower, &upper);
+    if (x == nullptr) {
+      continue;
+    }
+    EliminateRedundantChecks(loop, x, lower, upper);
+    if (version_loops_) {
+      VersionLoop(loop, x, lower, upper);
+    }
+  }
+}
+
+void LoopOptimizer::CollectChecks(LoopInfo* loop,
+                                  Definition* x,
+                                  GrowableArray<CheckArrayBoundInstr*>* checks,
+                                  GrowableArray<int64_t>* offsets) {
+  // Checks in the header run before the loop exit test and are left alone.
+  const GrowableArray<BlockEntryInstr*>& preorder = flow_graph_->preorder();
+  for (BitVector::Iterator block_it(loop->blocks()); !block_it.Done();
+       block_it.Advance()) {
+    BlockEntryInstr* block = preorder[block_it.Current()];
+    if (block == loop->header()) {
+      continue;
+    }
+    for (ForwardInstructionIterator it(block); !it.Done(); it.Advance()) {
+      CheckArrayBoundInstr* check = it.Current()->AsCheckArrayBound();
+      int64_t offset = 0;
+      if (check != nullptr &&
+          IsOffsetOf(loop, x, check->index()->definition(), &offset)) {
+        checks->Add(check);
+        offsets->Add(offset);
+      }
+    }
+  }
+}
+
+void LoopOptimizer::EliminateRedundantChecks(LoopInfo* loop,
+                                             Definition* x,
+                                             const Bound& lower,
+                                             const Bound& upper) {
+  // Constant lengths are left to range analysis, so only a constant lower
+  // bound and an upper bound relative to the length are recognized.
+  if (lower.def != nullptr || upper.def == nullptr) {
+    return;
+  }
+  GrowableArray<CheckArrayBoundInstr*> checks;
+  GrowableArray<int64_t> offsets;
+  CollectChecks(loop, x, &checks, &offsets);
+
+  // x + c lies in [lower + c, l + upper + c] for the length l.
+  Definition* length = UnwrapInteger(upper.def);
+  intptr_t count = 0;
+  for (intptr_t i = 0; i < checks.length(); i++) {
+    const int64_t offset = offsets[i];
+    if (Utils::WillAddOverflow(lower.offset, offset) ||
+        Utils::WillAddOverflow(upper.offset, offset) ||
+        (lower.offset + offset < 0) || (upper.offset + offset >= 0) ||
+        UnwrapInteger(checks[i]->length()->definition()) != length) {
+      continue;
+    }
+    checks[i]->RemoveFromGraph();
+    count++;
+  }
+  if (count == 0) {
+    return;
+  }
+  flow_graph_->RecordEliminatedBoundsChecks(count);
+  if (FLAG_trace_optimization) {
+    THR_Print("Removed %" Pd " redundant bounds checks in loop B%" Pd "\n",
+              count, loop->header()->block_id());
+  }
+}
+
+bool LoopOptimizer::VersionLoop(LoopInfo* loop,
+                                Definition* x,
+                                const Bound& lower,
+                                const Bound& upper) {
+  BlockEntryInstr* header = loop->header();
+  BlockEntryInstr* pre_header = header->ImmediateDominator();
+  if (pre_header == nullptr) {
+    return false;
+  }
+  GotoInstr* last = pre_header->last_instruction()->AsGoto();
+  if (last == nullptr || last->successor() != header) {
+    return false;
+  }
+  if (!IsTaggedBound(lower.def) || !IsTaggedBound(upper.def)) {
+    return false;
+  }
+
+  // Collect the checks on x + c against invariant lengths, tracking the
+  // largest c for every length and the smallest c overall.
+  GrowableArray<CheckArrayBoundInstr*> all_checks;
+  GrowableArray<int64_t> all_offsets;
+  CollectChecks(loop, x, &all_checks, &all_offsets);
+  GrowableArray<CheckArrayBoundInstr*> checks;
+  GrowableArray<Definition*> lengths;
+  GrowableArray<int64_t> max_offsets;
+  int64_t min_offset = kMaxInt64;
+  for (intptr_t j = 0; j < all_checks.length(); j++) {
+    CheckArrayBoundInstr* check = all_checks[j];
+    Definition* length = check->length()->definition();
+    const int64_t offset = all_offsets[j];
+    if (loop->Contains(length->GetBlock())) {
+      continue;
+    }
+    checks.Add(check);
+    min_offset = Utils::Minimum(min_offset, offset);
+    intptr_t i = 0;
+    while (i < lengths.length() && lengths[i] != length) {
+      i++;
+    }
+    if (i == lengths.length()) {
+      lengths.Add(length);
+      max_offsets.Add(offset);
+    } else {
+      max_offsets[i] = Utils::Maximum(max_offsets[i], offset);
+    }
+  }
+  if (checks.is_empty()) {
+    return false;
+  }
+
+  // All indices x + c lie in [lower + min_offset, upper + max_offset]
+  // in the body. Make sure all bounds are smis before emitting anything.
+  const int64_t lower_offset = lower.offset + min_offset;
+  if (!Smi::IsValid(lower_offset) ||
+      (lower.def == nullptr && lower_offset < 0)) {
+    return false;
+  }
+  for (intptr_t i = 0; i < lengths.length(); i++) {
+    if (!Smi::IsValid(upper.offset + max_offsets[i] + 1)) {
+      return false;
+    }
+  }
+
+  if (lower.def != nullptr) {
+    ConstantInstr* max_smi =
+        flow_graph_->GetConstant(Smi::Handle(Smi::New(Smi::kMaxValue)));
+    CheckArrayBoundInstr* check = new CheckArrayBoundInstr(
+        new Value(max_smi), new Value(EmitBound(pre_header, lower, min_offset)),
+        DeoptId::kNone);
+    check->mark_generalized();
+    EmitTo(pre_header, check);
+  }
+  for (intptr_t i = 0; i < lengths.length(); i++) {
+    // Checks upper + c + 1 <= length rather than upper + c < length, so
+    // that a loop that is not entered at all (upper = lower - 1) passes.
+    Bound length = {lengths[i], 0};
+    CheckArrayBoundInstr* check = new CheckArrayBoundInstr(
+        new Value(EmitBound(pre_header, length, 1)),
+        new Value(EmitBound(pre_header, upper, max_offsets[i] + 1)),
+        DeoptId::kNone);
+    check->mark_generalized();
+    EmitTo(pre_header, check);
+  }
+
+  if (FLAG_trace_optimization) {
+    THR_Print("Versioned loop B%" Pd " on %" Pd " bounds checks\n",
+              header->block_id(), checks.length());
+  }
+  for (intptr_t i = 0; i < checks.length(); i++) {
+    checks[i]->RemoveFromGraph();
+  }
+  flow_graph_->RecordEliminatedBoundsChecks(checks.length());
+  return true;
+}
+
+Definition* LoopOptimizer::ComputeControlBounds(LoopInfo* loop,
+                                                Bound* lower,
+                                                Bound* upper) {
+  BranchInstr* branch = loop->header()->last_instruction()->AsBranch();
+  if (branch == nullptr) {
+    return nullptr;
+  }
+  RelationalOpInstr* compare = branch->comparison()->AsRelationalOp();
+  if (compare == nullptr || (compare->operation_cid() != kSmiCid &&
+                             compare->operation_cid() != kMintCid)) {
+    return nullptr;
+  }
+
+  // Normalize to a comparison x (kind) limit that holds in the body.
+  const bool true_in_loop = loop->Contains(branch->true_successor());
+  if (true_in_loop == loop->Contains(branch->false_successor())) {
+    return nullptr;
+  }
+  Token::Kind kind = true_in_loop ? compare->kind()
+                                  : Token::NegateComparison(compare->kind());
+  Definition* x = compare->left()->definition();
+  Definition* limit = compare->right()->definition();
+  if (!loop->IsHeaderPhi(x)) {
+    x = compare->right()->definition();
+    limit = compare->left()->definition();
+    kind = Token::FlipComparison(kind);
+  }
+  if (!loop->IsHeaderPhi(x) || loop->Contains(limit->GetBlock())) {
+    return nullptr;
+  }
+
+  InductionVar* induc = loop->LookupInduction(x);
+  if (!InductionVar::IsLinear(induc) ||
+      !InductionVar::IsConstant(induc->next())) {
+    return nullptr;
+  }
+  Bound init;
+  if (!ToBound(induc->initial(), &init.def, &init.offset)) {
+    return nullptr;
+  }
+  Bound end = {limit, 0};
+  if (limit->IsConstant() && limit->AsConstant()->value().IsSmi()) {
+    end.def = nullptr;
+    end.offset = Smi::Cast(limit->AsConstant()->value()).Value();
+  }
+
+  // An increasing x is bounded by its initial value from below and by the
+  // limit from above, and vice versa.
+  const int64_t stride = induc->next()->offset();
+  if (stride > 0) {
+    if (kind == Token::kLT) {
+      end.offset -= 1;
+    } else if (kind != Token::kLTE) {
+      return nullptr;
+    }
+    *lower = init;
+    *upper = end;
+  } else if (stride < 0) {
+    if (kind == Token::kGT) {
+      end.offset += 1;
+    } else if (kind != Token::kGTE) {
+      return nullptr;
+    }
+    *lower = end;
+    *upper = init;
+  } else {
+    return nullptr;
+  }
+  return x;
+}
+
+Definition* LoopOptimizer::EmitBound(BlockEntryInstr* pre_header,
+                                     const Bound& bound,
+                                     int64_t extra) {
+  const int64_t offset = bound.offset + extra;
+  ASSERT(Smi::IsValid(offset));
+  ConstantInstr* constant =
+      flow_graph_->GetConstant(Smi::Handle(Smi::New(offset)));
+  if (bound.def == nullptr) {
+    return constant;
+  }
+  if (bound.def->Type()->ToCid() != kSmiCid) {
+    // Only the smi comparison in the loop header proves this; the loop
+    // deoptimizes there anyway if it does not hold.
+    EmitTo(pre_header, new CheckSmiInstr(new Value(bound.def), DeoptId::kNone,
+                                         TokenPosition::kNoSource));
+  }
+  if (offset == 0) {
+    return bound.def;
+  }
+  BinarySmiOpInstr* add =
+      new BinarySmiOpInstr(Token::kADD, new Value(bound.def),
+                           new Value(constant), DeoptId::kNone);
+  EmitTo(pre_header, add);
+  return add;
+}
+
+void LoopOptimizer::EmitTo(BlockEntryInstr* pre_header, Instruction* instr) {
+  GotoInstr* last = pre_header->last_instruction()->AsGoto();
+  flow_graph_->InsertBefore(
+      last, instr, last->env(),
+      instr->IsDefinition() ? FlowGraph::kValue : FlowGraph::kEffect);
+  instr->CopyDeoptIdFrom(*last);
+  instr->env()->set_deopt_id(instr->GetDeoptId());
+}
+
+}  // namespace dart
+
+#endif  // !defined(DART_PRECOMPILED_RUNTIME)
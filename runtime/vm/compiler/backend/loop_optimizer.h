@@ -0,0 +1,88 @@
+// Copyright (c) 2019, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#ifndef RUNTIME_VM_COMPILER_BACKEND_LOOP_OPTIMIZER_H_
+#define RUNTIME_VM_COMPILER_BACKEND_LOOP_OPTIMIZER_H_
+
+#include "vm/allocation.h"
+#include "vm/compiler/backend/flow_graph.h"
+#include "vm/compiler/backend/il.h"
+#include "vm/compiler/backend/loops.h"
+
+namespace dart {
+
+// Loop transformations driven by the induction variable analysis.
+//
+// Counted loops, i.e. loops whose header exits as soon as a basic linear
+// induction x fails a comparison against a loop-invariant limit, have
+// the bounds checks of their body on x + c removed when the bounds of x
+// prove them redundant, e.g. for a check on x against the length l in
+// a loop running while x < l.
+//
+// In JIT mode, the loops are then versioned on their remaining checks:
+// the checks of array accesses at x + c are replaced by a single range
+// check per array in the loop pre-header. The check deoptimizes when the
+// loop would access the array out of bounds, so unoptimized code acts as
+// the slow version of the loop. The check is marked as generalized, so
+// that a function that deoptimizes on it is never versioned again. AOT
+// code cannot deoptimize and a hoisted check would throw before the
+// effects of the preceding iterations, so AOT loops are not versioned.
+class LoopOptimizer : public ValueObject {
+ public:
+  explicit LoopOptimizer(FlowGraph* flow_graph)
+      : flow_graph_(flow_graph), version_loops_(false) {}
+
+  void Optimize();
+
+ private:
+  // Symbolic bound offset + def (or just offset if def is null).
+  struct Bound {
+    Definition* def;
+    int64_t offset;
+  };
+
+  void VisitHierarchy(LoopInfo* loop);
+
+  // Collects the checks of the body (excluding the header) on x + c,
+  // with the offsets c.
+  void CollectChecks(LoopInfo* loop,
+                     Definition* x,
+                     GrowableArray<CheckArrayBoundInstr*>* checks,
+                     GrowableArray<int64_t>* offsets);
+
+  // Removes the checks on x + c that hold for all x in [lower, upper].
+  void EliminateRedundantChecks(LoopInfo* loop,
+                                Definition* x,
+                                const Bound& lower,
+                                const Bound& upper);
+
+  // Versions the given loop on the bounds checks of its body.
+  // Returns true if any check was hoisted.
+  bool VersionLoop(LoopInfo* loop,
+                   Definition* x,
+                   const Bound& lower,
+                   const Bound& upper);
+
+  // Computes the bounds of the basic induction controlling the loop
+  // on entry to its body. Returns the controlling phi, or null if the
+  // loop is not counted.
+  Definition* ComputeControlBounds(LoopInfo* loop, Bound* lower, Bound* upper);
+
+  // Materializes bound + extra before the last instruction of the
+  // pre-header.
+  Definition* EmitBound(BlockEntryInstr* pre_header,
+                        const Bound& bound,
+                        int64_t extra);
+
+  void EmitTo(BlockEntryInstr* pre_header, Instruction* instr);
+
+  FlowGraph* flow_graph_;
+  bool version_loops_;
+
+  DISALLOW_COPY_AND_ASSIGN(LoopOptimizer);
+};
+
+}  // namespace dart
+
+#endif  // RUNTIME_VM_COMPILER_BACKEND_LOOP_OPTIMIZER_H_
@@ -0,0 +1,466 @@
+// Copyright (c) 2019, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#if !defined(DART_PRECOMPILED_RUNTIME)
+
+#include "vm/compiler/backend/loop_vectorizer.h"
+
+#include "vm/compiler/backend/flow_graph_compiler.h"
+#include "vm/compiler/backend/range_analysis.h"
+#include "vm/flags.h"
+#include "vm/log.h"
+
+namespace dart {
+
+DEFINE_FLAG(bool,
+            loop_vectorization,
+            true,
+            "Vectorize element-wise loops over typed data.");
+DECLARE_FLAG(bool, trace_optimization);
+
+// Largest number of lanes of any vector.
+static const intptr_t kMaxLanes = 4;
+
+// Returns the number of lanes of the vector for the given element class id
+// and the class ids of the vector and of its view of the array, or zero if
+// the elements cannot be vectorized.
+static intptr_t VectorLanes(intptr_t cid,
+                            intptr_t* simd_cid,
+                            intptr_t* array_cid) {
+  switch (cid) {
+    case kTypedDataFloat32ArrayCid:
+      *simd_cid = kFloat32x4Cid;
+      *array_cid = kTypedDataFloat32x4ArrayCid;
+      return 4;
+    case kTypedDataFloat64ArrayCid:
+      *simd_cid = kFloat64x2Cid;
+      *array_cid = kTypedDataFloat64x2ArrayCid;
+      return 2;
+    case kTypedDataInt32ArrayCid:
+      *simd_cid = kInt32x4Cid;
+      *array_cid = kTypedDataInt32x4ArrayCid;
+      return 4;
+    default:
+      return 0;
+  }
+}
+
+// Returns true if the definition is a double constant that converts to
+// single precision without loss.
+static bool IsFloatConstant(Definition* def) {
+  if (!def->IsConstant() || !def->AsConstant()->value().IsDouble()) {
+    return false;
+  }
+  const double value = Double::Cast(def->AsConstant()->value()).value();
+  return static_cast<double>(static_cast<float>(value)) == value;
+}
+
+// Returns true if the arithmetic operation exists on the lanes of a vector.
+static bool IsLaneWiseOp(intptr_t cid, Instruction* instr) {
+  if (cid == kTypedDataInt32ArrayCid) {
+    BinaryIntegerOpInstr* op = instr->AsBinaryIntegerOp();
+    if (op == nullptr) {
+      return false;
+    }
+    // Lanes wrap around on 32 bits, which the truncating store of
+    // the scalar loop does as well.
+    switch (op->op_kind()) {
+      case Token::kADD:
+      case Token::kSUB:
+      case Token::kBIT_AND:
+      case Token::kBIT_OR:
+      case Token::kBIT_XOR:
+        return true;
+      default:
+        return false;
+    }
+  }
+  BinaryDoubleOpInstr* op = instr->AsBinaryDoubleOp();
+  if (op == nullptr) {
+    return false;
+  }
+  switch (op->op_kind()) {
+    case Token::kADD:
+    case Token::kSUB:
+    case Token::kMUL:
+    case Token::kDIV:
+      return true;
+    default:
+      return false;
+  }
+}
+
+void LoopVectorizer::Vectorize() {
+#if defined(TARGET_ARCH_X64) || defined(TARGET_ARCH_ARM64)
+  if (!FLAG_loop_vectorization ||
+      !FlowGraphCompiler::SupportsUnboxedSimd128()) {
+    return;
+  }
+  const LoopHierarchy& hierarchy = flow_graph_->GetLoopHierarchy();
+  if (hierarchy.num_loops() == 0) {
+    return;
+  }
+  hierarchy.ComputeInduction();
+
+  // Find all candidates before changing the graph, which invalidates
+  // the loop hierarchy.
+  GrowableArray<Candidate> candidates;
+  const ZoneGrowableArray<BlockEntryInstr*>& headers = hierarchy.headers();
+  for (intptr_t i = 0; i < headers.length(); i++) {
+    Candidate candidate;
+    if (IsCandidate(headers[i]->loop_info(), &candidate)) {
+      candidates.Add(candidate);
+    }
+  }
+  if (candidates.is_empty()) {
+    return;
+  }
+  for (intptr_t i = 0; i < candidates.length(); i++) {
+    VectorizeLoop(candidates[i]);
+  }
+  flow_graph_->DiscoverBlocks();
+#endif  // defined(TARGET_ARCH_X64) || defined(TARGET_ARCH_ARM64)
+}
+
+bool LoopVectorizer::IsCandidate(LoopInfo* loop, Candidate* candidate) {
+  if (loop->inner() != nullptr || loop->back_edges().length() != 1) {
+    return false;
+  }
+  JoinEntryInstr* header = loop->header()->AsJoinEntry();
+  if (header == nullptr || header->PredecessorCount() != 2) {
+    return false;
+  }
+  BlockEntryInstr* pre_header = header->ImmediateDominator();
+  GotoInstr* last = pre_header->last_instruction()->AsGoto();
+  if (last == nullptr || last->successor() != header) {
+    return false;
+  }
+
+  // The header only tests x < n, branching to the body while it holds.
+  BranchInstr* branch = header->last_instruction()->AsBranch();
+  if (branch == nullptr) {
+    return false;
+  }
+  RelationalOpInstr* compare = branch->comparison()->AsRelationalOp();
+  if (compare == nullptr || compare->operation_cid() != kSmiCid ||
+      compare->kind() != Token::kLT) {
+    return false;
+  }
+  for (Instruction* instr = header->next(); instr != branch;
+       instr = instr->next()) {
+    if (!instr->IsCheckStackOverflow()) {
+      return false;
+    }
+  }
+  BlockEntryInstr* body = branch->true_successor();
+  GotoInstr* back_edge = body->last_instruction()->AsGoto();
+  if (loop->back_edges()[0] != body || back_edge == nullptr ||
+      body->PredecessorCount() != 1) {
+    return false;
+  }
+
+  PhiInstr* x = compare->left()->definition()->AsPhi();
+  intptr_t num_phis = 0;
+  for (PhiIterator it(header); !it.Done(); it.Advance()) {
+    num_phis++;
+  }
+  if (x == nullptr || !loop->IsHeaderPhi(x) || num_phis != 1 ||
+      x->representation() != kTagged || x->Type()->ToCid() != kSmiCid) {
+    return false;
+  }
+  InductionVar* induc = loop->LookupInduction(x);
+  if (!InductionVar::IsLinear(induc) ||
+      !InductionVar::IsConstant(induc->next()) ||
+      induc->next()->offset() != 1) {
+    return false;
+  }
+
+  // The limit must leave room to subtract the lanes without overflow.
+  Definition* limit = compare->right()->definition();
+  if (loop->Contains(limit->GetBlock()) ||
+      limit->Type()->ToCid() != kSmiCid ||
+      !RangeUtils::IsWithin(limit->range(), kSmiMin + kMaxLanes, kSmiMax)) {
+    return false;
+  }
+
+  candidate->header = header;
+  candidate->body = body;
+  candidate->x = x;
+  candidate->limit = limit;
+  candidate->cid = kIllegalCid;
+  for (ForwardInstructionIterator it(body); !it.Done(); it.Advance()) {
+    if (LoadIndexedInstr* load = it.Current()->AsLoadIndexed()) {
+      candidate->cid = load->class_id();
+      break;
+    }
+    if (StoreIndexedInstr* store = it.Current()->AsStoreIndexed()) {
+      candidate->cid = store->class_id();
+      break;
+    }
+  }
+  return IsVectorizableBody(loop, *candidate);
+}
+
+bool LoopVectorizer::IsVectorizableBody(LoopInfo* loop,
+                                        const Candidate& candidate) {
+  const intptr_t cid = candidate.cid;
+  intptr_t simd_cid = kIllegalCid;
+  intptr_t array_cid = kIllegalCid;
+  if (VectorLanes(cid, &simd_cid, &array_cid) == 0) {
+    return false;
+  }
+  JoinEntryInstr* header = candidate.header;
+  const intptr_t back_index = 1 - header->IndexOfPredecessor(
+                                      header->ImmediateDominator());
+  Definition* increment = candidate.x->InputAt(back_index)->definition();
+  const intptr_t element_size = Instance::ElementSizeFor(cid);
+
+  // Maps every definition of the body that has a vector equivalent.
+  DirectChainedHashMap<VectorKV> vectors;
+  intptr_t num_stores = 0;
+  for (ForwardInstructionIterator it(candidate.body); !it.Done();
+       it.Advance()) {
+    Instruction* instr = it.Current();
+    if (instr == increment || instr->IsCheckStackOverflow() ||
+        instr->IsGoto()) {
+      continue;
+    }
+    if (LoadIndexedInstr* load = instr->AsLoadIndexed()) {
+      if (load->class_id() != cid || load->index_scale() != element_size ||
+          load->index()->definition() != candidate.x ||
+          load->array()->definition()->representation() != kTagged ||
+          loop->Contains(load->array()->definition()->GetBlock()) ||
+          load->ComputeCanDeoptimize()) {
+        return false;
+      }
+    } else if (StoreIndexedInstr* store = instr->AsStoreIndexed()) {
+      if (store->class_id() != cid || store->index_scale() != element_size ||
+          store->index()->definition() != candidate.x ||
+          store->array()->definition()->representation() != kTagged ||
+          loop->Contains(store->array()->definition()->GetBlock()) ||
+          !IsVectorOperand(loop, cid, store->value(), &vectors)) {
+        return false;
+      }
+      num_stores++;
+      continue;
+    } else if (IsLaneWiseOp(cid, instr)) {
+      Definition* op = instr->AsDefinition();
+      for (intptr_t i = 0; i < op->InputCount(); i++) {
+        if (!IsVectorOperand(loop, cid, op->InputAt(i), &vectors)) {
+          return false;
+        }
+      }
+      if (cid == kTypedDataFloat32ArrayCid) {
+        // The scalar loop computes in double precision. That only rounds
+        // like single precision for a single operation on floats, which
+        // is rounded back to a float right away.
+        for (intptr_t i = 0; i < op->InputCount(); i++) {
+          Definition* input = op->InputAt(i)->definition();
+          if (!input->IsFloatToDouble() && !IsFloatConstant(input)) {
+            return false;
+          }
+        }
+        for (Value* use = op->input_use_list(); use != nullptr;
+             use = use->next_use()) {
+          if (!use->instruction()->IsDoubleToFloat()) {
+            return false;
+          }
+        }
+      }
+    } else if (instr->IsFloatToDouble() || instr->IsDoubleToFloat()) {
+      if (cid != kTypedDataFloat32ArrayCid ||
+          vectors.LookupValue(instr->InputAt(0)->definition()) == nullptr) {
+        return false;
+      }
+    } else if (instr->IsBox() || instr->IsUnbox() ||
+               instr->IsUnboxedIntConverter()) {
+      if (cid == kTypedDataFloat32ArrayCid ||
+          vectors.LookupValue(instr->InputAt(0)->definition()) == nullptr) {
+        return false;
+      }
+    } else {
+      return false;
+    }
+    Definition* def = instr->AsDefinition();
+    vectors.Insert(VectorKV::Pair(def, def));
+  }
+  return num_stores > 0;
+}
+
+bool LoopVectorizer::IsVectorOperand(LoopInfo* loop,
+                                     intptr_t cid,
+                                     Value* value,
+                                     DirectChainedHashMap<VectorKV>* vectors) {
+  Definition* def = value->definition();
+  if (vectors->LookupValue(def) != nullptr) {
+    return true;
+  }
+  if (loop->Contains(def->GetBlock())) {
+    return false;
+  }
+  switch (cid) {
+    case kTypedDataFloat32ArrayCid:
+      return IsFloatConstant(def);
+    case kTypedDataFloat64ArrayCid:
+      return def->representation() == kUnboxedDouble ||
+             (def->IsConstant() && def->AsConstant()->value().IsDouble());
+    default:
+      return false;
+  }
+}
+
+void LoopVectorizer::VectorizeLoop(const Candidate& candidate) {
+  intptr_t simd_cid = kIllegalCid;
+  intptr_t array_cid = kIllegalCid;
+  const intptr_t lanes = VectorLanes(candidate.cid, &simd_cid, &array_cid);
+  const intptr_t element_size = Instance::ElementSizeFor(candidate.cid);
+  JoinEntryInstr* header = candidate.header;
+  BlockEntryInstr* pre_header = header->ImmediateDominator();
+  GotoInstr* last = pre_header->last_instruction()->AsGoto();
+  const intptr_t pre_index = header->IndexOfPredecessor(pre_header);
+  const intptr_t try_index = header->try_index();
+
+  // Iterations x with x + lanes <= n run as vectors.
+  BinarySmiOpInstr* limit = new BinarySmiOpInstr(
+      Token::kSUB, new Value(candidate.limit),
+      new Value(flow_graph_->GetConstant(Smi::Handle(Smi::New(lanes - 1)))),
+      DeoptId::kNone);
+  limit->set_can_overflow(false);
+  flow_graph_->InsertBefore(last, limit, nullptr, FlowGraph::kValue);
+
+  // The pre-header now enters the vector loop, whose exit takes over the
+  // block id of the pre-header. That keeps the order of the predecessors
+  // of the header, and thus of its phi inputs.
+  const intptr_t exit_id = pre_header->block_id();
+  pre_header->set_block_id(flow_graph_->allocate_block_id());
+  JoinEntryInstr* vector_header = new JoinEntryInstr(
+      flow_graph_->allocate_block_id(), try_index, DeoptId::kNone);
+  TargetEntryInstr* vector_body = new TargetEntryInstr(
+      flow_graph_->allocate_block_id(), try_index, DeoptId::kNone);
+  TargetEntryInstr* vector_exit =
+      new TargetEntryInstr(exit_id, try_index, DeoptId::kNone);
+
+  GotoInstr* enter = new GotoInstr(vector_header, DeoptId::kNone);
+  last->previous()->LinkTo(enter);
+  pre_header->set_last_instruction(enter);
+  vector_exit->LinkTo(last);
+  vector_exit->set_last_instruction(last);
+
+  PhiInstr* index = new PhiInstr(vector_header, 2);
+  flow_graph_->AllocateSSAIndexes(index);
+  index->mark_alive();
+  Definition* init = candidate.x->InputAt(pre_index)->definition();
+  index->SetInputAt(0, new Value(init));
+  init->AddInputUse(index->InputAt(0));
+  vector_header->InsertPhi(index);
+  BranchInstr* branch = new BranchInstr(
+      new RelationalOpInstr(TokenPosition::kNoSource, Token::kLT,
+                            new Value(index), new Value(limit), kSmiCid,
+                            DeoptId::kNone),
+      DeoptId::kNone);
+  vector_header->AppendInstruction(branch);
+  vector_header->set_last_instruction(branch);
+  *branch->true_successor_address() = vector_body;
+  *branch->false_successor_address() = vector_exit;
+
+  // Emit the body on vectors, in the order of the scalar body.
+  Definition* increment = candidate.x->InputAt(1 - pre_index)->definition();
+  DirectChainedHashMap<VectorKV> vectors;
+  Instruction* cursor = vector_body;
+  for (ForwardInstructionIterator it(candidate.body); !it.Done();
+       it.Advance()) {
+    Instruction* instr = it.Current();
+    if (instr == increment || instr->IsCheckStackOverflow() ||
+        instr->IsGoto()) {
+      continue;
+    }
+    Definition* vector = nullptr;
+    if (LoadIndexedInstr* load = instr->AsLoadIndexed()) {
+      vector = new LoadIndexedInstr(
+          new Value(load->array()->definition()), new Value(index),
+          element_size, array_cid, kAlignedAccess, DeoptId::kNone,
+          load->token_pos());
+    } else if (StoreIndexedInstr* store = instr->AsStoreIndexed()) {
+      cursor = flow_graph_->AppendTo(
+          cursor,
+          new StoreIndexedInstr(
+              new Value(store->array()->definition()), new Value(index),
+              new Value(VectorOperand(pre_header, simd_cid, store->value(),
+                                      &vectors)),
+              kNoStoreBarrier, element_size, array_cid, kAlignedAccess,
+              DeoptId::kNone, store->token_pos()),
+          nullptr, FlowGraph::kEffect);
+      continue;
+    } else if (BinaryDoubleOpInstr* op = instr->AsBinaryDoubleOp()) {
+      vector = SimdOpInstr::Create(
+          SimdOpInstr::KindForOperator(simd_cid, op->op_kind()),
+          new Value(VectorOperand(pre_header, simd_cid, op->left(), &vectors)),
+          new Value(VectorOperand(pre_header, simd_cid, op->right(), &vectors)),
+          DeoptId::kNone);
+    } else if (BinaryIntegerOpInstr* op = instr->AsBinaryIntegerOp()) {
+      vector = SimdOpInstr::Create(
+          SimdOpInstr::KindForOperator(simd_cid, op->op_kind()),
+          new Value(VectorOperand(pre_header, simd_cid, op->left(), &vectors)),
+          new Value(VectorOperand(pre_header, simd_cid, op->right(), &vectors)),
+          DeoptId::kNone);
+    } else {
+      // Conversions between representations of the same lanes.
+      ASSERT(instr->InputCount() == 1);
+      vectors.Insert(VectorKV::Pair(
+          instr->AsDefinition(),
+          vectors.LookupValue(instr->InputAt(0)->definition())));
+      continue;
+    }
+    cursor = flow_graph_->AppendTo(cursor, vector, nullptr, FlowGraph::kValue);
+    vectors.Insert(VectorKV::Pair(instr->AsDefinition(), vector));
+  }
+  BinarySmiOpInstr* next = new BinarySmiOpInstr(
+      Token::kADD, new Value(index),
+      new Value(flow_graph_->GetConstant(Smi::Handle(Smi::New(lanes)))),
+      DeoptId::kNone);
+  next->set_can_overflow(false);
+  cursor = flow_graph_->AppendTo(cursor, next, nullptr, FlowGraph::kValue);
+  GotoInstr* back_edge = new GotoInstr(vector_header, DeoptId::kNone);
+  flow_graph_->AppendTo(cursor, back_edge, nullptr, FlowGraph::kEffect);
+  vector_body->set_last_instruction(back_edge);
+  index->SetInputAt(1, new Value(next));
+  next->AddInputUse(index->InputAt(1));
+
+  // The scalar loop starts where the vector loop left off.
+  candidate.x->InputAt(pre_index)->BindTo(index);
+
+  pre_header->ClearDominatedBlocks();
+  pre_header->AddDominatedBlock(vector_header);
+  vector_header->AddDominatedBlock(vector_body);
+  vector_header->AddDominatedBlock(vector_exit);
+  vector_exit->AddDominatedBlock(header);
+
+  if (FLAG_trace_optimization) {
+    THR_Print("Vectorized loop B%" Pd " on %" Pd " lanes\n",
+              header->block_id(), lanes);
+  }
+}
+
+Definition* LoopVectorizer::VectorOperand(
+    BlockEntryInstr* pre_header,
+    intptr_t simd_cid,
+    Value* value,
+    DirectChainedHashMap<VectorKV>* vectors) {
+  Definition* def = value->definition();
+  Definition* vector = vectors->LookupValue(def);
+  if (vector == nullptr) {
+    vector = SimdOpInstr::Create(simd_cid == kFloat32x4Cid
+                                     ? MethodRecognizer::kFloat32x4Splat
+                                     : MethodRecognizer::kFloat64x2Splat,
+                                 new Value(def), DeoptId::kNone);
+    flow_graph_->InsertBefore(pre_header->last_instruction(), vector, nullptr,
+                              FlowGraph::kValue);
+    vectors->Insert(VectorKV::Pair(def, vector));
+  }
+  return vector;
+}
+
+}  // namespace dart
+
+#endif  // !defined(DART_PRECOMPILED_RUNTIME)
@@ -0,0 +1,76 @@
+// Copyright (c) 2019, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#ifndef RUNTIME_VM_COMPILER_BACKEND_LOOP_VECTORIZER_H_
+#define RUNTIME_VM_COMPILER_BACKEND_LOOP_VECTORIZER_H_
+
+#include "vm/allocation.h"
+#include "vm/compiler/backend/flow_graph.h"
+#include "vm/compiler/backend/il.h"
+#include "vm/compiler/backend/loops.h"
+#include "vm/hash_map.h"
+
+namespace dart {
+
+// Vectorizes element-wise loops over Float32List, Float64List and Int32List.
+//
+// A loop qualifies when its header only tests a basic induction x < n,
+// stepping by one from an arbitrary start, and its single body block
+// loads and stores elements at x of loop-invariant arrays, combining them
+// with lane-wise arithmetic. Such a loop is preceded by a copy that runs
+// the same body on whole SIMD vectors (Float32x4, Float64x2 or Int32x4)
+// while x + lanes <= n, and then hands x over to the original loop, which
+// finishes the remaining iterations. No check is added, since no element
+// is accessed that the original loop would not have accessed.
+//
+// Reductions are not vectorized: reassociating floating point additions
+// changes their result, and integer arithmetic is done on 64 bits.
+class LoopVectorizer : public ValueObject {
+ public:
+  explicit LoopVectorizer(FlowGraph* flow_graph) : flow_graph_(flow_graph) {}
+
+  void Vectorize();
+
+ private:
+  typedef RawPointerKeyValueTrait<Definition, Definition*> VectorKV;
+
+  struct Candidate {
+    JoinEntryInstr* header;
+    BlockEntryInstr* body;
+    PhiInstr* x;
+    Definition* limit;
+    intptr_t cid;
+  };
+
+  // Returns true and fills in the candidate if the loop can be vectorized.
+  bool IsCandidate(LoopInfo* loop, Candidate* candidate);
+
+  // Returns true if every instruction of the body has a vector equivalent.
+  bool IsVectorizableBody(LoopInfo* loop, const Candidate& candidate);
+
+  // Returns true if the operand is a vector value or an invariant that can
+  // be splat to all lanes.
+  bool IsVectorOperand(LoopInfo* loop,
+                       intptr_t cid,
+                       Value* value,
+                       DirectChainedHashMap<VectorKV>* vectors);
+
+  // Emits the vector loop in front of the candidate.
+  void VectorizeLoop(const Candidate& candidate);
+
+  // Returns the vector equivalent of the operand, splatting invariants in
+  // the given pre-header.
+  Definition* VectorOperand(BlockEntryInstr* pre_header,
+                            intptr_t simd_cid,
+                            Value* value,
+                            DirectChainedHashMap<VectorKV>* vectors);
+
+  FlowGraph* flow_graph_;
+
+  DISALLOW_COPY_AND_ASSIGN(LoopVectorizer);
+};
+
+}  // namespace dart
+
+#endif  // RUNTIME_VM_COMPILER_BACKEND_LOOP_VECTORIZER_H_
@@ -101,6 +101,29 @@ class InductionVar : public ZoneAllocated {
     return x != nullptr && x->kind_ == kPeriodic;
   }
 
+  // Getters.
+  Kind kind() const { return kind_; }
+  int64_t offset() const {
+    ASSERT(kind_ == kInvariant);
+    return offset_;
+  }
+  int64_t mult() const {
+    ASSERT(kind_ == kInvariant);
+    return mult_;
+  }
+  Definition* def() const {
+    ASSERT(kind_ == kInvariant);
+    return def_;
+  }
+  InductionVar* initial() const {
+    ASSERT(kind_ != kInvariant);
+    return initial_;
+  }
+  InductionVar* next() const {
+    ASSERT(kind_ != kInvariant);
+    return next_;
+  }
+
  private:
   friend class InductionVarAnalysis;
 
@@ -9,6 +9,7 @@
 
 #include "vm/compiler/backend/loops.h"
 #include "vm/compiler/backend/il_printer.h"
+#include "vm/compiler/backend/il_test_helper.h"
 #include "vm/compiler/backend/inliner.h"
 #include "vm/compiler/backend/type_propagator.h"
 #include "vm/compiler/compiler_pass.h"
@@ -22,6 +23,8 @@
 
 namespace dart {
 
+DECLARE_FLAG(bool, loop_versioning);
+
 // Helper method to construct an induction debug string for loop hierarchy.
 void TestString(BufferFormatter* f,
                 LoopInfo* loop,
@@ -62,26 +65,10 @@ static const char* ComputeInduction(Thread* thread, const char* script_chars) {
   Dart_Handle result = Dart_Invoke(script, NewString("main"), 0, NULL);
   EXPECT_VALID(result);
 
-  // Find parsed function "foo".
+  // Build flow graph of function "foo".
   TransitionNativeToVM transition(thread);
-  Zone* zone = thread->zone();
-  Library& lib =
-      Library::ZoneHandle(Library::RawCast(Api::UnwrapHandle(script)));
-  RawFunction* raw_func =
-      lib.LookupLocalFunction(String::Handle(Symbols::New(thread, "foo")));
-  ParsedFunction* parsed_function =
-      new (zone) ParsedFunction(thread, Function::ZoneHandle(zone, raw_func));
-  EXPECT(parsed_function != nullptr);
-
-  // Build flow graph.
   CompilerState state(thread);
-  ZoneGrowableArray<const ICData*>* ic_data_array =
-      new (zone) ZoneGrowableArray<const ICData*>();
-  parsed_function->function().RestoreICDataMap(ic_data_array, true);
-  kernel::FlowGraphBuilder builder(parsed_function, ic_data_array, nullptr,
-                                   nullptr, true, DeoptId::kNone);
-  FlowGraph* flow_graph = builder.BuildGraph();
-  EXPECT(flow_graph != nullptr);
+  FlowGraph* flow_graph = BuildFlowGraph(thread, script, "foo");
 
   // Setup some pass data structures and perform minimum passes.
   SpeculativeInliningPolicy speculative_policy(/*enable_blacklist*/ false);
@@ -104,6 +91,112 @@ static const char* ComputeInduction(Thread* thread, const char* script_chars) {
   return Thread::Current()->zone()->MakeCopyOfString(buffer);
 }
 
+// The bounds checks left in a flow graph, and the number of checks that
+// were removed from it.
+struct BoundsChecks {
+  intptr_t in_loops;
+  intptr_t outside_loops;
+  intptr_t eliminated;
+};
+
+// Helper method to build the CFG of function [name] of an invoked script
+// and run the JIT pipeline on it up to and including the loop
+// optimizations. Returns the bounds checks of the optimized graph.
+static BoundsChecks OptimizeLoops(Thread* thread,
+                                  Dart_Handle script,
+                                  const char* name) {
+  TransitionNativeToVM transition(thread);
+  CompilerState state(thread);
+  FlowGraph* flow_graph = BuildFlowGraph(thread, script, name);
+  RunPassesUpTo(thread, flow_graph, CompilerPass::kOptimizeLoops);
+
+  BoundsChecks checks = {0, 0, flow_graph->eliminated_bounds_checks()};
+  flow_graph->GetLoopHierarchy();
+  for (BlockIterator block_it = flow_graph->reverse_postorder_iterator();
+       !block_it.Done(); block_it.Advance()) {
+    BlockEntryInstr* block = block_it.Current();
+    for (ForwardInstructionIterator it(block); !it.Done(); it.Advance()) {
+      if (it.Current()->IsCheckArrayBound()) {
+        if (block->loop_info() != nullptr) {
+          checks.in_loops++;
+        } else {
+          checks.outside_loops++;
+        }
+      }
+    }
+  }
+  return checks;
+}
+
+// The loops of a flow graph that only access whole vectors of an array, and
+// those that only access its single elements.
+struct VectorizedLoops {
+  intptr_t vector_loops;
+  intptr_t scalar_loops;
+};
+
+// Helper method to build the CFG of function [name] of an invoked script
+// and run the JIT pipeline on it up to and including the vectorization of
+// loops over arrays of class [element_cid], which are accessed as arrays of
+// class [vector_cid] by the vector loops.
+static VectorizedLoops VectorizeLoops(Thread* thread,
+                                      Dart_Handle script,
+                                      const char* name,
+                                      intptr_t element_cid,
+                                      intptr_t vector_cid) {
+  TransitionNativeToVM transition(thread);
+  CompilerState state(thread);
+  FlowGraph* flow_graph = BuildFlowGraph(thread, script, name);
+  RunPassesUpTo(thread, flow_graph, CompilerPass::kVectorizeLoops);
+
+  const LoopHierarchy& hierarchy = flow_graph->GetLoopHierarchy();
+  VectorizedLoops loops = {0, 0};
+  for (intptr_t i = 0; i < hierarchy.headers().length(); i++) {
+    LoopInfo* loop = hierarchy.headers()[i]->loop_info();
+    intptr_t simd_ops = 0;
+    intptr_t vector_loads = 0;
+    intptr_t element_loads = 0;
+    for (BitVector::Iterator block_it(loop->blocks()); !block_it.Done();
+         block_it.Advance()) {
+      BlockEntryInstr* block = flow_graph->preorder()[block_it.Current()];
+      for (ForwardInstructionIterator it(block); !it.Done(); it.Advance()) {
+        if (it.Current()->IsSimdOp()) {
+          simd_ops++;
+        } else if (LoadIndexedInstr* load = it.Current()->AsLoadIndexed()) {
+          if (load->class_id() == vector_cid) {
+            vector_loads++;
+          } else if (load->class_id() == element_cid) {
+            element_loads++;
+          }
+        }
+      }
+    }
+    if ((simd_ops > 0) && (vector_loads > 0) && (element_loads == 0)) {
+      loops.vector_loops++;
+    } else if ((element_loads > 0) && (simd_ops == 0) &&
+               (vector_loads == 0)) {
+      loops.scalar_loops++;
+    }
+  }
+  return loops;
+}
+
+// Helper method to invoke main of a loaded script with its callees
+// optimized early, and return its integer result.
+static int64_t InvokeOptimized(Dart_Handle script) {
+  SetFlagScope<bool> sfs(&FLAG_background_compilation, false);
+  SetFlagScope<int> sfs2(&FLAG_optimization_counter_threshold, 10);
+  Dart_Handle result = Dart_Invoke(script, NewString("main"), 0, NULL);
+  EXPECT_VALID(result);
+  int64_t value = 0;
+  EXPECT_VALID(Dart_IntegerToInt64(result, &value));
+  return value;
+}
+
+static int64_t InvokeOptimized(const char* script_chars) {
+  return InvokeOptimized(TestCase::LoadTestScript(script_chars, NULL));
+}
+
 TEST_CASE(BasicInduction) {
   const char* script_chars =
       "foo() {\n"
@@ -320,4 +413,195 @@ TEST_CASE(PeriodicAndDerived) {
   EXPECT_STREQ(ComputeInduction(thread, script_chars), expected);
 }
 
+TEST_CASE(LoopVersioningDeoptimizesOutOfBounds) {
+  const char* script_chars =
+      "import 'dart:typed_data';\n"
+      "foo(Uint8List a, int n) {\n"
+      "  int s = 0;\n"
+      "  for (int i = 0; i < n; i++) {\n"
+      "    s += a[i];\n"
+      "  }\n"
+      "  return s;\n"
+      "}\n"
+      "main() {\n"
+      "  var a = new Uint8List(10);\n"
+      "  for (int i = 0; i < 10; i++) a[i] = i;\n"
+      "  for (int i = 0; i < 100; i++) foo(a, 10);\n"
+      "  int empty = foo(new Uint8List(0), 0);\n"
+      "  try {\n"
+      "    foo(a, 11);\n"
+      "  } on RangeError catch (e) {\n"
+      "    return foo(a, 10) + empty;\n"
+      "  }\n"
+      "  return -1;\n"
+      "}\n";
+  EXPECT_EQ(45, InvokeOptimized(script_chars));
+}
+
+TEST_CASE(LoopVersioningHoistsBoundsChecks) {
+  const char* script_chars =
+      "import 'dart:typed_data';\n"
+      "foo(Uint8List a, int n) {\n"
+      "  int s = 0;\n"
+      "  for (int i = 0; i < n; i++) {\n"
+      "    s += a[i];\n"
+      "  }\n"
+      "  return s;\n"
+      "}\n"
+      "main() {\n"
+      "  var a = new Uint8List(10);\n"
+      "  for (int i = 0; i < 100; i++) foo(a, 10);\n"
+      "}\n";
+  Dart_Handle script = TestCase::LoadTestScript(script_chars, NULL);
+  EXPECT_VALID(Dart_Invoke(script, NewString("main"), 0, NULL));
+
+  // The check on i < a.length is replaced by a check on n <= a.length in
+  // the loop pre-header.
+  BoundsChecks checks = OptimizeLoops(thread, script, "foo");
+  EXPECT_EQ(0, checks.in_loops);
+  EXPECT_EQ(1, checks.outside_loops);
+  EXPECT_EQ(1, checks.eliminated);
+}
+
+TEST_CASE(LoopVectorizationHandlesRemainder) {
+  const char* script_chars =
+      "import 'dart:typed_data';\n"
+      "scale(Float32List to, Float32List from) {\n"
+      "  for (int i = 0; i < to.length; i++) {\n"
+      "    to[i] = from[i] * 0.5;\n"
+      "  }\n"
+      "}\n"
+      "add(Int32List to, Int32List from) {\n"
+      "  for (int i = 1; i < to.length - 1; i++) {\n"
+      "    to[i] = to[i] + from[i];\n"
+      "  }\n"
+      "}\n"
+      "main() {\n"
+      "  for (int i = 0; i < 100; i++) {\n"
+      "    scale(new Float32List(11), new Float32List(11));\n"
+      "    add(new Int32List(11), new Int32List(11));\n"
+      "  }\n"
+      "  var f = new Float32List(11);\n"
+      "  var a = new Int32List(11);\n"
+      "  for (int i = 0; i < 11; i++) {\n"
+      "    f[i] = i * 4.0;\n"
+      "    a[i] = 0x7fffffff;\n"
+      "  }\n"
+      "  scale(f, f);\n"
+      "  add(a, a);\n"
+      "  int s = 0;\n"
+      "  for (int i = 0; i < 11; i++) {\n"
+      "    s += f[i].toInt() + a[i];\n"
+      "  }\n"
+      "  return s;\n"
+      "}\n";
+  Dart_Handle script = TestCase::LoadTestScript(script_chars, NULL);
+  // f[i] = 2 * i sums to 110. Doubling kMaxInt32 wraps around to -2 for
+  // a[1] to a[9], while a[0] and a[10] keep their value.
+  EXPECT_EQ(110 - 2 * 9 + 2 * static_cast<int64_t>(kMaxInt32),
+            InvokeOptimized(script));
+
+#if defined(TARGET_ARCH_X64) || defined(TARGET_ARCH_ARM64)
+  // Both loops run on whole vectors first, and then finish the remaining
+  // elements in the original loop.
+  VectorizedLoops loops =
+      VectorizeLoops(thread, script, "scale", kTypedDataFloat32ArrayCid,
+                     kTypedDataFloat32x4ArrayCid);
+  EXPECT_EQ(1, loops.vector_loops);
+  EXPECT_EQ(1, loops.scalar_loops);
+  loops = VectorizeLoops(thread, script, "add", kTypedDataInt32ArrayCid,
+                         kTypedDataInt32x4ArrayCid);
+  EXPECT_EQ(1, loops.vector_loops);
+  EXPECT_EQ(1, loops.scalar_loops);
+#endif  // defined(TARGET_ARCH_X64) || defined(TARGET_ARCH_ARM64)
+}
+
+TEST_CASE(RedundantBoundsChecksInLoops) {
+  const char* script_chars =
+      "import 'dart:typed_data';\n"
+      "foo(Uint8List a) {\n"
+      "  int s = 0;\n"
+      "  for (int i = 0; i < a.length; i++) {\n"
+      "    s += a[i];\n"
+      "  }\n"
+      "  for (int i = a.length - 1; i >= 0; i--) {\n"
+      "    s += a[i];\n"
+      "  }\n"
+      "  return s;\n"
+      "}\n"
+      "bar(Uint8List a) {\n"
+      "  int s = 0;\n"
+      "  for (int i = 0; i < a.length; i++) {\n"
+      "    s += a[i + 1];\n"
+      "  }\n"
+      "  return s;\n"
+      "}\n"
+      "main() {\n"
+      "  var a = new Uint8List(10);\n"
+      "  for (int i = 0; i < 10; i++) a[i] = i;\n"
+      "  int caught = 0;\n"
+      "  for (int i = 0; i < 100; i++) {\n"
+      "    foo(a);\n"
+      "    try {\n"
+      "      bar(a);\n"
+      "    } on RangeError catch (e) {\n"
+      "      caught++;\n"
+      "    }\n"
+      "  }\n"
+      "  return foo(a) + caught;\n"
+      "}\n";
+  EXPECT_EQ(190, InvokeOptimized(script_chars));
+}
+
+TEST_CASE(RedundantBoundsChecksRemovedFromLoops) {
+  SetFlagScope<bool> sfs(&FLAG_loop_versioning, false);
+  const char* script_chars =
+      "import 'dart:typed_data';\n"
+      "foo(Uint8List a) {\n"
+      "  int s = 0;\n"
+      "  for (int i = 0; i < a.length; i++) {\n"
+      "    s += a[i];\n"
+      "  }\n"
+      "  for (int i = a.length - 1; i >= 0; i--) {\n"
+      "    s += a[i];\n"
+      "  }\n"
+      "  return s;\n"
+      "}\n"
+      "bar(Uint8List a) {\n"
+      "  int s = 0;\n"
+      "  for (int i = 0; i < a.length - 1; i++) {\n"
+      "    s += a[i + 1];\n"
+      "  }\n"
+      "  for (int i = 0; i < a.length; i++) {\n"
+      "    s += a[i + 1];\n"
+      "  }\n"
+      "  return s;\n"
+      "}\n"
+      "main() {\n"
+      "  var a = new Uint8List(10);\n"
+      "  for (int i = 0; i < 100; i++) {\n"
+      "    foo(a);\n"
+      "    try {\n"
+      "      bar(a);\n"
+      "    } on RangeError catch (e) {\n"
+      "    }\n"
+      "  }\n"
+      "}\n";
+  Dart_Handle script = TestCase::LoadTestScript(script_chars, NULL);
+  EXPECT_VALID(Dart_Invoke(script, NewString("main"), 0, NULL));
+
+  // Both loops of foo stay within [0, a.length - 1].
+  BoundsChecks checks = OptimizeLoops(thread, script, "foo");
+  EXPECT_EQ(0, checks.in_loops);
+  EXPECT_EQ(0, checks.outside_loops);
+  EXPECT_EQ(2, checks.eliminated);
+
+  // Only the first loop of bar stays in bounds. Without versioning, the
+  // check of the second loop is kept.
+  checks = OptimizeLoops(thread, script, "bar");
+  EXPECT_EQ(1, checks.in_loops);
+  EXPECT_EQ(0, checks.outside_loops);
+  EXPECT_EQ(1, checks.eliminated);
+}
+
 }  // namespace dart
@@ -2572,9 +2572,7 @@ void DeadStoreElimination::Optimize(FlowGraph* graph) {
 // Allocation Sinking
 //
 
-// Returns true if the given instruction is an allocation that
-// can be sunk by the Allocation Sinking pass.
-static bool IsSupportedAllocation(Instruction* instr) {
+bool AllocationSinking::IsSupportedAllocation(Instruction* instr) {
   return instr->IsAllocateObject() || instr->IsAllocateUninitializedContext();
 }
 
@@ -2609,7 +2607,7 @@ static bool IsSafeUse(Value* use, SafeUseCheck check_type) {
   if (store != NULL) {
     if (use == store->value()) {
       Definition* instance = store->instance()->definition();
-      return IsSupportedAllocation(instance) &&
+      return AllocationSinking::IsSupportedAllocation(instance) &&
              ((check_type == kOptimisticCheck) ||
               instance->Identity().IsAllocationSinkingCandidate());
     }
@@ -28,6 +28,10 @@ class AllocationSinking : public ZoneAllocated {
 
   void DetachMaterializations();
 
+  // Returns true if the given instruction is an allocation that
+  // can be sunk by the Allocation Sinking pass.
+  static bool IsSupportedAllocation(Instruction* instr);
+
  private:
   // Helper class to collect deoptimization exits that might need to
   // rematerialize an object: that is either instructions that reference
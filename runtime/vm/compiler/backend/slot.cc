@@ -128,7 +128,11 @@ const Slot& Slot::Get(const Field& field,
 
   if (field.guarded_cid() != kIllegalCid &&
       field.guarded_cid() != kDynamicCid) {
-    nullable_cid = field.guarded_cid();
+    // Values of an integer guarded field have no single class id, see
+    // ComputeCompileType.
+    if (field.guarded_cid() != kIntegerCid) {
+      nullable_cid = field.guarded_cid();
+    }
     is_nullable = field.is_nullable();
 
     if (thread->isolate()->use_field_guards()) {
@@ -150,6 +154,9 @@ const Slot& Slot::Get(const Field& field,
 }
 
 CompileType Slot::ComputeCompileType() const {
+  if (IsDartField() && (field().guarded_cid() == kIntegerCid)) {
+    return is_nullable() ? CompileType::NullableInt() : CompileType::Int();
+  }
   return CompileType::CreateNullable(is_nullable(), nullable_cid());
 }
 
@@ -343,6 +343,18 @@ void FlowGraphTypePropagator::VisitGuardFieldClass(
 
   Definition* def = guard->value()->definition();
   CompileType* current = TypeOf(def);
+  if (cid == kIntegerCid) {
+    // The value is either a Smi or a Mint.
+    if (current->IsNone() || !current->IsNullableInt() ||
+        (current->is_nullable() && !guard->field().is_nullable())) {
+      const bool is_nullable =
+          guard->field().is_nullable() && current->is_nullable();
+      SetTypeOf(def, new (zone()) CompileType(is_nullable
+                                                  ? CompileType::NullableInt()
+                                                  : CompileType::Int()));
+    }
+    return;
+  }
   if (current->IsNone() || (current->ToCid() != cid) ||
       (current->is_nullable() && !guard->field().is_nullable())) {
     const bool is_nullable =
@@ -1286,6 +1298,10 @@ CompileType LoadStaticFieldInstr::ComputeType() const {
       abstract_type = nullptr;  // Cid is known, calculate abstract type lazily.
     }
   }
+  if (field.guarded_cid() == kIntegerCid) {
+    return field.is_nullable() ? CompileType::NullableInt()
+                               : CompileType::Int();
+  }
   if ((field.guarded_cid() != kIllegalCid) &&
       (field.guarded_cid() != kDynamicCid)) {
     cid = field.guarded_cid();
@@ -1321,7 +1337,8 @@ CompileType LoadClassIdInstr::ComputeType() const {
 CompileType LoadFieldInstr::ComputeType() const {
   const AbstractType& field_type = slot().static_type();
   CompileType compile_type_cid = slot().ComputeCompileType();
-  if (field_type.raw() == AbstractType::null()) {
+  if ((field_type.raw() == AbstractType::null()) ||
+      (slot().IsDartField() && (slot().field().guarded_cid() == kIntegerCid))) {
     return compile_type_cid;
   }
 
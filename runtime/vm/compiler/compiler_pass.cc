@@ -12,6 +12,8 @@
 #include "vm/compiler/backend/il_printer.h"
 #include "vm/compiler/backend/inliner.h"
 #include "vm/compiler/backend/linearscan.h"
+#include "vm/compiler/backend/loop_optimizer.h"
+#include "vm/compiler/backend/loop_vectorizer.h"
 #include "vm/compiler/backend/range_analysis.h"
 #include "vm/compiler/backend/redundancy_elimination.h"
 #include "vm/compiler/backend/type_propagator.h"
@@ -19,6 +21,7 @@
 #if defined(DART_PRECOMPILER)
 #include "vm/compiler/aot/aot_call_specializer.h"
 #endif
+#include "vm/json_stream.h"
 #include "vm/timeline.h"
 
 #define COMPILER_PASS_REPEAT(Name, Body)                                       \
@@ -175,7 +178,9 @@ void CompilerPass::Run(CompilerPassState* state) const {
     {
       NOT_IN_PRODUCT(
           TimelineDurationScope tds2(thread, state->compiler_timeline, name()));
+      NOT_IN_PRODUCT(const int64_t start = OS::GetCurrentMonotonicMicros());
       repeat = DoBody(state);
+      NOT_IN_PRODUCT(RecordTime(OS::GetCurrentMonotonicMicros() - start));
       DEBUG_ASSERT(state->flow_graph->VerifyUseLists());
       thread->CheckForSafepoint();
     }
@@ -183,6 +188,50 @@ void CompilerPass::Run(CompilerPassState* state) const {
   }
 }
 
+#ifndef PRODUCT
+void CompilerPass::RecordTime(int64_t micros) const {
+  intptr_t bucket = 0;
+  while ((bucket < kNumTimeBuckets - 1) && ((micros >> (bucket + 1)) != 0)) {
+    bucket++;
+  }
+  AtomicOperations::IncrementBy(&time_histogram_[bucket], 1);
+  AtomicOperations::IncrementInt64By(&total_micros_, micros);
+}
+
+void CompilerPass::PrintTimesToJSON(JSONStream* js) {
+  JSONObject obj(js);
+  obj.AddProperty("type", "CompilerPassTimes");
+  {
+    JSONArray limits(&obj, "bucketLimitsMicros");
+    for (intptr_t i = 0; i < kNumTimeBuckets - 1; i++) {
+      limits.AddValue64(static_cast<int64_t>(1) << (i + 1));
+    }
+  }
+  JSONArray passes(&obj, "passes");
+  for (intptr_t i = 0; i < kNumPasses; i++) {
+    CompilerPass* pass = passes_[i];
+    if (pass == NULL) {
+      continue;
+    }
+    JSONObject pass_obj(&passes);
+    pass_obj.AddProperty("name", pass->name());
+    intptr_t runs = 0;
+    {
+      JSONArray histogram(&pass_obj, "histogram");
+      for (intptr_t j = 0; j < kNumTimeBuckets; j++) {
+        const intptr_t count =
+            AtomicOperations::LoadRelaxed(&pass->time_histogram_[j]);
+        histogram.AddValue(count);
+        runs += count;
+      }
+    }
+    pass_obj.AddProperty("runs", runs);
+    pass_obj.AddProperty64("totalMicros", AtomicOperations::LoadRelaxed(
+                                              &pass->total_micros_));
+  }
+}
+#endif  // !PRODUCT
+
 void CompilerPass::PrintGraph(CompilerPassState* state,
                               Flag mask,
                               intptr_t round) const {
@@ -207,6 +256,23 @@ void CompilerPass::PrintGraph(CompilerPassState* state,
 
 void CompilerPass::RunPipeline(PipelineMode mode,
                                CompilerPassState* pass_state) {
+  if (mode == kJITBaseline) {
+    // Implicit getters, setters and recognized methods are still inlined
+    // by the call specializer.
+    INVOKE_PASS(ComputeSSA);
+    INVOKE_PASS(ApplyICData);
+    INVOKE_PASS(SetOuterInliningId);
+    INVOKE_PASS(TypePropagation);
+    INVOKE_PASS(ApplyClassIds);
+    INVOKE_PASS(Canonicalize);
+    INVOKE_PASS(SelectRepresentations);
+    INVOKE_PASS(Canonicalize);
+    INVOKE_PASS(FinalizeGraph);
+    INVOKE_PASS(AllocateRegisters);
+    INVOKE_PASS(ReorderBlocks);
+    return;
+  }
+
   INVOKE_PASS(ComputeSSA);
 #if defined(DART_PRECOMPILER)
   if (mode == kAOT) {
@@ -247,8 +313,12 @@ void CompilerPass::RunPipeline(PipelineMode mode,
   INVOKE_PASS(TryOptimizePatterns);
   INVOKE_PASS(DSE);
   INVOKE_PASS(TypePropagation);
+  INVOKE_PASS(OptimizeLoops);
   INVOKE_PASS(RangeAnalysis);
   INVOKE_PASS(OptimizeBranches);
+  if (mode == kJIT) {
+    INVOKE_PASS(VectorizeLoops);
+  }
   INVOKE_PASS(TypePropagation);
   INVOKE_PASS(TryCatchOptimization);
   INVOKE_PASS(EliminateEnvironments);
@@ -353,6 +423,15 @@ COMPILER_PASS(LICM, {
 
 COMPILER_PASS(DSE, { DeadStoreElimination::Optimize(flow_graph); });
 
+COMPILER_PASS(OptimizeLoops, {
+  // Removes the bounds checks that the induction variables prove redundant
+  // and, in JIT mode only, hoists the others speculatively. Runs after LICM
+  // to see the loop-invariant array lengths, and before range analysis so
+  // that it does not need to see through constraints.
+  LoopOptimizer loop_optimizer(flow_graph);
+  loop_optimizer.Optimize();
+});
+
 COMPILER_PASS(RangeAnalysis, {
   // We have to perform range analysis after LICM because it
   // optimistically moves CheckSmi through phis into loop preheaders
@@ -368,6 +447,13 @@ COMPILER_PASS(OptimizeBranches, {
   ConstantPropagator::OptimizeBranches(flow_graph);
 });
 
+COMPILER_PASS(VectorizeLoops, {
+  // Runs after versioning and range analysis removed the bounds checks
+  // of the loop bodies, which would otherwise keep them scalar.
+  LoopVectorizer loop_vectorizer(flow_graph);
+  loop_vectorizer.Vectorize();
+});
+
 COMPILER_PASS(TryCatchOptimization,
               { TryCatchAnalyzer::Optimize(flow_graph); });
 
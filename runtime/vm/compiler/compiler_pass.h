@@ -34,6 +34,7 @@ namespace dart {
   V(LICM)                                                                      \
   V(OptimisticallySpecializeSmiPhis)                                           \
   V(OptimizeBranches)                                                          \
+  V(OptimizeLoops)                                                             \
   V(RangeAnalysis)                                                             \
   V(ReorderBlocks)                                                             \
   V(ReplaceArrayBoundChecksForAOT)                                             \
@@ -42,6 +43,7 @@ namespace dart {
   V(TryCatchOptimization)                                                      \
   V(TryOptimizePatterns)                                                       \
   V(TypePropagation)                                                           \
+  V(VectorizeLoops)                                                            \
   V(WidenSmiToInt32)                                                           \
   V(WriteBarrierElimination)
 
@@ -50,6 +52,7 @@ class BlockScheduler;
 class CallSpecializer;
 class FlowGraph;
 class Function;
+class JSONStream;
 class Precompiler;
 class SpeculativeInliningPolicy;
 
@@ -114,6 +117,12 @@ class CompilerPass {
   CompilerPass(Id id, const char* name) : name_(name), flags_(0) {
     ASSERT(passes_[id] == NULL);
     passes_[id] = this;
+#ifndef PRODUCT
+    total_micros_ = 0;
+    for (intptr_t i = 0; i < kNumTimeBuckets; i++) {
+      time_histogram_[i] = 0;
+    }
+#endif
 
     // By default print the final flow-graph after the register allocation.
     if (id == kAllocateRegisters) {
@@ -141,10 +150,18 @@ class CompilerPass {
 
   static void ParseFilters(const char* filter);
 
-  enum PipelineMode { kJIT, kAOT };
+  // kJITBaseline runs only the passes needed to generate code from the
+  // type feedback, without inlining or loop optimizations.
+  enum PipelineMode { kJIT, kJITBaseline, kAOT };
 
   static void RunPipeline(PipelineMode mode, CompilerPassState* state);
 
+#ifndef PRODUCT
+  // Reports the number of runs of every pass and a histogram of their
+  // wall time, accumulated over all compilations in this process.
+  static void PrintTimesToJSON(JSONStream* js);
+#endif
+
  protected:
   // This function executes the pass. If it returns true then
   // we will run Canonicalize on the graph and execute the pass
@@ -167,6 +184,19 @@ class CompilerPass {
 
   const char* name_;
   intptr_t flags_;
+
+#ifndef PRODUCT
+  void RecordTime(int64_t micros) const;
+
+  // Bucket i counts the runs that took less than 2^(i + 1) microseconds
+  // (and at least 2^i for i > 0). The last bucket is unbounded.
+  static const intptr_t kNumTimeBuckets = 20;
+
+  // Updated atomically, since passes run on several background compiler
+  // threads at once.
+  mutable intptr_t time_histogram_[kNumTimeBuckets];
+  mutable int64_t total_micros_;
+#endif
 };
 
 }  // namespace dart
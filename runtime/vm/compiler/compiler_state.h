@@ -86,6 +86,11 @@ class CompilerState : public StackResource {
   SlotCache* slot_cache() const { return slot_cache_; }
   void set_slot_cache(SlotCache* cache) { slot_cache_ = cache; }
 
+  // Whether the function is compiled in the baseline tier, which runs only
+  // a cheap subset of the optimization passes.
+  bool is_baseline_tier() const { return is_baseline_tier_; }
+  void set_is_baseline_tier(bool value) { is_baseline_tier_ = value; }
+
   // Create a dummy list of local variables representing a context object
   // with the given number of captured variables and given ID.
   //
@@ -119,6 +124,8 @@ class CompilerState : public StackResource {
   // Cache for Slot objects created during compilation (see slot.h).
   SlotCache* slot_cache_ = nullptr;
 
+  bool is_baseline_tier_ = false;
+
   // Caches for dummy LocalVariables and LocalScopes created during
   // bytecode to IL translation.
   ZoneGrowableArray<LocalScope*>* dummy_scopes_ = nullptr;
@@ -0,0 +1,201 @@
+// Copyright (c) 2019, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#ifndef RUNTIME_VM_COMPILER_JIT_BACKGROUND_COMPILATION_QUEUE_H_
+#define RUNTIME_VM_COMPILER_JIT_BACKGROUND_COMPILATION_QUEUE_H_
+
+#include "vm/allocation.h"
+#include "vm/object.h"
+#include "vm/os.h"
+#include "vm/visitor.h"
+
+namespace dart {
+
+// C-heap allocated background compilation queue element.
+class QueueElement {
+ public:
+  explicit QueueElement(const Function& function)
+      : next_(NULL),
+        function_(function.raw()),
+        enqueue_micros_(OS::GetCurrentMonotonicMicros()),
+        in_progress_(false),
+        cancelled_(false) {}
+
+  virtual ~QueueElement() {
+    next_ = NULL;
+    function_ = Function::null();
+  }
+
+  RawFunction* Function() const { return function_; }
+
+  void set_next(QueueElement* elem) { next_ = elem; }
+  QueueElement* next() const { return next_; }
+
+  RawObject* function() const { return function_; }
+  RawObject** function_ptr() {
+    return reinterpret_cast<RawObject**>(&function_);
+  }
+
+  int64_t enqueue_micros() const { return enqueue_micros_; }
+
+  // Set while a compiler thread works on the element.
+  bool in_progress() const { return in_progress_; }
+  void set_in_progress() { in_progress_ = true; }
+
+  // Set if the function deoptimized while it was being compiled.
+  bool cancelled() const { return cancelled_; }
+  void set_cancelled() { cancelled_ = true; }
+
+ private:
+  QueueElement* next_;
+  RawFunction* function_;
+  int64_t enqueue_micros_;
+  bool in_progress_;
+  bool cancelled_;
+
+  DISALLOW_COPY_AND_ASSIGN(QueueElement);
+};
+
+// Allocated in C-heap. Handles both input and output of background compilation.
+// Elements stay in the queue while they are compiled, so that a function is
+// never queued or compiled twice at the same time. Compiler threads claim the
+// hottest element nobody is working on yet, see Claim.
+class BackgroundCompilationQueue {
+ public:
+  BackgroundCompilationQueue() : first_(NULL), last_(NULL), length_(0) {}
+  virtual ~BackgroundCompilationQueue() { Clear(); }
+
+  void VisitObjectPointers(ObjectPointerVisitor* visitor) {
+    ASSERT(visitor != NULL);
+    QueueElement* p = first_;
+    while (p != NULL) {
+      visitor->VisitPointer(p->function_ptr());
+      p = p->next();
+    }
+  }
+
+  bool IsEmpty() const { return first_ == NULL; }
+  intptr_t length() const { return length_; }
+
+  void Add(QueueElement* value) {
+    ASSERT(value != NULL);
+    ASSERT(value->next() == NULL);
+    if (first_ == NULL) {
+      first_ = value;
+      ASSERT(last_ == NULL);
+    } else {
+      ASSERT(last_ != NULL);
+      last_->set_next(value);
+    }
+    last_ = value;
+    length_++;
+    ASSERT(first_ != NULL && last_ != NULL);
+  }
+
+  bool HasUnclaimed() const {
+    for (QueueElement* p = first_; p != NULL; p = p->next()) {
+      if (!p->in_progress()) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // Marks the element with the highest usage counter as in progress and
+  // returns it, or NULL if all elements are in progress. Queued functions
+  // count up from INT_MIN, so this favors the functions called most since
+  // they were queued. Ties go to the most recently queued function.
+  QueueElement* Claim(Function* function) {
+    QueueElement* best = NULL;
+    intptr_t best_usage = 0;
+    for (QueueElement* p = first_; p != NULL; p = p->next()) {
+      if (p->in_progress()) {
+        continue;
+      }
+      *function = p->Function();
+      const intptr_t usage = function->usage_counter();
+      if ((best == NULL) || (usage >= best_usage)) {
+        best = p;
+        best_usage = usage;
+      }
+    }
+    if (best == NULL) {
+      *function = Function::null();
+      return NULL;
+    }
+    best->set_in_progress();
+    *function = best->Function();
+    return best;
+  }
+
+  void Remove(QueueElement* value) {
+    ASSERT(value != NULL);
+    QueueElement* prev = NULL;
+    QueueElement* p = first_;
+    while (p != value) {
+      ASSERT(p != NULL);
+      prev = p;
+      p = p->next();
+    }
+    if (prev == NULL) {
+      first_ = value->next();
+    } else {
+      prev->set_next(value->next());
+    }
+    if (last_ == value) {
+      last_ = prev;
+    }
+    value->set_next(NULL);
+    length_--;
+  }
+
+  bool ContainsObj(const Object& obj) const {
+    QueueElement* p = first_;
+    while (p != NULL) {
+      if (p->function() == obj.raw()) {
+        return true;
+      }
+      p = p->next();
+    }
+    return false;
+  }
+
+  // Drops the queued requests for 'obj'. A request that is being compiled is
+  // only kept from being queued again.
+  void Cancel(const Object& obj) {
+    QueueElement* p = first_;
+    while (p != NULL) {
+      QueueElement* next = p->next();
+      if (p->function() == obj.raw()) {
+        if (p->in_progress()) {
+          p->set_cancelled();
+        } else {
+          Remove(p);
+          delete p;
+        }
+      }
+      p = next;
+    }
+  }
+
+  void Clear() {
+    while (!IsEmpty()) {
+      QueueElement* e = first_;
+      Remove(e);
+      delete e;
+    }
+    ASSERT((first_ == NULL) && (last_ == NULL) && (length_ == 0));
+  }
+
+ private:
+  QueueElement* first_;
+  QueueElement* last_;
+  intptr_t length_;
+
+  DISALLOW_COPY_AND_ASSIGN(BackgroundCompilationQueue);
+};
+
+}  // namespace dart
+
+#endif  // RUNTIME_VM_COMPILER_JIT_BACKGROUND_COMPILATION_QUEUE_H_
@@ -26,6 +26,7 @@
 #include "vm/compiler/frontend/bytecode_reader.h"
 #include "vm/compiler/frontend/flow_graph_builder.h"
 #include "vm/compiler/frontend/kernel_to_il.h"
+#include "vm/compiler/jit/background_compilation_queue.h"
 #include "vm/compiler/jit/jit_call_specializer.h"
 #include "vm/dart_entry.h"
 #include "vm/debugger.h"
@@ -84,16 +85,50 @@ DEFINE_FLAG(bool,
             false,
             "Trace only optimizing compiler operations.");
 DEFINE_FLAG(bool, trace_bailout, false, "Print bailout from ssa compiler.");
+DEFINE_FLAG(bool,
+            baseline_tier,
+            false,
+            "Compile warm functions with a cheap subset of the optimization "
+            "passes before fully optimizing them.");
+DEFINE_FLAG(int,
+            type_feedback_decay,
+            1,
+            "Shift the call counts of a function right by this amount when "
+            "installing its optimized code, so that later calls outweigh "
+            "earlier ones when reoptimizing.");
 DEFINE_FLAG(bool,
             verify_compiler,
             false,
             "Enable compiler verification assertions");
 
+DECLARE_FLAG(int, baseline_optimization_counter_threshold);
 DECLARE_FLAG(bool, enable_interpreter);
 DECLARE_FLAG(bool, huge_method_cutoff_in_code_size);
 DECLARE_FLAG(bool, trace_failed_optimization_attempts);
 DECLARE_FLAG(bool, unbox_numeric_fields);
 
+// Decays the call counts collected by the unoptimized code of the function,
+// which are consulted again if the function gets reoptimized.
+static void DecayTypeFeedback(const Function& function) {
+  if (FLAG_type_feedback_decay <= 0) {
+    return;
+  }
+  const Array& ic_data_array = Array::Handle(function.ic_data_array());
+  if (ic_data_array.IsNull()) {
+    return;
+  }
+  const intptr_t shift =
+      Utils::Minimum<intptr_t>(FLAG_type_feedback_decay, kBitsPerWord - 1);
+  ICData& ic_data = ICData::Handle();
+  // The first element holds the edge counters.
+  for (intptr_t i = 1; i < ic_data_array.Length(); i++) {
+    ic_data ^= ic_data_array.At(i);
+    if (!ic_data.IsNull()) {
+      ic_data.DecayCounts(shift);
+    }
+  }
+}
+
 static void PrecompilationModeHandler(bool value) {
   if (value) {
 #if defined(TARGET_ARCH_IA32)
@@ -489,6 +524,18 @@ RawError* Compiler::CompileClass(const Class& cls) {
   }
 }
 
+// Returns true if the optimizing compilation of the function should use the
+// baseline tier. Functions running unoptimized code are compiled in it, and
+// their baseline code later triggers the compilation in the full tier.
+static bool ShouldCompileBaseline(const Function& function, intptr_t osr_id) {
+#if defined(TARGET_ARCH_DBC)
+  return false;
+#else
+  return FLAG_baseline_tier && (osr_id == Compiler::kNoOSRDeoptId) &&
+         !function.IsIrregexpFunction() && !function.HasOptimizedCode();
+#endif
+}
+
 class CompileParsedFunctionHelper : public ValueObject {
  public:
   CompileParsedFunctionHelper(ParsedFunction* parsed_function,
@@ -496,6 +543,8 @@ class CompileParsedFunctionHelper : public ValueObject {
                               intptr_t osr_id)
       : parsed_function_(parsed_function),
         optimized_(optimized),
+        baseline_(optimized &&
+                  ShouldCompileBaseline(parsed_function->function(), osr_id)),
         osr_id_(osr_id),
         thread_(Thread::Current()),
         loading_invalidation_gen_at_start_(
@@ -506,6 +555,7 @@ class CompileParsedFunctionHelper : public ValueObject {
  private:
   ParsedFunction* parsed_function() const { return parsed_function_; }
   bool optimized() const { return optimized_; }
+  bool baseline() const { return baseline_; }
   intptr_t osr_id() const { return osr_id_; }
   Thread* thread() const { return thread_; }
   Isolate* isolate() const { return thread_->isolate(); }
@@ -519,6 +569,7 @@ class CompileParsedFunctionHelper : public ValueObject {
 
   ParsedFunction* parsed_function_;
   const bool optimized_;
+  const bool baseline_;
   const intptr_t osr_id_;
   Thread* const thread_;
   const intptr_t loading_invalidation_gen_at_start_;
@@ -661,6 +712,33 @@ RawCode* CompileParsedFunctionHelper::FinalizeCompilation(
       // to ensure that the code will be deoptimized if they are violated.
       thread()->compiler_state().cha().RegisterDependencies(code);
 
+      // Baseline code is replaced by fully optimized code, which should see
+      // all of the type feedback collected so far.
+      if ((osr_id() == Compiler::kNoOSRDeoptId) && !baseline()) {
+        DecayTypeFeedback(function);
+      }
+
+      // Charge the reoptimization budget of the call sites the installed
+      // code counts calls for. This happens at a safepoint, so the state
+      // bits of the ICData are not updated concurrently by the mutator.
+      const GrowableArray<const ICData*>& reoptimizing_call_sites =
+          flow_graph->reoptimizing_call_sites();
+      for (intptr_t i = 0; i < reoptimizing_call_sites.length(); i++) {
+        reoptimizing_call_sites[i]->IncrementReoptimizations();
+      }
+
+      if (baseline()) {
+        NOT_IN_PRODUCT(isolate()->GetBaselineCompilationsMetric()->increment());
+        // Credit the invocations that triggered the baseline compilation
+        // towards the full tier, which baseline code counts up to.
+        function.SetUsageCounter(
+            Utils::Maximum<intptr_t>(
+                function.usage_counter(),
+                Utils::Minimum<intptr_t>(
+                    FLAG_baseline_optimization_counter_threshold,
+                    FLAG_optimization_counter_threshold)));
+      }
+
       const ZoneGrowableArray<const Field*>& guarded_fields =
           *flow_graph->parsed_function().guarded_fields();
       Field& field = Field::Handle();
@@ -740,6 +818,7 @@ RawCode* CompileParsedFunctionHelper::Compile(CompilationPipeline* pipeline) {
       ZoneGrowableArray<const ICData*>* ic_data_array = nullptr;
 
       CompilerState compiler_state(thread());
+      compiler_state.set_is_baseline_tier(baseline());
 
       {
         if (optimized()) {
@@ -821,7 +900,9 @@ RawCode* CompileParsedFunctionHelper::Compile(CompilationPipeline* pipeline) {
         JitCallSpecializer call_specializer(flow_graph, &speculative_policy);
         pass_state.call_specializer = &call_specializer;
 
-        CompilerPass::RunPipeline(CompilerPass::kJIT, &pass_state);
+        CompilerPass::RunPipeline(
+            baseline() ? CompilerPass::kJITBaseline : CompilerPass::kJIT,
+            &pass_state);
       }
 
       ASSERT(pass_state.inline_id_to_function.length() ==
@@ -923,9 +1004,13 @@ static RawObject* CompileFunctionHelper(CompilationPipeline* pipeline,
     if (trace_compiler) {
       const intptr_t token_size =
           function.end_token_pos().Pos() - function.token_pos().Pos();
+      const char* tier = "";
+      if (optimized) {
+        tier = ShouldCompileBaseline(function, osr_id) ? "baseline "
+                                                       : "optimized ";
+      }
       THR_Print("Compiling %s%sfunction %s: '%s' @ token %s, size %" Pd "\n",
-                (osr_id == Compiler::kNoOSRDeoptId ? "" : "osr "),
-                (optimized ? "optimized " : ""),
+                (osr_id == Compiler::kNoOSRDeoptId ? "" : "osr "), tier,
                 (Compiler::IsBackgroundCompilation() ? "(background)" : ""),
                 function.ToFullyQualifiedCString(),
                 function.token_pos().ToCString(), token_size);
@@ -1212,6 +1297,9 @@ RawObject* Compiler::CompileOptimizedFunction(Thread* thread,
   const char* event_name;
   if (osr_id != kNoOSRDeoptId) {
     event_name = "CompileFunctionOptimizedOSR";
+  } else if (ShouldCompileBaseline(function, osr_id)) {
+    event_name = IsBackgroundCompilation() ? "CompileFunctionBaselineBackground"
+                                           : "CompileFunctionBaseline";
   } else if (IsBackgroundCompilation()) {
     event_name = "CompileFunctionOptimizedBackground";
   } else {
@@ -1519,112 +1607,32 @@ void Compiler::AbortBackgroundCompilation(intptr_t deopt_id, const char* msg) {
       deopt_id, Object::background_compilation_error());
 }
 
-// C-heap allocated background compilation queue element.
-class QueueElement {
- public:
-  explicit QueueElement(const Function& function)
-      : next_(NULL), function_(function.raw()) {}
-
-  virtual ~QueueElement() {
-    next_ = NULL;
-    function_ = Function::null();
-  }
-
-  RawFunction* Function() const { return function_; }
-
-  void set_next(QueueElement* elem) { next_ = elem; }
-  QueueElement* next() const { return next_; }
-
-  RawObject* function() const { return function_; }
-  RawObject** function_ptr() {
-    return reinterpret_cast<RawObject**>(&function_);
-  }
-
- private:
-  QueueElement* next_;
-  RawFunction* function_;
-
-  DISALLOW_COPY_AND_ASSIGN(QueueElement);
-};
-
-// Allocated in C-heap. Handles both input and output of background compilation.
-// It implements a FIFO queue, using Peek, Add, Remove operations.
-class BackgroundCompilationQueue {
- public:
-  BackgroundCompilationQueue() : first_(NULL), last_(NULL) {}
-  virtual ~BackgroundCompilationQueue() { Clear(); }
-
-  void VisitObjectPointers(ObjectPointerVisitor* visitor) {
-    ASSERT(visitor != NULL);
-    QueueElement* p = first_;
-    while (p != NULL) {
-      visitor->VisitPointer(p->function_ptr());
-      p = p->next();
-    }
-  }
-
-  bool IsEmpty() const { return first_ == NULL; }
-
-  void Add(QueueElement* value) {
-    ASSERT(value != NULL);
-    ASSERT(value->next() == NULL);
-    if (first_ == NULL) {
-      first_ = value;
-      ASSERT(last_ == NULL);
-    } else {
-      ASSERT(last_ != NULL);
-      last_->set_next(value);
-    }
-    last_ = value;
-    ASSERT(first_ != NULL && last_ != NULL);
-  }
-
-  QueueElement* Peek() const { return first_; }
-
-  RawFunction* PeekFunction() const {
-    QueueElement* e = Peek();
-    if (e == NULL) {
-      return Function::null();
-    } else {
-      return e->Function();
-    }
-  }
-
-  QueueElement* Remove() {
-    ASSERT(first_ != NULL);
-    QueueElement* result = first_;
-    first_ = first_->next();
-    if (first_ == NULL) {
-      last_ = NULL;
-    }
-    return result;
-  }
-
-  bool ContainsObj(const Object& obj) const {
-    QueueElement* p = first_;
-    while (p != NULL) {
-      if (p->function() == obj.raw()) {
-        return true;
-      }
-      p = p->next();
-    }
-    return false;
+#if !defined(PRODUCT)
+static void ReportQueueLength(intptr_t length) {
+  TimelineStream* stream = Timeline::GetCompilerStream();
+  ASSERT(stream != NULL);
+  TimelineEvent* event = stream->StartEvent();
+  if (event != NULL) {
+    event->Counter("BackgroundCompilationQueue");
+    event->SetNumArguments(1);
+    event->FormatArgument(0, "length", "%" Pd, length);
+    event->Complete();
   }
+}
 
-  void Clear() {
-    while (!IsEmpty()) {
-      QueueElement* e = Remove();
-      delete e;
-    }
-    ASSERT((first_ == NULL) && (last_ == NULL));
+static void ReportLatency(const Function& function, int64_t enqueue_micros) {
+  TimelineStream* stream = Timeline::GetCompilerStream();
+  ASSERT(stream != NULL);
+  TimelineEvent* event = stream->StartEvent();
+  if (event != NULL) {
+    event->Duration("BackgroundCompilationLatency", enqueue_micros,
+                    OS::GetCurrentMonotonicMicros());
+    event->SetNumArguments(1);
+    event->CopyArgument(0, "function", function.ToQualifiedCString());
+    event->Complete();
   }
-
- private:
-  QueueElement* first_;
-  QueueElement* last_;
-
-  DISALLOW_COPY_AND_ASSIGN(BackgroundCompilationQueue);
-};
+}
+#endif  // !defined(PRODUCT)
 
 BackgroundCompiler::BackgroundCompiler(Isolate* isolate)
     : isolate_(isolate),
@@ -1633,6 +1641,7 @@ BackgroundCompiler::BackgroundCompiler(Isolate* isolate)
       done_monitor_(new Monitor()),
       running_(false),
       done_(true),
+      running_workers_(0),
       disabled_depth_(0) {}
 
 // Fields all deleted in ::Stop; here clear them.
@@ -1654,11 +1663,12 @@ void BackgroundCompiler::Run() {
       Zone* zone = stack_zone.GetZone();
       HANDLESCOPE(thread);
       Function& function = Function::Handle(zone);
+      QueueElement* qelem = NULL;
       {
         MonitorLocker ml(queue_monitor_);
-        function = function_queue()->PeekFunction();
+        qelem = function_queue()->Claim(&function);
       }
-      while (running_ && !function.IsNull()) {
+      while (running_ && (qelem != NULL)) {
         // This is false if we are compiling bytecode -> unoptimized code.
         const bool optimizing = function.ShouldCompilerOptimize();
         ASSERT(FLAG_enable_interpreter || optimizing);
@@ -1670,49 +1680,66 @@ void BackgroundCompiler::Run() {
           Compiler::CompileFunction(thread, function);
         }
 
-        QueueElement* qelem = NULL;
         {
           MonitorLocker ml(queue_monitor_);
-          if (function_queue()->IsEmpty()) {
+          if (!running_) {
             // We are shutting down, queue was cleared.
-            function = Function::null();
+            qelem = NULL;
           } else {
-            qelem = function_queue()->Remove();
-            const Function& old = Function::Handle(qelem->Function());
+            function_queue()->Remove(qelem);
+            const int64_t latency =
+                OS::GetCurrentMonotonicMicros() - qelem->enqueue_micros();
+#if !defined(PRODUCT)
+            isolate_->GetBackgroundCompilationLatencyMetric()->set_value(
+                latency);
+            isolate_->GetBackgroundCompilationLatencyMaxMetric()->SetValue(
+                latency);
+            ReportLatency(function, qelem->enqueue_micros());
+#endif  // !defined(PRODUCT)
+            if (FLAG_trace_compiler) {
+              THR_Print("Background compilation of %s took %" Pd64 "us\n",
+                        function.ToQualifiedCString(), latency);
+            }
             // If an optimizable method is not optimized, put it back on
-            // the background queue (unless it was passed to foreground).
-            if ((optimizing && !old.HasOptimizedCode() &&
-                 old.IsOptimizable()) ||
-                FLAG_stress_test_background_compilation) {
-              if (old.is_background_optimizable() &&
-                  Compiler::CanOptimizeFunction(thread, old)) {
-                QueueElement* repeat_qelem = new QueueElement(old);
+            // the background queue (unless it was passed to foreground or
+            // deoptimized meanwhile).
+            if (!qelem->cancelled() &&
+                ((optimizing && !function.HasOptimizedCode() &&
+                  function.IsOptimizable()) ||
+                 FLAG_stress_test_background_compilation)) {
+              if (function.is_background_optimizable() &&
+                  Compiler::CanOptimizeFunction(thread, function)) {
+                QueueElement* repeat_qelem = new QueueElement(function);
                 function_queue()->Add(repeat_qelem);
+                ml.Notify();
               }
             }
-            function = function_queue()->PeekFunction();
+            delete qelem;
+            NOT_IN_PRODUCT(ReportQueueLength(function_queue()->length()));
+            qelem = function_queue()->Claim(&function);
           }
         }
-        if (qelem != NULL) {
-          delete qelem;
-        }
       }
     }
     Thread::ExitIsolateAsHelper();
     {
-      // Wait to be notified when the work queue is not empty.
+      // Wait to be notified when there is work nobody is doing yet.
       MonitorLocker ml(queue_monitor_);
-      while (function_queue()->IsEmpty() && running_) {
+      while (!function_queue()->HasUnclaimed() && running_) {
         ml.Wait();
       }
     }
   }  // while running
 
   {
-    // Notify that the thread is done.
+    // Notify when the last thread is done.
     MonitorLocker ml_done(done_monitor_);
-    done_ = true;
-    ml_done.Notify();
+    ASSERT(running_workers_ > 0);
+    running_workers_--;
+    if (running_workers_ == 0) {
+      done_ = true;
+      ml_done.Notify();
+    }
   }
 }
 
@@ -1731,10 +1758,22 @@ void BackgroundCompiler::CompileOptimized(const Function& function) {
     }
     QueueElement* elem = new QueueElement(function);
     function_queue()->Add(elem);
+    NOT_IN_PRODUCT(ReportQueueLength(function_queue()->length()));
     ml.Notify();
   }
 }
 
+void BackgroundCompiler::Cancel(const Function& function) {
+  ASSERT(Thread::Current()->IsMutatorThread());
+  MonitorLocker ml(queue_monitor_);
+  function_queue()->Cancel(function);
+}
+
+intptr_t BackgroundCompiler::QueueLength() {
+  MonitorLocker ml(queue_monitor_);
+  return function_queue()->length();
+}
+
 void BackgroundCompiler::VisitPointers(ObjectPointerVisitor* visitor) {
   function_queue_->VisitObjectPointers(visitor);
 }
@@ -1774,9 +1813,15 @@ void BackgroundCompiler::Start() {
   if (running_ || !done_) return;
   running_ = true;
   done_ = false;
-  bool task_started =
-      Dart::thread_pool()->Run(new BackgroundCompilerTask(this));
-  if (!task_started) {
+  ASSERT(running_workers_ == 0);
+  const intptr_t num_workers =
+      Utils::Maximum(1, FLAG_background_compilation_threads);
+  for (intptr_t i = 0; i < num_workers; i++) {
+    if (Dart::thread_pool()->Run(new BackgroundCompilerTask(this))) {
+      running_workers_++;
+    }
+  }
+  if (running_workers_ == 0) {
     running_ = false;
     done_ = true;
   }
@@ -1791,7 +1836,7 @@ void BackgroundCompiler::Stop() {
     MonitorLocker ml(queue_monitor_);
     running_ = false;
     function_queue_->Clear();
-    ml.Notify();  // Stop waiting for the queue.
+    ml.NotifyAll();  // Stop waiting for the queue.
   }
 
   {
@@ -1911,6 +1956,15 @@ void BackgroundCompiler::CompileOptimized(const Function& function) {
   UNREACHABLE();
 }
 
+void BackgroundCompiler::Cancel(const Function& function) {
+  UNREACHABLE();
+}
+
+intptr_t BackgroundCompiler::QueueLength() {
+  UNREACHABLE();
+  return 0;
+}
+
 void BackgroundCompiler::VisitPointers(ObjectPointerVisitor* visitor) {
   UNREACHABLE();
 }
@@ -158,9 +158,9 @@ class Compiler : public AllStatic {
   static void AbortBackgroundCompilation(intptr_t deopt_id, const char* msg);
 };
 
-// Class to run optimizing compilation in a background thread.
-// Current implementation: one task per isolate, it dies with the owning
-// isolate.
+// Class to run optimizing compilation in background threads.
+// Current implementation: --background_compilation_threads tasks per isolate
+// sharing one queue, they die with the owning isolate.
 // No OSR compilation in the background compiler.
 class BackgroundCompiler {
  public:
@@ -198,6 +198,14 @@ class BackgroundCompiler {
     }
     return false;
   }
+  // Drops pending requests to optimize 'function', e.g. because it just
+  // deoptimized and has to collect new feedback first.
+  static void Cancel(Isolate* isolate, const Function& function) {
+    ASSERT(Thread::Current()->IsMutatorThread());
+    if (isolate->background_compiler() != NULL) {
+      isolate->background_compiler()->Cancel(function);
+    }
+  }
   static bool IsRunning(Isolate* isolate) {
     ASSERT(Thread::Current()->IsMutatorThread());
     if (isolate->background_compiler() != NULL) {
@@ -210,6 +218,9 @@ class BackgroundCompiler {
   // compilation queue.
   void CompileOptimized(const Function& function);
 
+  // Number of functions waiting for or being compiled.
+  intptr_t QueueLength();
+
   void VisitPointers(ObjectPointerVisitor* visitor);
 
   BackgroundCompilationQueue* function_queue() const { return function_queue_; }
@@ -224,15 +235,17 @@ class BackgroundCompiler {
   void Disable();
   bool IsDisabled();
   bool IsRunning() { return !done_; }
+  void Cancel(const Function& function);
 
   Isolate* isolate_;
 
   Monitor* queue_monitor_;  // Controls access to the queue.
   BackgroundCompilationQueue* function_queue_;
 
-  Monitor* done_monitor_;   // Notify/wait that the thread is done.
-  bool running_;            // While true, will try to read queue and compile.
-  bool done_;               // True if the thread is done.
+  Monitor* done_monitor_;     // Notify/wait that the threads are done.
+  bool running_;              // While true, will try to read queue and compile.
+  bool done_;                 // True if all threads are done.
+  intptr_t running_workers_;  // Threads that have not finished Run yet.
 
   int16_t disabled_depth_;
 
@@ -6,6 +6,7 @@
 #include "platform/assert.h"
 #include "vm/class_finalizer.h"
 #include "vm/code_patcher.h"
+#include "vm/compiler/jit/background_compilation_queue.h"
 #include "vm/dart_api_impl.h"
 #include "vm/heap/safepoint.h"
 #include "vm/kernel_isolate.h"
@@ -16,6 +17,9 @@
 
 namespace dart {
 
+DECLARE_FLAG(bool, baseline_tier);
+DECLARE_FLAG(int, baseline_optimization_counter_threshold);
+
 ISOLATE_UNIT_TEST_CASE(CompileScript) {
   const char* kScriptChars =
       "class A {\n"
@@ -110,6 +114,125 @@ ISOLATE_UNIT_TEST_CASE(CompileFunctionOnHelperThread) {
   BackgroundCompiler::Stop(isolate);
 }
 
+ISOLATE_UNIT_TEST_CASE(CompileFunctionsOnHelperThreads) {
+  const char* kScriptChars =
+      "class A {\n"
+      "  static foo() { return 42; }\n"
+      "  static bar() { return 43; }\n"
+      "}\n";
+  String& url =
+      String::Handle(String::New("dart-test:CompileFunctionsOnHelperThreads"));
+  String& source = String::Handle(String::New(kScriptChars));
+  Script& script =
+      Script::Handle(Script::New(url, source, RawScript::kScriptTag));
+  Library& lib = Library::Handle(Library::CoreLibrary());
+  EXPECT(CompilerTest::TestCompileScript(lib, script));
+  EXPECT(ClassFinalizer::ProcessPendingClasses());
+  Class& cls =
+      Class::Handle(lib.LookupClass(String::Handle(Symbols::New(thread, "A"))));
+  EXPECT(!cls.IsNull());
+  Function& foo = Function::Handle(
+      cls.LookupStaticFunction(String::Handle(String::New("foo"))));
+  Function& bar = Function::Handle(
+      cls.LookupStaticFunction(String::Handle(String::New("bar"))));
+  CompilerTest::TestCompileFunction(foo);
+  CompilerTest::TestCompileFunction(bar);
+  EXPECT(!foo.HasOptimizedCode());
+  EXPECT(!bar.HasOptimizedCode());
+#if !defined(PRODUCT)
+  // Constant in product mode.
+  FLAG_background_compilation = true;
+#endif
+  SetFlagScope<int> sfs(&FLAG_background_compilation_threads, 2);
+  Isolate* isolate = thread->isolate();
+  BackgroundCompiler::Start(isolate);
+  isolate->background_compiler()->CompileOptimized(foo);
+  isolate->background_compiler()->CompileOptimized(bar);
+  // Already queued.
+  isolate->background_compiler()->CompileOptimized(foo);
+  EXPECT(isolate->background_compiler()->QueueLength() <= 2);
+  Monitor* m = new Monitor();
+  {
+    MonitorLocker ml(m);
+    while (!foo.HasOptimizedCode() || !bar.HasOptimizedCode()) {
+      ml.WaitWithSafepointCheck(thread, 1);
+    }
+  }
+  delete m;
+  BackgroundCompiler::Stop(isolate);
+  EXPECT_EQ(0, isolate->background_compiler()->QueueLength());
+}
+
+ISOLATE_UNIT_TEST_CASE(BackgroundCompilationQueueClaimAndCancel) {
+  const char* kScriptChars =
+      "class A {\n"
+      "  static foo() { return 42; }\n"
+      "  static bar() { return 43; }\n"
+      "  static baz() { return 44; }\n"
+      "}\n";
+  String& url = String::Handle(
+      String::New("dart-test:BackgroundCompilationQueueClaimAndCancel"));
+  String& source = String::Handle(String::New(kScriptChars));
+  Script& script =
+      Script::Handle(Script::New(url, source, RawScript::kScriptTag));
+  Library& lib = Library::Handle(Library::CoreLibrary());
+  EXPECT(CompilerTest::TestCompileScript(lib, script));
+  EXPECT(ClassFinalizer::ProcessPendingClasses());
+  Class& cls =
+      Class::Handle(lib.LookupClass(String::Handle(Symbols::New(thread, "A"))));
+  EXPECT(!cls.IsNull());
+  Function& foo = Function::Handle(
+      cls.LookupStaticFunction(String::Handle(String::New("foo"))));
+  Function& bar = Function::Handle(
+      cls.LookupStaticFunction(String::Handle(String::New("bar"))));
+  Function& baz = Function::Handle(
+      cls.LookupStaticFunction(String::Handle(String::New("baz"))));
+  foo.SetUsageCounter(10);
+  bar.SetUsageCounter(30);
+  baz.SetUsageCounter(30);
+
+  BackgroundCompilationQueue queue;
+  queue.Add(new QueueElement(foo));
+  queue.Add(new QueueElement(bar));
+  queue.Add(new QueueElement(baz));
+
+  // The hottest function is claimed first, and ties go to the most recently
+  // queued one. Claimed functions stay queued.
+  Function& function = Function::Handle();
+  QueueElement* baz_element = queue.Claim(&function);
+  EXPECT(function.raw() == baz.raw());
+  QueueElement* bar_element = queue.Claim(&function);
+  EXPECT(function.raw() == bar.raw());
+  EXPECT(queue.HasUnclaimed());
+  QueueElement* foo_element = queue.Claim(&function);
+  EXPECT(function.raw() == foo.raw());
+  EXPECT(!queue.HasUnclaimed());
+  EXPECT(queue.Claim(&function) == NULL);
+  EXPECT(function.IsNull());
+  EXPECT_EQ(3, queue.length());
+
+  // Cancelling a function that deoptimized while it is compiled keeps its
+  // element until the compile finishes, but marks it not to be queued again.
+  queue.Cancel(bar);
+  EXPECT_EQ(3, queue.length());
+  EXPECT(bar_element->cancelled());
+  EXPECT(!baz_element->cancelled());
+  EXPECT(!foo_element->cancelled());
+
+  // Cancelling a function that waits to be compiled drops its request.
+  queue.Add(new QueueElement(bar));
+  EXPECT(queue.HasUnclaimed());
+  queue.Cancel(bar);
+  EXPECT_EQ(3, queue.length());
+  EXPECT(!queue.HasUnclaimed());
+
+  queue.Remove(bar_element);
+  delete bar_element;
+  EXPECT(!queue.ContainsObj(bar));
+  EXPECT(queue.ContainsObj(foo));
+  EXPECT(queue.ContainsObj(baz));
+}
+
 ISOLATE_UNIT_TEST_CASE(RegenerateAllocStubs) {
   const char* kScriptChars =
       "class A {\n"
@@ -157,6 +280,78 @@ ISOLATE_UNIT_TEST_CASE(RegenerateAllocStubs) {
   EXPECT_VALID(result);
 }
 
+static Dart_Handle InvokeAdd(Dart_Handle lib, Dart_Handle a, Dart_Handle b) {
+  Dart_Handle args[2] = {a, b};
+  return Dart_Invoke(lib, NewString("add"), 2, args);
+}
+
+ISOLATE_UNIT_TEST_CASE(CompileFunctionBaselineTier) {
+// Baseline compilations are counted by a metric, which PRODUCT lacks.
+#if !defined(TARGET_ARCH_DBC) && !defined(PRODUCT)
+  SetFlagScope<bool> sfs(&FLAG_background_compilation, false);
+  SetFlagScope<bool> sfs2(&FLAG_baseline_tier, true);
+  SetFlagScope<int> sfs3(&FLAG_baseline_optimization_counter_threshold, 10);
+  SetFlagScope<int> sfs4(&FLAG_optimization_counter_threshold, 100);
+  const char* kScriptChars = "add(a, b) => a + b;\n";
+
+  Function& add = Function::Handle();
+  Metric* baseline_compilations =
+      thread->isolate()->GetBaselineCompilationsMetric();
+  const int64_t compilations_at_start = baseline_compilations->value();
+  TransitionVMToNative transition(thread);
+
+  Dart_Handle lib = TestCase::LoadTestScript(kScriptChars, NULL);
+  EXPECT_VALID(lib);
+  {
+    TransitionNativeToVM transition(thread);
+    const Library& library =
+        Library::Handle(Library::RawCast(Api::UnwrapHandle(lib)));
+    add = library.LookupLocalFunction(String::Handle(String::New("add")));
+    EXPECT(!add.IsNull());
+  }
+
+  // Warm calls compile 'add' in the baseline tier.
+  int64_t value = 0;
+  for (intptr_t i = 0; i < 20; i++) {
+    Dart_Handle result =
+        InvokeAdd(lib, Dart_NewInteger(i), Dart_NewInteger(1));
+    EXPECT_VALID(result);
+    EXPECT_VALID(Dart_IntegerToInt64(result, &value));
+    EXPECT_EQ(i + 1, value);
+  }
+  {
+    TransitionNativeToVM transition(thread);
+    EXPECT(add.HasOptimizedCode());
+    EXPECT_EQ(compilations_at_start + 1, baseline_compilations->value());
+  }
+
+  // Doubles deoptimize the baseline code specialized for Smis.
+  Dart_Handle result = InvokeAdd(lib, Dart_NewDouble(1.5), Dart_NewDouble(2));
+  EXPECT_VALID(result);
+  double sum = 0.0;
+  EXPECT_VALID(Dart_DoubleValue(result, &sum));
+  EXPECT_EQ(3.5, sum);
+  {
+    TransitionNativeToVM transition(thread);
+    EXPECT(add.deoptimization_counter() > 0);
+  }
+
+  // Hot calls compile 'add' in the baseline tier again and then in the full
+  // tier, which is not counted as a baseline compilation.
+  for (intptr_t i = 0; i < 500; i++) {
+    result = InvokeAdd(lib, Dart_NewInteger(i), Dart_NewInteger(i));
+    EXPECT_VALID(result);
+    EXPECT_VALID(Dart_IntegerToInt64(result, &value));
+    EXPECT_EQ(2 * i, value);
+  }
+  {
+    TransitionNativeToVM transition(thread);
+    EXPECT(add.HasOptimizedCode());
+    EXPECT_EQ(compilations_at_start + 2, baseline_compilations->value());
+  }
+#endif  // !defined(TARGET_ARCH_DBC) && !defined(PRODUCT)
+}
+
 TEST_CASE(EvalExpression) {
   const char* kScriptChars =
       "int ten = 2 * 5;              \n"
@@ -674,18 +674,75 @@ void FinalizablePersistentHandle::Finalize(
     Isolate* isolate,
     FinalizablePersistentHandle* handle) {
   if (!handle->raw()->IsHeapObject()) {
-    return;  // Free handle.
+    return;  // Free or detached handle.
   }
+  if (FLAG_defer_finalizers) {
+    isolate->api_state()->finalization_queue()->Enqueue(isolate, handle);
+    return;
+  }
+  InvokeCallback(isolate, handle);
+}
+
+void FinalizablePersistentHandle::InvokeCallback(
+    Isolate* isolate,
+    FinalizablePersistentHandle* handle) {
   Dart_WeakPersistentHandleFinalizer callback = handle->callback();
-  ASSERT(callback != NULL);
-  void* peer = handle->peer();
-  Dart_WeakPersistentHandle object = handle->apiHandle();
-  (*callback)(isolate->init_callback_data(), object, peer);
+  if (callback != NULL) {
+    void* peer = handle->peer();
+    Dart_WeakPersistentHandle object = handle->apiHandle();
+    (*callback)(isolate->init_callback_data(), object, peer);
+  } else {
+    ASSERT(handle->IsDetached());  // Deleted while its callback was queued.
+  }
   ApiState* state = isolate->api_state();
   ASSERT(state != NULL);
   state->weak_persistent_handles().FreeHandle(handle);
 }
 
+void FinalizationQueue::Enqueue(Isolate* isolate,
+                                FinalizablePersistentHandle* handle) {
+  ASSERT(handle->callback() != NULL);
+  handle->set_raw(FinalizablePersistentHandle::DetachedSentinel());
+  bool was_empty;
+  {
+    MutexLocker ml(&mutex_);
+    was_empty = (head_ == handles_.length());
+    handles_.Add(handle);
+  }
+  if (was_empty) {
+    // Have the mutator run the callbacks once it is out of the GC.
+    isolate->ScheduleInterrupts(Thread::kVMInterrupt);
+  }
+}
+
+bool FinalizationQueue::RunCallbacks(Isolate* isolate,
+                                     intptr_t max_callbacks) {
+  FinalizablePersistentHandle* batch[kBatchSize];
+  while (max_callbacks > 0) {
+    intptr_t count = 0;
+    {
+      MutexLocker ml(&mutex_);
+      while ((count < kBatchSize) && (count < max_callbacks) &&
+             (head_ < handles_.length())) {
+        batch[count++] = handles_[head_++];
+      }
+      if (head_ == handles_.length()) {
+        handles_.Clear();
+        head_ = 0;
+      }
+    }
+    if (count == 0) {
+      return false;
+    }
+    // Run the callbacks without holding the lock, as they may take a while.
+    for (intptr_t i = 0; i < count; i++) {
+      FinalizablePersistentHandle::InvokeCallback(isolate, batch[i]);
+    }
+    max_callbacks -= count;
+  }
+  return !IsEmpty();
+}
+
 // --- Handles ---
 
 DART_EXPORT bool Dart_IsError(Dart_Handle handle) {
@@ -888,6 +945,10 @@ Dart_HandleFromWeakPersistent(Dart_WeakPersistentHandle object) {
   NoSafepointScope no_safepoint_scope;
   FinalizablePersistentHandle* weak_ref =
       FinalizablePersistentHandle::Cast(object);
+  if (weak_ref->IsDetached()) {
+    // The referent was collected and the callback is still queued.
+    return Api::Null();
+  }
   return Api::NewHandle(thread, weak_ref->raw());
 }
 
@@ -981,6 +1042,11 @@ DART_EXPORT void Dart_DeleteWeakPersistentHandle(
   ASSERT(state != NULL);
   FinalizablePersistentHandle* weak_ref =
       FinalizablePersistentHandle::Cast(object);
+  if (weak_ref->IsDetached()) {
+    // The referent is gone and the queued callback frees the handle.
+    state->finalization_queue()->Cancel(weak_ref);
+    return;
+  }
   weak_ref->EnsureFreeExternal(isolate);
   state->weak_persistent_handles().FreeHandle(weak_ref);
 }
@@ -1445,6 +1511,21 @@ DART_EXPORT void Dart_NotifyLowMemory() {
   Isolate::NotifyLowMemory();
 }
 
+DART_EXPORT void Dart_SetGarbageCollectionGoals(intptr_t gc_time_percent,
+                                                intptr_t pause_millis) {
+  Thread* T = Thread::Current();
+  CHECK_ISOLATE(T->isolate());
+  if ((gc_time_percent < 0) || (gc_time_percent > 100)) {
+    FATAL1("%s expects gc_time_percent to be between 0 and 100.",
+           CURRENT_FUNC);
+  }
+  if (pause_millis < 0) {
+    FATAL1("%s expects pause_millis to be non-negative.", CURRENT_FUNC);
+  }
+  T->isolate()->heap()->SetGoals(gc_time_percent,
+                                 pause_millis * kMicrosecondsPerMillisecond);
+}
+
 DART_EXPORT void Dart_ExitIsolate() {
   Thread* T = Thread::Current();
   CHECK_ISOLATE(T->isolate());
@@ -6151,6 +6232,42 @@ Dart_Handle Dart_LoadCompilationTrace(uint8_t* buffer, intptr_t buffer_length) {
 #endif  // defined(DART_PRECOMPILED_RUNTIME)
 }
 
+DART_EXPORT
+Dart_Handle Dart_SaveTypeFeedback(uint8_t** buffer, intptr_t* buffer_length) {
+#if defined(DART_PRECOMPILED_RUNTIME)
+  return Api::NewError("%s: Cannot compile on an AOT runtime.", CURRENT_FUNC);
+#else
+  Thread* thread = Thread::Current();
+  API_TIMELINE_DURATION(thread);
+  DARTSCOPE(thread);
+  CHECK_NULL(buffer);
+  CHECK_NULL(buffer_length);
+  TypeFeedbackSaver saver(thread->zone());
+  ProgramVisitor::VisitClasses(&saver);
+  saver.StealBuffer(buffer, buffer_length);
+  return Api::Success();
+#endif  // defined(DART_PRECOMPILED_RUNTIME)
+}
+
+DART_EXPORT
+Dart_Handle Dart_LoadTypeFeedback(uint8_t* buffer, intptr_t buffer_length) {
+#if defined(DART_PRECOMPILED_RUNTIME)
+  return Api::NewError("%s: Cannot compile on an AOT runtime.", CURRENT_FUNC);
+#else
+  Thread* thread = Thread::Current();
+  API_TIMELINE_DURATION(thread);
+  DARTSCOPE(thread);
+  CHECK_NULL(buffer);
+  TypeFeedbackLoader loader(thread);
+  const Object& error =
+      Object::Handle(loader.LoadFeedback(buffer, buffer_length));
+  if (error.IsError()) {
+    return Api::NewHandle(T, Error::Cast(error).raw());
+  }
+  return Api::Success();
+#endif  // defined(DART_PRECOMPILED_RUNTIME)
+}
+
 DART_EXPORT Dart_Handle Dart_SortClasses() {
 #if defined(DART_PRECOMPILED_RUNTIME)
   return Api::NewError("%s: Cannot compile on an AOT runtime.", CURRENT_FUNC);
@@ -3095,6 +3095,54 @@ TEST_CASE(DartAPI_WeakPersistentHandleNoCallback) {
   }
 }
 
+TEST_CASE(DartAPI_WeakPersistentHandleDeferredCallback) {
+  SetFlagScope<bool> sfs(&FLAG_defer_finalizers, true);
+  Heap* heap = Isolate::Current()->heap();
+  Dart_WeakPersistentHandle weak_ref = NULL;
+  Dart_WeakPersistentHandle deleted_ref = NULL;
+  int peer = 0;
+  int deleted_peer = 0;
+  {
+    Dart_EnterScope();
+    Dart_Handle obj = NewString("new string");
+    EXPECT_VALID(obj);
+    weak_ref = Dart_NewWeakPersistentHandle(obj, &peer, 1 * KB,
+                                            WeakPersistentHandlePeerFinalizer);
+    EXPECT_VALID(AsHandle(weak_ref));
+    obj = NewString("another new string");
+    EXPECT_VALID(obj);
+    deleted_ref = Dart_NewWeakPersistentHandle(
+        obj, &deleted_peer, 0, WeakPersistentHandlePeerFinalizer);
+    EXPECT_VALID(AsHandle(deleted_ref));
+    Dart_ExitScope();
+  }
+  {
+    TransitionNativeToVM transition(thread);
+    GCTestHelper::CollectNewSpace();
+    GCTestHelper::WaitForGCTasks();
+    // The callbacks are queued, but the external size is already released.
+    EXPECT(peer == 0);
+    EXPECT(deleted_peer == 0);
+    EXPECT(heap->ExternalInWords(Heap::kNew) == 0);
+  }
+  // A handle whose callback is queued no longer has a referent.
+  {
+    Dart_EnterScope();
+    EXPECT(Dart_IsNull(Dart_HandleFromWeakPersistent(weak_ref)));
+    Dart_ExitScope();
+  }
+  // Deleting a handle whose callback is queued cancels the callback.
+  Dart_Isolate isolate = reinterpret_cast<Dart_Isolate>(Isolate::Current());
+  Dart_DeleteWeakPersistentHandle(isolate, deleted_ref);
+  {
+    TransitionNativeToVM transition(thread);
+    EXPECT(thread->HandleInterrupts() == Error::null());
+    EXPECT(peer == 42);
+    EXPECT(deleted_peer == 0);
+    EXPECT(Isolate::Current()->api_state()->finalization_queue()->IsEmpty());
+  }
+}
+
 VM_UNIT_TEST_CASE(DartAPI_WeakPersistentHandlesCallbackShutdown) {
   TestCase::CreateTestIsolate();
   Dart_EnterScope();
@@ -8211,6 +8259,166 @@ TEST_CASE(DartAPI_NotifyLowMemory) {
   EXPECT_VALID(result);
 }
 
+// Runs main of the script in a new isolate with the given GC goals, and
+// returns the capacity of new space afterwards.
+static int64_t NewSpaceCapacityWithGoals(const char* script_chars,
+                                         intptr_t gc_time_percent,
+                                         intptr_t pause_millis) {
+  TestCase::CreateTestIsolate();
+  Dart_EnterScope();
+  Dart_SetGarbageCollectionGoals(gc_time_percent, pause_millis);
+  Dart_Handle lib = TestCase::LoadTestScript(script_chars, NULL);
+  Dart_Handle result = Dart_Invoke(lib, NewString("main"), 0, NULL);
+  EXPECT_VALID(result);
+  int64_t capacity = 0;
+  {
+    Thread* thread = Thread::Current();
+    TransitionNativeToVM transition(thread);
+    Heap* heap = thread->isolate()->heap();
+    EXPECT_EQ(gc_time_percent, heap->gc_time_goal());
+    EXPECT_EQ(pause_millis * kMicrosecondsPerMillisecond,
+              heap->gc_pause_goal_micros());
+    capacity = heap->new_space()->CapacityInWords();
+  }
+  Dart_ExitScope();
+  Dart_ShutdownIsolate();
+  return capacity;
+}
+
+VM_UNIT_TEST_CASE(DartAPI_SetGarbageCollectionGoals) {
+  // New space grows while most of its objects survive, unless its
+  // scavenges would then take longer than the pause goal.
+  const char* kSurvivorsScript =
+      "var keep = [];\n"
+      "void main() {\n"
+      "  for (var i = 0; i < 500000; i++) {\n"
+      "    keep.add(new List(10));\n"
+      "  }\n"
+      "}\n";
+  const int64_t initial_capacity = FLAG_new_gen_semi_initial_size * MBInWords;
+  const int64_t survivors_capacity =
+      NewSpaceCapacityWithGoals(kSurvivorsScript, 0, 0);
+  EXPECT(survivors_capacity > initial_capacity);
+  EXPECT(NewSpaceCapacityWithGoals(kSurvivorsScript, 0, 1) <
+         survivors_capacity);
+
+  // New space does not grow while its objects are garbage, unless its
+  // scavenges take more of the time than the time goal.
+  const char* kGarbageScript =
+      "var v;\n"
+      "void main() {\n"
+      "  for (var i = 0; i < 100000; i++) {\n"
+      "    v = new List(100);\n"
+      "  }\n"
+      "}\n";
+  EXPECT_EQ(initial_capacity, NewSpaceCapacityWithGoals(kGarbageScript, 0, 0));
+  EXPECT(NewSpaceCapacityWithGoals(kGarbageScript, 1, 0) > initial_capacity);
+}
+
+VM_UNIT_TEST_CASE(DartAPI_SaveAndLoadTypeFeedback) {
+  const char* kScriptChars =
+      "class A { var f; foo() => 1; }\n"
+      "class B extends A { foo() => 2; }\n"
+      "call(x) => x.foo();\n"
+      "void main() {\n"
+      "  var a = new A();\n"
+      "  a.f = 42;\n"
+      "  for (int i = 0; i < 10; i++) {\n"
+      "    call(a);\n"
+      "    call(new B());\n"
+      "  }\n"
+      "}\n";
+
+  // Record the feedback of one run of the program.
+  TestCase::CreateTestIsolate();
+  Dart_EnterScope();
+  Dart_Handle lib = TestCase::LoadTestScript(kScriptChars, NULL);
+  Dart_Handle result = Dart_Invoke(lib, NewString("main"), 0, NULL);
+  EXPECT_VALID(result);
+
+  uint8_t* buffer = NULL;
+  intptr_t buffer_length = 0;
+  result = Dart_SaveTypeFeedback(&buffer, &buffer_length);
+  EXPECT_VALID(result);
+  char* feedback = reinterpret_cast<char*>(malloc(buffer_length + 1));
+  memmove(feedback, buffer, buffer_length);
+  feedback[buffer_length] = '\0';
+  EXPECT_SUBSTRING("dart-type-feedback-v1\n", feedback);
+  EXPECT_SUBSTRING(",::,call,", feedback);
+  EXPECT_SUBSTRING(",foo,1,10,", feedback);
+  EXPECT_SUBSTRING(",A,f,dart:core,_Smi\n", feedback);
+
+  // Loading into the same program skips the feedback it already has.
+  result = Dart_LoadTypeFeedback(buffer, buffer_length);
+  EXPECT_VALID(result);
+  Dart_ExitScope();
+  Dart_ShutdownIsolate();
+
+  // Load it into a fresh isolate running the same program, which has not
+  // collected any feedback yet.
+  TestCase::CreateTestIsolate();
+  Dart_EnterScope();
+  lib = TestCase::LoadTestScript(kScriptChars, NULL);
+  EXPECT_VALID(lib);
+  result = Dart_LoadTypeFeedback(reinterpret_cast<uint8_t*>(feedback),
+                                 buffer_length);
+  EXPECT_VALID(result);
+  {
+    Thread* thread = Thread::Current();
+    TransitionNativeToVM transition(thread);
+    StackZone zone(thread);
+    HandleScope scope(thread);
+    const Library& library =
+        Library::Handle(Library::RawCast(Api::UnwrapHandle(lib)));
+    const Function& call =
+        Function::Handle(library.LookupLocalFunction(String::Handle(
+            String::New("call"))));
+    EXPECT(!call.IsNull());
+    EXPECT(call.HasCode());
+    EXPECT_LE(20, call.usage_counter());
+
+    // Both receiver classes of x.foo() are restored.
+    const Array& ic_data_array = Array::Handle(call.ic_data_array());
+    EXPECT(!ic_data_array.IsNull());
+    ICData& ic_data = ICData::Handle();
+    String& name = String::Handle();
+    intptr_t foo_checks = 0;
+    for (intptr_t i = 1; i < ic_data_array.Length(); i++) {
+      ic_data ^= ic_data_array.At(i);
+      name = ic_data.target_name();
+      if (name.Equals("foo")) {
+        foo_checks = ic_data.NumberOfChecks();
+      }
+    }
+    EXPECT_EQ(2, foo_checks);
+
+    const Class& cls =
+        Class::Handle(library.LookupClass(String::Handle(String::New("A"))));
+    EXPECT(!cls.IsNull());
+    const Field& field =
+        Field::Handle(cls.LookupField(String::Handle(String::New("f"))));
+    EXPECT(!field.IsNull());
+    EXPECT_EQ(kSmiCid, field.guarded_cid());
+  }
+
+  // A header must match exactly, not only as a prefix.
+  char bad_feedback[] = "not-type-feedback\n";
+  result = Dart_LoadTypeFeedback(reinterpret_cast<uint8_t*>(bad_feedback),
+                                 strlen(bad_feedback));
+  EXPECT(Dart_IsError(result));
+  char short_header[] = "dart-type\n";
+  result = Dart_LoadTypeFeedback(reinterpret_cast<uint8_t*>(short_header),
+                                 strlen(short_header));
+  EXPECT(Dart_IsError(result));
+  char empty_header[] = "\n";
+  result = Dart_LoadTypeFeedback(reinterpret_cast<uint8_t*>(empty_header),
+                                 strlen(empty_header));
+  EXPECT(Dart_IsError(result));
+  Dart_ExitScope();
+  Dart_ShutdownIsolate();
+  free(feedback);
+}
+
 // There exists another test by name DartAPI_Invoke_CrossLibrary.
 // However, that currently fails for the dartk configuration as it
 // uses Dart_LoadLibray. This test here effectively tests the same
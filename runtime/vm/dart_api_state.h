@@ -221,7 +221,8 @@ class FinalizablePersistentHandle {
                                       external_size(), SpaceForExternal());
   }
 
-  // Called when the referent becomes unreachable.
+  // Called when the referent becomes unreachable. With --defer_finalizers the
+  // callback runs later, see FinalizationQueue.
   void UpdateUnreachable(Isolate* isolate) {
     EnsureFreeExternal(isolate);
     Finalize(isolate, this);
@@ -245,6 +246,9 @@ class FinalizablePersistentHandle {
 
   static FinalizablePersistentHandle* Cast(Dart_WeakPersistentHandle handle);
 
+  // True while the callback of a handle whose referent died is queued.
+  bool IsDetached() const { return raw_ == DetachedSentinel(); }
+
  private:
   enum {
     kExternalNewSpaceBit = 0,
@@ -263,12 +267,19 @@ class FinalizablePersistentHandle {
       : public BitField<uword, bool, kExternalNewSpaceBit, 1> {};
 
   friend class FinalizablePersistentHandles;
+  friend class FinalizationQueue;
 
   FinalizablePersistentHandle()
       : raw_(NULL), peer_(NULL), external_data_(0), callback_(NULL) {}
   ~FinalizablePersistentHandle() {}
 
   static void Finalize(Isolate* isolate, FinalizablePersistentHandle* handle);
+  static void InvokeCallback(Isolate* isolate,
+                             FinalizablePersistentHandle* handle);
+
+  // A Smi, so that the GC ignores detached handles, which cannot be confused
+  // with the next pointer of a free handle.
+  static RawObject* DetachedSentinel() { return Smi::New(1); }
 
   // Overload the raw_ field as a next pointer when adding freed
   // handles to the free list.
@@ -669,6 +680,51 @@ class ApiGrowableArray : public BaseGrowableArray<T, ValueObject, Zone> {
       : BaseGrowableArray<T, ValueObject, Zone>(initial_capacity, zone) {}
 };
 
+// Queues the callbacks of weak persistent handles whose referents were found
+// unreachable, so that the GC pause does not include the embedder's
+// finalization work. The GC detaches each handle from its referent, while
+// external size accounting is still updated eagerly. The mutator then runs the
+// callbacks in bounded batches when it next handles a VM interrupt or a
+// message, and runs all remaining ones at isolate shutdown. A handle stays
+// allocated until its callback has run; deleting it before then cancels the
+// callback.
+class FinalizationQueue {
+ public:
+  static const intptr_t kBatchSize = 64;
+
+  FinalizationQueue() : mutex_(), handles_(), head_(0) {}
+  ~FinalizationQueue() { ASSERT(IsEmpty()); }
+
+  // Called by the GC.
+  void Enqueue(Isolate* isolate, FinalizablePersistentHandle* handle);
+
+  // Called by the mutator. Runs at most 'max_callbacks' callbacks and returns
+  // true if more are queued.
+  bool RunCallbacks(Isolate* isolate, intptr_t max_callbacks);
+  void RunAllCallbacks(Isolate* isolate) {
+    while (RunCallbacks(isolate, kBatchSize)) {
+    }
+  }
+
+  // Cancels the callback of a detached handle that is being deleted.
+  void Cancel(FinalizablePersistentHandle* handle) {
+    ASSERT(handle->IsDetached());
+    handle->set_callback(NULL);
+  }
+
+  bool IsEmpty() {
+    MutexLocker ml(&mutex_);
+    return head_ == handles_.length();
+  }
+
+ private:
+  Mutex mutex_;
+  MallocGrowableArray<FinalizablePersistentHandle*> handles_;
+  intptr_t head_;  // Index of the oldest handle in handles_.
+
+  DISALLOW_COPY_AND_ASSIGN(FinalizationQueue);
+};
+
 // Implementation of the API State used in dart api for maintaining
 // local scopes, persistent handles etc. These are setup on a per isolate
 // basis and destroyed when the isolate is shutdown.
@@ -707,6 +763,8 @@ class ApiState {
     return weak_persistent_handles_;
   }
 
+  FinalizationQueue* finalization_queue() { return &finalization_queue_; }
+
   void VisitObjectPointers(ObjectPointerVisitor* visitor) {
     persistent_handles().VisitObjectPointers(visitor);
   }
@@ -768,6 +826,7 @@ class ApiState {
  private:
   PersistentHandles persistent_handles_;
   FinalizablePersistentHandles weak_persistent_handles_;
+  FinalizationQueue finalization_queue_;
   WeakTable acquired_table_;
 
   // Persistent handles to important objects.
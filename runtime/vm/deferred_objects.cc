@@ -187,6 +187,10 @@ void DeferredPcMarker::Materialize(DeoptContext* deopt_context) {
   if (function.HasOptimizedCode()) {
     function.SwitchToUnoptimizedCode();
   }
+  // Likewise drop a pending background compilation.
+  if (FLAG_background_compilation) {
+    BackgroundCompiler::Cancel(thread->isolate(), function);
+  }
 }
 
 void DeferredPp::Materialize(DeoptContext* deopt_context) {
@@ -59,6 +59,8 @@ constexpr bool kDartPrecompiledRuntime = false;
     "Run optimizing compilation in background")                                \
   R(background_compilation_stop_alot, false, bool, false,                      \
     "Stress test system: stop background compiler often.")                     \
+  P(background_compilation_threads, int, 1,                                    \
+    "Number of threads optimizing functions in background per isolate.")       \
   P(causal_async_stacks, bool, !USING_PRODUCT, "Improved async stacks")        \
   P(collect_code, bool, true, "Attempt to GC infrequently used code.")         \
   P(collect_dynamic_function_names, bool, true,                                \
@@ -72,6 +74,11 @@ constexpr bool kDartPrecompiledRuntime = false;
     "Concurrent mark for old generation.")                                     \
   P(concurrent_sweep, bool, USING_MULTICORE,                                   \
     "Concurrent sweep for old generation.")                                    \
+  P(decommit_free_memory, bool, false,                                         \
+    "Give the memory of large free blocks found by the concurrent sweeper "    \
+    "back to the OS.")                                                         \
+  P(defer_finalizers, bool, false,                                             \
+    "Run weak persistent handle finalizers after the GC pause, in batches.")   \
   R(dedup_instructions, true, bool, false,                                     \
     "Canonicalize instructions when precompiling.")                            \
   C(deoptimize_alot, false, false, bool, false,                                \
@@ -97,11 +104,19 @@ constexpr bool kDartPrecompiledRuntime = false;
     "Report error for bad overrides. Ignored in strong mode.")                 \
   R(error_on_bad_type, false, bool, false,                                     \
     "Report error for malformed types.")                                       \
+  P(evacuation_budget, int, 5,                                                 \
+    "Maximum milliseconds spent evacuating fragmented pages in a GC pause.")   \
   P(fields_may_be_reset, bool, false,                                          \
     "Don't optimize away static field initialization")                         \
   C(force_clone_compiler_objects, false, false, bool, false,                   \
     "Force cloning of objects needed in compiler (ICData and Field).")         \
   R(gc_at_alloc, false, bool, false, "GC at every allocation.")                \
+  P(gc_pause_goal, int, 0,                                                     \
+    "If positive, size the heap to keep GC pauses below this many "            \
+    "milliseconds.")                                                           \
+  P(gc_time_goal, int, 0,                                                      \
+    "If positive, size the heap to keep the percentage of time spent in GC "   \
+    "pauses below this value.")                                                \
   P(getter_setter_ratio, int, 13,                                              \
     "Ratio of getter/setter usage used for double field unboxing heuristics")  \
   P(guess_icdata_cid, bool, true,                                              \
@@ -161,6 +176,9 @@ constexpr bool kDartPrecompiledRuntime = false;
   P(reify_generic_functions, bool, true,                                       \
     "Enable reification of generic functions (not yet supported).")            \
   P(reorder_basic_blocks, bool, true, "Reorder basic blocks")                  \
+  P(scavenger_tasks, int, USING_MULTICORE ? 2 : 0,                             \
+    "The number of tasks to spawn during scavenging (0 means "                 \
+    "perform all scavenging on main thread).")                                 \
   C(stress_async_stacks, false, false, bool, false,                            \
     "Stress test async stack traces")                                          \
   P(strong, bool, true, "Enable strong mode.")                                 \
@@ -200,6 +218,8 @@ constexpr bool kDartPrecompiledRuntime = false;
   P(use_compactor, bool, false, "Compact the heap during old-space GC.")       \
   P(use_cha_deopt, bool, true,                                                 \
     "Use class hierarchy analysis even if it can cause deoptimization.")       \
+  P(use_evacuation, bool, false,                                               \
+    "Evacuate the most fragmented pages during old-space GC.")                 \
   P(use_field_guards, bool, !USING_DBC,                                        \
     "Use field guards and track field types")                                  \
   C(use_osr, false, true, bool, true, "Use OSR")                               \
@@ -282,4 +282,52 @@ TEST_CASE(GuardFieldConstructor2Test) {
   EXPECT_EQ(false, f3.is_nullable());
 }
 
+TEST_CASE(GuardFieldIntegerTest) {
+  SetFlagScope<bool> sfs(&FLAG_background_compilation, false);
+  SetFlagScope<int> sfs2(&FLAG_optimization_counter_threshold, 10);
+  const char* script_chars =
+      "class A {\n"
+      "  int value;\n"
+      "  A(this.value);\n"
+      "}\n"
+      "final a = new A(0);\n"
+      "store(v) {\n"
+      "  a.value = v;\n"
+      "  return a.value;\n"
+      "}\n"
+      "main() {\n"
+      "  for (int i = 0; i < 2000; i++) {\n"
+      "    if (store(i) != i) return false;\n"
+      "  }\n"
+      "  for (int i = 0; i < 2000; i++) {\n"
+      "    var v = i.isEven ? i : 0x4000000000000000 + i;\n"
+      "    if (store(v) != v) return false;\n"
+      "  }\n"
+      "  return identical(store(7), 7);\n"
+      "}\n";
+  Dart_Handle lib = TestCase::LoadTestScript(script_chars, NULL);
+  Dart_Handle result = Dart_Invoke(lib, NewString("main"), 0, NULL);
+  EXPECT_VALID(result);
+  EXPECT(Dart_IsBoolean(result));
+  bool value = false;
+  EXPECT_VALID(Dart_BooleanValue(result, &value));
+  EXPECT(value);
+  TransitionNativeToVM transition(thread);
+  Field& field = Field::ZoneHandle(LookupField(lib, "A", "value"));
+  if (Field::SupportsIntegerGuards()) {
+    // Storing Mints into the field guarded as Smi deoptimizes 'store' once.
+    // Later stores of Smi and Mint values pass the integer guard.
+    EXPECT_EQ(kIntegerCid, field.guarded_cid());
+    EXPECT_EQ(false, field.is_nullable());
+    Library& library = Library::Handle();
+    library ^= Api::UnwrapHandle(lib);
+    const Function& store = Function::Handle(
+        library.LookupLocalFunction(String::Handle(String::New("store"))));
+    EXPECT(store.HasOptimizedCode());
+    EXPECT(store.deoptimization_counter() <= 1);
+  } else {
+    EXPECT_EQ(kDynamicCid, field.guarded_cid());
+  }
+}
+
 }  // namespace dart
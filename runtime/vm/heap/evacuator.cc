@@ -0,0 +1,282 @@
+// Copyright (c) 2019, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "vm/heap/evacuator.h"
+
+#include "vm/globals.h"
+#include "vm/heap/freelist.h"
+#include "vm/heap/heap.h"
+#include "vm/heap/pages.h"
+#include "vm/isolate.h"
+#include "vm/lockers.h"
+#include "vm/object_id_ring.h"
+#include "vm/os.h"
+#include "vm/timeline.h"
+
+namespace dart {
+
+// Pages with more live data than this are not worth evacuating.
+static const intptr_t kMaxCandidateOccupancyPercent = 50;
+
+// Bounds the cost of the candidate lookup done by markers for every slot.
+static const intptr_t kMaxCandidates = 256;
+
+static int CompareByOccupancy(HeapPage* const* a, HeapPage* const* b) {
+  intptr_t a_used = (*a)->used_in_bytes();
+  intptr_t b_used = (*b)->used_in_bytes();
+  return (a_used < b_used) ? -1 : ((a_used > b_used) ? 1 : 0);
+}
+
+static int CompareByAddress(HeapPage* const* a, HeapPage* const* b) {
+  uword a_addr = reinterpret_cast<uword>(*a);
+  uword b_addr = reinterpret_cast<uword>(*b);
+  return (a_addr < b_addr) ? -1 : ((a_addr > b_addr) ? 1 : 0);
+}
+
+GCEvacuator::GCEvacuator(Thread* thread, PageSpace* old_space)
+    : HandleVisitor(thread),
+      ObjectPointerVisitor(thread->isolate()),
+      old_space_(old_space),
+      candidates_(),
+      candidates_start_(0),
+      candidates_end_(0),
+      slots_mutex_(),
+      slots_(),
+      to_pages_(),
+      to_top_(0),
+      to_end_(0),
+      evacuated_pages_(0) {}
+
+GCEvacuator::~GCEvacuator() {}
+
+bool GCEvacuator::SelectCandidates(intptr_t bytes_per_micro,
+                                   int64_t budget_micros) {
+  ASSERT(candidates_.is_empty());
+  MallocGrowableArray<HeapPage*> pages;
+  for (HeapPage* page = old_space_->pages_; page != NULL;
+       page = page->next()) {
+    // Pages that were not swept yet report no usage.
+    intptr_t used = page->used_in_bytes();
+    intptr_t capacity = page->object_end() - page->object_start();
+    if ((used > 0) &&
+        (used * 100 < capacity * kMaxCandidateOccupancyPercent)) {
+      pages.Add(page);
+    }
+  }
+  pages.Sort(CompareByOccupancy);
+
+  // Take the emptiest pages whose live data we expect to move in the budget.
+  intptr_t bytes_budget = bytes_per_micro * budget_micros;
+  MallocGrowableArray<HeapPage*> selected;
+  for (intptr_t i = 0; i < pages.length(); i++) {
+    if (selected.length() == kMaxCandidates) {
+      break;
+    }
+    bytes_budget -= pages[i]->used_in_bytes();
+    if (bytes_budget < 0) {
+      break;
+    }
+    selected.Add(pages[i]);
+  }
+  if (selected.is_empty()) {
+    return false;
+  }
+
+  selected.Sort(CompareByAddress);
+  for (intptr_t i = 0; i < selected.length(); i++) {
+    Candidate candidate = {selected[i], false};
+    candidates_.Add(candidate);
+  }
+  candidates_start_ = reinterpret_cast<uword>(selected[0]);
+  candidates_end_ =
+      reinterpret_cast<uword>(selected[selected.length() - 1]) + kPageSize;
+  return true;
+}
+
+intptr_t GCEvacuator::CandidateIndex(uword addr) const {
+  if ((addr < candidates_start_) || (addr >= candidates_end_)) {
+    return -1;
+  }
+  // Only compares addresses: 'addr' may be in an image page, where the page
+  // header cannot be read.
+  uword page = addr & kPageMask;
+  intptr_t lo = 0;
+  intptr_t hi = candidates_.length() - 1;
+  while (lo <= hi) {
+    intptr_t mid = lo + (hi - lo) / 2;
+    uword mid_page = reinterpret_cast<uword>(candidates_[mid].page);
+    if (mid_page == page) {
+      return mid;
+    } else if (mid_page < page) {
+      lo = mid + 1;
+    } else {
+      hi = mid - 1;
+    }
+  }
+  return -1;
+}
+
+void GCEvacuator::AddSlots(const MallocGrowableArray<RawObject**>& slots) {
+  MutexLocker ml(&slots_mutex_);
+  for (intptr_t i = 0; i < slots.length(); i++) {
+    slots_.Add(slots[i]);
+  }
+}
+
+intptr_t GCEvacuator::Evacuate(int64_t budget_micros) {
+  Thread* thread = Thread::Current();
+  const int64_t start = OS::GetCurrentMonotonicMicros();
+  intptr_t moved_bytes = 0;
+
+  {
+    TIMELINE_FUNCTION_GC_DURATION(thread, "EvacuatePages");
+    for (intptr_t i = 0; i < candidates_.length(); i++) {
+      if ((OS::GetCurrentMonotonicMicros() - start) > budget_micros) {
+        break;
+      }
+      HeapPage* page = candidates_[i].page;
+      intptr_t live_bytes = 0;
+      for (uword current = page->object_start(); current < page->object_end();
+           current += RawObject::FromAddr(current)->Size()) {
+        RawObject* raw_obj = RawObject::FromAddr(current);
+        if (raw_obj->IsMarked()) {
+          live_bytes += raw_obj->Size();
+        }
+      }
+      if ((to_end_ - to_top_) < static_cast<uword>(live_bytes)) {
+        // A fresh page can hold the live data of any page.
+        CloseToPage();
+        if (!old_space_->CanIncreaseCapacityInWords(kPageSizeInWords)) {
+          break;
+        }
+        HeapPage* to_page = old_space_->AllocatePage(HeapPage::kData);
+        if (to_page == NULL) {
+          break;
+        }
+        to_pages_.Add(to_page);
+        to_top_ = to_page->object_start();
+        to_end_ = to_page->object_end();
+      }
+      EvacuatePage(page);
+      candidates_[i].evacuated = true;
+      evacuated_pages_++;
+      moved_bytes += live_bytes;
+    }
+    CloseToPage();
+  }
+
+  if (evacuated_pages_ == 0) {
+    return 0;
+  }
+
+  {
+    TIMELINE_FUNCTION_GC_DURATION(thread, "ForwardEvacuatedObjects");
+    // The copies still refer to the old locations of their neighbours.
+    for (intptr_t i = 0; i < to_pages_.length(); i++) {
+      HeapPage* to_page = to_pages_[i];
+      uword current = to_page->object_start();
+      while (current < to_page->object_end()) {
+        current += RawObject::FromAddr(current)->VisitPointers(this);
+      }
+    }
+  }
+
+  {
+    TIMELINE_FUNCTION_GC_DURATION(thread, "ForwardRecordedSlots");
+    for (intptr_t i = 0; i < slots_.length(); i++) {
+      RawObject** slot = slots_[i];
+      // Slots inside evacuated objects were forwarded in their copies.
+      if (!IsEvacuated(reinterpret_cast<uword>(slot))) {
+        ForwardPointer(slot);
+      }
+    }
+  }
+
+  {
+    TIMELINE_FUNCTION_GC_DURATION(thread, "ForwardWeakReferences");
+    Isolate* isolate = thread->isolate();
+    isolate->store_buffer()->VisitObjectPointers(this);
+    isolate->heap()->ForwardWeakTables(this);
+    isolate->VisitWeakPersistentHandles(this);
+#ifndef PRODUCT
+    if (FLAG_support_service) {
+      isolate->object_id_ring()->VisitPointers(this);
+    }
+#endif  // !PRODUCT
+  }
+
+  // Free the evacuated pages.
+  HeapPage* prev = NULL;
+  HeapPage* page = old_space_->pages_;
+  while (page != NULL) {
+    HeapPage* next = page->next();
+    if (IsEvacuated(reinterpret_cast<uword>(page))) {
+      old_space_->FreePage(page, prev);
+    } else {
+      prev = page;
+    }
+    page = next;
+  }
+
+  return moved_bytes;
+}
+
+void GCEvacuator::EvacuatePage(HeapPage* page) {
+  uword current = page->object_start();
+  uword end = page->object_end();
+  while (current < end) {
+    RawObject* raw_obj = RawObject::FromAddr(current);
+    intptr_t size = raw_obj->Size();
+    if (raw_obj->IsMarked()) {
+      uword new_addr = to_top_;
+      to_top_ += size;
+      ASSERT(to_top_ <= to_end_);
+      // The copy keeps its mark bit and is swept with the rest of the heap.
+      memmove(reinterpret_cast<void*>(new_addr),
+              reinterpret_cast<void*>(current), size);
+      // The page is freed afterwards, so the header can hold the forwarding
+      // address.
+      *reinterpret_cast<uword*>(current) = new_addr;
+    }
+    current += size;
+  }
+}
+
+void GCEvacuator::CloseToPage() {
+  // Keep the page walkable; the sweeper turns the tail into free space.
+  if (to_top_ < to_end_) {
+    FreeListElement::AsElement(to_top_, to_end_ - to_top_);
+  }
+  to_top_ = to_end_ = 0;
+}
+
+DART_FORCE_INLINE
+void GCEvacuator::ForwardPointer(RawObject** ptr) {
+  RawObject* old_target = *ptr;
+  if (old_target->IsSmiOrNewObject()) {
+    return;  // Not moved.
+  }
+  uword old_addr = RawObject::ToAddr(old_target);
+  if (!IsEvacuated(old_addr)) {
+    return;  // Not moved.
+  }
+  uword new_addr = *reinterpret_cast<uword*>(old_addr);
+  *ptr = RawObject::FromAddr(new_addr);
+}
+
+// N.B.: Unlike the compactor's, this visitor is idempotent: forwarded pointers
+// never point into evacuated pages. Slots recorded more than once are fine.
+void GCEvacuator::VisitPointers(RawObject** first, RawObject** last) {
+  for (RawObject** ptr = first; ptr <= last; ptr++) {
+    ForwardPointer(ptr);
+  }
+}
+
+void GCEvacuator::VisitHandle(uword addr) {
+  FinalizablePersistentHandle* handle =
+      reinterpret_cast<FinalizablePersistentHandle*>(addr);
+  ForwardPointer(handle->raw_addr());
+}
+
+}  // namespace dart
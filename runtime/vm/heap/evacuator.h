@@ -0,0 +1,98 @@
+// Copyright (c) 2019, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#ifndef RUNTIME_VM_HEAP_EVACUATOR_H_
+#define RUNTIME_VM_HEAP_EVACUATOR_H_
+
+#include "platform/growable_array.h"
+#include "vm/allocation.h"
+#include "vm/dart_api_state.h"
+#include "vm/globals.h"
+#include "vm/os_thread.h"
+#include "vm/visitor.h"
+
+namespace dart {
+
+// Forward declarations.
+class Heap;
+class HeapPage;
+class PageSpace;
+class RawObject;
+
+// Implements partial compaction by evacuation. Before marking, the most
+// fragmented data pages are selected as candidates based on the occupancy the
+// sweeper recorded for them. While marking, the markers record every slot
+// that refers to an object on a candidate page. After marking, the live
+// objects of as many candidates as fit in the pause budget are copied to fresh
+// pages, the recorded slots are forwarded and the evacuated pages are freed.
+// The pause is therefore bounded by the budget and the number of slots into
+// the evacuated pages, rather than by the size of the heap.
+//
+// Slots written by the mutator while marking are not recorded, so evacuation
+// is only done when all marking happens inside the pause.
+class GCEvacuator : public HandleVisitor, public ObjectPointerVisitor {
+ public:
+  GCEvacuator(Thread* thread, PageSpace* old_space);
+  ~GCEvacuator();
+
+  // Selects the candidates for the next evacuation, preferring the pages with
+  // the least live data. Returns false if no page qualifies.
+  bool SelectCandidates(intptr_t bytes_per_micro, int64_t budget_micros);
+
+  bool IsCandidate(RawObject* raw_obj) const {
+    return CandidateIndex(reinterpret_cast<uword>(raw_obj)) != -1;
+  }
+
+  // Adds slots referring to candidates, recorded by a marker.
+  void AddSlots(const MallocGrowableArray<RawObject**>& slots);
+
+  // Evacuates candidates until the budget is exhausted, forwards all
+  // references to the moved objects and frees the evacuated pages. Returns
+  // the number of bytes moved.
+  intptr_t Evacuate(int64_t budget_micros);
+
+  intptr_t evacuated_pages() const { return evacuated_pages_; }
+
+ private:
+  struct Candidate {
+    HeapPage* page;
+    bool evacuated;
+  };
+
+  intptr_t CandidateIndex(uword addr) const;
+  bool IsEvacuated(uword addr) const {
+    intptr_t index = CandidateIndex(addr);
+    return (index != -1) && candidates_[index].evacuated;
+  }
+
+  void EvacuatePage(HeapPage* page);
+  void CloseToPage();
+
+  void ForwardPointer(RawObject** ptr);
+  void VisitPointers(RawObject** first, RawObject** last);
+  void VisitHandle(uword addr);
+
+  PageSpace* old_space_;
+
+  // Sorted by address for CandidateIndex.
+  MallocGrowableArray<Candidate> candidates_;
+  uword candidates_start_;
+  uword candidates_end_;
+
+  Mutex slots_mutex_;
+  MallocGrowableArray<RawObject**> slots_;
+
+  // Fresh pages receiving the evacuated objects.
+  MallocGrowableArray<HeapPage*> to_pages_;
+  uword to_top_;
+  uword to_end_;
+
+  intptr_t evacuated_pages_;
+
+  DISALLOW_COPY_AND_ASSIGN(GCEvacuator);
+};
+
+}  // namespace dart
+
+#endif  // RUNTIME_VM_HEAP_EVACUATOR_H_
@@ -44,6 +44,31 @@ FreeListElement* FreeListElement::AsElement(uword addr, intptr_t size) {
   // writable.
 }
 
+FreeListElement* FreeListElement::AsElementNew(uword addr, intptr_t size) {
+  ASSERT(size >= kObjectAlignment);
+  ASSERT(Utils::IsAligned(size, kObjectAlignment));
+
+  FreeListElement* result = reinterpret_cast<FreeListElement*>(addr);
+
+  uint32_t tags = 0;
+  tags = RawObject::SizeTag::update(size, tags);
+  tags = RawObject::ClassIdTag::update(kFreeListElement, tags);
+  ASSERT((addr & kNewObjectAlignmentOffset) == kNewObjectAlignmentOffset);
+  tags = RawObject::OldBit::update(false, tags);
+  tags = RawObject::OldAndNotMarkedBit::update(false, tags);
+  tags = RawObject::OldAndNotRememberedBit::update(false, tags);
+  tags = RawObject::NewBit::update(true, tags);
+  result->tags_ = tags;
+#if defined(HASH_IN_OBJECT_HEADER)
+  result->hash_ = 0;
+#endif
+  if (size > RawObject::SizeTag::kMaxSizeTag) {
+    *result->SizeAddress() = size;
+  }
+  result->set_next(NULL);
+  return result;
+}
+
 void FreeListElement::Init() {
   ASSERT(sizeof(FreeListElement) == kObjectAlignment);
   ASSERT(OFFSET_OF(FreeListElement, tags_) == Object::tags_offset());
@@ -54,9 +79,7 @@ intptr_t FreeListElement::HeaderSizeFor(intptr_t size) {
   return ((size > RawObject::SizeTag::kMaxSizeTag) ? 3 : 2) * kWordSize;
 }
 
-FreeList::FreeList()
-    : mutex_(new Mutex()),
-      freelist_search_budget_(kInitialFreeListSearchBudget) {
+FreeList::FreeList() : mutex_(new Mutex()) {
   Reset();
 }
 
@@ -108,71 +131,22 @@ uword FreeList::TryAllocateLocked(intptr_t size, bool is_protected) {
     }
   }
 
-  FreeListElement* previous = NULL;
-  FreeListElement* current = free_lists_[kNumLists];
-  // We are willing to search the freelist further for a big block.
-  // For each successful free-list search we:
-  //   * increase the search budget by #allocated-words
-  //   * decrease the search budget by #free-list-entries-traversed
-  //     which guarantees us to not waste more than around 1 search step per
-  //     word of allocation
-  //
-  // If we run out of search budget we fall back to allocating a new page and
-  // reset the search budget.
-  intptr_t tries_left = freelist_search_budget_ + (size >> kWordSizeLog2);
-  while (current != NULL) {
-    if (current->Size() >= size) {
-      // Found an element large enough to hold the requested size. Dequeue,
-      // split and enqueue the remainder.
-      intptr_t remainder_size = current->Size() - size;
-      intptr_t region_size =
-          size + FreeListElement::HeaderSizeFor(remainder_size);
-      if (is_protected) {
-        // Make the allocated block and the header of the remainder element
-        // writable.  The remainder will be non-writable if necessary after
-        // the call to SplitElementAfterAndEnqueue.
-        VirtualMemory::Protect(reinterpret_cast<void*>(current), region_size,
-                               VirtualMemory::kReadWrite);
-      }
-
-      if (previous == NULL) {
-        free_lists_[kNumLists] = current->next();
-      } else {
-        // If the previous free list element's next field is protected, it
-        // needs to be unprotected before storing to it and reprotected
-        // after.
-        bool target_is_protected = false;
-        uword target_address = 0L;
-        if (is_protected) {
-          uword writable_start = reinterpret_cast<uword>(current);
-          uword writable_end = writable_start + region_size - 1;
-          target_address = previous->next_address();
-          target_is_protected =
-              !VirtualMemory::InSamePage(target_address, writable_start) &&
-              !VirtualMemory::InSamePage(target_address, writable_end);
-        }
-        if (target_is_protected) {
-          VirtualMemory::Protect(reinterpret_cast<void*>(target_address),
-                                 kWordSize, VirtualMemory::kReadWrite);
-        }
-        previous->set_next(current->next());
-        if (target_is_protected) {
-          VirtualMemory::Protect(reinterpret_cast<void*>(target_address),
-                                 kWordSize, VirtualMemory::kReadExecute);
-        }
-      }
-      SplitElementAfterAndEnqueue(current, size, is_protected);
-      freelist_search_budget_ =
-          Utils::Minimum(tries_left, kInitialFreeListSearchBudget);
-      return reinterpret_cast<uword>(current);
-    } else if (tries_left-- < 0) {
-      freelist_search_budget_ = kInitialFreeListSearchBudget;
-      return 0;  // Trigger allocation of new page.
-    }
-    previous = current;
-    current = current->next();
+  FreeListElement* element = TryDequeueLarge(size);
+  if (element == NULL) {
+    return 0;  // Trigger allocation of new page.
   }
-  return 0;
+  if (is_protected) {
+    // Make the allocated block and the header of the remainder element
+    // writable.  The remainder will be non-writable if necessary after
+    // the call to SplitElementAfterAndEnqueue.
+    intptr_t remainder_size = element->Size() - size;
+    intptr_t region_size =
+        size + FreeListElement::HeaderSizeFor(remainder_size);
+    VirtualMemory::Protect(reinterpret_cast<void*>(element), region_size,
+                           VirtualMemory::kReadWrite);
+  }
+  SplitElementAfterAndEnqueue(element, size, is_protected);
+  return reinterpret_cast<uword>(element);
 }
 
 void FreeList::Free(uword addr, intptr_t size) {
@@ -197,9 +171,13 @@ void FreeList::Reset() {
   MutexLocker ml(mutex_);
   free_map_.Reset();
   last_free_small_size_ = -1;
-  for (int i = 0; i < (kNumLists + 1); i++) {
+  for (int i = 0; i < kNumLists; i++) {
     free_lists_[i] = NULL;
   }
+  large_map_.Reset();
+  for (int i = 0; i < kNumLargeLists; i++) {
+    large_lists_[i] = NULL;
+  }
 }
 
 intptr_t FreeList::IndexForSize(intptr_t size) {
@@ -213,9 +191,29 @@ intptr_t FreeList::IndexForSize(intptr_t size) {
   return index;
 }
 
+intptr_t FreeList::LargeIndexForSize(intptr_t size) {
+  ASSERT(size >= (kNumLists << kObjectAlignmentLog2));
+  intptr_t level = Utils::HighestBit(size);
+  intptr_t sub_list =
+      (size >> (level - kLargeSubListsLog2)) & (kLargeSubLists - 1);
+  intptr_t index = ((level - kLargeMinLevel) << kLargeSubListsLog2) + sub_list;
+  ASSERT(index < kNumLargeLists);
+  return index;
+}
+
 void FreeList::EnqueueElement(FreeListElement* element, intptr_t index) {
+  if (index == kNumLists) {
+    intptr_t large_index = LargeIndexForSize(element->Size());
+    FreeListElement* next = large_lists_[large_index];
+    if (next == NULL) {
+      large_map_.Set(large_index, true);
+    }
+    element->set_next(next);
+    large_lists_[large_index] = element;
+    return;
+  }
   FreeListElement* next = free_lists_[index];
-  if (next == NULL && index != kNumLists) {
+  if (next == NULL) {
     free_map_.Set(index, true);
     last_free_small_size_ =
         Utils::Maximum(last_free_small_size_, index << kObjectAlignmentLog2);
@@ -225,9 +223,10 @@ void FreeList::EnqueueElement(FreeListElement* element, intptr_t index) {
 }
 
 FreeListElement* FreeList::DequeueElement(intptr_t index) {
+  ASSERT(index < kNumLists);
   FreeListElement* result = free_lists_[index];
   FreeListElement* next = result->next();
-  if (next == NULL && index != kNumLists) {
+  if (next == NULL) {
     intptr_t size = index << kObjectAlignmentLog2;
     if (size == last_free_small_size_) {
       // Note: This is -1 * kObjectAlignment if no other small sizes remain.
@@ -241,6 +240,38 @@ FreeListElement* FreeList::DequeueElement(intptr_t index) {
   return result;
 }
 
+FreeListElement* FreeList::DequeueLargeElement(intptr_t large_index) {
+  FreeListElement* result = large_lists_[large_index];
+  FreeListElement* next = result->next();
+  if (next == NULL) {
+    large_map_.Set(large_index, false);
+  }
+  large_lists_[large_index] = next;
+  return result;
+}
+
+FreeListElement* FreeList::TryDequeueLarge(intptr_t size) {
+  intptr_t large_index = 0;
+  if (size >= (kNumLists << kObjectAlignmentLog2)) {
+    large_index = LargeIndexForSize(size);
+    // The first element of the request's own class may be large enough.
+    FreeListElement* head = large_lists_[large_index];
+    if ((head != NULL) && (head->Size() >= size)) {
+      return DequeueLargeElement(large_index);
+    }
+    large_index++;
+    if (large_index == kNumLargeLists) {
+      return NULL;
+    }
+  }
+  // Every element of a higher class is large enough.
+  large_index = large_map_.Next(large_index);
+  if (large_index == -1) {
+    return NULL;
+  }
+  return DequeueLargeElement(large_index);
+}
+
 intptr_t FreeList::LengthLocked(int index) const {
   DEBUG_ASSERT(mutex_->IsOwnedByCurrentThread());
   ASSERT(index >= 0);
@@ -304,16 +335,18 @@ void FreeList::PrintLarge() const {
   int large_objects = 0;
   intptr_t large_bytes = 0;
   MallocDirectChainedHashMap<NumbersKeyValueTrait<IntptrPair> > map;
-  FreeListElement* node;
-  for (node = free_lists_[kNumLists]; node != NULL; node = node->next()) {
-    IntptrPair* pair = map.Lookup(node->Size());
-    if (pair == NULL) {
-      large_sizes += 1;
-      map.Insert(IntptrPair(node->Size(), 1));
-    } else {
-      pair->set_second(pair->second() + 1);
+  for (intptr_t i = 0; i < kNumLargeLists; i++) {
+    FreeListElement* node;
+    for (node = large_lists_[i]; node != NULL; node = node->next()) {
+      IntptrPair* pair = map.Lookup(node->Size());
+      if (pair == NULL) {
+        large_sizes += 1;
+        map.Insert(IntptrPair(node->Size(), 1));
+      } else {
+        pair->set_second(pair->second() + 1);
+      }
+      large_objects += 1;
     }
-    large_objects += 1;
   }
 
   MallocDirectChainedHashMap<NumbersKeyValueTrait<IntptrPair> >::Iterator it =
@@ -371,31 +404,29 @@ FreeListElement* FreeList::TryAllocateLarge(intptr_t minimum_size) {
 
 FreeListElement* FreeList::TryAllocateLargeLocked(intptr_t minimum_size) {
   DEBUG_ASSERT(mutex_->IsOwnedByCurrentThread());
-  FreeListElement* previous = NULL;
-  FreeListElement* current = free_lists_[kNumLists];
-  // TODO(koda): Find largest.
-  // We are willing to search the freelist further for a big block.
-  intptr_t tries_left =
-      freelist_search_budget_ + (minimum_size >> kWordSizeLog2);
-  while (current != NULL) {
-    FreeListElement* next = current->next();
-    if (current->Size() >= minimum_size) {
-      if (previous == NULL) {
-        free_lists_[kNumLists] = next;
-      } else {
-        previous->set_next(next);
-      }
-      freelist_search_budget_ =
-          Utils::Minimum(tries_left, kInitialFreeListSearchBudget);
-      return current;
-    } else if (tries_left-- < 0) {
-      freelist_search_budget_ = kInitialFreeListSearchBudget;
-      return 0;  // Trigger allocation of new page.
+  intptr_t large_index = large_map_.Last();
+  if (large_index == -1) {
+    return NULL;
+  }
+  // The elements of a class are not ordered by size, so find the largest
+  // element of the highest class and the element before it.
+  FreeListElement* largest = large_lists_[large_index];
+  FreeListElement* before_largest = NULL;
+  for (FreeListElement* element = largest; element->next() != NULL;
+       element = element->next()) {
+    if (element->next()->Size() > largest->Size()) {
+      largest = element->next();
+      before_largest = element;
     }
-    previous = current;
-    current = next;
   }
-  return NULL;
+  if (largest->Size() < minimum_size) {
+    return NULL;
+  }
+  if (before_largest == NULL) {
+    return DequeueLargeElement(large_index);
+  }
+  before_largest->set_next(largest->next());
+  return largest;
 }
 
 uword FreeList::TryAllocateSmallLocked(intptr_t size) {
@@ -34,6 +34,8 @@ class FreeListElement {
   }
 
   static FreeListElement* AsElement(uword addr, intptr_t size);
+  // Formats a hole in new space so that heap walks can step over it.
+  static FreeListElement* AsElementNew(uword addr, intptr_t size);
 
   static void Init();
 
@@ -90,7 +92,9 @@ class FreeList {
   uword TryAllocateLocked(intptr_t size, bool is_protected);
   void FreeLocked(uword addr, intptr_t size);
 
-  // Returns a large element, at least 'minimum_size', or NULL if none exists.
+  // Returns the largest element if it is at least 'minimum_size', or NULL.
+  // Only the highest non-empty size class is searched, as it holds the
+  // largest elements.
   FreeListElement* TryAllocateLarge(intptr_t minimum_size);
   FreeListElement* TryAllocateLargeLocked(intptr_t minimum_size);
 
@@ -99,15 +103,35 @@ class FreeList {
   uword TryAllocateSmallLocked(intptr_t size);
 
  private:
-  static const int kNumLists = 128;
-  static const intptr_t kInitialFreeListSearchBudget = 1000;
+  // Elements smaller than kNumLists * kObjectAlignment are kept in exact-size
+  // lists, indexed by free_map_.
+  static const int kNumListsLog2 = 7;
+  static const int kNumLists = 1 << kNumListsLog2;
+
+  // Larger elements are kept in a two-level index of size classes: the first
+  // level is the power of two of the size, the second level splits each power
+  // of two into kLargeSubLists ranges of equal width. Any element in a class
+  // above the one of a request fits it, so a request takes the first element
+  // of its own class if that fits, or else the first element of the next
+  // non-empty class found in large_map_.
+  static const int kLargeSubListsLog2 = 3;
+  static const int kLargeSubLists = 1 << kLargeSubListsLog2;
+  static const int kLargeMinLevel = kNumListsLog2 + kObjectAlignmentLog2;
+  static const int kNumLargeLists =
+      (kBitsPerWord - kLargeMinLevel) * kLargeSubLists;
 
   static intptr_t IndexForSize(intptr_t size);
+  static intptr_t LargeIndexForSize(intptr_t size);
 
   intptr_t LengthLocked(int index) const;
 
+  // 'index' is kNumLists for large elements.
   void EnqueueElement(FreeListElement* element, intptr_t index);
   FreeListElement* DequeueElement(intptr_t index);
+  FreeListElement* DequeueLargeElement(intptr_t large_index);
+
+  // Returns a large element of at least 'size' bytes, or NULL.
+  FreeListElement* TryDequeueLarge(intptr_t size);
 
   void SplitElementAfterAndEnqueue(FreeListElement* element,
                                    intptr_t size,
@@ -121,9 +145,11 @@ class FreeList {
 
   BitSet<kNumLists> free_map_;
 
-  FreeListElement* free_lists_[kNumLists + 1];
+  FreeListElement* free_lists_[kNumLists];
+
+  BitSet<kNumLargeLists> large_map_;
 
-  intptr_t freelist_search_budget_;
+  FreeListElement* large_lists_[kNumLargeLists];
 
   // The largest available small size in bytes, or negative if there is none.
   intptr_t last_free_small_size_;
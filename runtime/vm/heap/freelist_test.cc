@@ -4,6 +4,7 @@
 
 #include "vm/heap/freelist.h"
 #include "platform/assert.h"
+#include "vm/random.h"
 #include "vm/unit_test.h"
 
 namespace dart {
@@ -182,4 +183,125 @@ TEST_CASE(FreeListProtectedVariableSizeObjects) {
   delete[] objects;
 }
 
+TEST_CASE(FreeListLargeBestFit) {
+  FreeList* free_list = new FreeList();
+  const intptr_t kBlobSize = 256 * KB;
+  VirtualMemory* region =
+      VirtualMemory::Allocate(kBlobSize, /* is_executable */ false, NULL);
+  uword blob = region->start();
+
+  // Free blocks of 64KB, 4KB and 8KB, kept apart by allocated gaps.
+  const intptr_t kGap = kObjectAlignment;
+  uword big_block = blob;
+  uword small_block = big_block + 64 * KB + kGap;
+  uword medium_block = small_block + 4 * KB + kGap;
+  free_list->Free(big_block, 64 * KB);
+  free_list->Free(small_block, 4 * KB);
+  free_list->Free(medium_block, 8 * KB);
+
+  // Requests are served from the smallest size class that fits them.
+  EXPECT_EQ(medium_block, Allocate(free_list, 6 * KB, false));
+  EXPECT_EQ(small_block, Allocate(free_list, 4 * KB, false));
+  // The 2KB remainder of the medium block fits a small request.
+  EXPECT_EQ(medium_block + 6 * KB, Allocate(free_list, 1 * KB, false));
+  EXPECT_EQ(big_block, Allocate(free_list, 3 * KB, false));
+
+  // TryAllocateLarge hands out the largest block.
+  free_list->Free(small_block, 4 * KB);
+  FreeListElement* element = free_list->TryAllocateLarge(16 * KB);
+  EXPECT_EQ(big_block + 3 * KB, reinterpret_cast<uword>(element));
+  EXPECT_EQ(61 * KB, element->Size());
+  EXPECT(free_list->TryAllocateLarge(16 * KB) == NULL);
+
+  // The largest element of the highest class is found even when a smaller
+  // element of the same class comes first.
+  uword larger_block = medium_block + 8 * KB + kGap;
+  uword smaller_block = larger_block + 70 * KB + kGap;
+  free_list->Free(larger_block, 70 * KB);
+  free_list->Free(smaller_block, 65 * KB);
+  element = free_list->TryAllocateLarge(68 * KB);
+  EXPECT_EQ(larger_block, reinterpret_cast<uword>(element));
+  EXPECT_EQ(70 * KB, element->Size());
+  element = free_list->TryAllocateLarge(64 * KB);
+  EXPECT_EQ(smaller_block, reinterpret_cast<uword>(element));
+  EXPECT(free_list->TryAllocateLarge(16 * KB) == NULL);
+
+  delete region;
+  delete free_list;
+}
+
+// Fragments a free list into many large holes of random sizes, and checks
+// that allocations from it find the holes that fit them and never overlap.
+TEST_CASE(FreeListFragmentedAllocation) {
+  FreeList* free_list = new FreeList();
+  const intptr_t kBlobSize = 16 * MB;
+  const intptr_t kMinSize = 2 * KB;
+  const intptr_t kMaxSize = 64 * KB;
+  const intptr_t kNumAllocations = 2000;
+  VirtualMemory* region =
+      VirtualMemory::Allocate(kBlobSize, /* is_executable */ false, NULL);
+  Random random(42);
+
+  // Carve the region into blocks of random sizes and free every other one.
+  uword top = region->start();
+  uword end = region->end();
+  bool free = true;
+  intptr_t largest = 0;
+  while (top < end) {
+    intptr_t size =
+        Utils::RoundUp(kMinSize + (random.NextUInt32() % (kMaxSize - kMinSize)),
+                       kObjectAlignment);
+    size = Utils::Minimum(size, static_cast<intptr_t>(end - top));
+    if (free) {
+      free_list->Free(top, size);
+      largest = Utils::Maximum(largest, size);
+    }
+    free = !free;
+    top += size;
+  }
+
+  // The only hole of the largest size class is found.
+  uword addr = free_list->TryAllocate(largest, false);
+  EXPECT(addr != 0);
+  free_list->Free(addr, largest);
+
+  // Every hole fits requests up to kMinSize, and the allocations kept live
+  // take far less than the free half of the region, so none fails.
+  MallocGrowableArray<uword> live_addresses(kNumAllocations);
+  MallocGrowableArray<intptr_t> live_sizes(kNumAllocations);
+  for (intptr_t i = 0; i < kNumAllocations; i++) {
+    const intptr_t size = Utils::RoundUp(
+        kObjectAlignment + (random.NextUInt32() % kMinSize), kObjectAlignment);
+    addr = free_list->TryAllocate(size, false);
+    EXPECT(addr != 0);
+    if (addr == 0) {
+      break;
+    }
+    EXPECT(region->Contains(addr) && region->Contains(addr + size - 1));
+    if ((i % 2) == 0) {
+      // Return half of the allocations to keep the list fragmented.
+      free_list->Free(addr, size);
+    } else {
+      memset(reinterpret_cast<void*>(addr), live_addresses.length() & 0xff,
+             size);
+      live_addresses.Add(addr);
+      live_sizes.Add(size);
+    }
+  }
+
+  // A live allocation overlapping another one, or a hole of the free list,
+  // would have been overwritten.
+  for (intptr_t i = 0; i < live_addresses.length(); i++) {
+    const uint8_t* bytes = reinterpret_cast<uint8_t*>(live_addresses[i]);
+    bool intact = true;
+    for (intptr_t j = 0; j < live_sizes[i]; j++) {
+      intact = intact && (bytes[j] == (i & 0xff));
+    }
+    EXPECT(intact);
+  }
+
+  delete region;
+  delete free_list;
+}
+
 }  // namespace dart
@@ -31,6 +31,7 @@
 namespace dart {
 
 DEFINE_FLAG(bool, write_protect_vm_isolate, true, "Write protect vm_isolate.");
+DECLARE_FLAG(bool, pretenure);
 
 Heap::Heap(Isolate* isolate,
            intptr_t max_new_gen_semi_words,
@@ -42,7 +43,9 @@ Heap::Heap(Isolate* isolate,
       barrier_done_(new Monitor()),
       read_only_(false),
       gc_new_space_in_progress_(false),
-      gc_old_space_in_progress_(false) {
+      gc_old_space_in_progress_(false),
+      gc_time_goal_(FLAG_gc_time_goal),
+      gc_pause_goal_micros_(FLAG_gc_pause_goal * kMicrosecondsPerMillisecond) {
   UpdateGlobalMaxUsed();
   for (int sel = 0; sel < kNumWeakSelectors; sel++) {
     new_weak_tables_[sel] = new WeakTable();
@@ -81,14 +84,29 @@ uword Heap::AllocateNew(intptr_t size) {
 }
 
 uword Heap::AllocateOld(intptr_t size, HeapPage::PageType type) {
-  ASSERT(Thread::Current()->no_safepoint_scope_depth() == 0);
-  uword addr = old_space_.TryAllocate(size, type);
+  Thread* thread = Thread::Current();
+  ASSERT(thread->no_safepoint_scope_depth() == 0);
+  uword addr = 0;
+  if (type == HeapPage::kData) {
+    addr = old_space_.TryAllocateInTLAB(thread, size);
+    if (addr != 0) {
+      return addr;
+    }
+  }
+  addr = old_space_.TryAllocate(size, type);
   if (addr != 0) {
     return addr;
   }
+  // Dead large objects are often what is holding the memory back. Sweeping
+  // them is cheap, so do it here rather than wait for the sweeper.
+  if (old_space_.SweepLargePages()) {
+    addr = old_space_.TryAllocate(size, type);
+    if (addr != 0) {
+      return addr;
+    }
+  }
   // If we are in the process of running a sweep, wait for the sweeper to free
   // memory.
-  Thread* thread = Thread::Current();
   if (thread->CanCollectGarbage()) {
     // Wait for any GC tasks that are in progress.
     WaitForSweeperTasks(thread);
@@ -385,10 +403,14 @@ void Heap::NotifyIdle(int64_t deadline) {
     TIMELINE_FUNCTION_GC_DURATION(thread, "IdleGC");
     CollectOldSpaceGarbage(thread, kMarkSweep, kIdle);
   }
+  if (FLAG_decommit_free_memory) {
+    SemiSpace::TrimCache();
+  }
 }
 
 void Heap::NotifyLowMemory() {
   CollectAllGarbage(kLowMemory);
+  SemiSpace::TrimCache();
 }
 
 void Heap::EvacuateNewSpace(Thread* thread, GCReason reason) {
@@ -405,6 +427,27 @@ void Heap::EvacuateNewSpace(Thread* thread, GCReason reason) {
   }
 }
 
+// Allocation stubs allocate in new space inline, so the stubs of classes
+// that became pretenured are regenerated to call into the runtime instead.
+void Heap::DisablePretenuredAllocationStubs(Thread* thread) {
+#if !defined(DART_PRECOMPILED_RUNTIME) && !defined(TARGET_ARCH_DBC)
+  // Stubs can only be patched by the mutator. Other threads leave the
+  // classes pending until the mutator's next scavenge.
+  if (!FLAG_pretenure || !thread->IsMutatorThread() ||
+      (thread->zone() == NULL)) {
+    return;
+  }
+  MallocGrowableArray<intptr_t> cids;
+  new_space_.TakeNewlyPretenured(&cids);
+  ClassTable* class_table = isolate()->class_table();
+  Class& cls = Class::Handle(thread->zone());
+  for (intptr_t i = 0; i < cids.length(); i++) {
+    cls = class_table->At(cids[i]);
+    cls.DisableAllocationStub();
+  }
+#endif  // !defined(DART_PRECOMPILED_RUNTIME) && !defined(TARGET_ARCH_DBC)
+}
+
 void Heap::CollectNewSpaceGarbage(Thread* thread, GCReason reason) {
   ASSERT((reason != kOldSpace) && (reason != kPromotion));
   if (BeginNewSpaceGC(thread)) {
@@ -418,6 +461,7 @@ void Heap::CollectNewSpaceGarbage(Thread* thread, GCReason reason) {
       NOT_IN_PRODUCT(PrintStatsToTimeline(&tds, reason));
       EndNewSpaceGC();
     }
+    DisablePretenuredAllocationStubs(thread);
     if (reason == kNewSpace) {
       if (old_space_.NeedsGarbageCollection()) {
         CollectOldSpaceGarbage(thread, kMarkSweep, kPromotion);
@@ -879,7 +923,7 @@ void Heap::PrintStats() {
     "%6" Pd ", %6" Pd ", "  // old gen: capacity before/after
     "%5" Pd ", %5" Pd ", "  // old gen: external before/after
     "%6.2f, %6.2f, %6.2f, %6.2f, %6.2f, %6.2f, "  // times
-    "%" Pd ", %" Pd ", %" Pd ", %" Pd ", "  // data
+    "%" Pd ", %" Pd ", %" Pd ", %" Pd ", %" Pd ", "  // data
     "]\n",  // End with a comma to make it easier to import in spreadsheets.
     isolate()->name(),
     GCTypeToString(stats_.type_),
@@ -909,7 +953,8 @@ void Heap::PrintStats() {
     stats_.data_[0],
     stats_.data_[1],
     stats_.data_[2],
-    stats_.data_[3]);
+    stats_.data_[3],
+    stats_.data_[4]);
   // clang-format on
 #endif  // !defined(PRODUCT)
 }
@@ -87,6 +87,12 @@ class Heap {
     return 0;
   }
 
+  // Whether new-space instances of the class are allocated in old space
+  // instead. See Scavenger::ShouldPretenure.
+  bool ShouldPretenure(intptr_t cid) const {
+    return new_space_.ShouldPretenure(cid);
+  }
+
   // Track external data.
   void AllocateExternal(intptr_t cid, intptr_t size, Space space);
   void FreeExternal(intptr_t size, Space space);
@@ -148,6 +154,15 @@ class Heap {
   void SetGrowthControlState(bool state);
   bool GrowthControlState();
 
+  // Goals for the growth policies of both generations, initially taken from
+  // --gc_time_goal and --gc_pause_goal. Zero means no goal.
+  void SetGoals(intptr_t time_percent, int64_t pause_micros) {
+    gc_time_goal_ = time_percent;
+    gc_pause_goal_micros_ = pause_micros;
+  }
+  intptr_t gc_time_goal() const { return gc_time_goal_; }
+  int64_t gc_pause_goal_micros() const { return gc_pause_goal_micros_; }
+
   // Protect access to the heap. Note: Code pages are made
   // executable/non-executable when 'read_only' is true/false, respectively.
   void WriteProtect(bool read_only);
@@ -301,7 +316,7 @@ class Heap {
     };
 
     enum { kTimeEntries = 6 };
-    enum { kDataEntries = 4 };
+    enum { kDataEntries = 5 };
 
     Data before_;
     Data after_;
@@ -347,6 +362,7 @@ class Heap {
   // Updates gc in progress flags.
   bool BeginNewSpaceGC(Thread* thread);
   void EndNewSpaceGC();
+  void DisablePretenuredAllocationStubs(Thread* thread);
   bool BeginOldSpaceGC(Thread* thread);
   void EndOldSpaceGC();
 
@@ -375,6 +391,9 @@ class Heap {
   bool gc_new_space_in_progress_;
   bool gc_old_space_in_progress_;
 
+  intptr_t gc_time_goal_;
+  int64_t gc_pause_goal_micros_;
+
   friend class Become;       // VisitObjectPointers
   friend class GCCompactor;  // VisitObjectPointers
   friend class Precompiler;  // VisitObjects
@@ -14,6 +14,8 @@
 
 namespace dart {
 
+DECLARE_FLAG(bool, pretenure);
+
 TEST_CASE(OldGC) {
   const char* kScriptChars =
       "main() {\n"
@@ -660,10 +662,344 @@ ISOLATE_UNIT_TEST_CASE(CollectAllGarbage_LiveOldToNewChain) {
   EXPECT(size_before < size_after);
 }
 
+static void ScavengeWithTasks(Thread* thread, int num_tasks) {
+  SetFlagScope<int> sfs(&FLAG_scavenger_tasks, num_tasks);
+  Heap* heap = thread->isolate()->heap();
+  heap->CollectAllGarbage();
+
+  const intptr_t kLength = 1000;
+  Array& old = Array::Handle(Array::New(kLength, Heap::kOld));
+  Array& neu = Array::Handle();
+  for (intptr_t i = 0; i < kLength; i++) {
+    neu = Array::New(2, Heap::kNew);
+    neu.SetAt(0, Smi::Handle(Smi::New(i)));
+    old.SetAt(i, neu);
+  }
+  WeakProperty& live_weak = WeakProperty::Handle(WeakProperty::New());
+  live_weak.set_key(Object::Handle(old.At(0)));
+  live_weak.set_value(Object::Handle(old.At(1)));
+  WeakProperty& dead_weak = WeakProperty::Handle(WeakProperty::New());
+  dead_weak.set_key(Array::Handle(Array::New(1, Heap::kNew)));
+  dead_weak.set_value(Array::Handle(Array::New(1, Heap::kNew)));
+  neu = Array::null();
+
+  // The second scavenge promotes the survivors of the first.
+  heap->CollectGarbage(Heap::kNew);
+  heap->CollectGarbage(Heap::kNew);
+
+  for (intptr_t i = 0; i < kLength; i++) {
+    neu ^= old.At(i);
+    EXPECT_EQ(Smi::New(i), neu.At(0));
+    EXPECT(neu.At(1) == Object::null());
+  }
+  EXPECT(live_weak.key() == old.At(0));
+  EXPECT(live_weak.value() == old.At(1));
+  EXPECT(dead_weak.key() == Object::null());
+  EXPECT(dead_weak.value() == Object::null());
+}
+
+ISOLATE_UNIT_TEST_CASE(Scavenge_Serial) {
+  ScavengeWithTasks(thread, 0);
+}
+
+ISOLATE_UNIT_TEST_CASE(Scavenge_Parallel) {
+  ScavengeWithTasks(thread, 4);
+}
+
+// A negative number of tasks scavenges with a single task.
+ISOLATE_UNIT_TEST_CASE(Scavenge_NegativeTasks) {
+  ScavengeWithTasks(thread, -1);
+}
+
+ISOLATE_UNIT_TEST_CASE(OldSpaceTLAB) {
+  Heap* heap = thread->isolate()->heap();
+  heap->CollectAllGarbage();
+  heap->WaitForSweeperTasks(thread);
+  intptr_t used_before = heap->UsedInWords(Heap::kOld);
+
+  // Small old-space objects are bump allocated next to each other.
+  const Array& first = Array::Handle(Array::New(2, Heap::kOld));
+  const Array& second = Array::Handle(Array::New(2, Heap::kOld));
+  EXPECT_EQ(RawObject::ToAddr(first.raw()) + first.raw()->Size(),
+            RawObject::ToAddr(second.raw()));
+  EXPECT_EQ(RawObject::ToAddr(second.raw()) + second.raw()->Size(),
+            thread->old_space_top());
+  EXPECT(heap->Verify());
+
+  // The unused part of the buffer is returned when collecting.
+  heap->CollectAllGarbage();
+  heap->WaitForSweeperTasks(thread);
+  EXPECT(thread->old_space_end() == 0);
+  EXPECT_EQ(used_before + (first.raw()->Size() >> kWordSizeLog2) +
+                (second.raw()->Size() >> kWordSizeLog2),
+            heap->UsedInWords(Heap::kOld));
+}
+
+ISOLATE_UNIT_TEST_CASE(EvacuateFragmentedPages) {
+  SetFlagScope<bool> sfs(&FLAG_use_evacuation, true);
+  SetFlagScope<int> sfs2(&FLAG_evacuation_budget, 1000);
+  Heap* heap = thread->isolate()->heap();
+  heap->CollectAllGarbage();
+  heap->WaitForSweeperTasks(thread);
+
+  // Fill several pages with small arrays and keep every tenth alive.
+  const intptr_t kNumArrays = 10000;
+  const intptr_t kNumSurvivors = kNumArrays / 10;
+  Array& all = Array::Handle(Array::New(kNumArrays, Heap::kOld));
+  Array& element = Array::Handle();
+  for (intptr_t i = 0; i < kNumArrays; i++) {
+    element = Array::New(8, Heap::kOld);
+    element.SetAt(0, Smi::Handle(Smi::New(i)));
+    all.SetAt(i, element);
+  }
+  const Array& survivors = Array::Handle(Array::New(kNumSurvivors));
+  for (intptr_t i = 0; i < kNumSurvivors; i++) {
+    element ^= all.At(i * 10);
+    survivors.SetAt(i, element);
+  }
+  all = Array::null();
+  element = Array::null();
+
+  // The first collection records the occupancy of the fragmented pages, the
+  // second one evacuates them.
+  heap->CollectAllGarbage();
+  heap->WaitForSweeperTasks(thread);
+  int64_t capacity_before = heap->CapacityInWords(Heap::kOld);
+  heap->CollectAllGarbage();
+  heap->WaitForSweeperTasks(thread);
+  EXPECT_LT(heap->CapacityInWords(Heap::kOld), capacity_before);
+  EXPECT(heap->Verify());
+
+  Smi& value = Smi::Handle();
+  for (intptr_t i = 0; i < kNumSurvivors; i++) {
+    element ^= survivors.At(i);
+    EXPECT_EQ(8, element.Length());
+    value ^= element.At(0);
+    EXPECT_EQ(i * 10, value.Value());
+  }
+}
+
 static void NoopFinalizer(void* isolate_callback_data,
                           Dart_WeakPersistentHandle handle,
                           void* peer) {}
 
+ISOLATE_UNIT_TEST_CASE(SweepLargePagesConcurrently) {
+  SetFlagScope<bool> sfs(&FLAG_concurrent_sweep, true);
+  SetFlagScope<bool> sfs2(&FLAG_write_protect_code, false);
+  Heap* heap = thread->isolate()->heap();
+  PageSpace* old_space = heap->old_space();
+  heap->CollectAllGarbage();
+  heap->WaitForSweeperTasks(thread);
+
+  const intptr_t kLength = kPageSizeInWords;
+  const Array& live = Array::Handle(Array::New(kLength, Heap::kOld));
+  live.SetAt(kLength - 1, Smi::Handle(Smi::New(42)));
+  Array::New(kLength, Heap::kOld);
+  int64_t capacity_before = heap->CapacityInWords(Heap::kOld);
+
+  // The dead array is released by whoever gets to it first, without waiting
+  // for the data pages to be swept.
+  heap->CollectAllGarbage();
+  old_space->SweepLargePages();
+  EXPECT_LT(heap->CapacityInWords(Heap::kOld), capacity_before);
+  heap->WaitForSweeperTasks(thread);
+  EXPECT(!old_space->SweepLargePages());
+  EXPECT(heap->Verify());
+
+  EXPECT_EQ(kLength, live.Length());
+  Smi& value = Smi::Handle();
+  value ^= live.At(kLength - 1);
+  EXPECT_EQ(42, value.Value());
+}
+
+ISOLATE_UNIT_TEST_CASE(MarkerTasksKeepReachableObjects) {
+  SetFlagScope<bool> sfs(&FLAG_concurrent_mark, false);
+  Heap* heap = thread->isolate()->heap();
+
+  // A wide tree, so that every marker can find work, with garbage between
+  // its nodes.
+  const intptr_t kFanOut = 64;
+  const intptr_t kLeafLength = 16;
+  const Array& root = Array::Handle(Array::New(kFanOut, Heap::kOld));
+  Array& node = Array::Handle();
+  Array& leaf = Array::Handle();
+  for (intptr_t i = 0; i < kFanOut; i++) {
+    node = Array::New(kFanOut, Heap::kOld);
+    for (intptr_t j = 0; j < kFanOut; j++) {
+      leaf = Array::New(kLeafLength, Heap::kOld);
+      leaf.SetAt(0, Smi::Handle(Smi::New(i * kFanOut + j)));
+      node.SetAt(j, leaf);
+      Array::New(kLeafLength, Heap::kOld);
+    }
+    root.SetAt(i, node);
+  }
+  node = Array::null();
+  leaf = Array::null();
+
+  Smi& value = Smi::Handle();
+  for (intptr_t num_tasks = 1; num_tasks <= 8; num_tasks *= 2) {
+    SetFlagScope<int> sfs2(&FLAG_marker_tasks, num_tasks);
+    heap->WaitForSweeperTasks(thread);
+    const intptr_t used_before = heap->UsedInWords(Heap::kOld);
+    heap->CollectAllGarbage();
+    heap->WaitForSweeperTasks(thread);
+    EXPECT(heap->Verify());
+    if (num_tasks == 1) {
+      // The garbage is collected.
+      EXPECT_LT(heap->UsedInWords(Heap::kOld), used_before);
+    }
+
+    // Every leaf was marked, and so survived unchanged.
+    bool intact = true;
+    for (intptr_t i = 0; i < kFanOut; i++) {
+      node ^= root.At(i);
+      for (intptr_t j = 0; j < kFanOut; j++) {
+        leaf ^= node.At(j);
+        value ^= leaf.At(0);
+        intact = intact && (leaf.Length() == kLeafLength) &&
+                 (value.Value() == i * kFanOut + j);
+      }
+    }
+    EXPECT(intact);
+  }
+}
+
+ISOLATE_UNIT_TEST_CASE(DecommitFreeMemory) {
+  SetFlagScope<bool> sfs(&FLAG_concurrent_sweep, true);
+  SetFlagScope<bool> sfs2(&FLAG_decommit_free_memory, true);
+  Heap* heap = thread->isolate()->heap();
+  heap->CollectAllGarbage();
+  heap->WaitForSweeperTasks(thread);
+
+  // Keeping one array in four leaves free blocks larger than the decommit
+  // threshold on partially used pages.
+  const intptr_t kLength = 4 * KB;
+  const intptr_t kCount = 16;
+  const Array& live = Array::Handle(Array::New(kCount, Heap::kOld));
+  Array& array = Array::Handle();
+  for (intptr_t i = 0; i < 4 * kCount; i++) {
+    array = Array::New(kLength, Heap::kOld);
+    if ((i % 4) == 0) {
+      live.SetAt(i / 4, array);
+    }
+  }
+  array = Array::null();
+
+  const intptr_t before = heap->old_space()->decommitted_in_bytes();
+  heap->CollectAllGarbage();
+  heap->WaitForSweeperTasks(thread);
+#if !defined(HOST_OS_FUCHSIA)
+  EXPECT_LT(before, heap->old_space()->decommitted_in_bytes());
+#else
+  // Decommitting is not supported, so nothing is counted.
+  EXPECT_EQ(before, heap->old_space()->decommitted_in_bytes());
+#endif
+  EXPECT(heap->Verify());
+
+  // The decommitted memory can be allocated again.
+  for (intptr_t i = 0; i < kCount; i++) {
+    array = Array::New(kLength, Heap::kOld);
+    EXPECT_EQ(kLength, array.Length());
+  }
+}
+
+TEST_CASE(PretenureLongLivedClass) {
+  SetFlagScope<bool> sfs(&FLAG_pretenure, true);
+  const char* kScriptChars =
+      "class Node {\n"
+      "  var next;\n"
+      "  Node(this.next);\n"
+      "}\n"
+      "var list;\n"
+      "main() {\n"
+      "  var node = null;\n"
+      "  for (var i = 0; i < 100000; i++) {\n"
+      "    node = new Node(node);\n"
+      "  }\n"
+      "  list = node;\n"
+      "}\n";
+  Dart_Handle h_lib = TestCase::LoadTestScript(kScriptChars, NULL);
+  Dart_Handle result = Dart_Invoke(h_lib, NewString("main"), 0, NULL);
+  EXPECT_VALID(result);
+
+  TransitionNativeToVM transition(thread);
+  Heap* heap = thread->isolate()->heap();
+  // All nodes survive, so the class is pretenured by the first scavenge
+  // that sees them.
+  heap->CollectGarbage(Heap::kNew);
+  Library& lib = Library::Handle();
+  lib ^= Api::UnwrapHandle(h_lib);
+  const Class& cls = Class::Handle(GetClass(lib, "Node"));
+  EXPECT(heap->ShouldPretenure(cls.id()));
+  const Instance& node = Instance::Handle(Instance::New(cls, Heap::kNew));
+  EXPECT(node.IsOld());
+
+  // Predefined classes are never pretenured.
+  EXPECT(!heap->ShouldPretenure(kArrayCid));
+}
+
+TEST_CASE(PretenureStoreYoungFromOptimizedCode) {
+  SetFlagScope<bool> sfs(&FLAG_pretenure, true);
+  SetFlagScope<bool> sfs2(&FLAG_background_compilation, false);
+  SetFlagScope<int> sfs3(&FLAG_optimization_counter_threshold, 10);
+  // The stores in the Node constructor have their write barriers eliminated
+  // once 'build' is optimized, so pretenured nodes must be remembered by the
+  // allocation for the young arrays they point to to survive a scavenge.
+  const char* kScriptChars =
+      "class Node {\n"
+      "  var next;\n"
+      "  var value;\n"
+      "  Node(this.next, this.value);\n"
+      "}\n"
+      "var list;\n"
+      "build(n) {\n"
+      "  var node = null;\n"
+      "  for (var i = 0; i < n; i++) {\n"
+      "    var value = new List(1);\n"
+      "    value[0] = i;\n"
+      "    node = new Node(node, value);\n"
+      "  }\n"
+      "  return node;\n"
+      "}\n"
+      "main() {\n"
+      "  list = build(100000);\n"
+      "}\n"
+      "rebuild() {\n"
+      "  for (var i = 0; i < 20; i++) {\n"
+      "    list = build(100);\n"
+      "  }\n"
+      "}\n"
+      "sum() {\n"
+      "  var sum = 0;\n"
+      "  for (var node = list; node != null; node = node.next) {\n"
+      "    sum += node.value[0];\n"
+      "  }\n"
+      "  return sum;\n"
+      "}\n";
+  Dart_Handle h_lib = TestCase::LoadTestScript(kScriptChars, NULL);
+  EXPECT_VALID(Dart_Invoke(h_lib, NewString("main"), 0, NULL));
+  {
+    TransitionNativeToVM transition(thread);
+    Heap* heap = thread->isolate()->heap();
+    heap->CollectGarbage(Heap::kNew);
+    Library& lib = Library::Handle();
+    lib ^= Api::UnwrapHandle(h_lib);
+    const Class& cls = Class::Handle(GetClass(lib, "Node"));
+    EXPECT(heap->ShouldPretenure(cls.id()));
+  }
+
+  EXPECT_VALID(Dart_Invoke(h_lib, NewString("rebuild"), 0, NULL));
+  {
+    TransitionNativeToVM transition(thread);
+    thread->isolate()->heap()->CollectGarbage(Heap::kNew);
+  }
+  Dart_Handle result = Dart_Invoke(h_lib, NewString("sum"), 0, NULL);
+  EXPECT_VALID(result);
+  int64_t sum = 0;
+  EXPECT_VALID(Dart_IntegerToInt64(result, &sum));
+  EXPECT_EQ(99 * 100 / 2, sum);
+}
+
 ISOLATE_UNIT_TEST_CASE(ExternalPromotion) {
   Isolate* isolate = Isolate::Current();
   Heap* heap = isolate->heap();
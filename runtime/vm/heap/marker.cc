@@ -6,6 +6,7 @@
 
 #include "vm/allocation.h"
 #include "vm/dart_api_state.h"
+#include "vm/heap/evacuator.h"
 #include "vm/heap/pages.h"
 #include "vm/heap/pointer_block.h"
 #include "vm/isolate.h"
@@ -109,8 +110,17 @@ class SkippedCodeFunctions {
 
 class MarkerWorkList : public ValueObject {
  public:
-  explicit MarkerWorkList(MarkingStack* marking_stack)
-      : marking_stack_(marking_stack) {
+  // 'deques' holds one deque per parallel marker, the one at 'deque_index'
+  // being this marker's. It is NULL when marking on a single thread.
+  MarkerWorkList(MarkingStack* marking_stack,
+                 MarkerDeque* deques,
+                 intptr_t num_deques,
+                 intptr_t deque_index)
+      : marking_stack_(marking_stack),
+        deques_(deques),
+        num_deques_(num_deques),
+        deque_index_(deque_index),
+        deque_(deques == NULL ? NULL : &deques[deque_index]) {
     work_ = marking_stack_->PopEmptyBlock();
   }
 
@@ -122,12 +132,18 @@ class MarkerWorkList : public ValueObject {
   // Returns NULL if no more work was found.
   RawObject* Pop() {
     ASSERT(work_ != NULL);
+    if (deque_ != NULL) {
+      RawObject* raw_obj = deque_->Pop();
+      if (raw_obj != NULL) {
+        return raw_obj;
+      }
+    }
     if (work_->IsEmpty()) {
       // TODO(koda): Track over/underflow events and use in heuristics to
       // distribute work and prevent degenerate flip-flopping.
       MarkingStack::Block* new_work = marking_stack_->PopNonEmptyBlock();
       if (new_work == NULL) {
-        return NULL;
+        return Steal();
       }
       marking_stack_->PushBlock(work_);
       work_ = new_work;
@@ -138,6 +154,9 @@ class MarkerWorkList : public ValueObject {
   }
 
   void Push(RawObject* raw_obj) {
+    if ((deque_ != NULL) && deque_->Push(raw_obj)) {
+      return;
+    }
     if (work_->IsFull()) {
       // TODO(koda): Track over/underflow events and use in heuristics to
       // distribute work and prevent degenerate flip-flopping.
@@ -149,6 +168,7 @@ class MarkerWorkList : public ValueObject {
 
   void Finalize() {
     ASSERT(work_->IsEmpty());
+    ASSERT((deque_ == NULL) || deque_->IsEmpty());
     marking_stack_->PushBlock(work_);
     work_ = NULL;
     // Fail fast on attempts to mark after finalizing.
@@ -162,8 +182,22 @@ class MarkerWorkList : public ValueObject {
   }
 
  private:
+  RawObject* Steal() {
+    for (intptr_t i = 1; i < num_deques_; i++) {
+      RawObject* raw_obj = deques_[(deque_index_ + i) % num_deques_].Steal();
+      if (raw_obj != NULL) {
+        return raw_obj;
+      }
+    }
+    return NULL;
+  }
+
   MarkingStack::Block* work_;
   MarkingStack* marking_stack_;
+  MarkerDeque* const deques_;
+  const intptr_t num_deques_;
+  const intptr_t deque_index_;
+  MarkerDeque* const deque_;
 };
 
 template <bool sync>
@@ -172,6 +206,9 @@ class MarkingVisitorBase : public ObjectPointerVisitor {
   MarkingVisitorBase(Isolate* isolate,
                      PageSpace* page_space,
                      MarkingStack* marking_stack,
+                     MarkerDeque* deques,
+                     intptr_t num_deques,
+                     intptr_t deque_index,
                      SkippedCodeFunctions* skipped_code_functions)
       : ObjectPointerVisitor(isolate),
         thread_(Thread::Current()),
@@ -181,7 +218,8 @@ class MarkingVisitorBase : public ObjectPointerVisitor {
         class_stats_size_(new intptr_t[num_classes_]),
 #endif  // !PRODUCT
         page_space_(page_space),
-        work_list_(marking_stack),
+        evacuator_(page_space->evacuator()),
+        work_list_(marking_stack, deques, num_deques, deque_index),
         delayed_weak_properties_(NULL),
         skipped_code_functions_(skipped_code_functions),
         marked_bytes_(0),
@@ -281,7 +319,13 @@ class MarkingVisitorBase : public ObjectPointerVisitor {
 
   void VisitPointers(RawObject** first, RawObject** last) {
     for (RawObject** current = first; current <= last; current++) {
-      MarkObject(*current);
+      RawObject* raw_obj = *current;
+      if ((evacuator_ != NULL) && raw_obj->IsHeapObject() &&
+          evacuator_->IsCandidate(raw_obj)) {
+        // The slot must be forwarded if the target is evacuated.
+        recorded_slots_.Add(current);
+      }
+      MarkObject(raw_obj);
     }
   }
 
@@ -318,6 +362,10 @@ class MarkingVisitorBase : public ObjectPointerVisitor {
   // Called when all marking is complete.
   void Finalize() {
     work_list_.Finalize();
+    if (evacuator_ != NULL) {
+      evacuator_->AddSlots(recorded_slots_);
+      recorded_slots_.Clear();
+    }
     // Detach code from functions.
     if (skipped_code_functions_ != NULL) {
       skipped_code_functions_->DetachCode();
@@ -395,6 +443,8 @@ class MarkingVisitorBase : public ObjectPointerVisitor {
   intptr_t* class_stats_size_;
 #endif  // !PRODUCT
   PageSpace* page_space_;
+  GCEvacuator* evacuator_;
+  MallocGrowableArray<RawObject**> recorded_slots_;
   MarkerWorkList work_list_;
   RawWeakProperty* delayed_weak_properties_;
   SkippedCodeFunctions* skipped_code_functions_;
@@ -595,7 +645,7 @@ class MarkTask : public ThreadPool::Task {
           // Wait for some work to appear.
           // TODO(iposva): Replace busy-waiting with a solution using Monitor,
           // and redraw the boundaries between stack/visitor/task as needed.
-          while (marking_stack_->IsEmpty() &&
+          while (marking_stack_->IsEmpty() && marker_->DequesAreEmpty() &&
                  AtomicOperations::LoadRelaxed(num_busy_) > 0) {
           }
 
@@ -792,9 +842,11 @@ GCMarker::GCMarker(Isolate* isolate, Heap* heap)
     : isolate_(isolate),
       heap_(heap),
       marking_stack_(),
+      deques_(NULL),
       visitors_(),
       marked_bytes_(0),
       marked_micros_(0) {
+  deques_ = new MarkerDeque[FLAG_marker_tasks];
   visitors_ = new SyncMarkingVisitor*[FLAG_marker_tasks];
   for (intptr_t i = 0; i < FLAG_marker_tasks; i++) {
     visitors_[i] = NULL;
@@ -812,6 +864,16 @@ GCMarker::~GCMarker() {
     }
   }
   delete[] visitors_;
+  delete[] deques_;
+}
+
+bool GCMarker::DequesAreEmpty() {
+  for (intptr_t i = 0; i < FLAG_marker_tasks; i++) {
+    if (!deques_[i].IsEmpty()) {
+      return false;
+    }
+  }
+  return true;
 }
 
 void GCMarker::StartConcurrentMark(PageSpace* page_space, bool collect_code) {
@@ -837,8 +899,9 @@ void GCMarker::StartConcurrentMark(PageSpace* page_space, bool collect_code) {
     ASSERT(visitors_[i] == NULL);
     SkippedCodeFunctions* skipped_code_functions =
         collect_code ? new SkippedCodeFunctions() : NULL;
-    visitors_[i] = new SyncMarkingVisitor(isolate_, page_space, &marking_stack_,
-                                          skipped_code_functions);
+    visitors_[i] =
+        new SyncMarkingVisitor(isolate_, page_space, &marking_stack_, deques_,
+                               num_tasks, i, skipped_code_functions);
 
     // Begin marking on a helper thread.
     bool result = Dart::thread_pool()->Run(new ConcurrentMarkTask(
@@ -869,8 +932,8 @@ void GCMarker::MarkObjects(PageSpace* page_space, bool collect_code) {
       // Mark everything on main thread.
       SkippedCodeFunctions* skipped_code_functions =
           collect_code ? new SkippedCodeFunctions() : NULL;
-      UnsyncMarkingVisitor mark(isolate_, page_space, &marking_stack_,
-                                skipped_code_functions);
+      UnsyncMarkingVisitor mark(isolate_, page_space, &marking_stack_, NULL, 0,
+                                0, skipped_code_functions);
       IterateRoots(&mark, 0, 1);
       mark.DrainMarkingStack();
       {
@@ -896,8 +959,9 @@ void GCMarker::MarkObjects(PageSpace* page_space, bool collect_code) {
         } else {
           SkippedCodeFunctions* skipped_code_functions =
               collect_code ? new SkippedCodeFunctions() : NULL;
-          visitor = new SyncMarkingVisitor(
-              isolate_, page_space, &marking_stack_, skipped_code_functions);
+          visitor = new SyncMarkingVisitor(isolate_, page_space,
+                                           &marking_stack_, deques_, num_tasks,
+                                           i, skipped_code_functions);
         }
 
         MarkTask* mark_task =
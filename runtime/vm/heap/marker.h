@@ -7,6 +7,7 @@
 
 #include "vm/allocation.h"
 #include "vm/heap/pointer_block.h"
+#include "vm/heap/work_stealing_deque.h"
 #include "vm/os_thread.h"  // Mutex.
 
 namespace dart {
@@ -17,10 +18,15 @@ class Heap;
 class Isolate;
 class ObjectPointerVisitor;
 class PageSpace;
+class RawObject;
 class RawWeakProperty;
 template <bool sync>
 class MarkingVisitorBase;
 
+// Each parallel marker keeps the work it discovers in its own deque, which
+// overflows into the shared marking stack and which idle markers steal from.
+typedef WorkStealingDeque<RawObject, 10> MarkerDeque;
+
 // The class GCMarker is used to mark reachable old generation objects as part
 // of the mark-sweep collection. The marking bit used is defined in RawObject.
 // Instances have a lifetime that spans from the beginining of concurrent
@@ -55,6 +61,7 @@ class GCMarker {
   void IterateWeakReferences(MarkingVisitorType* visitor);
   void ProcessWeakTables(PageSpace* page_space);
   void ProcessObjectIdTable();
+  bool DequesAreEmpty();
 
   // Called by anyone: finalize and accumulate stats from 'visitor'.
   template <class MarkingVisitorType>
@@ -63,6 +70,7 @@ class GCMarker {
   Isolate* const isolate_;
   Heap* const heap_;
   MarkingStack marking_stack_;
+  MarkerDeque* deques_;
   MarkingVisitorBase<true>** visitors_;
 
   Mutex stats_mutex_;
@@ -8,6 +8,7 @@
 #include "platform/assert.h"
 #include "vm/heap/become.h"
 #include "vm/heap/compactor.h"
+#include "vm/heap/evacuator.h"
 #include "vm/heap/marker.h"
 #include "vm/heap/safepoint.h"
 #include "vm/heap/sweeper.h"
@@ -74,6 +75,7 @@ HeapPage* HeapPage::Allocate(intptr_t size_in_words,
   result->forwarding_page_ = NULL;
   result->card_table_ = NULL;
   result->type_ = type;
+  result->needs_sweep_ = false;
 
   LSAN_REGISTER_ROOT_REGION(result, sizeof(*result));
 
@@ -132,7 +134,8 @@ void HeapPage::VisitObjectPointers(ObjectPointerVisitor* visitor) const {
 }
 
 void HeapPage::VisitRememberedCards(ObjectPointerVisitor* visitor) {
-  ASSERT(Thread::Current()->IsAtSafepoint());
+  ASSERT(Thread::Current()->IsAtSafepoint() ||
+         (Thread::Current()->task_kind() == Thread::kScavengerTask));
   NoSafepointScope no_safepoint;
 
   if (card_table_ == NULL) {
@@ -231,6 +234,10 @@ void HeapPage::WriteProtect(bool read_only) {
 // based on the device's actual speed.
 static const intptr_t kConservativeInitialMarkSpeed = 20;
 
+// The initial estimate of how many bytes we can evacuate per microsecond.
+// After the first evacuation, we use the observed speed instead.
+static const intptr_t kConservativeInitialEvacuationSpeed = 100;
+
 PageSpace::PageSpace(Heap* heap, intptr_t max_capacity_in_words)
     : freelist_(),
       heap_(heap),
@@ -241,6 +248,8 @@ PageSpace::PageSpace(Heap* heap, intptr_t max_capacity_in_words)
       exec_pages_tail_(NULL),
       large_pages_(NULL),
       image_pages_(NULL),
+      large_pages_sweep_lock_(new Mutex()),
+      large_pages_to_sweep_(0),
       bump_top_(0),
       bump_end_(0),
       max_capacity_in_words_(max_capacity_in_words),
@@ -258,9 +267,12 @@ PageSpace::PageSpace(Heap* heap, intptr_t max_capacity_in_words)
                              FLAG_old_gen_growth_rate,
                              FLAG_old_gen_growth_time_ratio),
       marker_(NULL),
+      evacuator_(NULL),
       gc_time_micros_(0),
       collections_(0),
-      mark_words_per_micro_(kConservativeInitialMarkSpeed) {
+      mark_words_per_micro_(kConservativeInitialMarkSpeed),
+      evacuated_bytes_per_micro_(kConservativeInitialEvacuationSpeed),
+      decommitted_in_bytes_(0) {
   // We aren't holding the lock but no one can reference us yet.
   UpdateMaxCapacityLocked();
   UpdateMaxUsed();
@@ -278,6 +290,7 @@ PageSpace::~PageSpace() {
   FreePages(large_pages_);
   FreePages(image_pages_);
   delete pages_lock_;
+  delete large_pages_sweep_lock_;
   delete tasks_lock_;
   ASSERT(marker_ == NULL);
 }
@@ -342,12 +355,16 @@ HeapPage* PageSpace::AllocateLargePage(intptr_t size, HeapPage::PageType type) {
   if (page == NULL) {
     return NULL;
   }
-  page->set_next(large_pages_);
-  large_pages_ = page;
-  IncreaseCapacityInWords(page_size_in_words);
   // Only one object in this page (at least until String::MakeExternal or
   // Array::MakeFixedLength is called).
   page->set_object_end(page->object_start() + size);
+  {
+    // The concurrent sweeper may be unlinking large pages.
+    MutexLocker ml(pages_lock_);
+    page->set_next(large_pages_);
+    large_pages_ = page;
+    IncreaseCapacityInWordsLocked(page_size_in_words);
+  }
   return page;
 }
 
@@ -399,12 +416,22 @@ void PageSpace::FreePage(HeapPage* page, HeapPage* previous_page) {
 }
 
 void PageSpace::FreeLargePage(HeapPage* page, HeapPage* previous_page) {
-  IncreaseCapacityInWords(-(page->memory_->size() >> kWordSizeLog2));
-  // Remove the page from the list.
-  if (previous_page != NULL) {
-    previous_page->set_next(page->next());
-  } else {
-    large_pages_ = page->next();
+  {
+    MutexLocker ml(pages_lock_);
+    IncreaseCapacityInWordsLocked(-(page->memory_->size() >> kWordSizeLog2));
+    if ((previous_page == NULL) && (large_pages_ != page)) {
+      // Pages were allocated since the sweeper read the head of the list.
+      previous_page = large_pages_;
+      while (previous_page->next() != page) {
+        previous_page = previous_page->next();
+      }
+    }
+    // Remove the page from the list.
+    if (previous_page != NULL) {
+      previous_page->set_next(page->next());
+    } else {
+      large_pages_ = page->next();
+    }
   }
   page->Deallocate();
 }
@@ -640,6 +667,7 @@ void PageSpace::MakeIterable() const {
   if (bump_top_ < bump_end_) {
     FreeListElement::AsElement(bump_top_, bump_end_ - bump_top_);
   }
+  heap_->isolate()->thread_registry()->MakeOldSpaceTLABsIterable(this);
 }
 
 void PageSpace::AbandonBumpAllocation() {
@@ -761,7 +789,12 @@ void PageSpace::VisitObjectPointers(ObjectPointerVisitor* visitor) const {
 }
 
 void PageSpace::VisitRememberedCards(ObjectPointerVisitor* visitor) const {
+  MutexLocker ml(large_pages_sweep_lock_);
   for (HeapPage* page = large_pages_; page != NULL; page = page->next()) {
+    if (page->needs_sweep_ &&
+        !RawObject::FromAddr(page->object_start())->IsMarked()) {
+      continue;  // Dead, but not swept yet.
+    }
     page->VisitRememberedCards(visitor);
   }
 }
@@ -803,6 +836,7 @@ void PageSpace::WriteProtect(bool read_only) {
   if (read_only) {
     // Avoid MakeIterable trying to write to the heap.
     AbandonBumpAllocation();
+    AbandonTLABs();
   }
   for (ExclusivePageIterator it(this); !it.Done(); it.Advance()) {
     if (!it.page()->is_image_page()) {
@@ -1064,6 +1098,10 @@ void PageSpace::CollectGarbageAtSafepoint(bool compact,
 
   NoSafepointScope no_safepoints;
 
+  // Return the unused parts of the threads' allocation buffers before the
+  // marking results overwrite the usage.
+  AbandonTLABs();
+
   if (FLAG_print_free_list_before_gc) {
     OS::PrintErr("Data Freelist (before GC):\n");
     freelist_[HeapPage::kData].Print();
@@ -1094,6 +1132,21 @@ void PageSpace::CollectGarbageAtSafepoint(bool compact,
   if (marker_ == NULL) {
     ASSERT(phase() == kDone);
     marker_ = new GCMarker(isolate, heap_);
+    // Markers only record the slots they visit, so evacuate only if all of
+    // the marking happens in this pause.
+    if (finalize && !compact && FLAG_use_evacuation) {
+      ASSERT(evacuator_ == NULL);
+      evacuator_ = new GCEvacuator(thread, this);
+      if (evacuator_->SelectCandidates(
+              evacuated_bytes_per_micro_,
+              EvacuationBudgetMicros())) {
+        // Slots of detached code would not be recorded.
+        collect_code = false;
+      } else {
+        delete evacuator_;
+        evacuator_ = NULL;
+      }
+    }
   } else {
     ASSERT(phase() == kAwaitingFinalization);
   }
@@ -1123,6 +1176,13 @@ void PageSpace::CollectGarbageAtSafepoint(bool compact,
   int64_t mid2 = OS::GetCurrentMonotonicMicros();
   int64_t mid3 = 0;
 
+  // Large and executable pages are swept with the data pages by the sweeper
+  // task. In W^X mode code pages are only writable during the pause, so they
+  // are then swept here, as they are when the data pages are not swept
+  // concurrently.
+  const bool sweep_large_and_code_concurrently =
+      FLAG_concurrent_sweep && !compact && !FLAG_write_protect_code;
+
   {
     if (FLAG_verify_before_gc) {
       OS::PrintErr("Verifying before sweeping...");
@@ -1131,52 +1191,54 @@ void PageSpace::CollectGarbageAtSafepoint(bool compact,
     }
 
     TIMELINE_FUNCTION_GC_DURATION(thread, "SweepLargeAndExecutablePages");
-    GCSweeper sweeper;
-
-    // During stop-the-world phases we should use bulk lock when adding
-    // elements to the free list.
-    MutexLocker mld(freelist_[HeapPage::kData].mutex());
-    MutexLocker mle(freelist_[HeapPage::kExecutable].mutex());
 
-    // Large and executable pages are always swept immediately.
-    HeapPage* prev_page = NULL;
-    HeapPage* page = large_pages_;
-    while (page != NULL) {
-      HeapPage* next_page = page->next();
-      const intptr_t words_to_end = sweeper.SweepLargePage(page);
-      if (words_to_end == 0) {
-        FreeLargePage(page, prev_page);
-      } else {
-        TruncateLargePage(page, words_to_end << kWordSizeLog2);
-        prev_page = page;
+    // Flag the large pages for SweepLargePages, which the sweeper task runs
+    // unless they are swept right here.
+    {
+      MutexLocker ml(large_pages_sweep_lock_);
+      ASSERT(large_pages_to_sweep_ == 0);
+      for (HeapPage* page = large_pages_; page != NULL; page = page->next()) {
+        page->needs_sweep_ = true;
+        large_pages_to_sweep_++;
       }
-      // Advance to the next page.
-      page = next_page;
     }
 
-    prev_page = NULL;
-    page = exec_pages_;
-    FreeList* freelist = &freelist_[HeapPage::kExecutable];
-    while (page != NULL) {
-      HeapPage* next_page = page->next();
-      bool page_in_use = sweeper.SweepPage(page, freelist, true);
-      if (page_in_use) {
-        prev_page = page;
-      } else {
-        FreePage(page, prev_page);
+    if (!sweep_large_and_code_concurrently) {
+      SweepLargePages();
+
+      // During stop-the-world phases we should use bulk lock when adding
+      // elements to the free list.
+      MutexLocker mle(freelist_[HeapPage::kExecutable].mutex());
+
+      GCSweeper sweeper;
+      HeapPage* prev_page = NULL;
+      HeapPage* page = exec_pages_;
+      FreeList* freelist = &freelist_[HeapPage::kExecutable];
+      while (page != NULL) {
+        HeapPage* next_page = page->next();
+        bool page_in_use = sweeper.SweepPage(page, freelist, true);
+        if (page_in_use) {
+          prev_page = page;
+        } else {
+          FreePage(page, prev_page);
+        }
+        // Advance to the next page.
+        page = next_page;
       }
-      // Advance to the next page.
-      page = next_page;
     }
 
     mid3 = OS::GetCurrentMonotonicMicros();
   }
 
+  if (evacuator_ != NULL) {
+    Evacuate(thread);
+  }
+
   if (compact) {
     Compact(thread);
     set_phase(kDone);
   } else if (FLAG_concurrent_sweep) {
-    ConcurrentSweep(isolate);
+    ConcurrentSweep(isolate, sweep_large_and_code_concurrently);
   } else {
     BlockingSweep();
     set_phase(kDone);
@@ -1240,10 +1302,85 @@ void PageSpace::BlockingSweep() {
   }
 }
 
-void PageSpace::ConcurrentSweep(Isolate* isolate) {
+void PageSpace::ConcurrentSweep(Isolate* isolate, bool sweep_code) {
   // Start the concurrent sweeper task now.
   GCSweeper::SweepConcurrent(isolate, pages_, pages_tail_,
-                             &freelist_[HeapPage::kData]);
+                             &freelist_[HeapPage::kData],
+                             sweep_code ? exec_pages_ : NULL,
+                             sweep_code ? exec_pages_tail_ : NULL,
+                             &freelist_[HeapPage::kExecutable]);
+}
+
+bool PageSpace::SweepLargePages() {
+  MutexLocker ml(large_pages_sweep_lock_);
+  if (large_pages_to_sweep_ == 0) {
+    return false;
+  }
+
+  TIMELINE_FUNCTION_GC_DURATION(Thread::Current(), "SweepLargePages");
+  GCSweeper sweeper;
+  bool released = false;
+  HeapPage* prev_page = NULL;
+  HeapPage* page = NULL;
+  {
+    // Pages allocated from here on are added in front of this one and need
+    // no sweeping.
+    MutexLocker pl(pages_lock_);
+    page = large_pages_;
+  }
+  while ((page != NULL) && (large_pages_to_sweep_ > 0)) {
+    HeapPage* next_page = page->next();
+    if (page->needs_sweep_) {
+      page->needs_sweep_ = false;
+      large_pages_to_sweep_--;
+      const intptr_t words_to_end = sweeper.SweepLargePage(page);
+      if (words_to_end == 0) {
+        FreeLargePage(page, prev_page);
+        released = true;
+      } else {
+        TruncateLargePage(page, words_to_end << kWordSizeLog2);
+        prev_page = page;
+      }
+    } else {
+      prev_page = page;
+    }
+    // Advance to the next page.
+    page = next_page;
+  }
+  ASSERT(large_pages_to_sweep_ == 0);
+  return released;
+}
+
+// Evacuation must leave room for the rest of the pause within the goal.
+int64_t PageSpace::EvacuationBudgetMicros() const {
+  int64_t budget = FLAG_evacuation_budget * kMicrosecondsPerMillisecond;
+  const int64_t pause_goal = heap_->gc_pause_goal_micros();
+  if (pause_goal > 0) {
+    budget = Utils::Minimum(budget, pause_goal / 4);
+  }
+  return budget;
+}
+
+void PageSpace::Evacuate(Thread* thread) {
+  TIMELINE_FUNCTION_GC_DURATION(thread, "Evacuate");
+  const int64_t start = OS::GetCurrentMonotonicMicros();
+  thread->isolate()->set_compaction_in_progress(true);
+  intptr_t moved_bytes = evacuator_->Evacuate(EvacuationBudgetMicros());
+  thread->isolate()->set_compaction_in_progress(false);
+  const int64_t micros = OS::GetCurrentMonotonicMicros() - start;
+  if ((moved_bytes > 0) && (micros > 0)) {
+    evacuated_bytes_per_micro_ =
+        Utils::Maximum(static_cast<intptr_t>(1),
+                       static_cast<intptr_t>(moved_bytes / micros));
+  }
+  delete evacuator_;
+  evacuator_ = NULL;
+
+  if (FLAG_verify_after_gc) {
+    OS::PrintErr("Verifying after evacuating...");
+    heap_->VerifyGC(kAllowMarked);
+    OS::PrintErr(" done.\n");
+  }
 }
 
 void PageSpace::Compact(Thread* thread) {
@@ -1334,6 +1471,58 @@ uword PageSpace::TryAllocatePromoLocked(intptr_t size,
   return TryAllocateDataLocked(size, growth_policy);
 }
 
+void PageSpace::FreePromoLocked(uword addr, intptr_t size) {
+  ASSERT(size >= kObjectAlignment);
+  ASSERT(Utils::IsAligned(size, kObjectAlignment));
+  freelist_[HeapPage::kData].FreeLocked(addr, size);
+  AtomicOperations::DecrementBy(&(usage_.used_in_words),
+                                (size >> kWordSizeLog2));
+}
+
+uword PageSpace::TryAllocateInFreshTLAB(Thread* thread, intptr_t size) {
+  ASSERT(size <= kTLABMaxObjectSize);
+  MutexLocker ml(freelist_[HeapPage::kData].mutex());
+  AbandonTLABLocked(thread);
+  // Counts the whole TLAB as used.
+  uword tlab = TryAllocateDataLocked(kTLABSize, kControlGrowth);
+  if (tlab == 0) {
+    return 0;
+  }
+  thread->set_old_space_top(tlab + size);
+  thread->set_old_space_end(tlab + kTLABSize);
+  return tlab;
+}
+
+void PageSpace::AbandonTLAB(Thread* thread) {
+  if (thread->old_space_top() == thread->old_space_end()) {
+    return;
+  }
+  MutexLocker ml(freelist_[HeapPage::kData].mutex());
+  AbandonTLABLocked(thread);
+}
+
+void PageSpace::AbandonTLABLocked(Thread* thread) {
+  uword top = thread->old_space_top();
+  uword end = thread->old_space_end();
+  if (top < end) {
+    FreePromoLocked(top, end - top);
+  }
+  thread->set_old_space_top(0);
+  thread->set_old_space_end(0);
+}
+
+void PageSpace::AbandonTLABs() {
+  heap_->isolate()->thread_registry()->AbandonOldSpaceTLABs(this);
+}
+
+void PageSpace::MakeTLABIterable(Thread* thread) const {
+  uword top = thread->old_space_top();
+  uword end = thread->old_space_end();
+  if (top < end) {
+    FreeListElement::AsElement(top, end - top);
+  }
+}
+
 void PageSpace::SetupImagePage(void* pointer, uword size, bool is_executable) {
   // Setup a HeapPage so precompiled Instructions can be traversed.
   // Instructions are contiguous at [pointer, pointer + size). HeapPage
@@ -1447,17 +1636,28 @@ void PageSpaceController::EvaluateGarbageCollection(SpaceUsage before,
     // Define GC to be 'worthwhile' iff at least fraction t of heap is garbage.
     double t = 1.0 - desired_utilization_;
     // If we spend too much time in GC, strive for even more free space.
-    if (gc_time_fraction > garbage_collection_time_ratio_) {
-      t += (gc_time_fraction - garbage_collection_time_ratio_) / 100.0;
+    const int time_ratio = (heap_->gc_time_goal() > 0)
+                               ? static_cast<int>(heap_->gc_time_goal())
+                               : garbage_collection_time_ratio_;
+    if (gc_time_fraction > time_ratio) {
+      t += (gc_time_fraction - time_ratio) / 100.0;
     }
 
     // Number of pages we can allocate and still be within the desired growth
     // ratio.
-    const intptr_t grow_pages =
+    intptr_t grow_pages =
         (static_cast<intptr_t>(after.CombinedCapacityInWords() /
                                desired_utilization_) -
          (after.CombinedCapacityInWords())) /
         kPageSizeInWords;
+    // A larger heap makes every collection take longer, so the growth ratio
+    // heuristics are not applied while pauses exceed the goal.
+    const int64_t pause_goal = heap_->gc_pause_goal_micros();
+    const bool over_pause_goal =
+        (pause_goal > 0) && (history_.MaxPauseMicros() > pause_goal);
+    if (over_pause_goal) {
+      grow_pages = 0;
+    }
     if (garbage_ratio == 0) {
       // No garbage in the previous cycle so it would be hard to compute a
       // grow_heap size based on estimated garbage so we use growth ratio
@@ -1558,6 +1758,15 @@ void PageSpaceGarbageCollectionHistory::AddGarbageCollectionTime(int64_t start,
   history_.Add(entry);
 }
 
+int64_t PageSpaceGarbageCollectionHistory::MaxPauseMicros() const {
+  int64_t result = 0;
+  for (int i = 0; i < history_.Size(); i++) {
+    Entry entry = history_.Get(i);
+    result = Utils::Maximum(result, entry.end - entry.start);
+  }
+  return result;
+}
+
 int PageSpaceGarbageCollectionHistory::GarbageCollectionTimeFraction() {
   int64_t gc_time = 0;
   int64_t total_time = 0;
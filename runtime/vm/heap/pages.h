@@ -5,6 +5,7 @@
 #ifndef RUNTIME_VM_HEAP_PAGES_H_
 #define RUNTIME_VM_HEAP_PAGES_H_
 
+#include "platform/atomic.h"
 #include "vm/globals.h"
 #include "vm/heap/freelist.h"
 #include "vm/heap/spaces.h"
@@ -25,6 +26,7 @@ class JSONObject;
 class ObjectPointerVisitor;
 class ObjectSet;
 class ForwardingPage;
+class GCEvacuator;
 class GCMarker;
 
 // TODO(iposva): Determine heap sizes and tune the page size accordingly.
@@ -130,9 +132,11 @@ class HeapPage {
   ForwardingPage* forwarding_page_;
   uint8_t* card_table_;  // Remembered set, not marking.
   PageType type_;
+  bool needs_sweep_;  // Large pages only, see PageSpace::SweepLargePages.
 
   friend class PageSpace;
   friend class GCCompactor;
+  friend class GCEvacuator;
 
   DISALLOW_ALLOCATION();
   DISALLOW_IMPLICIT_CONSTRUCTORS(HeapPage);
@@ -149,6 +153,9 @@ class PageSpaceGarbageCollectionHistory {
 
   int GarbageCollectionTimeFraction();
 
+  // The longest collection in the history.
+  int64_t MaxPauseMicros() const;
+
   bool IsEmpty() const { return history_.Size() == 0; }
 
  private:
@@ -316,6 +323,11 @@ class PageSpace {
   // Collect the garbage in the page space using mark-sweep or mark-compact.
   void CollectGarbage(bool compact, bool finalize);
 
+  // Sweeps the large pages that a mark-sweep left for the concurrent sweeper.
+  // Called by the sweeper, and by the mutator when it runs out of memory
+  // before the sweeper gets to them. Returns true if memory was released.
+  bool SweepLargePages();
+
   void AddRegionsToObjectSet(ObjectSet* set) const;
 
   void InitGrowthControl() {
@@ -349,6 +361,15 @@ class PageSpace {
 
   intptr_t collections() const { return collections_; }
 
+  // Free memory given back to the OS by the sweeper. May be called by
+  // sweeper tasks.
+  void AddDecommitted(intptr_t bytes) {
+    AtomicOperations::IncrementBy(&decommitted_in_bytes_, bytes);
+  }
+  intptr_t decommitted_in_bytes() const {
+    return AtomicOperations::LoadRelaxed(&decommitted_in_bytes_);
+  }
+
 #ifndef PRODUCT
   void PrintToJSONObject(JSONObject* object) const;
   void PrintHeapMapToJSONStream(Isolate* isolate, JSONStream* stream) const;
@@ -390,11 +411,38 @@ class PageSpace {
   Phase phase() const { return phase_; }
   void set_phase(Phase val) { phase_ = val; }
 
+  // Non-NULL while marking for an evacuation, see GCEvacuator.
+  GCEvacuator* evacuator() const { return evacuator_; }
+
   // Attempt to allocate from bump block rather than normal freelist.
   uword TryAllocateDataBump(intptr_t size, GrowthPolicy growth_policy);
   uword TryAllocateDataBumpLocked(intptr_t size, GrowthPolicy growth_policy);
   // Prefer small freelist blocks, then chip away at the bump block.
   uword TryAllocatePromoLocked(intptr_t size, GrowthPolicy growth_policy);
+  // Return the unused part of a block obtained from TryAllocatePromoLocked.
+  void FreePromoLocked(uword addr, intptr_t size);
+
+  // Bump allocation of small data objects out of a thread-local allocation
+  // buffer (TLAB), which avoids the freelist lock on the fast path. A TLAB is
+  // counted as used when it is carved out of the freelist; its unused tail is
+  // handed back when it is abandoned at a safepoint or when the thread leaves
+  // the isolate. Returns 0 if the object is too large or no TLAB is available.
+  uword TryAllocateInTLAB(Thread* thread, intptr_t size) {
+    ASSERT(Utils::IsAligned(size, kObjectAlignment));
+    uword top = thread->old_space_top();
+    if ((thread->old_space_end() - top) >= static_cast<uword>(size)) {
+      thread->set_old_space_top(top + size);
+      return top;
+    }
+    if (size > kTLABMaxObjectSize) {
+      return 0;
+    }
+    return TryAllocateInFreshTLAB(thread, size);
+  }
+  void AbandonTLAB(Thread* thread);
+  // Abandons the TLABs of all threads of the isolate. Called at safepoints.
+  void AbandonTLABs();
+  void MakeTLABIterable(Thread* thread) const;
 
   void SetupImagePage(void* pointer, uword size, bool is_executable);
 
@@ -404,6 +452,12 @@ class PageSpace {
   void AbandonMarkingForShutdown();
 
  private:
+  static const intptr_t kTLABSize = 16 * KB;
+  static const intptr_t kTLABMaxObjectSize = 1 * KB;
+
+  uword TryAllocateInFreshTLAB(Thread* thread, intptr_t size);
+  void AbandonTLABLocked(Thread* thread);
+
   // Ids for time and data records in Heap::GCStats.
   enum {
     // Time
@@ -448,8 +502,10 @@ class PageSpace {
                                  int64_t pre_wait_for_sweepers,
                                  int64_t pre_safe_point);
   void BlockingSweep();
-  void ConcurrentSweep(Isolate* isolate);
+  void ConcurrentSweep(Isolate* isolate, bool sweep_code);
   void Compact(Thread* thread);
+  void Evacuate(Thread* thread);
+  int64_t EvacuationBudgetMicros() const;
 
   static intptr_t LargePageSizeInWordsFor(intptr_t size);
 
@@ -480,6 +536,12 @@ class PageSpace {
   HeapPage* large_pages_;
   HeapPage* image_pages_;
 
+  // Serializes sweeping of the large pages left unswept by the last
+  // mark-sweep with the visitors of their remembered cards. Acquired before
+  // pages_lock_.
+  Mutex* large_pages_sweep_lock_;
+  intptr_t large_pages_to_sweep_;
+
   // A block of memory in a data page, managed by bump allocation. The remainder
   // is kept formatted as a FreeListElement, but is not in any freelist.
   uword bump_top_;
@@ -504,10 +566,13 @@ class PageSpace {
 #endif
   PageSpaceController page_space_controller_;
   GCMarker* marker_;
+  GCEvacuator* evacuator_;
 
   int64_t gc_time_micros_;
   intptr_t collections_;
   intptr_t mark_words_per_micro_;
+  intptr_t evacuated_bytes_per_micro_;
+  intptr_t decommitted_in_bytes_;
 
   friend class ExclusivePageIterator;
   friend class ExclusiveCodePageIterator;
@@ -517,6 +582,7 @@ class PageSpace {
   friend class SweeperTask;
   friend class GCCompactor;
   friend class CompactorTask;
+  friend class GCEvacuator;
 
   DISALLOW_IMPLICIT_CONSTRUCTORS(PageSpace);
 };
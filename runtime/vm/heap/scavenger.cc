@@ -7,6 +7,8 @@
 #include "vm/dart.h"
 #include "vm/dart_api_state.h"
 #include "vm/flag_list.h"
+#include "vm/heap/freelist.h"
+#include "vm/heap/pages.h"
 #include "vm/heap/pointer_block.h"
 #include "vm/heap/safepoint.h"
 #include "vm/heap/verifier.h"
@@ -17,6 +19,8 @@
 #include "vm/object_id_ring.h"
 #include "vm/object_set.h"
 #include "vm/stack_frame.h"
+#include "vm/thread_barrier.h"
+#include "vm/thread_pool.h"
 #include "vm/thread_registry.h"
 #include "vm/timeline.h"
 #include "vm/visitor.h"
@@ -33,6 +37,16 @@ DEFINE_FLAG(int,
             90,
             "Grow new gen when less than this percentage is garbage.");
 DEFINE_FLAG(int, new_gen_growth_factor, 2, "Grow new gen by this factor.");
+DEFINE_FLAG(bool,
+            pretenure,
+            false,
+            "Allocate instances of classes whose new objects mostly survive "
+            "their first scavenge directly in old space.");
+DEFINE_FLAG(int,
+            pretenure_threshold,
+            90,
+            "Pretenure a class when at least this percentage of the bytes it "
+            "allocated in new space survive their first scavenge.");
 
 // Scavenger uses RawObject::kMarkBit to distinguish forwarded and non-forwarded
 // objects. The kMarkBit does not intersect with the target address because of
@@ -60,19 +74,157 @@ static inline void ForwardTo(uword original, uword target) {
   *reinterpret_cast<uword*>(original) = target | kForwarded;
 }
 
-class ScavengerVisitor : public ObjectPointerVisitor {
+// Scavenger tasks visit copied and promoted objects through a shared stack of
+// blocks. Like MarkerWorkList, each task keeps one block private and only
+// exchanges full (or empty) blocks with the shared stack.
+class ScavengerWorkList : public ValueObject {
  public:
-  explicit ScavengerVisitor(Isolate* isolate,
-                            Scavenger* scavenger,
-                            SemiSpace* from)
+  explicit ScavengerWorkList(MarkingStack* work_stack)
+      : work_stack_(work_stack), work_(NULL) {
+    if (work_stack_ != NULL) {
+      work_ = work_stack_->PopEmptyBlock();
+    }
+  }
+
+  ~ScavengerWorkList() { ASSERT(work_ == NULL); }
+
+  // Returns NULL if no more work was found.
+  RawObject* Pop() {
+    ASSERT(work_ != NULL);
+    if (work_->IsEmpty()) {
+      MarkingStack::Block* new_work = work_stack_->PopNonEmptyBlock();
+      if (new_work == NULL) {
+        return NULL;
+      }
+      work_stack_->PushBlock(work_);
+      work_ = new_work;
+    }
+    return work_->Pop();
+  }
+
+  void Push(RawObject* raw_obj) {
+    ASSERT(work_ != NULL);
+    if (work_->IsFull()) {
+      work_stack_->PushBlock(work_);
+      work_ = work_stack_->PopEmptyBlock();
+    }
+    work_->Push(raw_obj);
+  }
+
+  void Finalize() {
+    if (work_ != NULL) {
+      ASSERT(work_->IsEmpty());
+      work_stack_->PushBlock(work_);
+      work_ = NULL;
+    }
+  }
+
+ private:
+  MarkingStack* work_stack_;
+  MarkingStack::Block* work_;
+
+  DISALLOW_COPY_AND_ASSIGN(ScavengerWorkList);
+};
+
+#ifndef PRODUCT
+// The class heap stats of the objects copied by one task of a parallel
+// scavenge. Several tasks updating the class table at the same time would
+// lose counts, so the main thread merges these after the tasks are done.
+class ScavengerClassStats {
+ public:
+  explicit ScavengerClassStats(intptr_t num_classes)
+      : num_classes_(num_classes),
+        live_new_count_(new intptr_t[num_classes]),
+        live_new_size_(new intptr_t[num_classes]),
+        promoted_count_(new intptr_t[num_classes]),
+        promoted_size_(new intptr_t[num_classes]) {
+    for (intptr_t i = 0; i < num_classes_; i++) {
+      live_new_count_[i] = 0;
+      live_new_size_[i] = 0;
+      promoted_count_[i] = 0;
+      promoted_size_[i] = 0;
+    }
+  }
+
+  ~ScavengerClassStats() {
+    delete[] live_new_count_;
+    delete[] live_new_size_;
+    delete[] promoted_count_;
+    delete[] promoted_size_;
+  }
+
+  void UpdateLiveNew(intptr_t class_id, intptr_t size) {
+    ASSERT(class_id < num_classes_);
+    live_new_count_[class_id] += 1;
+    live_new_size_[class_id] += size;
+  }
+
+  void UpdateAllocatedOld(intptr_t class_id, intptr_t size) {
+    ASSERT(class_id < num_classes_);
+    promoted_count_[class_id] += 1;
+    promoted_size_[class_id] += size;
+  }
+
+  void MergeInto(ClassTable* table) const {
+    for (intptr_t i = 0; i < table->NumCids(); ++i) {
+      if (live_new_count_[i] > 0) {
+        table->UpdateLiveNew(i, live_new_size_[i], live_new_count_[i]);
+      }
+      if (promoted_count_[i] > 0) {
+        table->UpdateAllocatedOld(i, promoted_size_[i], promoted_count_[i]);
+      }
+    }
+  }
+
+ private:
+  const intptr_t num_classes_;
+  intptr_t* live_new_count_;
+  intptr_t* live_new_size_;
+  intptr_t* promoted_count_;
+  intptr_t* promoted_size_;
+
+  DISALLOW_COPY_AND_ASSIGN(ScavengerClassStats);
+};
+#endif  // !PRODUCT
+
+// The serial visitor copies objects with a Cheney scan of the to space and a
+// promoted stack at the end of it (see Scavenger::ProcessToSpace). The
+// parallel visitor claims objects by atomically installing a forwarding
+// header, copies them into task-local to-space and promotion buffers and
+// hands them to the other tasks through a ScavengerWorkList.
+template <bool parallel>
+class ScavengerVisitorBase : public ObjectPointerVisitor {
+ public:
+  ScavengerVisitorBase(Isolate* isolate,
+                       Scavenger* scavenger,
+                       SemiSpace* from,
+                       MarkingStack* work_stack)
       : ObjectPointerVisitor(isolate),
         thread_(Thread::Current()),
         scavenger_(scavenger),
         from_(from),
         heap_(scavenger->heap_),
         page_space_(scavenger->heap_->old_space()),
+        work_list_(work_stack),
+        copy_top_(0),
+        copy_end_(0),
+        promo_top_(0),
+        promo_end_(0),
+        delayed_weak_properties_(NULL),
         bytes_promoted_(0),
-        visiting_old_object_(NULL) {}
+        failed_to_promote_(false),
+#ifndef PRODUCT
+        class_stats_(parallel ? new ScavengerClassStats(
+                                    isolate->class_table()->Capacity())
+                              : NULL),
+#endif  // !PRODUCT
+        visiting_old_object_(NULL) {
+    ASSERT(parallel == (work_stack != NULL));
+  }
+
+#ifndef PRODUCT
+  ~ScavengerVisitorBase() { delete class_stats_; }
+#endif  // !PRODUCT
 
   void VisitPointers(RawObject** first, RawObject** last) {
     ASSERT(Utils::IsAligned(first, sizeof(*first)));
@@ -97,8 +249,154 @@ class ScavengerVisitor : public ObjectPointerVisitor {
   }
 
   intptr_t bytes_promoted() const { return bytes_promoted_; }
+  bool failed_to_promote() const { return failed_to_promote_; }
+
+#ifndef PRODUCT
+  // Hands the class heap stats of a parallel visitor over to the caller.
+  ScavengerClassStats* ReleaseClassStats() {
+    ScavengerClassStats* class_stats = class_stats_;
+    class_stats_ = NULL;
+    return class_stats;
+  }
+#endif  // !PRODUCT
+
+  void EnqueueWeakProperty(RawWeakProperty* raw_weak) {
+    ASSERT(raw_weak->IsHeapObject());
+    ASSERT(raw_weak->IsNewObject());
+    ASSERT(raw_weak->IsWeakProperty());
+#if defined(DEBUG)
+    uword raw_addr = RawObject::ToAddr(raw_weak);
+    uword header = *reinterpret_cast<uword*>(raw_addr);
+    ASSERT(!IsForwarding(header));
+#endif  // defined(DEBUG)
+    ASSERT(raw_weak->ptr()->next_ == 0);
+    raw_weak->ptr()->next_ = reinterpret_cast<uword>(delayed_weak_properties_);
+    delayed_weak_properties_ = raw_weak;
+  }
+
+  intptr_t ProcessWeakProperty(RawWeakProperty* raw_weak) {
+    // The fate of the weak property is determined by its key.
+    RawObject* raw_key = raw_weak->ptr()->key_;
+    if (raw_key->IsHeapObject() && raw_key->IsNewObject()) {
+      uword raw_addr = RawObject::ToAddr(raw_key);
+      uword header = LoadHeader(raw_addr);
+      if (!IsForwarding(header)) {
+        // Key is white.  Enqueue the weak property.
+        EnqueueWeakProperty(raw_weak);
+        return raw_weak->Size();
+      }
+    }
+    // Key is gray or black.  Make the weak property black.
+    return raw_weak->VisitPointersNonvirtual(this);
+  }
+
+  // Visits the weak properties whose keys have become reachable since they
+  // were enqueued. Returns true if any weak property was visited, which may
+  // have produced more work.
+  bool ProcessPendingWeakProperties() {
+    bool visited = false;
+    RawWeakProperty* cur_weak = delayed_weak_properties_;
+    delayed_weak_properties_ = NULL;
+    while (cur_weak != NULL) {
+      uword next_weak = cur_weak->ptr()->next_;
+      // Promoted weak properties are not enqueued. So we can guarantee that
+      // we do not need to think about store barriers here.
+      ASSERT(cur_weak->IsNewObject());
+      RawObject* raw_key = cur_weak->ptr()->key_;
+      ASSERT(raw_key->IsHeapObject());
+      // Key still points into from space even if the object has been
+      // promoted to old space by now. The key will be updated accordingly
+      // below when VisitPointers is run.
+      ASSERT(raw_key->IsNewObject());
+      uword raw_addr = RawObject::ToAddr(raw_key);
+      ASSERT(from_->Contains(raw_addr));
+      uword header = LoadHeader(raw_addr);
+      // Reset the next pointer in the weak property.
+      cur_weak->ptr()->next_ = 0;
+      if (IsForwarding(header)) {
+        cur_weak->VisitPointersNonvirtual(this);
+        visited = true;
+      } else {
+        EnqueueWeakProperty(cur_weak);
+      }
+      // Advance to next weak property in the queue.
+      cur_weak = reinterpret_cast<RawWeakProperty*>(next_weak);
+    }
+    return visited;
+  }
+
+  // Drains the work list shared with the other scavenger tasks.
+  void ProcessWorkList() {
+    ASSERT(parallel);
+    do {
+      RawObject* raw_obj = work_list_.Pop();
+      while (raw_obj != NULL) {
+        ProcessObject(raw_obj);
+        raw_obj = work_list_.Pop();
+      }
+      // Work list is empty. Check whether any pending weak property had its
+      // key copied by another task in the meantime.
+    } while (ProcessPendingWeakProperties());
+  }
+
+  // Called when all objects have been copied.
+  void Finalize() {
+    work_list_.Finalize();
+    RetireCopyBuffer();
+    if (promo_top_ < promo_end_) {
+      page_space_->AcquireDataLock();
+      RetirePromoBufferLocked();
+      page_space_->ReleaseDataLock();
+    }
+
+    // The queued weak properties at this point do not refer to reachable
+    // keys, so we clear their key and value fields.
+    RawWeakProperty* cur_weak = delayed_weak_properties_;
+    delayed_weak_properties_ = NULL;
+    while (cur_weak != NULL) {
+      uword next_weak = cur_weak->ptr()->next_;
+      // Reset the next pointer in the weak property.
+      cur_weak->ptr()->next_ = 0;
+
+#if defined(DEBUG)
+      RawObject* raw_key = cur_weak->ptr()->key_;
+      uword raw_addr = RawObject::ToAddr(raw_key);
+      uword header = *reinterpret_cast<uword*>(raw_addr);
+      ASSERT(!IsForwarding(header));
+      ASSERT(raw_key->IsHeapObject());
+      ASSERT(raw_key->IsNewObject());  // Key still points into from space.
+#endif                                 // defined(DEBUG)
+
+      WeakProperty::Clear(cur_weak);
+
+      // Advance to next weak property in the queue.
+      cur_weak = reinterpret_cast<RawWeakProperty*>(next_weak);
+    }
+  }
 
  private:
+  // Sizes of the task-local allocation buffers used by parallel scavenges.
+  // Objects larger than a quarter of a buffer are allocated individually.
+  static const intptr_t kCopyBufferSize = 8 * KB;
+  static const intptr_t kPromoBufferSize = 32 * KB;
+
+  static uword LoadHeader(uword raw_addr) {
+    uword* header_addr = reinterpret_cast<uword*>(raw_addr);
+    return parallel ? AtomicOperations::LoadRelaxed(header_addr)
+                    : *header_addr;
+  }
+
+  // A claimed object whose copy is not yet complete has a forwarding header
+  // with no target. Wait for the claiming task to publish the target.
+  static uword WaitForForwarding(uword raw_addr, uword header) {
+    ASSERT(parallel);
+    uword* header_addr = reinterpret_cast<uword*>(raw_addr);
+    while (ForwardedAddr(header) == 0) {
+      header = AtomicOperations::LoadAcquire(header_addr);
+    }
+    return ForwardedAddr(header);
+  }
+
   void UpdateStoreBuffer(RawObject** p, RawObject* obj) {
     ASSERT(obj->IsHeapObject());
     if (FLAG_verify_gc_contains) {
@@ -128,11 +426,14 @@ class ScavengerVisitor : public ObjectPointerVisitor {
     ASSERT(from_->Contains(raw_addr));
     // Read the header word of the object and determine if the object has
     // already been copied.
-    uword header = *reinterpret_cast<uword*>(raw_addr);
+    uword header = LoadHeader(raw_addr);
     uword new_addr = 0;
     if (IsForwarding(header)) {
       // Get the new location of the object.
-      new_addr = ForwardedAddr(header);
+      new_addr = parallel ? WaitForForwarding(raw_addr, header)
+                          : ForwardedAddr(header);
+    } else if (parallel) {
+      new_addr = CopyParallel(raw_obj, header);
     } else {
       intptr_t size = raw_obj->Size();
       NOT_IN_PRODUCT(intptr_t cid = raw_obj->GetClassId());
@@ -160,7 +461,7 @@ class ScavengerVisitor : public ObjectPointerVisitor {
           NOT_IN_PRODUCT(class_table->UpdateAllocatedOld(cid, size));
         } else {
           // Promotion did not succeed. Copy into the to space instead.
-          scavenger_->failed_to_promote_ = true;
+          failed_to_promote_ = true;
           new_addr = scavenger_->AllocateGC(size);
           NOT_IN_PRODUCT(class_table->UpdateLiveNew(cid, size));
         }
@@ -174,19 +475,7 @@ class ScavengerVisitor : public ObjectPointerVisitor {
 
       RawObject* new_obj = RawObject::FromAddr(new_addr);
       if (new_obj->IsOldObject()) {
-        // Promoted: update age/barrier tags.
-        uint32_t tags = new_obj->ptr()->tags_;
-        tags = RawObject::OldBit::update(true, tags);
-        tags = RawObject::OldAndNotRememberedBit::update(true, tags);
-        tags = RawObject::NewBit::update(false, tags);
-        // Setting the forwarding pointer below will make this tenured object
-        // visible to the concurrent marker, but we haven't visited its slots
-        // yet. We mark the object here to prevent the concurrent marker from
-        // adding it to the mark stack and visiting its unprocessed slots. We
-        // push it to the mark stack after forwarding its slots.
-        tags =
-            RawObject::OldAndNotMarkedBit::update(!thread_->is_marking(), tags);
-        new_obj->ptr()->tags_ = tags;
+        UpdatePromotedTags(new_obj);
       }
 
       // Remember forwarding address.
@@ -201,18 +490,187 @@ class ScavengerVisitor : public ObjectPointerVisitor {
     }
   }
 
+  void UpdatePromotedTags(RawObject* new_obj) {
+    // Promoted: update age/barrier tags.
+    uint32_t tags = new_obj->ptr()->tags_;
+    tags = RawObject::OldBit::update(true, tags);
+    tags = RawObject::OldAndNotRememberedBit::update(true, tags);
+    tags = RawObject::NewBit::update(false, tags);
+    // Setting the forwarding pointer below will make this tenured object
+    // visible to the concurrent marker, but we haven't visited its slots
+    // yet. We mark the object here to prevent the concurrent marker from
+    // adding it to the mark stack and visiting its unprocessed slots. We
+    // push it to the mark stack after forwarding its slots.
+    tags = RawObject::OldAndNotMarkedBit::update(!thread_->is_marking(), tags);
+    new_obj->ptr()->tags_ = tags;
+  }
+
+  uword CopyParallel(RawObject* raw_obj, uword header) {
+    uword raw_addr = RawObject::ToAddr(raw_obj);
+    // Claim the object by installing a forwarding header without a target.
+    // If another task won the race, use (or wait for) its copy.
+    uword old_header = AtomicOperations::CompareAndSwapWord(
+        reinterpret_cast<uword*>(raw_addr), header, kForwarded);
+    if (old_header != header) {
+      return WaitForForwarding(raw_addr, old_header);
+    }
+
+    // The header has been overwritten, so decode the size from our copy.
+    uint32_t tags = static_cast<uint32_t>(header);
+    intptr_t size = raw_obj->HeapSize(tags);
+    NOT_IN_PRODUCT(intptr_t cid = RawObject::ClassIdTag::decode(tags));
+    uword new_addr = 0;
+    bool promoted = false;
+    if (scavenger_->survivor_end_ <= raw_addr) {
+      // Not a survivor of a previous scavenge. Copy it into the to space
+      // unless the buffers handed out to the tasks have exhausted it.
+      new_addr = TryAllocateCopy(size);
+    }
+    if (new_addr == 0) {
+      new_addr = TryAllocatePromo(size);
+      if (new_addr != 0) {
+        promoted = true;
+      } else {
+        // Promotion did not succeed. Copy into the to space instead.
+        failed_to_promote_ = true;
+        new_addr = TryAllocateCopy(size);
+        if (new_addr == 0) {
+          OUT_OF_MEMORY();
+        }
+      }
+    }
+    // Copy the object to the new location and restore the header that was
+    // replaced when claiming the object.
+    memmove(reinterpret_cast<void*>(new_addr),
+            reinterpret_cast<void*>(raw_addr), size);
+    *reinterpret_cast<uword*>(new_addr) = header;
+
+    RawObject* new_obj = RawObject::FromAddr(new_addr);
+    if (promoted) {
+      UpdatePromotedTags(new_obj);
+      bytes_promoted_ += size;
+      NOT_IN_PRODUCT(class_stats_->UpdateAllocatedOld(cid, size));
+    } else {
+      NOT_IN_PRODUCT(class_stats_->UpdateLiveNew(cid, size));
+    }
+
+    // Publish the copy. Tasks waiting in WaitForForwarding will observe the
+    // fully initialized object.
+    ASSERT((new_addr & kForwardingMask) == 0);
+    AtomicOperations::StoreRelease(reinterpret_cast<uword*>(raw_addr),
+                                   new_addr | kForwarded);
+    work_list_.Push(new_obj);
+    return new_addr;
+  }
+
+  void ProcessObject(RawObject* raw_obj) {
+    if (raw_obj->IsNewObject()) {
+      if (raw_obj->GetClassId() == kWeakPropertyCid) {
+        ProcessWeakProperty(reinterpret_cast<RawWeakProperty*>(raw_obj));
+      } else {
+        raw_obj->VisitPointersNonvirtual(this);
+      }
+      return;
+    }
+    // Resolve or copy all objects referred to by the promoted object.
+    ASSERT(!raw_obj->IsRemembered());
+    VisitingOldObject(raw_obj);
+    raw_obj->VisitPointersNonvirtual(this);
+    if (raw_obj->IsMarked()) {
+      // Complete our promise from UpdatePromotedTags.
+      thread_->MarkingStackAddObject(raw_obj);
+    }
+    VisitingOldObject(NULL);
+  }
+
+  uword TryAllocateCopy(intptr_t size) {
+    if (size > (kCopyBufferSize / 4)) {
+      return scavenger_->TryAllocateGCShared(size);
+    }
+    if ((copy_end_ - copy_top_) < static_cast<uword>(size)) {
+      RetireCopyBuffer();
+      uword buffer = scavenger_->TryAllocateGCShared(kCopyBufferSize);
+      if (buffer == 0) {
+        // Not enough room left for a whole buffer; take what is left.
+        return scavenger_->TryAllocateGCShared(size);
+      }
+      copy_top_ = buffer;
+      copy_end_ = buffer + kCopyBufferSize;
+    }
+    uword result = copy_top_;
+    copy_top_ += size;
+    return result;
+  }
+
+  // Leaves the to space walkable after the scavenge.
+  void RetireCopyBuffer() {
+    if (copy_top_ < copy_end_) {
+      FreeListElement::AsElementNew(copy_top_, copy_end_ - copy_top_);
+    }
+    copy_top_ = 0;
+    copy_end_ = 0;
+  }
+
+  uword TryAllocatePromo(intptr_t size) {
+    if ((size <= (kPromoBufferSize / 4)) &&
+        ((promo_end_ - promo_top_) >= static_cast<uword>(size))) {
+      uword result = promo_top_;
+      promo_top_ += size;
+      return result;
+    }
+    page_space_->AcquireDataLock();
+    uword result = 0;
+    if (size > (kPromoBufferSize / 4)) {
+      result =
+          page_space_->TryAllocatePromoLocked(size, PageSpace::kForceGrowth);
+    } else {
+      RetirePromoBufferLocked();
+      uword buffer = page_space_->TryAllocatePromoLocked(
+          kPromoBufferSize, PageSpace::kForceGrowth);
+      if (buffer != 0) {
+        promo_top_ = buffer + size;
+        promo_end_ = buffer + kPromoBufferSize;
+        result = buffer;
+      } else {
+        result =
+            page_space_->TryAllocatePromoLocked(size, PageSpace::kForceGrowth);
+      }
+    }
+    page_space_->ReleaseDataLock();
+    return result;
+  }
+
+  void RetirePromoBufferLocked() {
+    if (promo_top_ < promo_end_) {
+      page_space_->FreePromoLocked(promo_top_, promo_end_ - promo_top_);
+    }
+    promo_top_ = 0;
+    promo_end_ = 0;
+  }
+
   Thread* thread_;
   Scavenger* scavenger_;
   SemiSpace* from_;
   Heap* heap_;
   PageSpace* page_space_;
+  ScavengerWorkList work_list_;
+  uword copy_top_;
+  uword copy_end_;
+  uword promo_top_;
+  uword promo_end_;
   RawWeakProperty* delayed_weak_properties_;
   intptr_t bytes_promoted_;
+  // Each task records its own promotion failures; they are merged into the
+  // scavenger once all tasks are done.
+  bool failed_to_promote_;
+#ifndef PRODUCT
+  ScavengerClassStats* class_stats_;
+#endif  // !PRODUCT
   RawObject* visiting_old_object_;
 
   friend class Scavenger;
 
-  DISALLOW_COPY_AND_ASSIGN(ScavengerVisitor);
+  DISALLOW_COPY_AND_ASSIGN(ScavengerVisitorBase);
 };
 
 class ScavengerWeakVisitor : public HandleVisitor {
@@ -286,6 +744,7 @@ SemiSpace::~SemiSpace() {
 
 Mutex* SemiSpace::mutex_ = NULL;
 SemiSpace* SemiSpace::cache_ = NULL;
+bool SemiSpace::cache_trimmed_ = false;
 
 void SemiSpace::Init() {
   if (mutex_ == NULL) {
@@ -348,10 +807,21 @@ void SemiSpace::Delete() {
     MutexLocker locker(mutex_);
     old_cache = cache_;
     cache_ = this;
+    cache_trimmed_ = false;
   }
   delete old_cache;
 }
 
+void SemiSpace::TrimCache() {
+  MutexLocker locker(mutex_);
+  if ((cache_ == NULL) || (cache_->reserved_ == NULL) || cache_trimmed_) {
+    return;
+  }
+  VirtualMemory::Decommit(cache_->reserved_->address(),
+                          cache_->reserved_->size());
+  cache_trimmed_ = true;
+}
+
 void SemiSpace::WriteProtect(bool read_only) {
   if (reserved_ != NULL) {
     reserved_->Protect(read_only ? VirtualMemory::kReadOnly
@@ -372,13 +842,15 @@ Scavenger::Scavenger(Heap* heap,
       max_semi_capacity_in_words_(max_semi_capacity_in_words),
       object_alignment_(object_alignment),
       scavenging_(false),
-      delayed_weak_properties_(NULL),
       gc_time_micros_(0),
       collections_(0),
       scavenge_words_per_micro_(kConservativeInitialScavengeSpeed),
       idle_scavenge_threshold_in_words_(0),
       external_size_(0),
-      failed_to_promote_(false) {
+      failed_to_promote_(false),
+      pretenured_(),
+      newly_pretenured_(),
+      pretenured_in_bytes_(0) {
   // Verify assumptions about the first word in objects which the scavenger is
   // going to use for forwarding pointers.
   ASSERT(Object::tags_offset() == 0);
@@ -400,6 +872,7 @@ Scavenger::Scavenger(Heap* heap,
   end_ = to_->end();
 
   survivor_end_ = FirstObjectStart();
+  allocation_start_ = FirstObjectStart();
   idle_scavenge_threshold_in_words_ = initial_semi_capacity_in_words;
 
   UpdateMaxHeapCapacity();
@@ -415,8 +888,22 @@ intptr_t Scavenger::NewSizeInWords(intptr_t old_size_in_words) const {
   if (stats_history_.Size() == 0) {
     return old_size_in_words;
   }
-  double garbage = stats_history_.Get(0).ExpectedGarbageFraction();
-  if (garbage < (FLAG_new_gen_garbage_threshold / 100.0)) {
+  const ScavengeStats& last = stats_history_.Get(0);
+  bool grow = last.ExpectedGarbageFraction() <
+              (FLAG_new_gen_garbage_threshold / 100.0);
+  // Fewer, larger scavenges when they take too much of the time.
+  const intptr_t time_goal = heap_->gc_time_goal();
+  if ((time_goal > 0) && (GCTimeFraction() > time_goal)) {
+    grow = true;
+  }
+  // Assume the pause grows with the space, and don't grow past the pause
+  // goal.
+  const int64_t pause_goal = heap_->gc_pause_goal_micros();
+  if ((pause_goal > 0) &&
+      ((last.DurationMicros() * FLAG_new_gen_growth_factor) > pause_goal)) {
+    grow = false;
+  }
+  if (grow) {
     return Utils::Minimum(max_semi_capacity_in_words_,
                           old_size_in_words * FLAG_new_gen_growth_factor);
   } else {
@@ -424,6 +911,22 @@ intptr_t Scavenger::NewSizeInWords(intptr_t old_size_in_words) const {
   }
 }
 
+// Percentage of the time since the oldest scavenge in the history that was
+// spent scavenging.
+intptr_t Scavenger::GCTimeFraction() const {
+  int64_t gc_time = 0;
+  for (intptr_t i = 0; i < stats_history_.Size() - 1; i++) {
+    gc_time += stats_history_.Get(i).DurationMicros();
+  }
+  const int64_t total_time =
+      stats_history_.Get(0).EndMicros() -
+      stats_history_.Get(stats_history_.Size() - 1).EndMicros();
+  if (total_time <= 0) {
+    return 0;
+  }
+  return static_cast<intptr_t>(gc_time * 100 / total_time);
+}
+
 SemiSpace* Scavenger::Prologue(Isolate* isolate) {
   NOT_IN_PRODUCT(isolate->class_table()->ResetCountersNew());
 
@@ -483,6 +986,7 @@ void Scavenger::Epilogue(Isolate* isolate, SemiSpace* from) {
     // objects candidates for promotion next time.
     survivor_end_ = end_;
   }
+  allocation_start_ = top_;
 
   // Update estimate of scavenger speed. This statistic assumes survivorship
   // rates don't change much.
@@ -561,7 +1065,7 @@ bool Scavenger::ShouldPerformIdleScavenge(int64_t deadline) {
 }
 
 void Scavenger::IterateStoreBuffers(Isolate* isolate,
-                                    ScavengerVisitor* visitor) {
+                                    SerialScavengerVisitor* visitor) {
   // Iterating through the store buffers.
   // Grab the deduplication sets out of the isolate's consolidated store buffer.
   StoreBufferBlock* pending = isolate->store_buffer()->Blocks();
@@ -590,14 +1094,12 @@ void Scavenger::IterateStoreBuffers(Isolate* isolate,
   heap_->old_space()->VisitRememberedCards(visitor);
 
   heap_->RecordData(kStoreBufferEntries, total_count);
-  heap_->RecordData(kDataUnused1, 0);
-  heap_->RecordData(kDataUnused2, 0);
   // Done iterating through old objects remembered in the store buffers.
   visitor->VisitingOldObject(NULL);
 }
 
 void Scavenger::IterateObjectIdTable(Isolate* isolate,
-                                     ScavengerVisitor* visitor) {
+                                     ObjectPointerVisitor* visitor) {
 #ifndef PRODUCT
   if (!FLAG_support_service) {
     return;
@@ -612,7 +1114,8 @@ void Scavenger::IterateObjectIdTable(Isolate* isolate,
 #endif  // !PRODUCT
 }
 
-void Scavenger::IterateRoots(Isolate* isolate, ScavengerVisitor* visitor) {
+void Scavenger::IterateRoots(Isolate* isolate,
+                             SerialScavengerVisitor* visitor) {
   NOT_IN_PRODUCT(Thread* thread = Thread::Current());
   int64_t start = OS::GetCurrentMonotonicMicros();
   {
@@ -658,7 +1161,7 @@ void Scavenger::IterateWeakRoots(Isolate* isolate, HandleVisitor* visitor) {
   isolate->VisitWeakPersistentHandles(visitor);
 }
 
-void Scavenger::ProcessToSpace(ScavengerVisitor* visitor) {
+void Scavenger::ProcessToSpace(SerialScavengerVisitor* visitor) {
   Thread* thread = Thread::Current();
 
   // Iterate until all work has been drained.
@@ -670,7 +1173,7 @@ void Scavenger::ProcessToSpace(ScavengerVisitor* visitor) {
         resolved_top_ += raw_obj->VisitPointersNonvirtual(visitor);
       } else {
         RawWeakProperty* raw_weak = reinterpret_cast<RawWeakProperty*>(raw_obj);
-        resolved_top_ += ProcessWeakProperty(raw_weak, visitor);
+        resolved_top_ += visitor->ProcessWeakProperty(raw_weak);
       }
     }
     {
@@ -695,37 +1198,10 @@ void Scavenger::ProcessToSpace(ScavengerVisitor* visitor) {
       }
       visitor->VisitingOldObject(NULL);
     }
-    {
-      // Finished this round of scavenging. Process the pending weak properties
-      // for which the keys have become reachable. Potentially this adds more
-      // objects to the to space.
-      RawWeakProperty* cur_weak = delayed_weak_properties_;
-      delayed_weak_properties_ = NULL;
-      while (cur_weak != NULL) {
-        uword next_weak = cur_weak->ptr()->next_;
-        // Promoted weak properties are not enqueued. So we can guarantee that
-        // we do not need to think about store barriers here.
-        ASSERT(cur_weak->IsNewObject());
-        RawObject* raw_key = cur_weak->ptr()->key_;
-        ASSERT(raw_key->IsHeapObject());
-        // Key still points into from space even if the object has been
-        // promoted to old space by now. The key will be updated accordingly
-        // below when VisitPointers is run.
-        ASSERT(raw_key->IsNewObject());
-        uword raw_addr = RawObject::ToAddr(raw_key);
-        ASSERT(visitor->from_->Contains(raw_addr));
-        uword header = *reinterpret_cast<uword*>(raw_addr);
-        // Reset the next pointer in the weak property.
-        cur_weak->ptr()->next_ = 0;
-        if (IsForwarding(header)) {
-          cur_weak->VisitPointersNonvirtual(visitor);
-        } else {
-          EnqueueWeakProperty(cur_weak);
-        }
-        // Advance to next weak property in the queue.
-        cur_weak = reinterpret_cast<RawWeakProperty*>(next_weak);
-      }
-    }
+    // Finished this round of scavenging. Process the pending weak properties
+    // for which the keys have become reachable. Potentially this adds more
+    // objects to the to space.
+    visitor->ProcessPendingWeakProperties();
   }
 }
 
@@ -758,37 +1234,6 @@ void Scavenger::UpdateMaxHeapUsage() {
 #endif  // !defined(PRODUCT)
 }
 
-void Scavenger::EnqueueWeakProperty(RawWeakProperty* raw_weak) {
-  ASSERT(raw_weak->IsHeapObject());
-  ASSERT(raw_weak->IsNewObject());
-  ASSERT(raw_weak->IsWeakProperty());
-#if defined(DEBUG)
-  uword raw_addr = RawObject::ToAddr(raw_weak);
-  uword header = *reinterpret_cast<uword*>(raw_addr);
-  ASSERT(!IsForwarding(header));
-#endif  // defined(DEBUG)
-  ASSERT(raw_weak->ptr()->next_ == 0);
-  raw_weak->ptr()->next_ = reinterpret_cast<uword>(delayed_weak_properties_);
-  delayed_weak_properties_ = raw_weak;
-}
-
-uword Scavenger::ProcessWeakProperty(RawWeakProperty* raw_weak,
-                                     ScavengerVisitor* visitor) {
-  // The fate of the weak property is determined by its key.
-  RawObject* raw_key = raw_weak->ptr()->key_;
-  if (raw_key->IsHeapObject() && raw_key->IsNewObject()) {
-    uword raw_addr = RawObject::ToAddr(raw_key);
-    uword header = *reinterpret_cast<uword*>(raw_addr);
-    if (!IsForwarding(header)) {
-      // Key is white.  Enqueue the weak property.
-      EnqueueWeakProperty(raw_weak);
-      return raw_weak->Size();
-    }
-  }
-  // Key is gray or black.  Make the weak property black.
-  return raw_weak->VisitPointersNonvirtual(visitor);
-}
-
 void Scavenger::ProcessWeakReferences() {
   // Rehash the weak tables now that we know which objects survive this cycle.
   for (int sel = 0; sel < Heap::kNumWeakSelectors; sel++) {
@@ -816,32 +1261,6 @@ void Scavenger::ProcessWeakReferences() {
     // table above.
     delete table;
   }
-
-  // The queued weak properties at this point do not refer to reachable keys,
-  // so we clear their key and value fields.
-  {
-    RawWeakProperty* cur_weak = delayed_weak_properties_;
-    delayed_weak_properties_ = NULL;
-    while (cur_weak != NULL) {
-      uword next_weak = cur_weak->ptr()->next_;
-      // Reset the next pointer in the weak property.
-      cur_weak->ptr()->next_ = 0;
-
-#if defined(DEBUG)
-      RawObject* raw_key = cur_weak->ptr()->key_;
-      uword raw_addr = RawObject::ToAddr(raw_key);
-      uword header = *reinterpret_cast<uword*>(raw_addr);
-      ASSERT(!IsForwarding(header));
-      ASSERT(raw_key->IsHeapObject());
-      ASSERT(raw_key->IsNewObject());  // Key still points into from space.
-#endif                                 // defined(DEBUG)
-
-      WeakProperty::Clear(cur_weak);
-
-      // Advance to next weak property in the queue.
-      cur_weak = reinterpret_cast<RawWeakProperty*>(next_weak);
-    }
-  }
 }
 
 void Scavenger::FlushTLS() const {
@@ -898,6 +1317,295 @@ RawObject* Scavenger::FindObject(FindObjectVisitor* visitor) const {
   return Object::null();
 }
 
+// State shared between the main thread and the tasks of a parallel scavenge.
+struct ParallelScavengeState {
+  SemiSpace* from;
+  MarkingStack* work_stack;
+  ThreadBarrier* barrier;
+  // Used to coordinate draining among tasks; all start out as 'busy'.
+  uintptr_t num_busy;
+  // Root slices are claimed by bumping this counter.
+  intptr_t next_root_slice;
+  // Store buffer blocks not yet claimed by any task.
+  StoreBufferBlock* store_buffer_blocks;
+  intptr_t store_buffer_entries;
+  intptr_t bytes_promoted;
+  // The number of tasks that failed to promote some object.
+  intptr_t tasks_failed_to_promote;
+  int64_t* task_micros;
+#ifndef PRODUCT
+  // The class heap stats of each task, merged after the tasks are done.
+  ScavengerClassStats** class_stats;
+#endif  // !PRODUCT
+};
+
+class ParallelScavengerTask : public ThreadPool::Task {
+ public:
+  ParallelScavengerTask(Scavenger* scavenger,
+                        Isolate* isolate,
+                        ParallelScavengeState* state,
+                        intptr_t task_index)
+      : scavenger_(scavenger),
+        isolate_(isolate),
+        state_(state),
+        task_index_(task_index) {}
+
+  virtual void Run() {
+    bool result =
+        Thread::EnterIsolateAsHelper(isolate_, Thread::kScavengerTask, true);
+    ASSERT(result);
+    ThreadBarrier* barrier = state_->barrier;
+    {
+      TIMELINE_FUNCTION_GC_DURATION(Thread::Current(), "ScavengerTask");
+      int64_t start = OS::GetCurrentMonotonicMicros();
+      ParallelScavengerVisitor visitor(isolate_, scavenger_, state_->from,
+                                       state_->work_stack);
+
+      // Phase 1: Claim root slices and store buffer blocks, and copy
+      // everything reachable from them.
+      ProcessRoots(&visitor);
+
+      bool more_to_scavenge = false;
+      do {
+        do {
+          visitor.ProcessWorkList();
+
+          // I can't find more work right now. If no other task is busy,
+          // then there will never be more work (NB: 1 is *before* decrement).
+          if (AtomicOperations::FetchAndDecrement(&state_->num_busy) == 1) {
+            break;
+          }
+
+          // Wait for some work to appear.
+          while (state_->work_stack->IsEmpty() &&
+                 AtomicOperations::LoadRelaxed(&state_->num_busy) > 0) {
+          }
+
+          // If no tasks are busy, there will never be more work.
+          if (AtomicOperations::LoadRelaxed(&state_->num_busy) == 0) break;
+
+          // I saw some work; get busy and compete for it.
+          AtomicOperations::FetchAndIncrement(&state_->num_busy);
+        } while (true);
+        // Wait for all tasks to stop.
+        barrier->Sync();
+#if defined(DEBUG)
+        ASSERT(AtomicOperations::LoadRelaxed(&state_->num_busy) == 0);
+        // Caveat: must not allow any task to continue past the barrier
+        // before we checked num_busy, otherwise one of them might rush
+        // ahead and increment it.
+        barrier->Sync();
+#endif
+        // Check if we have any pending weak properties whose keys have been
+        // copied by another task.
+        more_to_scavenge = visitor.ProcessPendingWeakProperties();
+        if (more_to_scavenge) {
+          // We have more work to do. Notify others.
+          AtomicOperations::FetchAndIncrement(&state_->num_busy);
+        }
+
+        // Wait for all other tasks to finish processing their pending weak
+        // properties and decide if they need to continue scavenging.
+        // Caveat: we need two barriers here to make this decision in lock step
+        // between all tasks and the main thread.
+        barrier->Sync();
+        if (!more_to_scavenge &&
+            (AtomicOperations::LoadRelaxed(&state_->num_busy) > 0)) {
+          // All tasks continue to scavenge as long as any single task has
+          // some work to do.
+          AtomicOperations::FetchAndIncrement(&state_->num_busy);
+          more_to_scavenge = true;
+        }
+        barrier->Sync();
+      } while (more_to_scavenge);
+
+      // Phase 2: Retire allocation buffers and clear the weak properties
+      // whose keys did not survive.
+      visitor.Finalize();
+      AtomicOperations::IncrementBy(&state_->bytes_promoted,
+                                    visitor.bytes_promoted());
+      if (visitor.failed_to_promote()) {
+        AtomicOperations::FetchAndIncrement(&state_->tasks_failed_to_promote);
+      }
+      NOT_IN_PRODUCT(state_->class_stats[task_index_] =
+                         visitor.ReleaseClassStats());
+      int64_t stop = OS::GetCurrentMonotonicMicros();
+      if (task_index_ < ScavengeStats::kMaxTaskTimings) {
+        state_->task_micros[task_index_] = stop - start;
+      }
+    }
+    barrier->Sync();
+    Thread::ExitIsolateAsHelper(true);
+
+    // This task is done. Notify the original thread.
+    barrier->Exit();
+  }
+
+ private:
+  void ProcessRoots(ParallelScavengerVisitor* visitor) {
+    NOT_IN_PRODUCT(Thread* thread = Thread::Current());
+    bool more_root_slices = true;
+    while (more_root_slices) {
+      intptr_t slice =
+          AtomicOperations::FetchAndIncrement(&state_->next_root_slice);
+      switch (slice) {
+        case 0: {
+          TIMELINE_FUNCTION_GC_DURATION(thread, "ProcessRoots");
+          isolate_->VisitObjectPointers(visitor,
+                                        ValidationPolicy::kDontValidateFrames);
+          break;
+        }
+        case 1: {
+          TIMELINE_FUNCTION_GC_DURATION(thread, "ProcessRememberedCards");
+          visitor->VisitingOldObject(NULL);
+          scavenger_->heap_->old_space()->VisitRememberedCards(visitor);
+          break;
+        }
+        case 2: {
+          scavenger_->IterateObjectIdTable(isolate_, visitor);
+          break;
+        }
+        default:
+          more_root_slices = false;
+      }
+    }
+
+    TIMELINE_FUNCTION_GC_DURATION(thread, "ProcessRememberedSet");
+    StoreBuffer* store_buffer = isolate_->store_buffer();
+    intptr_t total_count = 0;
+    StoreBufferBlock* pending = PopStoreBufferBlock();
+    while (pending != NULL) {
+      // Generated code appends to store buffers; tell MemorySanitizer.
+      MSAN_UNPOISON(pending, sizeof(*pending));
+      total_count += pending->Count();
+      while (!pending->IsEmpty()) {
+        RawObject* raw_object = pending->Pop();
+        ASSERT(!raw_object->IsForwardingCorpse());
+        ASSERT(raw_object->IsRemembered());
+        raw_object->ClearRememberedBit();
+        visitor->VisitingOldObject(raw_object);
+        raw_object->VisitPointersNonvirtual(visitor);
+      }
+      pending->Reset();
+      // Return the emptied block for recycling (no need to check threshold).
+      store_buffer->PushBlock(pending, StoreBuffer::kIgnoreThreshold);
+      pending = PopStoreBufferBlock();
+    }
+    // Done iterating through old objects remembered in the store buffers.
+    visitor->VisitingOldObject(NULL);
+    AtomicOperations::IncrementBy(&state_->store_buffer_entries, total_count);
+  }
+
+  // Blocks never return to the pending list once claimed, so a plain
+  // compare-and-swap pop does not suffer from ABA.
+  StoreBufferBlock* PopStoreBufferBlock() {
+    StoreBufferBlock* block =
+        AtomicOperations::LoadRelaxed(&state_->store_buffer_blocks);
+    while (block != NULL) {
+      StoreBufferBlock* old_block = AtomicOperations::CompareAndSwapPointer(
+          &state_->store_buffer_blocks, block, block->next());
+      if (old_block == block) {
+        return block;
+      }
+      block = old_block;
+    }
+    return NULL;
+  }
+
+  Scavenger* scavenger_;
+  Isolate* isolate_;
+  ParallelScavengeState* state_;
+  const intptr_t task_index_;
+
+  DISALLOW_COPY_AND_ASSIGN(ParallelScavengerTask);
+};
+
+intptr_t Scavenger::SerialScavenge(Isolate* isolate, SemiSpace* from) {
+  SerialScavengerVisitor visitor(isolate, this, from, NULL);
+  IterateRoots(isolate, &visitor);
+  int64_t iterate_roots = OS::GetCurrentMonotonicMicros();
+  {
+    TIMELINE_FUNCTION_GC_DURATION(Thread::Current(), "ProcessToSpace");
+    ProcessToSpace(&visitor);
+  }
+  visitor.Finalize();
+  int64_t process_to_space = OS::GetCurrentMonotonicMicros();
+  heap_->RecordTime(kProcessToSpace, process_to_space - iterate_roots);
+  failed_to_promote_ = visitor.failed_to_promote();
+  return visitor.bytes_promoted();
+}
+
+intptr_t Scavenger::ParallelScavenge(Isolate* isolate,
+                                     SemiSpace* from,
+                                     intptr_t num_tasks,
+                                     int64_t* task_micros) {
+  TIMELINE_FUNCTION_GC_DURATION(Thread::Current(), "ParallelScavenge");
+  int64_t start = OS::GetCurrentMonotonicMicros();
+  MarkingStack work_stack;
+  ParallelScavengeState state;
+  state.from = from;
+  state.work_stack = &work_stack;
+  state.num_busy = num_tasks;
+  state.next_root_slice = 0;
+  // Grab the deduplication sets out of the isolate's consolidated store buffer.
+  state.store_buffer_blocks = isolate->store_buffer()->Blocks();
+  state.store_buffer_entries = 0;
+  state.bytes_promoted = 0;
+  state.tasks_failed_to_promote = 0;
+  state.task_micros = task_micros;
+#ifndef PRODUCT
+  state.class_stats = new ScavengerClassStats*[num_tasks];
+  for (intptr_t i = 0; i < num_tasks; i++) {
+    state.class_stats[i] = NULL;
+  }
+#endif  // !PRODUCT
+  {
+    ThreadBarrier barrier(num_tasks + 1, heap_->barrier(),
+                          heap_->barrier_done());
+    state.barrier = &barrier;
+    for (intptr_t i = 0; i < num_tasks; i++) {
+      bool result = Dart::thread_pool()->Run(
+          new ParallelScavengerTask(this, isolate, &state, i));
+      ASSERT(result);
+    }
+    bool more_to_scavenge = false;
+    do {
+      // Wait for all tasks to stop.
+      barrier.Sync();
+#if defined(DEBUG)
+      ASSERT(AtomicOperations::LoadRelaxed(&state.num_busy) == 0);
+      // Caveat: must not allow any task to continue past the barrier
+      // before we checked num_busy, otherwise one of them might rush
+      // ahead and increment it.
+      barrier.Sync();
+#endif
+      // Wait for all tasks to go through weak properties and verify that
+      // there are no more objects to copy.
+      barrier.Sync();
+      more_to_scavenge = AtomicOperations::LoadRelaxed(&state.num_busy) > 0;
+      barrier.Sync();
+    } while (more_to_scavenge);
+
+    // Wait for all tasks to retire their allocation buffers.
+    barrier.Sync();
+    barrier.Exit();
+  }
+  ASSERT(state.store_buffer_blocks == NULL);
+#ifndef PRODUCT
+  ClassTable* class_table = isolate->class_table();
+  for (intptr_t i = 0; i < num_tasks; i++) {
+    state.class_stats[i]->MergeInto(class_table);
+    delete state.class_stats[i];
+  }
+  delete[] state.class_stats;
+#endif  // !PRODUCT
+  int64_t end = OS::GetCurrentMonotonicMicros();
+  heap_->RecordData(kStoreBufferEntries, state.store_buffer_entries);
+  heap_->RecordTime(kProcessToSpace, end - start);
+  failed_to_promote_ = state.tasks_failed_to_promote > 0;
+  return state.bytes_promoted;
+}
+
 void Scavenger::Scavenge() {
   Isolate* isolate = heap_->isolate();
   // Ensure that all threads for this isolate are at a safepoint (either stopped
@@ -935,19 +1643,26 @@ void Scavenger::Scavenge() {
   SpaceUsage usage_before = GetCurrentUsage();
   intptr_t promo_candidate_words =
       (survivor_end_ - FirstObjectStart()) / kWordSize;
+  const uword from_top = top_;
   SemiSpace* from = Prologue(isolate);
   // The API prologue/epilogue may create/destroy zones, so we must not
   // depend on zone allocations surviving beyond the epilogue callback.
   {
     StackZone zone(thread);
-    // Setup the visitor and run the scavenge.
-    ScavengerVisitor visitor(isolate, this, from);
-    page_space->AcquireDataLock();
-    IterateRoots(isolate, &visitor);
-    int64_t iterate_roots = OS::GetCurrentMonotonicMicros();
-    {
-      TIMELINE_FUNCTION_GC_DURATION(thread, "ProcessToSpace");
-      ProcessToSpace(&visitor);
+    // Negative task counts are treated as a single task.
+    const intptr_t num_tasks =
+        (FLAG_scavenger_tasks == 0)
+            ? 0
+            : Utils::Maximum<intptr_t>(1, FLAG_scavenger_tasks);
+    int64_t task_micros[ScavengeStats::kMaxTaskTimings];
+    intptr_t bytes_promoted;
+    if (num_tasks == 0) {
+      page_space->AcquireDataLock();
+      bytes_promoted = SerialScavenge(isolate, from);
+    } else {
+      // Scavenger tasks take the data lock only to refill their promotion
+      // buffers.
+      bytes_promoted = ParallelScavenge(isolate, from, num_tasks, task_micros);
     }
     int64_t process_to_space = OS::GetCurrentMonotonicMicros();
     {
@@ -956,15 +1671,31 @@ void Scavenger::Scavenge() {
       IterateWeakRoots(isolate, &weak_visitor);
     }
     ProcessWeakReferences();
-    page_space->ReleaseDataLock();
+    if (num_tasks == 0) {
+      page_space->ReleaseDataLock();
+    }
+    if (FLAG_pretenure) {
+      TIMELINE_FUNCTION_GC_DURATION(thread, "UpdatePretenuring");
+      UpdatePretenuring(isolate, from, from_top);
+    }
 
     // Scavenge finished. Run accounting.
     int64_t end = OS::GetCurrentMonotonicMicros();
-    heap_->RecordTime(kProcessToSpace, process_to_space - iterate_roots);
     heap_->RecordTime(kIterateWeaks, end - process_to_space);
-    stats_history_.Add(ScavengeStats(
-        start, end, usage_before, GetCurrentUsage(), promo_candidate_words,
-        visitor.bytes_promoted() >> kWordSizeLog2));
+    ScavengeStats stats(start, end, usage_before, GetCurrentUsage(),
+                        promo_candidate_words,
+                        bytes_promoted >> kWordSizeLog2,
+                        pretenured_in_bytes_ >> kWordSizeLog2);
+    heap_->RecordData(kPretenuredKB, pretenured_in_bytes_ / KB);
+    pretenured_in_bytes_ = 0;
+    const intptr_t num_timings =
+        Utils::Minimum(num_tasks, ScavengeStats::kMaxTaskTimings);
+    for (intptr_t i = 0; i < num_timings; i++) {
+      stats.set_task_micros(i, task_micros[i]);
+    }
+    heap_->RecordData(kScavengerTasks, num_tasks);
+    heap_->RecordData(kMaxTaskMicros, stats.MaxTaskMicros());
+    stats_history_.Add(stats);
   }
   Epilogue(isolate, from);
 
@@ -1028,6 +1759,72 @@ void Scavenger::FreeExternal(intptr_t size) {
   ASSERT(external_size_ >= 0);
 }
 
+// Only classes allocating at least this much in new space between two
+// scavenges have a meaningful survival rate.
+static const intptr_t kMinPretenureSampleBytes = 64 * KB;
+
+// Attributes the objects allocated since the last scavenge to their classes
+// and pretenures the classes whose objects mostly survived. The survivors of
+// earlier scavenges are not counted: they already proved to be long lived and
+// would bias the rate towards pretenuring.
+void Scavenger::UpdatePretenuring(Isolate* isolate,
+                                  SemiSpace* from,
+                                  uword from_top) {
+  const intptr_t num_cids = isolate->class_table()->NumCids();
+  Zone* zone = Thread::Current()->zone();
+  intptr_t* allocated_bytes = zone->Alloc<intptr_t>(num_cids);
+  intptr_t* survived_bytes = zone->Alloc<intptr_t>(num_cids);
+  memset(allocated_bytes, 0, num_cids * sizeof(intptr_t));
+  memset(survived_bytes, 0, num_cids * sizeof(intptr_t));
+
+  ASSERT(from->Contains(allocation_start_) || (allocation_start_ == from_top));
+  uword current = allocation_start_;
+  while (current < from_top) {
+    uword header = *reinterpret_cast<uword*>(current);
+    RawObject* raw_obj;
+    bool survived;
+    if (IsForwarding(header)) {
+      raw_obj = RawObject::FromAddr(ForwardedAddr(header));
+      survived = true;
+    } else {
+      raw_obj = RawObject::FromAddr(current);
+      survived = false;
+    }
+    const intptr_t cid = raw_obj->GetClassId();
+    const intptr_t size = raw_obj->Size();
+    if (cid < num_cids) {
+      allocated_bytes[cid] += size;
+      if (survived) {
+        survived_bytes[cid] += size;
+      }
+    }
+    current += size;
+  }
+
+  for (intptr_t cid = kNumPredefinedCids; cid < num_cids; cid++) {
+    if ((allocated_bytes[cid] < kMinPretenureSampleBytes) ||
+        ShouldPretenure(cid)) {
+      continue;
+    }
+    if ((survived_bytes[cid] * 100) <
+        (allocated_bytes[cid] * FLAG_pretenure_threshold)) {
+      continue;
+    }
+    while (pretenured_.length() <= cid) {
+      pretenured_.Add(false);
+    }
+    pretenured_[cid] = true;
+    newly_pretenured_.Add(cid);
+  }
+}
+
+void Scavenger::TakeNewlyPretenured(MallocGrowableArray<intptr_t>* cids) {
+  for (intptr_t i = 0; i < newly_pretenured_.length(); i++) {
+    cids->Add(newly_pretenured_[i]);
+  }
+  newly_pretenured_.Clear();
+}
+
 void Scavenger::Evacuate() {
   // We need a safepoint here to prevent allocation right before or right after
   // the scavenge.
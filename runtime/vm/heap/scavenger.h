@@ -6,6 +6,8 @@
 #define RUNTIME_VM_HEAP_SCAVENGER_H_
 
 #include "platform/assert.h"
+#include "platform/atomic.h"
+#include "platform/growable_array.h"
 #include "platform/utils.h"
 #include "vm/dart.h"
 #include "vm/flags.h"
@@ -23,7 +25,10 @@ class Heap;
 class Isolate;
 class JSONObject;
 class ObjectSet;
-class ScavengerVisitor;
+template <bool parallel>
+class ScavengerVisitorBase;
+typedef ScavengerVisitorBase<false> SerialScavengerVisitor;
+typedef ScavengerVisitorBase<true> ParallelScavengerVisitor;
 
 // Wrapper around VirtualMemory that adds caching and handles the empty case.
 class SemiSpace {
@@ -40,6 +45,10 @@ class SemiSpace {
   // Hand back an unused space.
   void Delete();
 
+  // Gives the memory of the cached unused space back to the OS, keeping the
+  // address range for reuse.
+  static void TrimCache();
+
   void* pointer() const { return region_.pointer(); }
   uword start() const { return region_.start(); }
   uword end() const { return region_.end(); }
@@ -61,25 +70,32 @@ class SemiSpace {
   MemoryRegion region_;
 
   static SemiSpace* cache_;
+  static bool cache_trimmed_;
   static Mutex* mutex_;
 };
 
 // Statistics for a particular scavenge.
 class ScavengeStats {
  public:
-  ScavengeStats() {}
+  // Upper bound on the number of scavenger tasks whose timings are kept.
+  static const intptr_t kMaxTaskTimings = 16;
+
+  ScavengeStats() : num_tasks_(0) {}
   ScavengeStats(int64_t start_micros,
                 int64_t end_micros,
                 SpaceUsage before,
                 SpaceUsage after,
                 intptr_t promo_candidates_in_words,
-                intptr_t promoted_in_words)
+                intptr_t promoted_in_words,
+                intptr_t pretenured_in_words)
       : start_micros_(start_micros),
         end_micros_(end_micros),
         before_(before),
         after_(after),
         promo_candidates_in_words_(promo_candidates_in_words),
-        promoted_in_words_(promoted_in_words) {}
+        promoted_in_words_(promoted_in_words),
+        pretenured_in_words_(pretenured_in_words),
+        num_tasks_(0) {}
 
   // Of all data before scavenge, what fraction was found to be garbage?
   // If this scavenge included growth, assume the extra capacity would become
@@ -101,6 +117,33 @@ class ScavengeStats {
   intptr_t UsedBeforeInWords() const { return before_.used_in_words; }
 
   int64_t DurationMicros() const { return end_micros_ - start_micros_; }
+  int64_t EndMicros() const { return end_micros_; }
+
+  // Words allocated directly in old space since the previous scavenge because
+  // their class was pretenured. This scavenge did not have to copy them.
+  intptr_t PretenuredInWords() const { return pretenured_in_words_; }
+
+  // Time spent by each task of a parallel scavenge, or none if the scavenge
+  // ran on the main thread only.
+  intptr_t num_tasks() const { return num_tasks_; }
+  int64_t task_micros(intptr_t task_index) const {
+    ASSERT((task_index >= 0) && (task_index < num_tasks_));
+    return task_micros_[task_index];
+  }
+  void set_task_micros(intptr_t task_index, int64_t micros) {
+    ASSERT((task_index >= 0) && (task_index < kMaxTaskTimings));
+    task_micros_[task_index] = micros;
+    if (task_index >= num_tasks_) {
+      num_tasks_ = task_index + 1;
+    }
+  }
+  int64_t MaxTaskMicros() const {
+    int64_t result = 0;
+    for (intptr_t i = 0; i < num_tasks_; i++) {
+      result = Utils::Maximum(result, task_micros_[i]);
+    }
+    return result;
+  }
 
  private:
   int64_t start_micros_;
@@ -109,6 +152,9 @@ class ScavengeStats {
   SpaceUsage after_;
   intptr_t promo_candidates_in_words_;
   intptr_t promoted_in_words_;
+  intptr_t pretenured_in_words_;
+  intptr_t num_tasks_;
+  int64_t task_micros_[kMaxTaskTimings];
 };
 
 class Scavenger {
@@ -143,6 +189,28 @@ class Scavenger {
     return result;
   }
 
+  // Like AllocateGC, but may be called concurrently by scavenger tasks.
+  // Returns 0 when the to space is exhausted.
+  uword TryAllocateGCShared(intptr_t size) {
+    ASSERT(Utils::IsAligned(size, kObjectAlignment));
+    ASSERT(scavenging_);
+    uword top = AtomicOperations::LoadRelaxed(&top_);
+    while (true) {
+      intptr_t remaining = end_ - top;
+      if (remaining < size) {
+        return 0;
+      }
+      uword old_top = AtomicOperations::CompareAndSwapWord(&top_, top,
+                                                           top + size);
+      if (old_top == top) {
+        ASSERT(to_->Contains(top));
+        ASSERT((top & kObjectAlignmentMask) == object_alignment_);
+        return top;
+      }
+      top = old_top;
+    }
+  }
+
   uword TryAllocateInTLAB(Thread* thread, intptr_t size) {
     ASSERT(Utils::IsAligned(size, kObjectAlignment));
     ASSERT(heap_ != Dart::vm_isolate()->heap());
@@ -223,6 +291,20 @@ class Scavenger {
 
   void FlushTLS() const;
 
+  // Whether new instances of the class should be allocated in old space,
+  // because most of them survived their first scavenge. Only decided with
+  // --pretenure.
+  bool ShouldPretenure(intptr_t cid) const {
+    return (cid < pretenured_.length()) && pretenured_[cid];
+  }
+  void RecordPretenured(intptr_t size) {
+    AtomicOperations::IncrementBy(&pretenured_in_bytes_, size);
+  }
+
+  // Returns the classes that became pretenured since the last call, so that
+  // their allocation stubs can be regenerated.
+  void TakeNewlyPretenured(MallocGrowableArray<intptr_t>* cids);
+
  private:
   // Ids for time and data records in Heap::GCStats.
   enum {
@@ -235,23 +317,24 @@ class Scavenger {
     kIterateWeaks = 5,
     // Data
     kStoreBufferEntries = 0,
-    kDataUnused1 = 1,
-    kDataUnused2 = 2,
-    kToKBAfterStoreBuffer = 3
+    kScavengerTasks = 1,
+    kMaxTaskMicros = 2,
+    kToKBAfterStoreBuffer = 3,
+    kPretenuredKB = 4
   };
 
   uword FirstObjectStart() const { return to_->start() | object_alignment_; }
   SemiSpace* Prologue(Isolate* isolate);
-  void IterateStoreBuffers(Isolate* isolate, ScavengerVisitor* visitor);
-  void IterateObjectIdTable(Isolate* isolate, ScavengerVisitor* visitor);
-  void IterateRoots(Isolate* isolate, ScavengerVisitor* visitor);
-  void IterateWeakProperties(Isolate* isolate, ScavengerVisitor* visitor);
-  void IterateWeakReferences(Isolate* isolate, ScavengerVisitor* visitor);
+  void IterateStoreBuffers(Isolate* isolate, SerialScavengerVisitor* visitor);
+  void IterateObjectIdTable(Isolate* isolate, ObjectPointerVisitor* visitor);
+  void IterateRoots(Isolate* isolate, SerialScavengerVisitor* visitor);
   void IterateWeakRoots(Isolate* isolate, HandleVisitor* visitor);
-  void ProcessToSpace(ScavengerVisitor* visitor);
-  void EnqueueWeakProperty(RawWeakProperty* raw_weak);
-  uword ProcessWeakProperty(RawWeakProperty* raw_weak,
-                            ScavengerVisitor* visitor);
+  void ProcessToSpace(SerialScavengerVisitor* visitor);
+  intptr_t SerialScavenge(Isolate* isolate, SemiSpace* from);
+  intptr_t ParallelScavenge(Isolate* isolate,
+                            SemiSpace* from,
+                            intptr_t num_tasks,
+                            int64_t* task_micros);
   void Epilogue(Isolate* isolate, SemiSpace* from);
 
   bool IsUnreachable(RawObject** p);
@@ -282,8 +365,10 @@ class Scavenger {
   void UpdateMaxHeapUsage();
 
   void ProcessWeakReferences();
+  void UpdatePretenuring(Isolate* isolate, SemiSpace* from, uword from_top);
 
   intptr_t NewSizeInWords(intptr_t old_size_in_words) const;
+  intptr_t GCTimeFraction() const;
 
   uword top_;
   uword end_;
@@ -299,6 +384,9 @@ class Scavenger {
   // Objects below this address have survived a scavenge.
   uword survivor_end_;
 
+  // Objects at or above this address were allocated since the last scavenge.
+  uword allocation_start_;
+
   intptr_t max_semi_capacity_in_words_;
 
   // All object are aligned to this value.
@@ -307,9 +395,6 @@ class Scavenger {
   // Keep track whether a scavenge is currently running.
   bool scavenging_;
 
-  // Keep track of pending weak properties discovered while scagenging.
-  RawWeakProperty* delayed_weak_properties_;
-
   int64_t gc_time_micros_;
   intptr_t collections_;
   static const int kStatsHistoryCapacity = 4;
@@ -323,8 +408,15 @@ class Scavenger {
 
   bool failed_to_promote_;
 
-  friend class ScavengerVisitor;
+  // Indexed by class id. Only changed during a scavenge.
+  MallocGrowableArray<bool> pretenured_;
+  MallocGrowableArray<intptr_t> newly_pretenured_;
+  intptr_t pretenured_in_bytes_;
+
+  template <bool>
+  friend class ScavengerVisitorBase;
   friend class ScavengerWeakVisitor;
+  friend class ParallelScavengerTask;
 
   DISALLOW_COPY_AND_ASSIGN(Scavenger);
 };
@@ -12,9 +12,26 @@
 #include "vm/lockers.h"
 #include "vm/thread_pool.h"
 #include "vm/timeline.h"
+#include "vm/virtual_memory.h"
 
 namespace dart {
 
+// Smaller free blocks are likely to be reused before the OS would reclaim
+// their memory.
+static const intptr_t kMinDecommitSize = 64 * KB;
+
+// Keeps the header of the free block, which becomes a free list element.
+void GCSweeper::Decommit(uword start, uword end) {
+  const intptr_t size = end - start;
+  uword interior = start + FreeListElement::HeaderSizeFor(size);
+  interior = Utils::RoundUp(interior, VirtualMemory::PageSize());
+  end = Utils::RoundDown(end, VirtualMemory::PageSize());
+  if (interior < end) {
+    decommitted_in_bytes_ += VirtualMemory::Decommit(
+        reinterpret_cast<void*>(interior), end - interior);
+  }
+}
+
 bool GCSweeper::SweepPage(HeapPage* page, FreeList* freelist, bool locked) {
   ASSERT(!page->is_image_page());
 
@@ -55,6 +72,11 @@ bool GCSweeper::SweepPage(HeapPage* page, FreeList* freelist, bool locked) {
 #endif  // DEBUG
       }
       if ((current != start) || (free_end != end)) {
+        // Must happen before the block is added to the free list, where the
+        // mutator could allocate into it.
+        if (decommit_ && !is_executable && (obj_size >= kMinDecommitSize)) {
+          Decommit(current, free_end);
+        }
         // Only add to the free list if not covering the whole page.
         if (locked) {
           freelist->FreeLocked(current, obj_size);
@@ -103,17 +125,25 @@ class SweeperTask : public ThreadPool::Task {
               PageSpace* old_space,
               HeapPage* first,
               HeapPage* last,
-              FreeList* freelist)
+              FreeList* freelist,
+              HeapPage* code_first,
+              HeapPage* code_last,
+              FreeList* code_freelist)
       : task_isolate_(isolate),
         old_space_(old_space),
         first_(first),
         last_(last),
-        freelist_(freelist) {
+        freelist_(freelist),
+        code_first_(code_first),
+        code_last_(code_last),
+        code_freelist_(code_freelist) {
     ASSERT(task_isolate_ != NULL);
     ASSERT(first_ != NULL);
     ASSERT(old_space_ != NULL);
     ASSERT(last_ != NULL);
     ASSERT(freelist_ != NULL);
+    ASSERT((code_first_ == NULL) == (code_last_ == NULL));
+    ASSERT(code_freelist_ != NULL);
     MonitorLocker ml(old_space_->tasks_lock());
     old_space_->set_tasks(old_space_->tasks() + 1);
     old_space_->set_phase(PageSpace::kSweeping);
@@ -126,29 +156,17 @@ class SweeperTask : public ThreadPool::Task {
     {
       Thread* thread = Thread::Current();
       TIMELINE_FUNCTION_GC_DURATION(thread, "SweeperTask");
-      GCSweeper sweeper;
-
-      HeapPage* page = first_;
-      HeapPage* prev_page = NULL;
-
-      while (page != NULL) {
-        ASSERT(thread->BypassSafepoints());  // Or we should be checking in.
-        HeapPage* next_page = page->next();
-        ASSERT(page->type() == HeapPage::kData);
-        bool page_in_use = sweeper.SweepPage(page, freelist_, false);
-        if (page_in_use) {
-          prev_page = page;
-        } else {
-          old_space_->FreePage(page, prev_page);
-        }
-        {
-          // Notify the mutator thread that we have added elements to the free
-          // list or that more capacity is available.
-          MonitorLocker ml(old_space_->tasks_lock());
-          ml.Notify();
-        }
-        if (page == last_) break;
-        page = next_page;
+
+      // Large pages are cheap to sweep and release the most memory, so they
+      // go first.
+      if (old_space_->SweepLargePages()) {
+        MonitorLocker ml(old_space_->tasks_lock());
+        ml.Notify();
+      }
+
+      SweepPages(thread, first_, last_, freelist_);
+      if (code_first_ != NULL) {
+        SweepPages(thread, code_first_, code_last_, code_freelist_);
       }
     }
     // Exit isolate cleanly *before* notifying it, to avoid shutdown race.
@@ -164,19 +182,56 @@ class SweeperTask : public ThreadPool::Task {
   }
 
  private:
+  void SweepPages(Thread* thread,
+                  HeapPage* first,
+                  HeapPage* last,
+                  FreeList* freelist) {
+    GCSweeper sweeper(FLAG_decommit_free_memory);
+    HeapPage* page = first;
+    HeapPage* prev_page = NULL;
+
+    while (page != NULL) {
+      ASSERT(thread->BypassSafepoints());  // Or we should be checking in.
+      HeapPage* next_page = page->next();
+      ASSERT(page->type() == first->type());
+      bool page_in_use = sweeper.SweepPage(page, freelist, false);
+      if (page_in_use) {
+        prev_page = page;
+      } else {
+        old_space_->FreePage(page, prev_page);
+      }
+      {
+        // Notify the mutator thread that we have added elements to the free
+        // list or that more capacity is available.
+        MonitorLocker ml(old_space_->tasks_lock());
+        ml.Notify();
+      }
+      if (page == last) break;
+      page = next_page;
+    }
+    old_space_->AddDecommitted(sweeper.decommitted_in_bytes());
+  }
+
   Isolate* task_isolate_;
   PageSpace* old_space_;
   HeapPage* first_;
   HeapPage* last_;
   FreeList* freelist_;
+  HeapPage* code_first_;
+  HeapPage* code_last_;
+  FreeList* code_freelist_;
 };
 
 void GCSweeper::SweepConcurrent(Isolate* isolate,
                                 HeapPage* first,
                                 HeapPage* last,
-                                FreeList* freelist) {
-  SweeperTask* task = new SweeperTask(isolate, isolate->heap()->old_space(),
-                                      first, last, freelist);
+                                FreeList* freelist,
+                                HeapPage* code_first,
+                                HeapPage* code_last,
+                                FreeList* code_freelist) {
+  SweeperTask* task =
+      new SweeperTask(isolate, isolate->heap()->old_space(), first, last,
+                      freelist, code_first, code_last, code_freelist);
   ThreadPool* pool = Dart::thread_pool();
   pool->Run(task);
 }
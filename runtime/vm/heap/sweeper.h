@@ -20,7 +20,10 @@ class PageSpace;
 // memory.
 class GCSweeper {
  public:
-  GCSweeper() {}
+  // With 'decommit', the memory of large free blocks is given back to the OS
+  // (see --decommit_free_memory).
+  explicit GCSweeper(bool decommit = false)
+      : decommit_(decommit), decommitted_in_bytes_(0) {}
   ~GCSweeper() {}
 
   // Sweep the memory area for the page while clearing the mark bits and adding
@@ -34,11 +37,24 @@ class GCSweeper {
   // last marked object.
   intptr_t SweepLargePage(HeapPage* page);
 
-  // Sweep the regular sized data pages between first and last inclusive.
+  intptr_t decommitted_in_bytes() const { return decommitted_in_bytes_; }
+
+  // Sweep the large pages flagged by the last mark-sweep, the regular sized
+  // data pages between first and last inclusive, and the executable pages
+  // between code_first and code_last inclusive, if any.
   static void SweepConcurrent(Isolate* isolate,
                               HeapPage* first,
                               HeapPage* last,
-                              FreeList* freelist);
+                              FreeList* freelist,
+                              HeapPage* code_first,
+                              HeapPage* code_last,
+                              FreeList* code_freelist);
+
+ private:
+  void Decommit(uword start, uword end);
+
+  const bool decommit_;
+  intptr_t decommitted_in_bytes_;
 };
 
 }  // namespace dart
@@ -0,0 +1,112 @@
+// Copyright (c) 2019, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#ifndef RUNTIME_VM_HEAP_WORK_STEALING_DEQUE_H_
+#define RUNTIME_VM_HEAP_WORK_STEALING_DEQUE_H_
+
+#include "platform/assert.h"
+#include "platform/atomic.h"
+#include "vm/allocation.h"
+#include "vm/globals.h"
+
+namespace dart {
+
+// A fixed capacity Chase-Lev work-stealing deque of pointers. The owning
+// thread pushes and pops at the bottom without locking; other threads steal
+// from the top. Since the capacity is fixed, Push fails instead of growing
+// and the caller must put the work elsewhere.
+//
+// All accesses to the indices and elements are atomic, as thieves read them
+// while the owner changes them. The orderings between the bottom and top
+// indices required by the algorithm are provided by full memory barriers.
+template <typename T, intptr_t kCapacityLog2>
+class WorkStealingDeque {
+ public:
+  static const intptr_t kCapacity = static_cast<intptr_t>(1) << kCapacityLog2;
+
+  WorkStealingDeque() : top_(0), bottom_(0) {}
+
+  // Owner only. Returns false if the deque is full.
+  bool Push(T* value) {
+    ASSERT(value != NULL);
+    const intptr_t bottom = AtomicOperations::LoadRelaxed(&bottom_);
+    const intptr_t top = AtomicOperations::LoadAcquire(&top_);
+    if ((bottom - top) >= kCapacity) {
+      return false;
+    }
+    AtomicOperations::StoreRelaxed(&elements_[bottom & kMask], value);
+    AtomicOperations::StoreRelease(&bottom_, bottom + 1);
+    return true;
+  }
+
+  // Owner only. Returns NULL if the deque is empty.
+  T* Pop() {
+    const intptr_t bottom = AtomicOperations::LoadRelaxed(&bottom_) - 1;
+    AtomicOperations::StoreRelaxed(&bottom_, bottom);
+    // Order the store of bottom_ before the load of top_, so that a thief
+    // cannot take the element this pop takes.
+    AtomicOperations::FullMemoryBarrier();
+    intptr_t top = AtomicOperations::LoadRelaxed(&top_);
+    if (top > bottom) {
+      // Empty.
+      AtomicOperations::StoreRelease(&bottom_, bottom + 1);
+      return NULL;
+    }
+    T* value = AtomicOperations::LoadRelaxed(&elements_[bottom & kMask]);
+    if (top == bottom) {
+      // Last element: race the thieves for it.
+      if (CompareAndSwapTop(top, top + 1) != top) {
+        value = NULL;
+      }
+      AtomicOperations::StoreRelease(&bottom_, bottom + 1);
+    }
+    return value;
+  }
+
+  // Any thread. Returns NULL if the deque is empty or the race for the top
+  // element was lost.
+  T* Steal() {
+    const intptr_t top = AtomicOperations::LoadAcquire(&top_);
+    // Order the load of top_ before the load of bottom_.
+    AtomicOperations::FullMemoryBarrier();
+    const intptr_t bottom = AtomicOperations::LoadAcquire(&bottom_);
+    if (top >= bottom) {
+      return NULL;
+    }
+    // The owner cannot reuse this slot before top_ moves past it, in which
+    // case the CAS below fails.
+    T* value = AtomicOperations::LoadRelaxed(&elements_[top & kMask]);
+    if (CompareAndSwapTop(top, top + 1) != top) {
+      return NULL;
+    }
+    return value;
+  }
+
+  // Only exact when no Push or Pop is running.
+  bool IsEmpty() {
+    return AtomicOperations::LoadAcquire(&top_) >=
+           AtomicOperations::LoadAcquire(&bottom_);
+  }
+
+ private:
+  static const intptr_t kMask = kCapacity - 1;
+
+  intptr_t CompareAndSwapTop(intptr_t old_value, intptr_t new_value) {
+    return static_cast<intptr_t>(AtomicOperations::CompareAndSwapWord(
+        reinterpret_cast<uword*>(&top_), static_cast<uword>(old_value),
+        static_cast<uword>(new_value)));
+  }
+
+  // Thieves and the owner contend on top_. Only the owner stores to bottom_
+  // and elements_, but thieves read them.
+  intptr_t top_;
+  intptr_t bottom_;
+  T* elements_[kCapacity];
+
+  DISALLOW_COPY_AND_ASSIGN(WorkStealingDeque);
+};
+
+}  // namespace dart
+
+#endif  // RUNTIME_VM_HEAP_WORK_STEALING_DEQUE_H_
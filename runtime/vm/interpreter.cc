@@ -924,7 +924,9 @@ DART_NOINLINE bool Interpreter::ProcessInvocation(bool* invoked,
         const classid_t field_nullability_cid = field->ptr()->is_nullable_;
         const classid_t value_cid = InterpreterHelpers::GetClassId(value);
         if (value_cid != field_guarded_cid &&
-            value_cid != field_nullability_cid) {
+            value_cid != field_nullability_cid &&
+            !(field_guarded_cid == kIntegerCid &&
+              RawObject::IsIntegerClassId(value_cid))) {
           if (Smi::Value(field->ptr()->guarded_list_length_) <
                   Field::kUnknownFixedLength &&
               field_guarded_cid == kIllegalCid) {
@@ -503,6 +503,10 @@ MessageHandler::MessageStatus IsolateMessageHandler::HandleMessage(
   tds.CopyArgument(0, "isolateName", I->name());
 #endif
 
+  // Let an idle isolate catch up with finalizers deferred by a GC.
+  I->api_state()->finalization_queue()->RunCallbacks(
+      I, FinalizationQueue::kBatchSize);
+
   // If the message is in band we lookup the handler to dispatch to.  If the
   // receive port was closed, we drop the message without deserializing it.
   // Illegal port is a special case for artificially enqueued isolate library
@@ -1822,6 +1826,8 @@ void Isolate::LowLevelShutdown() {
   // Finalize any weak persistent handles with a non-null referent.
   FinalizeWeakPersistentHandlesVisitor visitor;
   api_state()->weak_persistent_handles().VisitHandles(&visitor);
+  // Also run the callbacks that were deferred, see FinalizationQueue.
+  api_state()->finalization_queue()->RunAllCallbacks(this);
 
 #if !defined(PRODUCT)
   if (FLAG_dump_megamorphic_stats) {
@@ -2835,6 +2841,11 @@ Thread* Isolate::ScheduleThread(bool is_mutator, bool bypass_safepoint) {
 void Isolate::UnscheduleThread(Thread* thread,
                                bool is_mutator,
                                bool bypass_safepoint) {
+  // Hand back the unused part of the thread's old-space allocation buffer
+  // while it still counts as running, so no GC can race with this.
+  if (heap() != NULL) {
+    heap()->old_space()->AbandonTLAB(thread);
+  }
   // Disassociate the 'Thread' structure and unschedule the thread
   // from this isolate.
   // We are disassociating the thread from an isolate and it would
@@ -6,12 +6,14 @@
 
 #include "vm/metrics.h"
 
+#include "vm/compiler/jit/compiler.h"
 #include "vm/isolate.h"
 #include "vm/json_stream.h"
 #include "vm/log.h"
 #include "vm/native_entry.h"
 #include "vm/object.h"
 #include "vm/runtime_entry.h"
+#include "vm/virtual_memory.h"
 
 namespace dart {
 
@@ -270,6 +272,11 @@ int64_t MetricHeapOldExternal::Value() const {
   return isolate()->heap()->ExternalInWords(Heap::kOld) * kWordSize;
 }
 
+int64_t MetricHeapOldDecommitted::Value() const {
+  ASSERT(isolate() == Isolate::Current());
+  return isolate()->heap()->old_space()->decommitted_in_bytes();
+}
+
 int64_t MetricHeapNewUsed::Value() const {
   ASSERT(isolate() == Isolate::Current());
   return isolate()->heap()->UsedInWords(Heap::kNew) * kWordSize;
@@ -291,6 +298,16 @@ int64_t MetricHeapUsed::Value() const {
          isolate()->heap()->UsedInWords(Heap::kOld) * kWordSize;
 }
 
+int64_t MetricBackgroundCompilationQueueLength::Value() const {
+  ASSERT(isolate() == Isolate::Current());
+#if defined(DART_PRECOMPILED_RUNTIME)
+  return 0;
+#else
+  BackgroundCompiler* background_compiler = isolate()->background_compiler();
+  return (background_compiler == NULL) ? 0 : background_compiler->QueueLength();
+#endif  // defined(DART_PRECOMPILED_RUNTIME)
+}
+
 int64_t MetricIsolateCount::Value() const {
   return Isolate::IsolateListLength();
 }
@@ -303,6 +320,10 @@ int64_t MetricPeakRSS::Value() const {
   return Service::MaxRSS();
 }
 
+int64_t MetricDecommitted::Value() const {
+  return VirtualMemory::decommitted_bytes();
+}
+
 void Metric::Init() {
 #define VM_METRIC_INIT(type, variable, name, unit)                             \
   vm_metric_##variable##_.InitInstance(name, NULL, Metric::unit);
@@ -19,6 +19,8 @@ class JSONStream;
   V(MetricHeapOldCapacity, HeapOldCapacity, "heap.old.capacity", kByte)        \
   V(MaxMetric, HeapOldCapacityMax, "heap.old.capacity.max", kByte)             \
   V(MetricHeapOldExternal, HeapOldExternal, "heap.old.external", kByte)        \
+  V(MetricHeapOldDecommitted, HeapOldDecommitted, "heap.old.decommitted",      \
+    kByte)                                                                     \
   V(MetricHeapNewUsed, HeapNewUsed, "heap.new.used", kByte)                    \
   V(MaxMetric, HeapNewUsedMax, "heap.new.used.max", kByte)                     \
   V(MetricHeapNewCapacity, HeapNewCapacity, "heap.new.capacity", kByte)        \
@@ -27,12 +29,20 @@ class JSONStream;
   V(MetricHeapUsed, HeapGlobalUsed, "heap.global.used", kByte)                 \
   V(MaxMetric, HeapGlobalUsedMax, "heap.global.used.max", kByte)               \
   V(Metric, RunnableLatency, "isolate.runnable.latency", kMicrosecond)         \
-  V(Metric, RunnableHeapSize, "isolate.runnable.heap", kByte)
+  V(Metric, RunnableHeapSize, "isolate.runnable.heap", kByte)                  \
+  V(MetricBackgroundCompilationQueueLength,                                    \
+    BackgroundCompilationQueueLength, "compiler.background.queue", kCounter)   \
+  V(Metric, BackgroundCompilationLatency, "compiler.background.latency",       \
+    kMicrosecond)                                                              \
+  V(MaxMetric, BackgroundCompilationLatencyMax,                                \
+    "compiler.background.latency.max", kMicrosecond)                           \
+  V(Metric, BaselineCompilations, "compiler.baseline.count", kCounter)
 
 #define VM_METRIC_LIST(V)                                                      \
   V(MetricIsolateCount, IsolateCount, "vm.isolate.count", kCounter)            \
   V(MetricCurrentRSS, CurrentRSS, "vm.memory.current", kByte)                  \
-  V(MetricPeakRSS, PeakRSS, "vm.memory.max", kByte)
+  V(MetricPeakRSS, PeakRSS, "vm.memory.max", kByte)                            \
+  V(MetricDecommitted, Decommitted, "vm.memory.decommitted", kByte)
 
 class Metric {
  public:
@@ -145,6 +155,11 @@ class MetricHeapOldExternal : public Metric {
   virtual int64_t Value() const;
 };
 
+class MetricHeapOldDecommitted : public Metric {
+ protected:
+  virtual int64_t Value() const;
+};
+
 class MetricHeapNewUsed : public Metric {
  protected:
   virtual int64_t Value() const;
@@ -175,11 +190,21 @@ class MetricPeakRSS : public Metric {
   virtual int64_t Value() const;
 };
 
+class MetricDecommitted : public Metric {
+ protected:
+  virtual int64_t Value() const;
+};
+
 class MetricHeapUsed : public Metric {
  protected:
   virtual int64_t Value() const;
 };
 
+class MetricBackgroundCompilationQueueLength : public Metric {
+ protected:
+  virtual int64_t Value() const;
+};
+
 #if !defined(PRODUCT)
 #define VM_METRIC_VARIABLE(type, variable, name, unit)                         \
   static type vm_metric_##variable##_;
@@ -2036,6 +2036,13 @@ RawObject* Object::Allocate(intptr_t cls_id, intptr_t size, Heap::Space space) {
   Isolate* isolate = thread->isolate();
   Heap* heap = isolate->heap();
 
+  // Classes whose instances mostly survive their first scavenge skip the
+  // copy.
+  if ((space == Heap::kNew) && heap->ShouldPretenure(cls_id)) {
+    heap->new_space()->RecordPretenured(size);
+    space = Heap::kOld;
+  }
+
   uword address;
 
   // In a bump allocation scope, all allocations go into old space.
@@ -2987,6 +2994,7 @@ RawFunction* Function::CreateDynamicInvocationForwarder(
   forwarder.set_optimized_instruction_count(0);
   forwarder.set_inlining_depth(0);
   forwarder.set_optimized_call_site_count(0);
+  forwarder.set_non_escaping_parameters(0);
   forwarder.set_kernel_offset(kernel_offset());
 
   return forwarder.raw();
@@ -7501,6 +7509,7 @@ RawFunction* Function::New(const String& name,
   NOT_IN_PRECOMPILED(result.set_deoptimization_counter(0));
   NOT_IN_PRECOMPILED(result.set_optimized_instruction_count(0));
   NOT_IN_PRECOMPILED(result.set_optimized_call_site_count(0));
+  NOT_IN_PRECOMPILED(result.set_non_escaping_parameters(0));
   NOT_IN_PRECOMPILED(result.set_inlining_depth(0));
   NOT_IN_PRECOMPILED(result.set_kernel_offset(0));
   result.set_is_optimizable(is_native ? false : true);
@@ -7543,6 +7552,7 @@ RawFunction* Function::Clone(const Class& new_owner) const {
   clone.set_optimized_instruction_count(0);
   clone.set_inlining_depth(0);
   clone.set_optimized_call_site_count(0);
+  clone.set_non_escaping_parameters(0);
 
   if (new_owner.NumTypeParameters() > 0) {
     // Adjust uninstantiated types to refer to type parameters of the new owner.
@@ -9119,7 +9129,8 @@ bool Field::UpdateGuardedCidAndLength(const Object& value) const {
     return false;
   }
 
-  if ((cid == guarded_cid()) || ((cid == kNullCid) && is_nullable())) {
+  if ((cid == guarded_cid()) || ((cid == kNullCid) && is_nullable()) ||
+      ((guarded_cid() == kIntegerCid) && RawObject::IsIntegerClassId(cid))) {
     // Class id of the assigned value matches expected class id and nullability.
 
     // If we are tracking length check if it has matches.
@@ -9143,6 +9154,13 @@ bool Field::UpdateGuardedCidAndLength(const Object& value) const {
     // turns it into a nullable field with the given class id.
     ASSERT(is_nullable());
     set_guarded_cid(cid);
+  } else if (SupportsIntegerGuards() &&
+             RawObject::IsIntegerClassId(guarded_cid()) &&
+             RawObject::IsIntegerClassId(cid)) {
+    // Fields holding counters or hashes see both Smi and Mint values. Keep
+    // guarding them as integers so that they can still be unboxed and a
+    // value leaving the Smi range does not deoptimize the code again.
+    set_guarded_cid(kIntegerCid);
   } else {
     // Give up on tracking class id of values contained in this field.
     ASSERT(guarded_cid() != cid);
@@ -13505,6 +13523,19 @@ void ICData::set_rebind_rule(uint32_t rebind_rule) const {
                   RebindRuleBits::update(rebind_rule, raw_ptr()->state_bits_));
 }
 
+intptr_t ICData::reoptimizations() const {
+  return ReoptimizationsBits::decode(raw_ptr()->state_bits_);
+}
+
+void ICData::IncrementReoptimizations() const {
+  const intptr_t value = reoptimizations();
+  if (value < kMaxReoptimizations) {
+    StoreNonPointer(
+        &raw_ptr()->state_bits_,
+        ReoptimizationsBits::update(value + 1, raw_ptr()->state_bits_));
+  }
+}
+
 bool ICData::is_static_call() const {
   return rebind_rule() != kInstance;
 }
@@ -14078,6 +14109,16 @@ intptr_t ICData::AggregateCount() const {
   return count;
 }
 
+void ICData::DecayCounts(intptr_t shift) const {
+  const intptr_t len = NumberOfChecks();
+  for (intptr_t i = 0; i < len; i++) {
+    const intptr_t count = GetCountAt(i);
+    if (count > 1) {
+      SetCountAt(i, Utils::Maximum<intptr_t>(count >> shift, 1));
+    }
+  }
+}
+
 void ICData::SetCodeAt(intptr_t index, const Code& value) const {
   ASSERT(!Isolate::Current()->compilation_allowed());
   const Array& data = Array::Handle(ic_data());
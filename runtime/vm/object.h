@@ -1847,6 +1847,13 @@ class ICData : public Object {
   RebindRule rebind_rule() const;
   void set_rebind_rule(uint32_t rebind_rule) const;
 
+  // Number of times optimized code was compiled to count the calls of this
+  // site that were not inlined, which may trigger reoptimization.
+  // Saturates at kMaxReoptimizations.
+  static const intptr_t kMaxReoptimizations = 7;
+  intptr_t reoptimizations() const;
+  void IncrementReoptimizations() const;
+
   // The length of the array. This includes all sentinel entries including
   // the final one.
   intptr_t Length() const;
@@ -1970,6 +1977,10 @@ class ICData : public Object {
   intptr_t GetCountAt(intptr_t index) const;
   intptr_t AggregateCount() const;
 
+  // Divides the counts by 2^shift, keeping used checks at a count of at
+  // least one, so that later calls outweigh earlier ones.
+  void DecayCounts(intptr_t shift) const;
+
   // Returns this->raw() if num_args_tested == 1 and arg_nr == 1, otherwise
   // returns a new ICData object containing only unique arg_nr checks.
   // Returns only used entries.
@@ -2079,10 +2090,13 @@ class ICData : public Object {
     kDeoptReasonPos = kNumArgsTestedPos + kNumArgsTestedSize,
     kDeoptReasonSize = kLastRecordedDeoptReason + 1,
     kRebindRulePos = kDeoptReasonPos + kDeoptReasonSize,
-    kRebindRuleSize = 3
+    kRebindRuleSize = 3,
+    kReoptimizationsPos = kRebindRulePos + kRebindRuleSize,
+    kReoptimizationsSize = 3
   };
 
   COMPILE_ASSERT(kNumRebindRules <= (1 << kRebindRuleSize));
+  COMPILE_ASSERT(kMaxReoptimizations < (1 << kReoptimizationsSize));
 
   class NumArgsTestedBits : public BitField<uint32_t,
                                             uint32_t,
@@ -2096,6 +2110,11 @@ class ICData : public Object {
                                          uint32_t,
                                          ICData::kRebindRulePos,
                                          ICData::kRebindRuleSize> {};
+  class ReoptimizationsBits
+      : public BitField<uint32_t,
+                        uint32_t,
+                        ICData::kReoptimizationsPos,
+                        ICData::kReoptimizationsSize> {};
 #if defined(DEBUG)
   // Used in asserts to verify that a check is not added twice.
   bool HasCheck(const GrowableArray<intptr_t>& cids) const;
@@ -2597,6 +2616,11 @@ class Function : public Object {
     set_optimized_call_site_count(value);
   }
 
+  // Bit i of non_escaping_parameters() is set if parameter i was found not
+  // to escape the optimized code of this function. Only the first
+  // kMaxEscapeSummaryParameters parameters are tracked.
+  static const intptr_t kMaxEscapeSummaryParameters = 8;
+
   void SetKernelDataAndScript(const Script& script,
                               const ExternalTypedData& data,
                               intptr_t offset);
@@ -3328,6 +3352,8 @@ class Field : public Object {
 
   // Return class id that any non-null value read from this field is guaranteed
   // to have or kDynamicCid if such class id is not known.
+  // kIntegerCid means that the value is either a Smi or a Mint, see
+  // SupportsIntegerGuards.
   // Stores to this field must update this information hence the name.
   intptr_t guarded_cid() const {
 #if defined(DEGUG)
@@ -3347,6 +3373,18 @@ class Field : public Object {
   static intptr_t guarded_cid_offset() {
     return OFFSET_OF(RawField, guarded_cid_);
   }
+
+  // Whether a field assigned both Smi and Mint values keeps guarding them
+  // as kIntegerCid instead of giving up on tracking its class id. Only the
+  // backends that can check and unbox such fields support this state.
+  static bool SupportsIntegerGuards() {
+#if defined(TARGET_ARCH_X64) || defined(TARGET_ARCH_ARM64)
+    return true;
+#else
+    return false;
+#endif
+  }
+
   // Return the list length that any list stored in this field is guaranteed
   // to have. If length is kUnknownFixedLength the length has not
   // been determined. If length is kNoFixedLength this field has multiple
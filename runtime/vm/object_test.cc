@@ -2843,6 +2843,19 @@ ISOLATE_UNIT_TEST_CASE(ICData) {
   o1.SetCountAt(o1.NumberOfChecks() - 1, 0);
   EXPECT_EQ(2, o1.NumberOfUsedChecks());
 
+  o1.SetCountAt(0, 10);
+  o1.DecayCounts(2);
+  EXPECT_EQ(2, o1.GetCountAt(0));
+  EXPECT_EQ(1, o1.GetCountAt(1));
+  EXPECT_EQ(0, o1.GetCountAt(2));
+
+  EXPECT_EQ(0, o1.reoptimizations());
+  for (intptr_t i = 0; i <= ICData::kMaxReoptimizations; i++) {
+    o1.IncrementReoptimizations();
+  }
+  EXPECT_EQ(ICData::kMaxReoptimizations, o1.reoptimizations());
+  EXPECT_EQ(ICData::kInstance, o1.rebind_rule());
+
   ICData& o2 = ICData::Handle();
   o2 = ICData::New(function, target_name, args_descriptor, 57, 2,
                    ICData::kInstance);
@@ -2804,9 +2804,9 @@ void ProfilerService::PrintTimelineJSON(JSONStream* stream,
                                         int64_t time_extent_micros) {
   Thread* thread = Thread::Current();
   Isolate* isolate = thread->isolate();
-  const intptr_t thread_task_mask = Thread::kMutatorTask |
-                                    Thread::kCompilerTask |
-                                    Thread::kSweeperTask | Thread::kMarkerTask;
+  const intptr_t thread_task_mask =
+      Thread::kMutatorTask | Thread::kCompilerTask | Thread::kSweeperTask |
+      Thread::kMarkerTask | Thread::kScavengerTask;
   NoAllocationSampleFilter filter(isolate->main_port(), thread_task_mask,
                                   time_origin_micros, time_extent_micros);
   const bool as_timeline = true;
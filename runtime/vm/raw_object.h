@@ -564,6 +564,19 @@ class RawObject {
     return result;
   }
 
+  // Like Size, but decodes the given header tags instead of loading them from
+  // the object. Used by the parallel scavenger, which may have replaced the
+  // header with a forwarding pointer by the time the size is needed.
+  intptr_t HeapSize(uint32_t tags) const {
+    intptr_t result = SizeTag::decode(tags);
+    if (result != 0) {
+      return result;
+    }
+    result = SizeFromClass(ClassIdTag::decode(tags));
+    ASSERT(result > SizeTag::kMaxSizeTag);
+    return result;
+  }
+
   bool Contains(uword addr) const {
     intptr_t this_size = Size();
     uword this_addr = RawObject::ToAddr(this);
@@ -670,7 +683,8 @@ class RawObject {
   intptr_t VisitPointersPredefined(ObjectPointerVisitor* visitor,
                                    intptr_t class_id);
 
-  intptr_t SizeFromClass() const;
+  intptr_t SizeFromClass() const { return SizeFromClass(GetClassId()); }
+  intptr_t SizeFromClass(intptr_t class_id) const;
 
   intptr_t GetClassId() const {
     uint32_t tags = ptr()->tags_;
@@ -843,7 +857,8 @@ class RawObject {
   friend class RawString;
   friend class RawTypedData;
   friend class Scavenger;
-  friend class ScavengerVisitor;
+  template <bool>
+  friend class ScavengerVisitorBase;
   friend class SizeExcludingClassVisitor;  // GetClassId
   friend class InstanceAccumulator;        // GetClassId
   friend class RetainingPathVisitor;       // GetClassId
@@ -1107,6 +1122,7 @@ class RawFunction : public RawObject {
   F(intptr_t, int32_t, usage_counter)                                          \
   F(intptr_t, uint16_t, optimized_instruction_count)                           \
   F(intptr_t, uint16_t, optimized_call_site_count)                             \
+  F(intptr_t, uint8_t, non_escaping_parameters)                                \
   F(int8_t, int8_t, deoptimization_counter)                                    \
   F(intptr_t, int8_t, state_bits)                                              \
   F(int, int8_t, inlining_depth)
@@ -2483,7 +2499,8 @@ class RawWeakProperty : public RawInstance {
   template <bool>
   friend class MarkingVisitorBase;
   friend class Scavenger;
-  friend class ScavengerVisitor;
+  template <bool>
+  friend class ScavengerVisitorBase;
 };
 
 // MirrorReferences are used by mirrors to hold reflectees that are VM
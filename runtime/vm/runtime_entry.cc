@@ -287,6 +287,11 @@ DEFINE_RUNTIME_ENTRY(AllocateObject, 2) {
       Instance::Handle(zone, Instance::New(cls, Heap::kNew));
 
   arguments.SetReturn(instance);
+  // Instances of pretenured classes are allocated in old space, so this is
+  // needed even when no type arguments are stored below.
+  if (Heap::IsAllocatableInNewSpace(cls.instance_size())) {
+    EnsureNewOrRemembered(isolate, thread, instance);
+  }
   if (cls.NumTypeArguments() == 0) {
     // No type arguments required for a non-parameterized type.
     ASSERT(Instance::CheckedHandle(zone, arguments.ArgAt(1)).IsNull());
@@ -301,10 +306,6 @@ DEFINE_RUNTIME_ENTRY(AllocateObject, 2) {
          (type_arguments.IsInstantiated() &&
           (type_arguments.Length() >= cls.NumTypeArguments())));
   instance.SetTypeArguments(type_arguments);
-
-  if (Heap::IsAllocatableInNewSpace(cls.instance_size())) {
-    EnsureNewOrRemembered(isolate, thread, instance);
-  }
 }
 
 // Instantiate type.
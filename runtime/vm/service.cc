@@ -9,6 +9,7 @@
 #include "platform/globals.h"
 
 #include "vm/base64.h"
+#include "vm/compiler/compiler_pass.h"
 #include "vm/compiler/jit/compiler.h"
 #include "vm/cpu.h"
 #include "vm/dart_api_impl.h"
@@ -3553,6 +3554,22 @@ static bool GetVMTimelineFlags(Thread* thread, JSONStream* js) {
   return true;
 }
 
+static const MethodParameter* get_compiler_pass_times_params[] = {
+    NO_ISOLATE_PARAMETER, NULL,
+};
+
+static bool GetCompilerPassTimes(Thread* thread, JSONStream* js) {
+#if defined(DART_PRECOMPILED_RUNTIME)
+  // Nothing is compiled at runtime.
+  JSONObject obj(js);
+  obj.AddProperty("type", "CompilerPassTimes");
+  JSONArray passes(&obj, "passes");
+#else
+  CompilerPass::PrintTimesToJSON(js);
+#endif
+  return true;
+}
+
 static const MethodParameter* clear_vm_timeline_params[] = {
     NO_ISOLATE_PARAMETER, NULL,
 };
@@ -4750,6 +4767,8 @@ static const ServiceMethodDescriptor service_methods_[] = {
       get_native_allocation_samples_params },
   { "getClassList", GetClassList,
     get_class_list_params },
+  { "_getCompilerPassTimes", GetCompilerPassTimes,
+    get_compiler_pass_times_params },
   { "_getCpuProfile", GetCpuProfile,
     get_cpu_profile_params },
   { "_getCpuProfileTimeline", GetCpuProfileTimeline,
@@ -1421,7 +1421,8 @@ void StubCode::GenerateAllocationStubForClass(Assembler* assembler,
 
   __ LoadObject(kNullReg, Object::null_object());
   if (FLAG_inline_alloc && Heap::IsAllocatableInNewSpace(instance_size) &&
-      !cls.TraceAllocation(isolate)) {
+      !cls.TraceAllocation(isolate) &&
+      !isolate->heap()->ShouldPretenure(cls.id())) {
     Label slow_case;
 
     // Allocate the object and update top to point to
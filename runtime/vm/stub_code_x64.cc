@@ -1534,7 +1534,8 @@ void StubCode::GenerateAllocationStubForClass(Assembler* assembler,
   }
   Isolate* isolate = Isolate::Current();
   if (FLAG_inline_alloc && Heap::IsAllocatableInNewSpace(instance_size) &&
-      !cls.TraceAllocation(isolate)) {
+      !cls.TraceAllocation(isolate) &&
+      !isolate->heap()->ShouldPretenure(cls.id())) {
     Label slow_case;
     // Allocate the object and update top to point to
     // next object start and initialize the allocated object.
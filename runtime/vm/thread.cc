@@ -98,6 +98,8 @@ Thread::Thread(Isolate* isolate)
       deferred_interrupts_(0),
       stack_overflow_count_(0),
       bump_allocate_(false),
+      old_space_top_(0),
+      old_space_end_(0),
       hierarchy_info_(NULL),
       type_usage_info_(NULL),
       pending_functions_(GrowableObjectArray::null()),
@@ -301,6 +303,10 @@ const char* Thread::TaskKindToCString(TaskKind kind) {
       return "kSweeperTask";
     case kMarkerTask:
       return "kMarkerTask";
+    case kCompactorTask:
+      return "kCompactorTask";
+    case kScavengerTask:
+      return "kScavengerTask";
     default:
       UNREACHABLE();
       return "";
@@ -539,6 +545,15 @@ RawError* Thread::HandleInterrupts() {
       heap()->CollectGarbage(Heap::kNew);
     }
     heap()->CheckFinishConcurrentMarking(this);
+    if (IsMutatorThread()) {
+      FinalizationQueue* finalization_queue =
+          isolate()->api_state()->finalization_queue();
+      if (finalization_queue->RunCallbacks(isolate(),
+                                           FinalizationQueue::kBatchSize)) {
+        // Leave the rest for the next check.
+        ScheduleInterrupts(kVMInterrupt);
+      }
+    }
   }
   if ((interrupt_bits & kMessageInterrupt) != 0) {
     MessageHandler::MessageStatus status =
@@ -214,6 +214,7 @@ class Thread : public BaseThread {
     kMarkerTask = 0x4,
     kSweeperTask = 0x8,
     kCompactorTask = 0x10,
+    kScavengerTask = 0x20,
   };
   // Converts a TaskKind to its corresponding C-String name.
   static const char* TaskKindToCString(TaskKind kind);
@@ -483,6 +484,13 @@ class Thread : public BaseThread {
   bool bump_allocate() const { return bump_allocate_; }
   void set_bump_allocate(bool b) { bump_allocate_ = b; }
 
+  // Bounds of this thread's old-space allocation buffer, see
+  // PageSpace::TryAllocateInTLAB.
+  uword old_space_top() const { return old_space_top_; }
+  uword old_space_end() const { return old_space_end_; }
+  void set_old_space_top(uword value) { old_space_top_ = value; }
+  void set_old_space_end(uword value) { old_space_end_ = value; }
+
   HandleScope* top_handle_scope() const {
 #if defined(DEBUG)
     return top_handle_scope_;
@@ -878,6 +886,8 @@ class Thread : public BaseThread {
   uint16_t deferred_interrupts_;
   int32_t stack_overflow_count_;
   bool bump_allocate_;
+  uword old_space_top_;
+  uword old_space_end_;
 
   // Compiler state:
   CompilerState* compiler_state_ = nullptr;
@@ -18,6 +18,7 @@ namespace dart {
 class JSONStream;
 class JSONArray;
 #endif
+class PageSpace;
 
 // Unordered collection of threads relating to a particular isolate.
 class ThreadRegistry {
@@ -35,6 +36,8 @@ class ThreadRegistry {
   void ReleaseStoreBuffers();
   void AcquireMarkingStacks();
   void ReleaseMarkingStacks();
+  void AbandonOldSpaceTLABs(PageSpace* old_space);
+  void MakeOldSpaceTLABsIterable(const PageSpace* old_space);
 
   Thread* mutator_thread() const { return mutator_thread_; }
 
@@ -9,6 +9,8 @@
 
 namespace dart {
 
+int64_t VirtualMemory::decommitted_bytes_ = 0;
+
 bool VirtualMemory::InSamePage(uword address0, uword address1) {
   return (Utils::RoundDown(address0, PageSize()) ==
           Utils::RoundDown(address1, PageSize()));
@@ -27,6 +29,18 @@ void VirtualMemory::Truncate(intptr_t new_size, bool try_unmap) {
   region_.Subregion(region_, 0, new_size);
 }
 
+intptr_t VirtualMemory::Decommit(void* address, intptr_t size) {
+  uword start = Utils::RoundUp(reinterpret_cast<uword>(address), PageSize());
+  uword end = Utils::RoundDown(reinterpret_cast<uword>(address) + size,
+                               PageSize());
+  if ((start >= end) ||
+      !DecommitPages(reinterpret_cast<void*>(start), end - start)) {
+    return 0;
+  }
+  AtomicOperations::IncrementInt64By(&decommitted_bytes_, end - start);
+  return end - start;
+}
+
 VirtualMemory* VirtualMemory::ForImagePage(void* pointer, uword size) {
   // Memory for precompilated instructions was allocated by the embedder, so
   // create a VirtualMemory without allocating.
@@ -5,6 +5,7 @@
 #ifndef RUNTIME_VM_VIRTUAL_MEMORY_H_
 #define RUNTIME_VM_VIRTUAL_MEMORY_H_
 
+#include "platform/atomic.h"
 #include "platform/utils.h"
 #include "vm/globals.h"
 #include "vm/memory_region.h"
@@ -37,6 +38,17 @@ class VirtualMemory {
   static void Protect(void* address, intptr_t size, Protection mode);
   void Protect(Protection mode) { return Protect(address(), size(), mode); }
 
+  // Gives the physical memory of the whole pages in the given range back to
+  // the OS. The range stays mapped and accessible, but its contents are
+  // undefined until written. Returns the number of bytes given back, which
+  // is 0 if the OS does not support it.
+  static intptr_t Decommit(void* address, intptr_t size);
+
+  // Total number of bytes given back to the OS by Decommit.
+  static int64_t decommitted_bytes() {
+    return AtomicOperations::LoadRelaxed(&decommitted_bytes_);
+  }
+
   // Reserves and commits a virtual memory segment with size. If a segment of
   // the requested size cannot be allocated, NULL is returned.
   static VirtualMemory* Allocate(intptr_t size,
@@ -72,6 +84,10 @@ class VirtualMemory {
   // can give back the virtual memory to the system. Returns true on success.
   static bool FreeSubSegment(void* address, intptr_t size);
 
+  // Page aligned part of Decommit. Returns false if the OS does not support
+  // it.
+  static bool DecommitPages(void* address, intptr_t size);
+
   // This constructor is only used internally when reserving new virtual spaces.
   // It does not reserve any virtual address space on its own.
   VirtualMemory(const MemoryRegion& region,
@@ -86,6 +102,7 @@ class VirtualMemory {
   MemoryRegion reserved_;
 
   static uword page_size_;
+  static int64_t decommitted_bytes_;
 
   DISALLOW_IMPLICIT_CONSTRUCTORS(VirtualMemory);
 };
@@ -177,6 +177,11 @@ bool VirtualMemory::FreeSubSegment(void* address, intptr_t size) {
   return true;
 }
 
+bool VirtualMemory::DecommitPages(void* address, intptr_t size) {
+  // Not implemented. It would need the VMO backing the range.
+  return false;
+}
+
 void VirtualMemory::Protect(void* address, intptr_t size, Protection mode) {
 #if defined(DEBUG)
   Thread* thread = Thread::Current();
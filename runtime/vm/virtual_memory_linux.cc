@@ -101,6 +101,17 @@ bool VirtualMemory::FreeSubSegment(void* address,
   return true;
 }
 
+bool VirtualMemory::DecommitPages(void* address, intptr_t size) {
+#if defined(MADV_FREE)
+  // Lets the kernel reclaim the pages lazily, under memory pressure.
+  // Available since Linux 4.5.
+  if (madvise(address, size, MADV_FREE) == 0) {
+    return true;
+  }
+#endif
+  return madvise(address, size, MADV_DONTNEED) == 0;
+}
+
 void VirtualMemory::Protect(void* address, intptr_t size, Protection mode) {
 #if defined(DEBUG)
   Thread* thread = Thread::Current();
@@ -101,6 +101,10 @@ bool VirtualMemory::FreeSubSegment(void* address,
   return true;
 }
 
+bool VirtualMemory::DecommitPages(void* address, intptr_t size) {
+  return madvise(address, size, MADV_FREE) == 0;
+}
+
 void VirtualMemory::Protect(void* address, intptr_t size, Protection mode) {
 #if defined(DEBUG)
   Thread* thread = Thread::Current();
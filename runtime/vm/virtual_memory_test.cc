@@ -100,4 +100,34 @@ VM_UNIT_TEST_CASE(FreeVirtualMemory) {
   }
 }
 
+VM_UNIT_TEST_CASE(DecommitVirtualMemory) {
+  const intptr_t kVirtualMemoryBlockSize = 64 * KB;
+  VirtualMemory* vm =
+      VirtualMemory::Allocate(kVirtualMemoryBlockSize, false, NULL);
+  EXPECT(vm != NULL);
+  char* buf = reinterpret_cast<char*>(vm->address());
+  memset(buf, 'a', kVirtualMemoryBlockSize);
+
+  // Only whole pages are decommitted: the partial pages at both ends keep
+  // their contents.
+  const intptr_t page_size = VirtualMemory::PageSize();
+  const int64_t before = VirtualMemory::decommitted_bytes();
+  const intptr_t decommitted =
+      VirtualMemory::Decommit(buf + 1, kVirtualMemoryBlockSize - 2);
+  EXPECT_EQ(decommitted, VirtualMemory::decommitted_bytes() - before);
+#if !defined(HOST_OS_FUCHSIA)
+  EXPECT_EQ(kVirtualMemoryBlockSize - 2 * page_size, decommitted);
+#else
+  EXPECT_EQ(0, decommitted);
+#endif
+  EXPECT_EQ('a', buf[0]);
+  EXPECT_EQ('a', buf[page_size - 1]);
+  EXPECT_EQ('a', buf[kVirtualMemoryBlockSize - 1]);
+
+  // The range stays usable.
+  buf[page_size] = 'b';
+  EXPECT_EQ('b', buf[page_size]);
+  delete vm;
+}
+
 }  // namespace dart
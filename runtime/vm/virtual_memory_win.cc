@@ -82,6 +82,11 @@ bool VirtualMemory::FreeSubSegment(void* address,
   return true;
 }
 
+bool VirtualMemory::DecommitPages(void* address, intptr_t size) {
+  // The pages stay committed, but their contents need not be preserved.
+  return VirtualAlloc(address, size, MEM_RESET, PAGE_READWRITE) != NULL;
+}
+
 void VirtualMemory::Protect(void* address, intptr_t size, Protection mode) {
 #if defined(DEBUG)
   Thread* thread = Thread::Current();
@@ -222,6 +222,14 @@ class _IOCrypto {
   }
 }
 
+@patch
+class _IOBufferPoolInfo {
+  @patch
+  static List<int> _statistics() {
+    throw new UnsupportedError("_IOBufferPoolInfo._statistics");
+  }
+}
+
 @patch
 class _Platform {
   @patch
@@ -665,6 +665,11 @@ abstract class _RandomAccessFileOps {
   length();
   flush();
   lock(int lock, int start, int end);
+
+  // Reads and writes run by the file IO pool, completing with the same
+  // responses as the corresponding IO service requests.
+  Future readAsync(int bytes);
+  Future writeFromAsync(List<int> buffer, int start, int end);
 }
 
 class _RandomAccessFile implements RandomAccessFile {
@@ -700,6 +705,7 @@ class _RandomAccessFile implements RandomAccessFile {
           'ext.dart.io.getOpenFiles', _FileResourceInfo.getOpenFiles);
       registerExtension(
           'ext.dart.io.getFileByID', _FileResourceInfo.getFileInfoMapByID);
+      _IOBufferPoolInfo.connect();
       _connectedResourceHandler = true;
     }
   }
@@ -749,7 +755,7 @@ class _RandomAccessFile implements RandomAccessFile {
     if (bytes is! int) {
       throw new ArgumentError(bytes);
     }
-    return _dispatch(_IOService.fileRead, [null, bytes]).then((response) {
+    return _dispatchToPool(() => _ops.readAsync(bytes)).then((response) {
       if (_isErrorResponse(response)) {
         throw _exceptionFromResponse(response, "read failed", path);
       }
@@ -783,12 +789,12 @@ class _RandomAccessFile implements RandomAccessFile {
       return new Future.value(0);
     }
     int length = end - start;
-    return _dispatch(_IOService.fileReadInto, [null, length]).then((response) {
+    return _dispatchToPool(() => _ops.readAsync(length)).then((response) {
       if (_isErrorResponse(response)) {
         throw _exceptionFromResponse(response, "readInto failed", path);
       }
-      int read = response[1];
-      List<int> data = response[2];
+      List<int> data = response[1];
+      int read = data.length;
       buffer.setRange(start, start + read, data);
       _resourceInfo.addRead(read);
       return read;
@@ -858,16 +864,14 @@ class _RandomAccessFile implements RandomAccessFile {
       return new Future.error(e);
     }
 
-    List request = new List(4);
-    request[0] = null;
-    request[1] = result.buffer;
-    request[2] = result.start;
-    request[3] = end - (start - result.start);
-    return _dispatch(_IOService.fileWriteFrom, request).then((response) {
+    int bufferEnd = end - (start - result.start);
+    return _dispatchToPool(
+            () => _ops.writeFromAsync(result.buffer, result.start, bufferEnd))
+        .then((response) {
       if (_isErrorResponse(response)) {
         throw _exceptionFromResponse(response, "writeFrom failed", path);
       }
-      _resourceInfo.addWrite(end - (start - result.start));
+      _resourceInfo.addWrite(bufferEnd);
       return this;
     });
   }
@@ -1080,12 +1084,9 @@ class _RandomAccessFile implements RandomAccessFile {
   int _pointer() => _ops.getPointer();
 
   Future _dispatch(int request, List data, {bool markClosed: false}) {
-    if (closed) {
-      return new Future.error(new FileSystemException("File closed", path));
-    }
-    if (_asyncDispatched) {
-      var msg = "An async operation is currently pending";
-      return new Future.error(new FileSystemException(msg, path));
+    Future error = _checkAsyncDispatch();
+    if (error != null) {
+      return error;
     }
     if (markClosed) {
       // Set closed to true to ensure that no more async requests can be issued
@@ -1099,6 +1100,30 @@ class _RandomAccessFile implements RandomAccessFile {
     });
   }
 
+  // Like _dispatch, for the operations run by the file IO pool instead of
+  // the IO service.
+  Future _dispatchToPool(Future operation()) {
+    Future error = _checkAsyncDispatch();
+    if (error != null) {
+      return error;
+    }
+    _asyncDispatched = true;
+    return operation().whenComplete(() {
+      _asyncDispatched = false;
+    });
+  }
+
+  Future _checkAsyncDispatch() {
+    if (closed) {
+      return new Future.error(new FileSystemException("File closed", path));
+    }
+    if (_asyncDispatched) {
+      var msg = "An async operation is currently pending";
+      return new Future.error(new FileSystemException(msg, path));
+    }
+    return null;
+  }
+
   void _checkAvailable() {
     if (_asyncDispatched) {
       throw new FileSystemException(
@@ -280,3 +280,33 @@ class _SocketResourceInfo extends _ReadWriteResourceInfo {
     openSockets.remove(info.id);
   }
 }
+
+/// Statistics of the pool recycling the native storage of the buffers that
+/// files, sockets and processes read into.
+class _IOBufferPoolInfo {
+  static bool _connected = false;
+
+  /// Returns the pool hits, misses and resident bytes.
+  external static List<int> _statistics();
+
+  static void connect() {
+    if (!_connected) {
+      registerExtension(
+          'ext.dart.io.getIOBufferPoolStatistics', getStatistics);
+      _connected = true;
+    }
+  }
+
+  static Future<ServiceExtensionResponse> getStatistics(function, params) {
+    assert(function == 'ext.dart.io.getIOBufferPoolStatistics');
+    var statistics = _statistics();
+    var data = {
+      'type': '_iobufferpool',
+      'hits': statistics[0],
+      'misses': statistics[1],
+      'residentBytes': statistics[2],
+    };
+    var jsonValue = json.encode(data);
+    return new Future.value(new ServiceExtensionResponse.result(jsonValue));
+  }
+}
@@ -726,6 +726,24 @@ class _RawSecureSocket extends Stream<RawSocketEvent>
     return written;
   }
 
+  int writeBuffers(List<List<int>> buffers) {
+    int written = 0;
+    for (List<int> buffer in buffers) {
+      int bytes = write(buffer);
+      written += bytes;
+      if (bytes < buffer.length) break;
+    }
+    return written;
+  }
+
+  int sendFile(RandomAccessFile file, int position, int count) {
+    // The bytes have to go through the filter to be encrypted, which only
+    // takes a limited amount at a time.
+    const int maxChunk = 64 * 1024;
+    file.setPositionSync(position);
+    return write(file.readSync(count < maxChunk ? count : maxChunk));
+  }
+
   X509Certificate get peerCertificate => _secureFilter.peerCertificate;
 
   String get selectedProtocol => _selectedProtocol;
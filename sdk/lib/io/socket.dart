@@ -528,6 +528,28 @@ abstract class RawSocket implements Stream<RawSocketEvent> {
    */
   int write(List<int> buffer, [int offset, int count]);
 
+  /**
+   * Writes the [buffers] in order to the socket. The number of successfully
+   * written bytes is returned. Like [write], this function is non-blocking
+   * and will only write data if buffer space is available in the socket.
+   *
+   * Where the platform allows it, the buffers are written with a single
+   * system call instead of one [write] per buffer.
+   */
+  int writeBuffers(List<List<int>> buffers);
+
+  /**
+   * Writes up to [count] bytes of [file] from [position] to the socket. The
+   * number of successfully written bytes is returned. Like [write], this
+   * function is non-blocking and will only write data if buffer space is
+   * available in the socket.
+   *
+   * Where the platform allows it, the bytes are sent directly from the
+   * file without being copied into Dart memory. The range must lie within
+   * the file, and the position of [file] is unspecified afterwards.
+   */
+  int sendFile(RandomAccessFile file, int position, int count);
+
   /**
    * Returns the port used by this socket.
    */
@@ -782,6 +804,15 @@ abstract class RawDatagramSocket extends Stream<RawSocketEvent> {
    */
   int send(List<int> buffer, InternetAddress address, int port);
 
+  /**
+   * Send each of the [buffers] as a datagram.
+   *
+   * Returns the number of datagrams sent, which is less than the number of
+   * [buffers] if the socket could not take them all. Where the platform
+   * allows it, the datagrams are sent with a single system call.
+   */
+  int sendBatch(List<List<int>> buffers, InternetAddress address, int port);
+
   /**
    * Receive a datagram. If there are no datagrams available `null` is
    * returned.
@@ -790,6 +821,17 @@ abstract class RawDatagramSocket extends Stream<RawSocketEvent> {
    */
   Datagram receive();
 
+  /**
+   * Receive up to [maxCount] datagrams. If there are no datagrams available
+   * an empty list is returned. Fewer than [maxCount] datagrams are returned
+   * only when no more are available.
+   *
+   * The data of the datagrams are views on shared buffers. Where the
+   * platform allows it, several datagrams are received with a single system
+   * call.
+   */
+  List<Datagram> receiveBatch([int maxCount = 16]);
+
   /**
    * Join a multicast group.
    *
@@ -0,0 +1,79 @@
+// Copyright (c) 2019, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+//
+// Tests asynchronous reads and writes of many files at the same time, whose
+// completions can be delivered together.
+
+import "dart:async";
+import "dart:io";
+import "dart:typed_data";
+
+import "package:async_helper/async_helper.dart";
+import "package:expect/expect.dart";
+
+const int fileCount = 20;
+const int chunkCount = 50;
+const int chunkLength = 100;
+
+List<int> chunk(int file, int index) =>
+    new List<int>.generate(chunkLength, (i) => (file * 31 + index + i) & 0xFF);
+
+Future writeChunks(RandomAccessFile file, int fileIndex) async {
+  for (int i = 0; i < chunkCount; i++) {
+    var bytes = chunk(fileIndex, i);
+    // Alternate between typed data and lists needing a conversion.
+    await file.writeFrom(i.isEven ? new Uint8List.fromList(bytes) : bytes);
+  }
+}
+
+Future readChunks(RandomAccessFile file, int fileIndex) async {
+  var buffer = new Uint8List(chunkLength + 2);
+  for (int i = 0; i < chunkCount; i++) {
+    if (i.isEven) {
+      Expect.listEquals(chunk(fileIndex, i), await file.read(chunkLength));
+    } else {
+      int read = await file.readInto(buffer, 1, 1 + chunkLength);
+      Expect.equals(chunkLength, read);
+      Expect.listEquals(chunk(fileIndex, i), buffer.sublist(1, 1 + read));
+    }
+  }
+  Expect.equals(0, (await file.read(chunkLength)).length);
+}
+
+main() async {
+  asyncStart();
+  var temp = Directory.systemTemp.createTempSync('dart_file_concurrent');
+  var files = new List<File>.generate(
+      fileCount, (i) => new File('${temp.path}/file$i'));
+
+  var writers = await Future.wait(
+      files.map((file) => file.open(mode: FileMode.write)));
+  await Future.wait(new List.generate(
+      fileCount, (i) => writeChunks(writers[i], i)));
+  await Future.wait(writers.map((file) => file.close()));
+
+  var readers = await Future.wait(files.map((file) => file.open()));
+  await Future.wait(new List.generate(
+      fileCount, (i) => readChunks(readers[i], i)));
+
+  // Only one operation can be pending on a file.
+  var pending = readers[0].read(1);
+  await readers[0].read(1).then((_) {
+    Expect.fail("Second pending operation did not fail");
+  }, onError: (e) {
+    Expect.isTrue(e is FileSystemException);
+  });
+  await pending;
+  await Future.wait(readers.map((file) => file.close()));
+
+  // Operations on a closed file fail.
+  await readers[0].read(1).then((_) {
+    Expect.fail("Read of a closed file did not fail");
+  }, onError: (e) {
+    Expect.isTrue(e is FileSystemException);
+  });
+
+  temp.deleteSync(recursive: true);
+  asyncEnd();
+}
@@ -0,0 +1,56 @@
+// Copyright (c) 2019, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+//
+// Tests RawDatagramSocket.sendBatch and RawDatagramSocket.receiveBatch.
+
+import "dart:io";
+import "dart:typed_data";
+
+import "package:async_helper/async_helper.dart";
+import "package:expect/expect.dart";
+
+main() {
+  asyncStart();
+  const int count = 40;
+  var address = InternetAddress.loopbackIPv4;
+  var datagrams = new List<List<int>>.generate(
+      count,
+      (i) => i.isEven
+          ? new Uint8List.fromList(new List.generate(i + 1, (j) => i))
+          : new List<int>.filled(1000 + i, i));
+  RawDatagramSocket.bind(address, 0).then((producer) {
+    RawDatagramSocket.bind(address, 0).then((receiver) {
+      int sent = 0;
+      producer.listen((event) {
+        if (event == RawSocketEvent.write && sent < count) {
+          sent += producer.sendBatch(
+              datagrams.sublist(sent), address, receiver.port);
+          producer.writeEventsEnabled = true;
+        }
+      });
+      var received = <List<int>>[];
+      receiver.listen((event) {
+        if (event != RawSocketEvent.read) return;
+        // Ask for more datagrams than one native call receives, too.
+        int maxCount = received.length.isEven ? 7 : 100;
+        var batch = receiver.receiveBatch(maxCount);
+        Expect.isTrue(batch.length <= maxCount);
+        for (var datagram in batch) {
+          Expect.equals(producer.port, datagram.port);
+          Expect.equals(address, datagram.address);
+          received.add(datagram.data);
+        }
+        if (received.length == count) {
+          for (int i = 0; i < count; i++) {
+            Expect.listEquals(datagrams[i], received[i]);
+          }
+          Expect.isTrue(receiver.receiveBatch().isEmpty);
+          producer.close();
+          receiver.close();
+          asyncEnd();
+        }
+      });
+    });
+  });
+}
@@ -0,0 +1,106 @@
+// Copyright (c) 2019, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+//
+// Tests RawSocket.writeBuffers and RawSocket.sendFile.
+
+import "dart:async";
+import "dart:io";
+import "dart:typed_data";
+
+import "package:async_helper/async_helper.dart";
+import "package:expect/expect.dart";
+
+const SERVER_ADDRESS = "127.0.0.1";
+
+// Connects to a server collecting the bytes it receives, and calls write
+// each time the client socket can be written to until it returns false.
+Future<List<int>> transfer(bool write(RawSocket socket)) {
+  var completer = new Completer<List<int>>();
+  RawServerSocket.bind(SERVER_ADDRESS, 0).then((server) {
+    server.listen((socket) {
+      var received = <int>[];
+      socket.listen((e) {
+        if (e == RawSocketEvent.read) {
+          received.addAll(socket.read());
+        } else if (e == RawSocketEvent.readClosed) {
+          socket.close();
+          server.close();
+          completer.complete(received);
+        }
+      });
+    });
+    RawSocket.connect(SERVER_ADDRESS, server.port).then((socket) {
+      socket.listen((e) {
+        if (e == RawSocketEvent.write) {
+          if (write(socket)) {
+            socket.writeEventsEnabled = true;
+          } else {
+            socket.shutdown(SocketDirection.send);
+          }
+        }
+      });
+    });
+  });
+  return completer.future;
+}
+
+void testWriteBuffers() {
+  asyncStart();
+  var buffers = <List<int>>[
+    new Uint8List.fromList([1, 2, 3]),
+    <int>[4, 5],
+    new Uint8List(0),
+    new Uint8List.fromList(new List.generate(100000, (i) => i & 0xFF)),
+    new Uint8List.view(new Uint8List.fromList([0, 6, 7, 0]).buffer, 1, 2),
+  ];
+  var expected = buffers.expand((buffer) => buffer).toList();
+  int offset = 0;
+  transfer((socket) {
+    // Write the buffers that have not been written completely yet.
+    var remaining = <List<int>>[];
+    int start = offset;
+    for (var buffer in buffers) {
+      if (start < buffer.length) {
+        remaining.add(buffer.sublist(start));
+        start = 0;
+      } else {
+        start -= buffer.length;
+      }
+    }
+    offset += socket.writeBuffers(remaining);
+    return offset < expected.length;
+  }).then((received) {
+    Expect.listEquals(expected, received);
+    asyncEnd();
+  });
+}
+
+void testSendFile() {
+  asyncStart();
+  var temp = Directory.systemTemp.createTempSync('dart_raw_socket_send_file');
+  var file = new File('${temp.path}/file');
+  var contents = new List<int>.generate(200000, (i) => (i * 7) & 0xFF);
+  file.writeAsBytesSync(contents);
+  var randomAccessFile = file.openSync();
+  const int start = 1000;
+  const int end = 150000;
+  int position = start;
+  transfer((socket) {
+    Expect.throws(
+        () => socket.sendFile(randomAccessFile, 0, contents.length + 1),
+        (e) => e is RangeError);
+    position += socket.sendFile(randomAccessFile, position, end - position);
+    return position < end;
+  }).then((received) {
+    Expect.listEquals(contents.sublist(start, end), received);
+    randomAccessFile.closeSync();
+    temp.deleteSync(recursive: true);
+    asyncEnd();
+  });
+}
+
+void main() {
+  testWriteBuffers();
+  testSendFile();
+}